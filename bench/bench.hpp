@@ -0,0 +1,379 @@
+#pragma once
+
+#include "perf_counters.hpp"
+#include "simd/aligned_allocator.hpp"
+#include "simd/cpu_features.hpp"
+#include "simd/simd_dispatch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if !defined(__ANDROID__) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64))
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define BENCH_HAS_TSC 1
+#endif
+
+/**
+    Disables auto-vectorization of the scalar baselines, so they measure what the simd types are
+    compared against instead of a second, compiler generated simd kernel.
+*/
+#if defined(__GNUC__) && !defined(__clang__)
+#define BENCH_SCALAR __attribute__((noinline, optimize("no-tree-vectorize")))
+#elif defined(__GNUC__)
+#define BENCH_SCALAR __attribute__((noinline))
+#else
+#define BENCH_SCALAR
+#endif
+
+/**
+    Minimal microbenchmark harness in the spirit of Google Benchmark. Each benchmark cpp file
+    registers kernels at static initialization:
+
+        const bench::registration registered([] {
+            bench::add({ "simdf4/add", "scalar/add", count, 3 * count * sizeof(float), [] { ... } });
+        });
+
+    A kernel processes `elements` values per call and moves `bytes` bytes (0 for latency chains);
+    kernels that set `flops` (floating point operations per call) also get a GFLOP/s column.
+    bench::run runs every kernel repeatedly for at least --min-time seconds, keeps the fastest
+    sample and reports time and reference cycles (TSC) per element, bandwidth and the speedup over
+    the baseline kernel. --filter=<text> selects kernels by name, --json prints the results as
+    JSON for trend tracking. --perf adds core cycles, IPC and cache / branch misses per element
+    from the hardware counters (see perf_counters), summed over all samples.
+*/
+namespace bench {
+
+struct kernel {
+    std::string name;
+    /** Name of the kernel the speedup is computed against, empty for none. */
+    std::string baseline;
+    size_t elements;
+    size_t bytes;
+    std::function<void()> run;
+    double flops = 0;
+};
+
+struct result {
+    const kernel* source;
+    double ns_per_element;
+    /** Negative when no cycle counter is available. */
+    double cycles_per_element;
+    double speedup;
+    /** Hardware counts over counted_elements values, all -1 without --perf. */
+    perf_counters::values counters;
+    double counted_elements;
+};
+
+/**
+    Number of float values per array in the throughput kernels. Input and output of a
+    kernel fit into the L1 data cache together.
+*/
+const size_t l1_elements = 2048;
+/**
+    Number of dependent operations in the latency kernels.
+*/
+const size_t chain_length = 1024;
+
+inline std::vector<kernel>& kernels()
+{
+    static std::vector<kernel> list;
+    return list;
+}
+inline void add(kernel k)
+{
+    kernels().push_back(std::move(k));
+}
+
+struct registration {
+    explicit registration(const std::function<void()>& add_kernels)
+    {
+        add_kernels();
+    }
+};
+
+/**
+    Makes the compiler assume value is read and modified, e.g. so a latency chain seeded with a
+    constant is not folded.
+*/
+template <typename T>
+inline void do_not_optimize(T& value)
+{
+#if defined(__GNUC__)
+    __asm__ volatile(""
+                     : "+m"(value)
+                     :
+                     : "memory");
+#else
+    static volatile char sink;
+    sink = *reinterpret_cast<volatile char*>(&value);
+#endif
+}
+
+/**
+    Array of count values filled with generator(i), register padded.
+*/
+template <typename T, typename Generator>
+aligned_vector<T> make_data(size_t count, Generator generator)
+{
+    aligned_vector<T> result(count);
+    for (size_t i = 0; i < count; ++i)
+        result[i] = static_cast<T>(generator(i));
+    return result;
+}
+
+inline uint64_t cycle_count() noexcept
+{
+#if defined(BENCH_HAS_TSC)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+inline result measure(const kernel& k, double min_time, perf_counters* counters)
+{
+    using clock = std::chrono::steady_clock;
+    const int samples = 5;
+    k.run();
+
+    // calibrate the number of calls per sample
+    size_t iterations = 1;
+    for (;;) {
+        const auto start = clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+            k.run();
+        const double seconds = std::chrono::duration<double>(clock::now() - start).count();
+        if (seconds >= min_time / samples || iterations >= (size_t(1) << 30))
+            break;
+        iterations *= seconds > 0 ? std::max<size_t>(2, std::min<size_t>(100, static_cast<size_t>(min_time / samples / seconds) + 1)) : 100;
+    }
+
+    double best_ns = 1e300;
+    uint64_t best_cycles = ~uint64_t(0);
+    if (counters)
+        counters->start();
+    for (int s = 0; s < samples; ++s) {
+        const auto start = clock::now();
+        const uint64_t start_cycles = cycle_count();
+        for (size_t i = 0; i < iterations; ++i)
+            k.run();
+        const uint64_t cycles = cycle_count() - start_cycles;
+        const double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        best_ns = std::min(best_ns, ns);
+        best_cycles = std::min(best_cycles, cycles);
+    }
+    perf_counters::values counts;
+    counts.fill(-1);
+    if (counters)
+        counts = counters->stop();
+    const double elements = static_cast<double>(iterations) * k.elements;
+#if defined(BENCH_HAS_TSC)
+    const double cycles_per_element = best_cycles / elements;
+#else
+    const double cycles_per_element = -1;
+#endif
+    return result{ &k, best_ns / elements, cycles_per_element, 0, counts, elements * samples };
+}
+
+inline const char* isa_name(simd_isa isa)
+{
+    switch (isa) {
+    case simd_isa::scalar:
+        return "scalar";
+    case simd_isa::neon:
+        return "neon";
+    case simd_isa::sse2:
+        return "sse2";
+    case simd_isa::sse3:
+        return "sse3";
+    case simd_isa::ssse3:
+        return "ssse3";
+    case simd_isa::sse4_1:
+        return "sse4.1";
+    case simd_isa::avx:
+        return "avx";
+    case simd_isa::avx2:
+        return "avx2";
+    case simd_isa::avx512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+/**
+    Counter value per element, negative if the counter is unavailable.
+*/
+inline double per_element(const result& r, perf_counters::event e)
+{
+    return r.counters[e] < 0 ? -1 : r.counters[e] / r.counted_elements;
+}
+inline double instructions_per_cycle(const result& r)
+{
+    const auto cycles = r.counters[perf_counters::cycles];
+    const auto instructions = r.counters[perf_counters::instructions];
+    return cycles <= 0 || instructions < 0 ? -1 : static_cast<double>(instructions) / cycles;
+}
+
+inline void print_optional(const char* format, double value)
+{
+    if (value >= 0)
+        std::printf(format, value);
+    else
+        std::printf("%10s", "-");
+}
+
+/**
+    GFLOP/s of a kernel that counts its flops, -1 for the others.
+*/
+inline double gflops(const result& r)
+{
+    return r.source->flops > 0 ? r.source->flops / (r.ns_per_element * r.source->elements) : -1;
+}
+
+inline void print_table(const std::vector<result>& results, bool with_counters)
+{
+    const bool with_flops = std::any_of(results.begin(), results.end(), [](const result& r) { return r.source->flops > 0; });
+    std::printf("%-40s %10s %12s %10s %10s", "benchmark", "ns/elem", "cycles/elem", "GB/s", "speedup");
+    if (with_flops)
+        std::printf(" %10s", "GFLOP/s");
+    if (with_counters)
+        std::printf(" %10s %10s %10s %10s %10s", "core cyc/e", "IPC", "L1D mis/e", "LLC mis/e", "br mis/e");
+    std::printf("\n");
+    for (const auto& r : results) {
+        std::printf("%-40s %10.3f ", r.source->name.c_str(), r.ns_per_element);
+        if (r.cycles_per_element >= 0)
+            std::printf("%12.3f ", r.cycles_per_element);
+        else
+            std::printf("%12s ", "-");
+        if (r.source->bytes != 0)
+            std::printf("%10.2f ", r.source->bytes / (r.ns_per_element * r.source->elements));
+        else
+            std::printf("%10s ", "-");
+        if (r.speedup > 0)
+            std::printf("%9.2fx", r.speedup);
+        else
+            std::printf("%10s", "-");
+        if (with_flops)
+            print_optional(" %10.2f", gflops(r));
+        if (with_counters) {
+            print_optional(" %10.3f", per_element(r, perf_counters::cycles));
+            print_optional(" %10.2f", instructions_per_cycle(r));
+            print_optional(" %10.4f", per_element(r, perf_counters::l1d_misses));
+            print_optional(" %10.4f", per_element(r, perf_counters::llc_misses));
+            print_optional(" %10.4f", per_element(r, perf_counters::branch_misses));
+        }
+        std::printf("\n");
+    }
+}
+
+inline void print_json(const std::vector<result>& results)
+{
+    // isa is what the simd types were compiled for, cpu the best level of the machine running them
+    // and kernels the level the dispatched kernels of simd_algorithm and simd_blas run at
+    std::printf("{\n  \"context\": { \"isa\": \"%s\", \"cpu\": \"%s\", \"kernels\": \"%s\", \"cycle_counter\": \"%s\" },\n  \"benchmarks\": [",
+        isa_name(compiled_isa()), isa_name(cpu_features::instance().best_isa()), isa_name(simd_dispatch::kernel_isa(compiled_isa())),
+        results.empty() || results[0].cycles_per_element < 0 ? "none" : "tsc");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::printf("%s\n    { \"name\": \"%s\", \"elements\": %zu, \"ns_per_element\": %.6g", i == 0 ? "" : ",",
+            r.source->name.c_str(), r.source->elements, r.ns_per_element);
+        if (r.cycles_per_element >= 0)
+            std::printf(", \"cycles_per_element\": %.6g", r.cycles_per_element);
+        if (r.source->bytes != 0)
+            std::printf(", \"bytes_per_second\": %.6g", r.source->bytes / (r.ns_per_element * r.source->elements) * 1e9);
+        if (r.source->flops > 0)
+            std::printf(", \"flops_per_second\": %.6g", gflops(r) * 1e9);
+        if (r.speedup > 0)
+            std::printf(", \"baseline\": \"%s\", \"speedup\": %.6g", r.source->baseline.c_str(), r.speedup);
+        const std::pair<const char*, double> counters[] = {
+            { "core_cycles_per_element", per_element(r, perf_counters::cycles) },
+            { "instructions_per_cycle", instructions_per_cycle(r) },
+            { "l1d_misses_per_element", per_element(r, perf_counters::l1d_misses) },
+            { "llc_misses_per_element", per_element(r, perf_counters::llc_misses) },
+            { "branch_misses_per_element", per_element(r, perf_counters::branch_misses) }
+        };
+        for (const auto& c : counters) {
+            if (c.second >= 0)
+                std::printf(", \"%s\": %.6g", c.first, c.second);
+        }
+        std::printf(" }");
+    }
+    std::printf("\n  ]\n}\n");
+}
+
+inline int run(int argc, char** argv)
+{
+    std::string filter;
+    bool json = false;
+    bool with_counters = false;
+    double min_time = 0.1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.compare(0, 9, "--filter=") == 0) {
+            filter = arg.substr(9);
+        } else if (arg == "--json") {
+            json = true;
+        } else if (arg == "--perf") {
+            with_counters = true;
+        } else if (arg.compare(0, 11, "--min-time=") == 0) {
+            min_time = std::atof(arg.c_str() + 11);
+        } else {
+            std::fprintf(stderr, "usage: %s [--filter=<text>] [--min-time=<seconds>] [--json] [--perf]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // selected kernels and the baselines they are compared against
+    const auto& all = kernels();
+    std::vector<bool> selected(all.size(), false);
+    for (size_t i = 0; i < all.size(); ++i) {
+        if (all[i].name.find(filter) == std::string::npos)
+            continue;
+        selected[i] = true;
+        for (size_t j = 0; j < all.size(); ++j)
+            selected[j] = selected[j] || all[j].name == all[i].baseline;
+    }
+
+    std::unique_ptr<perf_counters> counters;
+    if (with_counters) {
+        counters.reset(new perf_counters());
+        if (!counters->any_available()) {
+            std::fprintf(stderr, "hardware counters are not available (check /proc/sys/kernel/perf_event_paranoid)\n");
+            counters.reset();
+            with_counters = false;
+        }
+    }
+
+    std::vector<result> results;
+    for (size_t i = 0; i < all.size(); ++i) {
+        if (selected[i])
+            results.push_back(measure(all[i], min_time, counters.get()));
+    }
+    for (auto& r : results) {
+        for (const auto& b : results) {
+            if (!r.source->baseline.empty() && b.source->name == r.source->baseline)
+                r.speedup = b.ns_per_element / r.ns_per_element;
+        }
+    }
+
+    if (json)
+        print_json(results);
+    else
+        print_table(results, with_counters);
+    return 0;
+}
+
+} // namespace bench
@@ -0,0 +1,31 @@
+QT -= gui core
+
+CONFIG += console
+CONFIG -= app_bundle
+
+!android:CONFIG += c++1z
+android:CONFIG += c++14
+
+isEmpty(SIMD_X86_ARCH):SIMD_X86_ARCH = -msse4.1 -mmmx
+!android:QMAKE_CXXFLAGS += $$SIMD_X86_ARCH
+android:QMAKE_CXXFLAGS += -mfloat-abi=softfp -mfpu=neon
+!win32-msvc*:QMAKE_CXXFLAGS_RELEASE += -O3
+
+include(../simd/dispatch/dispatch.pri)
+
+SOURCES += \
+    bench_main.cpp \
+    bench_simdf4.cpp \
+    bench_simdu16x8.cpp \
+    bench_math.cpp \
+    bench_mat4f.cpp \
+    bench_quatf.cpp \
+    bench_gemm.cpp \
+    bench_blas.cpp \
+    bench_parallel.cpp
+
+HEADERS += \
+    bench.hpp \
+    perf_counters.hpp
+
+INCLUDEPATH += ../
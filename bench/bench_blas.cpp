@@ -0,0 +1,129 @@
+#include "bench.hpp"
+
+#include "simd/simd_blas.hpp"
+
+#include <cmath>
+
+namespace {
+const size_t count = bench::l1_elements;
+// y = A x for a column-major A with 4 columns and y far larger than the last level cache, with
+// coherent and non-temporal stores of y (which is not read for beta = 0)
+const size_t stream_count = 8 << 20;
+const size_t stream_columns = 4;
+// sgemv on a 256 x 256 matrix, which fits into the L2 cache
+const size_t gemv_size = 256;
+
+struct data_set {
+    aligned_vector<float> x = bench::make_data<float>(count, [](size_t i) { return 1.0f + (i % 17) * 0.25f; });
+    aligned_vector<float> y = bench::make_data<float>(count, [](size_t i) { return 0.5f * (i % 3); });
+    aligned_vector<float> matrix = bench::make_data<float>(gemv_size * gemv_size, [](size_t i) { return 0.01f * (i % 101); });
+    aligned_vector<float> gemv_out = aligned_vector<float>(gemv_size);
+};
+data_set& data()
+{
+    static data_set d;
+    return d;
+}
+struct stream_data_set {
+    aligned_vector<float> matrix = bench::make_data<float>(stream_count * stream_columns, [](size_t i) { return 0.001f * (i % 1000); });
+    float x[stream_columns] = { 1.0f, -0.5f, 0.25f, 2.0f };
+    aligned_vector<float> y = aligned_vector<float>(stream_count);
+};
+stream_data_set& stream_data()
+{
+    static stream_data_set d;
+    return d;
+}
+
+BENCH_SCALAR void scalar_axpy(size_t n, float alpha, const float* x, float* y)
+{
+    for (size_t i = 0; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+BENCH_SCALAR float scalar_dot(size_t n, const float* x, const float* y)
+{
+    float sum = 0;
+    for (size_t i = 0; i < n; ++i)
+        sum += x[i] * y[i];
+    return sum;
+}
+BENCH_SCALAR float scalar_nrm2(size_t n, const float* x)
+{
+    float sum = 0;
+    for (size_t i = 0; i < n; ++i)
+        sum += x[i] * x[i];
+    return std::sqrt(sum);
+}
+BENCH_SCALAR void scalar_gemv(size_t m, size_t n, const float* a, const float* x, float* y)
+{
+    // row-major
+    for (size_t i = 0; i < m; ++i) {
+        float sum = 0;
+        for (size_t j = 0; j < n; ++j)
+            sum += a[i * n + j] * x[j];
+        y[i] = sum;
+    }
+}
+
+const bench::registration registered([] {
+    // alpha alternates sign so that y stays bounded over the repetitions
+    bench::add({ "scalar/axpy", "", count, 3 * count * sizeof(float), [] {
+                    auto& d = data();
+                    static float alpha = 0.5f;
+                    scalar_axpy(count, alpha = -alpha, d.x.data(), d.y.data());
+                } });
+    bench::add({ "simd_blas/saxpy", "scalar/axpy", count, 3 * count * sizeof(float), [] {
+                    auto& d = data();
+                    static float alpha = 0.5f;
+                    simd_blas::saxpy(count, alpha = -alpha, d.x.data(), d.y.data());
+                } });
+
+    bench::add({ "scalar/dot", "", count, 2 * count * sizeof(float), [] {
+                    auto& d = data();
+                    float result = scalar_dot(count, d.x.data(), d.y.data());
+                    bench::do_not_optimize(result);
+                } });
+    bench::add({ "simd_blas/sdot", "scalar/dot", count, 2 * count * sizeof(float), [] {
+                    auto& d = data();
+                    float result = simd_blas::sdot(count, d.x.data(), d.y.data());
+                    bench::do_not_optimize(result);
+                } });
+    bench::add({ "scalar/nrm2", "", count, count * sizeof(float), [] {
+                    float result = scalar_nrm2(count, data().x.data());
+                    bench::do_not_optimize(result);
+                } });
+    bench::add({ "simd_blas/snrm2", "scalar/nrm2", count, count * sizeof(float), [] {
+                    float result = simd_blas::snrm2(count, data().x.data());
+                    bench::do_not_optimize(result);
+                } });
+
+    const size_t gemv_elements = gemv_size * gemv_size;
+    const size_t gemv_bytes = (gemv_elements + 2 * gemv_size) * sizeof(float);
+    bench::add({ "scalar/gemv", "", gemv_elements, gemv_bytes, [] {
+                    auto& d = data();
+                    scalar_gemv(gemv_size, gemv_size, d.matrix.data(), d.x.data(), d.gemv_out.data());
+                } });
+    bench::add({ "simd_blas/sgemv_rows", "scalar/gemv", gemv_elements, gemv_bytes, [] {
+                    auto& d = data();
+                    simd_blas::sgemv(simd_blas::row_major, simd_blas::no_transpose, gemv_size, gemv_size, 1.0f,
+                        d.matrix.data(), gemv_size, d.x.data(), 0.0f, d.gemv_out.data());
+                } });
+    bench::add({ "simd_blas/sgemv_columns", "scalar/gemv", gemv_elements, gemv_bytes, [] {
+                    auto& d = data();
+                    simd_blas::sgemv(simd_blas::column_major, simd_blas::no_transpose, gemv_size, gemv_size, 1.0f,
+                        d.matrix.data(), gemv_size, d.x.data(), 0.0f, d.gemv_out.data());
+                } });
+
+    const size_t stream_bytes = (stream_columns + 1) * stream_count * sizeof(float);
+    bench::add({ "simd_blas/sgemv_stream", "", stream_count, stream_bytes, [] {
+                    auto& d = stream_data();
+                    simd_blas::sgemv(simd_blas::column_major, simd_blas::no_transpose, stream_count, stream_columns, 1.0f,
+                        d.matrix.data(), stream_count, d.x, 0.0f, d.y.data());
+                } });
+    bench::add({ "simd_blas/sgemv_stream_nt", "simd_blas/sgemv_stream", stream_count, stream_bytes, [] {
+                    auto& d = stream_data();
+                    simd_blas::sgemv(simd_blas::column_major, simd_blas::no_transpose, stream_count, stream_columns, 1.0f,
+                        d.matrix.data(), stream_count, d.x, 0.0f, d.y.data(), simd_base::cache_coherence::non_temporal);
+                } });
+});
+} // namespace
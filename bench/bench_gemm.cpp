@@ -0,0 +1,69 @@
+#include "bench.hpp"
+
+#include "simd/simd_gemm.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+/**
+    Square row-major products of n x n matrices, the elements are those of C and each call
+    counts 2 n^3 flops for the GFLOP/s column.
+*/
+struct data_set {
+    size_t n;
+    std::vector<float> a;
+    std::vector<float> b;
+    std::vector<float> c;
+
+    explicit data_set(size_t size)
+        : n(size)
+        , a(size * size)
+        , b(size * size)
+        , c(size * size)
+    {
+        for (size_t i = 0; i < size * size; ++i) {
+            a[i] = 0.001f * static_cast<float>(i % 1000);
+            b[i] = 1.0f - 0.002f * static_cast<float>(i % 500);
+        }
+    }
+};
+
+BENCH_SCALAR void naive_gemm(size_t n, const float* a, const float* b, float* c)
+{
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            float sum = 0;
+            for (size_t p = 0; p < n; ++p)
+                sum += a[i * n + p] * b[p * n + j];
+            c[i * n + j] = sum;
+        }
+    }
+}
+
+void add_size(size_t n)
+{
+    auto d = std::make_shared<data_set>(n);
+    const std::string size = std::to_string(n);
+    const std::string baseline = "scalar/gemm_" + size;
+    const size_t elements = n * n;
+    const size_t bytes = 3 * n * n * sizeof(float);
+    const double flops = 2.0 * n * n * n;
+    bench::add({ baseline, "", elements, bytes, [d] {
+                    naive_gemm(d->n, d->a.data(), d->b.data(), d->c.data());
+                },
+        flops });
+    bench::add({ "simd_blas/sgemm_" + size, baseline, elements, bytes, [d] {
+                    simd_blas::sgemm(simd_blas::row_major, simd_blas::no_transpose, simd_blas::no_transpose,
+                        d->n, d->n, d->n, 1.0f, d->a.data(), d->n, d->b.data(), d->n, 0.0f, d->c.data(), d->n);
+                },
+        flops });
+}
+
+const bench::registration registered([] {
+    add_size(64);
+    add_size(256);
+    add_size(512);
+});
+} // namespace
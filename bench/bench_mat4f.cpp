@@ -0,0 +1,98 @@
+#include "bench.hpp"
+
+#include "simd/mat4f.hpp"
+
+#include <array>
+#include <vector>
+
+namespace {
+// vertices per call, input and output fit into the L1 data cache together
+const size_t point_count = bench::l1_elements / 3;
+const size_t matrix_count = 64;
+
+struct data_set {
+    std::vector<vec3f> points;
+    std::vector<vec3f> output = std::vector<vec3f>(point_count);
+    std::vector<mat4f> matrices;
+    std::vector<mat4f> products = std::vector<mat4f>(matrix_count);
+    mat4f transform;
+    // the same matrices column-major for the scalar kernels
+    std::vector<std::array<float, 16>> scalar_matrices = std::vector<std::array<float, 16>>(matrix_count);
+    std::vector<std::array<float, 16>> scalar_products = std::vector<std::array<float, 16>>(matrix_count);
+    float scalar_transform[16];
+
+    data_set()
+    {
+        for (size_t i = 0; i < point_count; ++i)
+            points.push_back(vec3f{ 0.5f * (i % 13), 1.0f - 0.25f * (i % 7), 0.125f * i });
+        for (size_t i = 0; i < matrix_count; ++i) {
+            const float f = static_cast<float>(i);
+            matrices.emplace_back(simdf4(1, f, 0, 0), simdf4(0, 2, f, 0), simdf4(0.5f, 0, 3, 0), simdf4(f, -1, 2, 1));
+        }
+        const float rows[16] = { 0, -2, 0, 5, 2, 0, 0, -3, 0, 0, 4, 1, 0, 0, 0, 1 };
+        transform = mat4f::from_rows(rows);
+        transform.store(scalar_transform);
+        for (size_t i = 0; i < matrix_count; ++i)
+            matrices[i].store(scalar_matrices[i].data());
+    }
+};
+data_set& data()
+{
+    static data_set d;
+    return d;
+}
+
+BENCH_SCALAR void scalar_transform_points(const vec3f* input, size_t count, vec3f* output, const float* m)
+{
+    // m is column-major
+    for (size_t i = 0; i < count; ++i) {
+        const vec3f p = input[i];
+        output[i] = vec3f{ m[0] * p.x + m[4] * p.y + m[8] * p.z + m[12],
+            m[1] * p.x + m[5] * p.y + m[9] * p.z + m[13],
+            m[2] * p.x + m[6] * p.y + m[10] * p.z + m[14] };
+    }
+}
+BENCH_SCALAR void scalar_multiply(const float* a, const float* b, float* out)
+{
+    for (size_t c = 0; c < 4; ++c) {
+        for (size_t r = 0; r < 4; ++r) {
+            float sum = 0;
+            for (size_t k = 0; k < 4; ++k)
+                sum += a[k * 4 + r] * b[c * 4 + k];
+            out[c * 4 + r] = sum;
+        }
+    }
+}
+
+const bench::registration registered([] {
+    bench::add({ "scalar/transform_points", "", point_count, 2 * point_count * sizeof(vec3f), [] {
+                    auto& d = data();
+                    scalar_transform_points(d.points.data(), point_count, d.output.data(), d.scalar_transform);
+                } });
+    bench::add({ "mat4f/transform_points", "scalar/transform_points", point_count, 2 * point_count * sizeof(vec3f), [] {
+                    auto& d = data();
+                    transform_points(d.points.data(), point_count, d.output.data(), d.transform);
+                } });
+
+    bench::add({ "scalar/mat4_multiply", "", matrix_count, 2 * matrix_count * sizeof(mat4f), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < matrix_count; ++i)
+                        scalar_multiply(d.scalar_transform, d.scalar_matrices[i].data(), d.scalar_products[i].data());
+                } });
+    bench::add({ "mat4f/multiply", "scalar/mat4_multiply", matrix_count, 2 * matrix_count * sizeof(mat4f), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < matrix_count; ++i)
+                        d.products[i] = d.transform * d.matrices[i];
+                } });
+    bench::add({ "mat4f/inverse", "", matrix_count, 2 * matrix_count * sizeof(mat4f), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < matrix_count; ++i)
+                        d.products[i] = d.matrices[i].inverse();
+                } });
+    bench::add({ "mat4f/transpose", "", matrix_count, 2 * matrix_count * sizeof(mat4f), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < matrix_count; ++i)
+                        d.products[i] = d.matrices[i].transpose();
+                } });
+});
+} // namespace
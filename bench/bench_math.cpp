@@ -0,0 +1,61 @@
+#include "bench.hpp"
+
+#include "simd/simd_math.hpp"
+#include "simd/simdf16.hpp"
+#include "simd/simdf4.hpp"
+#include "simd/simdf8.hpp"
+
+#include <cmath>
+#include <memory>
+
+namespace {
+const size_t count = 1 << 14;
+
+struct data_set {
+    aligned_vector<float> input;
+    aligned_vector<float> output;
+};
+
+template <typename V, typename F>
+void add_simd(const std::string& name, const std::string& baseline, std::shared_ptr<data_set> d, F f)
+{
+    bench::add({ name + "/simdf" + std::to_string(V::value_count), baseline, count, 2 * count * sizeof(float), [d, f] {
+                    for (size_t i = 0; i < count; i += V::value_count)
+                        f(V::load_aligned(&d->input[i])).store_aligned(&d->output[i]);
+                } });
+}
+
+/**
+    Registers libm as the baseline of a function and the simd_math version for every width.
+*/
+template <typename SF, typename LF>
+void add_function(const char* function, float lo, float hi, SF simd_f, LF libm_f)
+{
+    auto d = std::make_shared<data_set>();
+    d->input = bench::make_data<float>(count, [lo, hi](size_t i) { return lo + (hi - lo) * static_cast<float>(i) / count; });
+    d->output.resize(count);
+
+    const std::string name = std::string("math/") + function;
+    bench::add({ name + "/libm", "", count, 2 * count * sizeof(float), [d, libm_f] {
+                    for (size_t i = 0; i < count; ++i)
+                        d->output[i] = libm_f(d->input[i]);
+                } });
+    add_simd<simdf4>(name, name + "/libm", d, simd_f);
+    add_simd<simdf8>(name, name + "/libm", d, simd_f);
+    add_simd<simdf16>(name, name + "/libm", d, simd_f);
+}
+
+const bench::registration registered([] {
+    add_function("exp", -80, 80, [](auto x) { return simd_math::exp(x); }, [](float x) { return std::exp(x); });
+    add_function("exp2", -120, 120, [](auto x) { return simd_math::exp2(x); }, [](float x) { return std::exp2(x); });
+    add_function("log", 1e-10f, 1e10f, [](auto x) { return simd_math::log(x); }, [](float x) { return std::log(x); });
+    add_function("log2", 1e-10f, 1e10f, [](auto x) { return simd_math::log2(x); }, [](float x) { return std::log2(x); });
+    add_function("sin", -100, 100, [](auto x) { return simd_math::sin(x); }, [](float x) { return std::sin(x); });
+    add_function("cos", -100, 100, [](auto x) { return simd_math::cos(x); }, [](float x) { return std::cos(x); });
+    add_function("tan", -1.5f, 1.5f, [](auto x) { return simd_math::tan(x); }, [](float x) { return std::tan(x); });
+    add_function("atan2", -10, 10, [](auto x) { return simd_math::atan2(x, decltype(x)(0.5f)); }, [](float x) { return std::atan2(x, 0.5f); });
+    add_function("pow", 0, 1000, [](auto x) { return simd_math::pow(x, decltype(x)(1.7f)); }, [](float x) { return std::pow(x, 1.7f); });
+    add_function("tanh", -5, 5, [](auto x) { return simd_math::tanh(x); }, [](float x) { return std::tanh(x); });
+    add_function("erf", -5, 5, [](auto x) { return simd_math::erf(x); }, [](float x) { return std::erf(x); });
+});
+} // namespace
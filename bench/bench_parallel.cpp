@@ -0,0 +1,61 @@
+#include "bench.hpp"
+
+#include "simd/simd_parallel.hpp"
+
+namespace {
+// far larger than the last level cache, single-threaded kernels are limited by one core
+const size_t count = 16 << 20;
+
+using vector = simd<float, simd_algorithm::native_width<float>::value>;
+
+struct data_set {
+    aligned_vector<float> a = bench::make_data<float>(count, [](size_t i) { return 1.0f + (i % 17) * 0.25f; });
+    aligned_vector<float> out = aligned_vector<float>(count);
+    aligned_vector<uint16_t> pixels = bench::make_data<uint16_t>(count, [](size_t i) { return static_cast<uint16_t>(i * 7); });
+    aligned_vector<uint16_t> pixels_out = aligned_vector<uint16_t>(count);
+};
+data_set& data()
+{
+    static data_set d;
+    return d;
+}
+
+// a few operations per value, so that the single-threaded loop is not purely memory bound; lambdas
+// because a function pointer op is called indirectly on the pool threads
+const auto polynomial = [](const vector& v) {
+    return vector::fma(vector::fma(vector::fma(v, vector(0.5f), vector(-1.0f)), v, vector(2.0f)), v, vector(0.25f));
+};
+const auto add = [](const vector& a, const vector& b) { return a + b; };
+const auto blend = [](const simdu16x8& a, const simdu16x8& b) { return a.avg(b); };
+
+const bench::registration registered([] {
+    const size_t float_bytes = 2 * count * sizeof(float);
+    bench::add({ "simd_algorithm/transform_polynomial", "", count, float_bytes, [] {
+                    auto& d = data();
+                    simd_algorithm::transform(d.a.data(), count, d.out.data(), polynomial);
+                } });
+    bench::add({ "simd_parallel/transform_polynomial", "simd_algorithm/transform_polynomial", count, float_bytes, [] {
+                    auto& d = data();
+                    simd_parallel::transform(d.a.data(), count, d.out.data(), polynomial);
+                } });
+
+    bench::add({ "simd_algorithm/reduce_add", "", count, count * sizeof(float), [] {
+                    float sum = simd_algorithm::reduce(data().a.data(), count, 0.0f, add);
+                    bench::do_not_optimize(sum);
+                } });
+    bench::add({ "simd_parallel/reduce_add", "simd_algorithm/reduce_add", count, count * sizeof(float), [] {
+                    float sum = simd_parallel::reduce(data().a.data(), count, 0.0f, add);
+                    bench::do_not_optimize(sum);
+                } });
+
+    const size_t pixel_bytes = 3 * count * sizeof(uint16_t);
+    bench::add({ "simd_algorithm/u16_blend", "", count, pixel_bytes, [] {
+                    auto& d = data();
+                    simd_algorithm::transform(d.pixels.data(), d.pixels.data() + 1, count - 1, d.pixels_out.data(), blend);
+                } });
+    bench::add({ "simd_parallel/u16_blend", "simd_algorithm/u16_blend", count, pixel_bytes, [] {
+                    auto& d = data();
+                    simd_parallel::transform(d.pixels.data(), d.pixels.data() + 1, count - 1, d.pixels_out.data(), blend);
+                } });
+});
+} // namespace
@@ -0,0 +1,195 @@
+#include "bench.hpp"
+
+#include "simd/quatf.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+// joints per call, the inputs and the output fit into the L1 data cache together
+const size_t joint_count = 512;
+
+struct scalar_quat {
+    float x, y, z, w;
+};
+
+struct data_set {
+    std::vector<quatf> a;
+    std::vector<quatf> b;
+    std::vector<quatf> out = std::vector<quatf>(joint_count);
+    std::vector<vec3f> points;
+    std::vector<vec3f> rotated = std::vector<vec3f>(joint_count);
+    // the same values for the scalar kernels
+    std::vector<scalar_quat> scalar_a;
+    std::vector<scalar_quat> scalar_b;
+    std::vector<scalar_quat> scalar_out = std::vector<scalar_quat>(joint_count);
+
+    data_set()
+    {
+        for (size_t i = 0; i < joint_count; ++i) {
+            const float angle = 0.01f * static_cast<float>(i);
+            a.push_back(quatf::from_axis_angle(vec3f{ 0.6f, 0.8f, 0 }, angle));
+            b.push_back(quatf::from_axis_angle(vec3f{ 0, 0.8f, -0.6f }, 1.0f - angle));
+            points.push_back(vec3f{ angle, 1.0f, -angle });
+            const auto qa = a.back().to_array();
+            const auto qb = b.back().to_array();
+            scalar_a.push_back(scalar_quat{ qa[0], qa[1], qa[2], qa[3] });
+            scalar_b.push_back(scalar_quat{ qb[0], qb[1], qb[2], qb[3] });
+        }
+    }
+};
+data_set& data()
+{
+    static data_set d;
+    return d;
+}
+
+BENCH_SCALAR void scalar_multiply(const scalar_quat* a, const scalar_quat* b, scalar_quat* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        const scalar_quat p = a[i];
+        const scalar_quat q = b[i];
+        out[i] = scalar_quat{ p.w * q.x + p.x * q.w + p.y * q.z - p.z * q.y,
+            p.w * q.y - p.x * q.z + p.y * q.w + p.z * q.x,
+            p.w * q.z + p.x * q.y - p.y * q.x + p.z * q.w,
+            p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z };
+    }
+}
+BENCH_SCALAR void scalar_nlerp(const scalar_quat* a, const scalar_quat* b, float t, scalar_quat* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        const scalar_quat p = a[i];
+        scalar_quat q = b[i];
+        if (p.x * q.x + p.y * q.y + p.z * q.z + p.w * q.w < 0)
+            q = scalar_quat{ -q.x, -q.y, -q.z, -q.w };
+        const scalar_quat r{ p.x + t * (q.x - p.x), p.y + t * (q.y - p.y), p.z + t * (q.z - p.z), p.w + t * (q.w - p.w) };
+        const float scale = 1.0f / std::sqrt(r.x * r.x + r.y * r.y + r.z * r.z + r.w * r.w);
+        out[i] = scalar_quat{ r.x * scale, r.y * scale, r.z * scale, r.w * scale };
+    }
+}
+BENCH_SCALAR void scalar_slerp(const scalar_quat* a, const scalar_quat* b, float t, scalar_quat* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        const scalar_quat p = a[i];
+        scalar_quat q = b[i];
+        float d = p.x * q.x + p.y * q.y + p.z * q.z + p.w * q.w;
+        if (d < 0) {
+            q = scalar_quat{ -q.x, -q.y, -q.z, -q.w };
+            d = -d;
+        }
+        float wa = 1.0f - t;
+        float wb = t;
+        if (d <= 0.9995f) {
+            const float angle = std::acos(d);
+            const float scale = 1.0f / std::sin(angle);
+            wa = std::sin((1.0f - t) * angle) * scale;
+            wb = std::sin(t * angle) * scale;
+        }
+        out[i] = scalar_quat{ wa * p.x + wb * q.x, wa * p.y + wb * q.y, wa * p.z + wb * q.z, wa * p.w + wb * q.w };
+    }
+}
+BENCH_SCALAR void scalar_rotate(const scalar_quat* q, const vec3f* v, vec3f* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        const scalar_quat r = q[i];
+        const vec3f p = v[i];
+        const vec3f t{ 2 * (r.y * p.z - r.z * p.y), 2 * (r.z * p.x - r.x * p.z), 2 * (r.x * p.y - r.y * p.x) };
+        out[i] = vec3f{ p.x + r.w * t.x + (r.y * t.z - r.z * t.y),
+            p.y + r.w * t.y + (r.z * t.x - r.x * t.z),
+            p.z + r.w * t.z + (r.x * t.y - r.y * t.x) };
+    }
+}
+
+/**
+    Registers the scalar baseline and the quatf and quatf4 kernels of one operation.
+*/
+void add_operation(const char* operation, size_t bytes, std::function<void()> scalar, std::function<void()> single, std::function<void()> batch)
+{
+    const std::string baseline = std::string("scalar/quat_") + operation;
+    bench::add({ baseline, "", joint_count, bytes, std::move(scalar) });
+    bench::add({ std::string("quatf/") + operation, baseline, joint_count, bytes, std::move(single) });
+    bench::add({ std::string("quatf4/") + operation, baseline, joint_count, bytes, std::move(batch) });
+}
+
+const float t = 0.3f;
+
+void multiply_scalar()
+{
+    auto& d = data();
+    scalar_multiply(d.scalar_a.data(), d.scalar_b.data(), d.scalar_out.data(), joint_count);
+}
+void multiply_single()
+{
+    auto& d = data();
+    for (size_t i = 0; i < joint_count; ++i)
+        d.out[i] = d.a[i] * d.b[i];
+}
+void multiply_batch()
+{
+    auto& d = data();
+    for (size_t i = 0; i < joint_count; i += 4)
+        (quatf4::load(&d.a[i]) * quatf4::load(&d.b[i])).store(&d.out[i]);
+}
+
+void nlerp_scalar()
+{
+    auto& d = data();
+    scalar_nlerp(d.scalar_a.data(), d.scalar_b.data(), t, d.scalar_out.data(), joint_count);
+}
+void nlerp_single()
+{
+    auto& d = data();
+    for (size_t i = 0; i < joint_count; ++i)
+        d.out[i] = quatf::nlerp(d.a[i], d.b[i], t);
+}
+void nlerp_batch()
+{
+    auto& d = data();
+    for (size_t i = 0; i < joint_count; i += 4)
+        quatf4::nlerp(quatf4::load(&d.a[i]), quatf4::load(&d.b[i]), simdf4(t)).store(&d.out[i]);
+}
+
+void slerp_scalar()
+{
+    auto& d = data();
+    scalar_slerp(d.scalar_a.data(), d.scalar_b.data(), t, d.scalar_out.data(), joint_count);
+}
+void slerp_single()
+{
+    auto& d = data();
+    for (size_t i = 0; i < joint_count; ++i)
+        d.out[i] = quatf::slerp(d.a[i], d.b[i], t);
+}
+void slerp_batch()
+{
+    auto& d = data();
+    for (size_t i = 0; i < joint_count; i += 4)
+        quatf4::slerp(quatf4::load(&d.a[i]), quatf4::load(&d.b[i]), simdf4(t)).store(&d.out[i]);
+}
+
+void rotate_scalar()
+{
+    auto& d = data();
+    scalar_rotate(d.scalar_a.data(), d.points.data(), d.rotated.data(), joint_count);
+}
+void rotate_single()
+{
+    auto& d = data();
+    for (size_t i = 0; i < joint_count; ++i)
+        d.rotated[i] = d.a[i].rotate(d.points[i]);
+}
+void rotate_batch()
+{
+    auto& d = data();
+    for (size_t i = 0; i < joint_count; i += 4)
+        quatf4::load(&d.a[i]).rotate(vec3f4::load(&d.points[i])).store(&d.rotated[i]);
+}
+
+const bench::registration registered([] {
+    const size_t blend_bytes = 3 * joint_count * sizeof(quatf);
+    add_operation("multiply", blend_bytes, multiply_scalar, multiply_single, multiply_batch);
+    add_operation("nlerp", blend_bytes, nlerp_scalar, nlerp_single, nlerp_batch);
+    add_operation("slerp", blend_bytes, slerp_scalar, slerp_single, slerp_batch);
+    add_operation("rotate", joint_count * (sizeof(quatf) + 2 * sizeof(vec3f)), rotate_scalar, rotate_single, rotate_batch);
+});
+} // namespace
@@ -0,0 +1,243 @@
+#include "bench.hpp"
+
+#include "simd/simdf4.hpp"
+
+#include <cmath>
+
+namespace {
+const size_t count = bench::l1_elements;
+
+struct data_set {
+    // padded so the unaligned kernels can read and write one value past count
+    aligned_vector<float> a = bench::make_data<float>(count + 16, [](size_t i) { return 1.0f + (i % 17) * 0.25f; });
+    aligned_vector<float> b = bench::make_data<float>(count + 16, [](size_t i) { return 2.0f + (i % 5) * 0.5f; });
+    aligned_vector<float> c = bench::make_data<float>(count + 16, [](size_t i) { return 0.5f * (i % 3); });
+    aligned_vector<float> out = aligned_vector<float>(count + 16);
+};
+data_set& data()
+{
+    static data_set d;
+    return d;
+}
+
+BENCH_SCALAR void scalar_copy(const float* a, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i];
+}
+BENCH_SCALAR void scalar_add(const float* a, const float* b, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i] + b[i];
+}
+BENCH_SCALAR void scalar_mul(const float* a, const float* b, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i] * b[i];
+}
+BENCH_SCALAR void scalar_div(const float* a, const float* b, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i] / b[i];
+}
+BENCH_SCALAR void scalar_min(const float* a, const float* b, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i] < b[i] ? a[i] : b[i];
+}
+BENCH_SCALAR void scalar_sqrt(const float* a, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = std::sqrt(a[i]);
+}
+BENCH_SCALAR void scalar_rcp(const float* a, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = 1.0f / a[i];
+}
+BENCH_SCALAR void scalar_rsqrt(const float* a, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = 1.0f / std::sqrt(a[i]);
+}
+BENCH_SCALAR void scalar_multiply_add(const float* a, const float* b, const float* c, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i] * b[i] + c[i];
+}
+BENCH_SCALAR void scalar_pairwise_add(const float* a, float* out, size_t n)
+{
+    for (size_t i = 0; i < n; i += 2)
+        out[i / 2] = a[i] + a[i + 1];
+}
+BENCH_SCALAR void scalar_transpose(const float* a, float* out, size_t n)
+{
+    for (size_t block = 0; block < n; block += 16) {
+        for (size_t r = 0; r < 4; ++r) {
+            for (size_t c = 0; c < 4; ++c)
+                out[block + c * 4 + r] = a[block + r * 4 + c];
+        }
+    }
+}
+
+template <typename Op>
+void add_unary(const char* name, const char* baseline, Op op)
+{
+    bench::add({ std::string("simdf4/") + name, baseline, count, 2 * count * sizeof(float), [op] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 4)
+                        op(simdf4::load_aligned(&d.a[i])).store_aligned(&d.out[i]);
+                } });
+}
+template <typename Op>
+void add_binary(const char* name, const char* baseline, Op op)
+{
+    bench::add({ std::string("simdf4/") + name, baseline, count, 3 * count * sizeof(float), [op] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 4)
+                        op(simdf4::load_aligned(&d.a[i]), simdf4::load_aligned(&d.b[i])).store_aligned(&d.out[i]);
+                } });
+}
+/**
+    Chain of dependent operations x = op(x, y), the time per element is the latency of op.
+*/
+template <typename Op>
+void add_latency(const char* name, Op op)
+{
+    bench::add({ std::string("simdf4/") + name + "/latency", "", bench::chain_length, 0, [op] {
+                    simdf4 x(1.0f);
+                    simdf4 y(1.0f);
+                    bench::do_not_optimize(x);
+                    bench::do_not_optimize(y);
+                    for (size_t i = 0; i < bench::chain_length; ++i)
+                        x = op(x, y);
+                    bench::do_not_optimize(x);
+                } });
+}
+template <typename F>
+void add_scalar(const char* name, size_t streams, F f)
+{
+    bench::add({ std::string("scalar/") + name, "", count, streams * count * sizeof(float), f });
+}
+
+const bench::registration registered([] {
+    add_scalar("copy", 2, [] { scalar_copy(data().a.data(), data().out.data(), count); });
+    add_scalar("add", 3, [] { scalar_add(data().a.data(), data().b.data(), data().out.data(), count); });
+    add_scalar("mul", 3, [] { scalar_mul(data().a.data(), data().b.data(), data().out.data(), count); });
+    add_scalar("div", 3, [] { scalar_div(data().a.data(), data().b.data(), data().out.data(), count); });
+    add_scalar("min", 3, [] { scalar_min(data().a.data(), data().b.data(), data().out.data(), count); });
+    add_scalar("sqrt", 2, [] { scalar_sqrt(data().a.data(), data().out.data(), count); });
+    add_scalar("rcp", 2, [] { scalar_rcp(data().a.data(), data().out.data(), count); });
+    add_scalar("rsqrt", 2, [] { scalar_rsqrt(data().a.data(), data().out.data(), count); });
+    add_scalar("multiply_add", 4, [] { scalar_multiply_add(data().a.data(), data().b.data(), data().c.data(), data().out.data(), count); });
+    bench::add({ "scalar/pairwise_add", "", count, count / 2 * 3 * sizeof(float), [] { scalar_pairwise_add(data().a.data(), data().out.data(), count); } });
+    add_scalar("transpose", 2, [] { scalar_transpose(data().a.data(), data().out.data(), count); });
+
+    bench::add({ "simdf4/load_store/aligned", "scalar/copy", count, 2 * count * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 4)
+                        simdf4::load_aligned(&d.a[i]).store_aligned(&d.out[i]);
+                } });
+    bench::add({ "simdf4/load_store/unaligned", "scalar/copy", count, 2 * count * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 1; i < count + 1; i += 4)
+                        simdf4(&d.a[i]).store(&d.out[i]);
+                } });
+    bench::add({ "simdf4/load_store/partial", "scalar/copy", count, 2 * count * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 3)
+                        simdf4::load_partial(&d.a[i], 3).store_partial(&d.out[i], 3);
+                } });
+
+    add_binary("add", "scalar/add", [](const simdf4& a, const simdf4& b) { return a + b; });
+    add_binary("mul", "scalar/mul", [](const simdf4& a, const simdf4& b) { return a * b; });
+    add_binary("div", "scalar/div", [](const simdf4& a, const simdf4& b) { return a / b; });
+    add_binary("min", "scalar/min", [](const simdf4& a, const simdf4& b) { return a.min(b); });
+    add_binary("compare_select", "scalar/min", [](const simdf4& a, const simdf4& b) {
+        return simdf4::select(a.compare(b, simd_base::compare_flags::lower), a, b);
+    });
+    add_unary("sqrt", "scalar/sqrt", [](const simdf4& a) { return a.sqrt(); });
+    add_unary("rcp", "scalar/rcp", [](const simdf4& a) { return a.rcp(); });
+    add_unary("rcp/estimate", "scalar/rcp", [](const simdf4& a) { return a.rcp<simd_base::estimate>(); });
+    add_unary("rsqrt", "scalar/rsqrt", [](const simdf4& a) { return a.rsqrt(); });
+    add_unary("rsqrt/newton_1", "scalar/rsqrt", [](const simdf4& a) { return a.rsqrt<simd_base::newton_1>(); });
+    add_unary("abs", "", [](const simdf4& a) { return a.abs(); });
+    add_unary("round", "", [](const simdf4& a) { return a.round(); });
+    add_unary("shuffle", "", [](const simdf4& a) { return simdf4::shuffle<3, 2, 1, 0>(a, a); });
+    add_unary("unpack_low", "", [](const simdf4& a) { return simdf4::unpack_low(a, a); });
+    bench::add({ "simdf4/fma", "scalar/multiply_add", count, 4 * count * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 4)
+                        simdf4::fma(simdf4::load_aligned(&d.a[i]), simdf4::load_aligned(&d.b[i]), simdf4::load_aligned(&d.c[i])).store_aligned(&d.out[i]);
+                } });
+    bench::add({ "simdf4/horizontal_add", "scalar/pairwise_add", count, count / 2 * 3 * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 8)
+                        simdf4::horizontal_add(simdf4::load_aligned(&d.a[i]), simdf4::load_aligned(&d.a[i + 4])).store_aligned(&d.out[i / 2]);
+                } });
+    // one scalar per register: the reductions against the horizontal_add idiom they replace
+    bench::add({ "simdf4/reduce_add/horizontal_add", "", count, count * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 4) {
+                        const simdf4 a = simdf4::load_aligned(&d.a[i]);
+                        const simdf4 pairs = simdf4::horizontal_add(a, a);
+                        d.out[i / 4] = simdf4::horizontal_add(pairs, pairs).to_array()[0];
+                    }
+                } });
+    bench::add({ "simdf4/reduce_add", "simdf4/reduce_add/horizontal_add", count, count * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 4)
+                        d.out[i / 4] = simdf4::load_aligned(&d.a[i]).reduce_add();
+                } });
+    bench::add({ "simdf4/reduce_max", "", count, count * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 4)
+                        d.out[i / 4] = simdf4::load_aligned(&d.a[i]).reduce_max();
+                } });
+    bench::add({ "simdf4/dot/horizontal_add", "", count, 2 * count * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 4) {
+                        const simdf4 p = simdf4::load_aligned(&d.a[i]) * simdf4::load_aligned(&d.b[i]);
+                        const simdf4 pairs = simdf4::horizontal_add(p, p);
+                        d.out[i / 4] = simdf4::horizontal_add(pairs, pairs).to_array()[0];
+                    }
+                } });
+    bench::add({ "simdf4/dot", "simdf4/dot/horizontal_add", count, 2 * count * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 4)
+                        d.out[i / 4] = simdf4::dot(simdf4::load_aligned(&d.a[i]), simdf4::load_aligned(&d.b[i]));
+                } });
+    bench::add({ "simdf4/transpose", "scalar/transpose", count, 2 * count * sizeof(float), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 16) {
+                        simdf4 r0 = simdf4::load_aligned(&d.a[i]);
+                        simdf4 r1 = simdf4::load_aligned(&d.a[i + 4]);
+                        simdf4 r2 = simdf4::load_aligned(&d.a[i + 8]);
+                        simdf4 r3 = simdf4::load_aligned(&d.a[i + 12]);
+                        simdf4::transpose(r0, r1, r2, r3);
+                        r0.store_aligned(&d.out[i]);
+                        r1.store_aligned(&d.out[i + 4]);
+                        r2.store_aligned(&d.out[i + 8]);
+                        r3.store_aligned(&d.out[i + 12]);
+                    }
+                } });
+
+    add_latency("add", [](const simdf4& x, const simdf4& y) { return x + y; });
+    add_latency("mul", [](const simdf4& x, const simdf4& y) { return x * y; });
+    add_latency("div", [](const simdf4& x, const simdf4& y) { return x / y; });
+    add_latency("sqrt", [](const simdf4& x, const simdf4&) { return x.sqrt(); });
+    add_latency("rsqrt/newton_1", [](const simdf4& x, const simdf4&) { return x.rsqrt<simd_base::newton_1>(); });
+    add_latency("fma", [](const simdf4& x, const simdf4& y) { return simdf4::fma(x, y, y); });
+    add_latency("compare_select", [](const simdf4& x, const simdf4& y) {
+        return simdf4::select(x.compare(y, simd_base::compare_flags::lower), y, x);
+    });
+    add_latency("horizontal_add", [](const simdf4& x, const simdf4& y) { return simdf4::horizontal_add(x, y); });
+    add_latency("reduce_add/horizontal_add", [](const simdf4& x, const simdf4&) {
+        const simdf4 pairs = simdf4::horizontal_add(x, x);
+        return simdf4::horizontal_add(pairs, pairs);
+    });
+    add_latency("reduce_add", [](const simdf4& x, const simdf4&) { return simdf4(x.reduce_add()); });
+    add_latency("dot", [](const simdf4& x, const simdf4& y) { return simdf4(simdf4::dot(x, y)); });
+    add_latency("shuffle", [](const simdf4& x, const simdf4&) { return simdf4::shuffle<1, 2, 3, 0>(x, x); });
+});
+} // namespace
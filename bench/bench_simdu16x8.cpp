@@ -0,0 +1,123 @@
+#include "bench.hpp"
+
+#include "simd/simdu16x8.hpp"
+
+namespace {
+const size_t count = bench::l1_elements;
+
+struct data_set {
+    aligned_vector<uint16_t> a = bench::make_data<uint16_t>(count + 16, [](size_t i) { return i % 251; });
+    aligned_vector<uint16_t> b = bench::make_data<uint16_t>(count + 16, [](size_t i) { return i % 13; });
+    aligned_vector<uint8_t> bytes = bench::make_data<uint8_t>(count + 16, [](size_t i) { return i % 255; });
+    aligned_vector<uint16_t> out = aligned_vector<uint16_t>(count + 16);
+};
+data_set& data()
+{
+    static data_set d;
+    return d;
+}
+
+BENCH_SCALAR void scalar_copy(const uint16_t* a, uint16_t* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i];
+}
+BENCH_SCALAR void scalar_widen(const uint8_t* a, uint16_t* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i];
+}
+BENCH_SCALAR void scalar_add(const uint16_t* a, const uint16_t* b, uint16_t* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = static_cast<uint16_t>(a[i] + b[i]);
+}
+BENCH_SCALAR void scalar_subtract_saturate(const uint16_t* a, const uint16_t* b, uint16_t* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = a[i] > b[i] ? static_cast<uint16_t>(a[i] - b[i]) : 0;
+}
+BENCH_SCALAR void scalar_mul(const uint16_t* a, const uint16_t* b, uint16_t* out, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+        out[i] = static_cast<uint16_t>(a[i] * b[i]);
+}
+BENCH_SCALAR uint32_t scalar_sum(const uint16_t* a, size_t n)
+{
+    uint32_t result = 0;
+    for (size_t i = 0; i < n; ++i)
+        result += a[i];
+    return result;
+}
+
+template <typename Op>
+void add_binary(const char* name, const char* baseline, Op op)
+{
+    bench::add({ std::string("simdu16x8/") + name, baseline, count, 3 * count * sizeof(uint16_t), [op] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 8)
+                        op(simdu16x8::load_aligned(&d.a[i]), simdu16x8::load_aligned(&d.b[i])).store_aligned(&d.out[i]);
+                } });
+}
+template <typename Op>
+void add_latency(const char* name, Op op)
+{
+    bench::add({ std::string("simdu16x8/") + name + "/latency", "", bench::chain_length, 0, [op] {
+                    simdu16x8 x(1);
+                    simdu16x8 y(3);
+                    bench::do_not_optimize(x);
+                    bench::do_not_optimize(y);
+                    for (size_t i = 0; i < bench::chain_length; ++i)
+                        x = op(x, y);
+                    bench::do_not_optimize(x);
+                } });
+}
+
+const bench::registration registered([] {
+    bench::add({ "scalar/u16/copy", "", count, 2 * count * sizeof(uint16_t), [] { scalar_copy(data().a.data(), data().out.data(), count); } });
+    bench::add({ "scalar/u16/widen", "", count, count * 3, [] { scalar_widen(data().bytes.data(), data().out.data(), count); } });
+    bench::add({ "scalar/u16/add", "", count, 3 * count * sizeof(uint16_t), [] { scalar_add(data().a.data(), data().b.data(), data().out.data(), count); } });
+    bench::add({ "scalar/u16/subtract_saturate", "", count, 3 * count * sizeof(uint16_t), [] { scalar_subtract_saturate(data().a.data(), data().b.data(), data().out.data(), count); } });
+    bench::add({ "scalar/u16/mul", "", count, 3 * count * sizeof(uint16_t), [] { scalar_mul(data().a.data(), data().b.data(), data().out.data(), count); } });
+    bench::add({ "scalar/u16/sum", "", count, count * sizeof(uint16_t), [] {
+                    uint32_t result = scalar_sum(data().a.data(), count);
+                    bench::do_not_optimize(result);
+                } });
+
+    bench::add({ "simdu16x8/load_store/aligned", "scalar/u16/copy", count, 2 * count * sizeof(uint16_t), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 8)
+                        simdu16x8::load_aligned(&d.a[i]).store_aligned(&d.out[i]);
+                } });
+    bench::add({ "simdu16x8/load_store/unaligned", "scalar/u16/copy", count, 2 * count * sizeof(uint16_t), [] {
+                    auto& d = data();
+                    for (size_t i = 1; i < count + 1; i += 8)
+                        simdu16x8(&d.a[i]).store(&d.out[i]);
+                } });
+    bench::add({ "simdu16x8/load_store/partial", "scalar/u16/copy", count, 2 * count * sizeof(uint16_t), [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 5)
+                        simdu16x8::load_partial(&d.a[i], 5).store_partial(&d.out[i], 5);
+                } });
+    bench::add({ "simdu16x8/load_u8", "scalar/u16/widen", count, count * 3, [] {
+                    auto& d = data();
+                    for (size_t i = 0; i < count; i += 8)
+                        simdu16x8(&d.bytes[i]).store_aligned(&d.out[i]);
+                } });
+
+    add_binary("add", "scalar/u16/add", [](const simdu16x8& a, const simdu16x8& b) { return a + b; });
+    add_binary("subtract_saturate", "scalar/u16/subtract_saturate", [](const simdu16x8& a, const simdu16x8& b) { return a - b; });
+    add_binary("mul", "scalar/u16/mul", [](const simdu16x8& a, const simdu16x8& b) { return a * b; });
+    bench::add({ "simdu16x8/sum", "scalar/u16/sum", count, count * sizeof(uint16_t), [] {
+                    auto& d = data();
+                    uint32_t result = 0;
+                    for (size_t i = 0; i < count; i += 8)
+                        result += simdu16x8::load_aligned(&d.a[i]).sum();
+                    bench::do_not_optimize(result);
+                } });
+
+    add_latency("add", [](const simdu16x8& x, const simdu16x8& y) { return x + y; });
+    add_latency("mul", [](const simdu16x8& x, const simdu16x8& y) { return x * y; });
+    add_latency("sum", [](const simdu16x8& x, const simdu16x8&) { return simdu16x8(x.sum_saturate()); });
+});
+} // namespace
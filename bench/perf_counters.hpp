@@ -0,0 +1,153 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+/**
+    Hardware event counters of the calling thread, read with perf_event_open on Linux.
+    Counters the kernel refuses (no PMU in a VM, perf_event_paranoid > 2, ...) stay
+    unavailable; on other platforms all of them are.
+
+        perf_counters counters;
+        counters.start();
+        kernel();
+        const auto values = counters.stop();
+
+    The counters form one group led by the first available event (cycles), so they are enabled,
+    disabled and scheduled together and cover the same instructions. When the kernel multiplexes
+    the group with other users of the PMU, the counts are scaled up by the ratio of the time the
+    group was enabled to the time it was counting; when it never counted, all are unavailable.
+*/
+class perf_counters {
+public:
+    enum event {
+        cycles,
+        instructions,
+        l1d_misses,
+        llc_misses,
+        branch_misses,
+        event_count
+    };
+    using values = std::array<int64_t, event_count>;
+
+    perf_counters() noexcept
+    {
+        this->_fds.fill(-1);
+#if defined(__linux__)
+        const uint64_t cache_read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        this->add(cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        this->add(instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        this->add(l1d_misses, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | cache_read_miss);
+        this->add(llc_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        this->add(branch_misses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+    ~perf_counters()
+    {
+#if defined(__linux__)
+        for (int fd : this->_fds) {
+            if (fd >= 0)
+                close(fd);
+        }
+#endif
+    }
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    bool available(event e) const noexcept
+    {
+        return this->_fds[e] >= 0;
+    }
+    bool any_available() const noexcept
+    {
+        return this->_leader >= 0;
+    }
+
+    void start() noexcept
+    {
+#if defined(__linux__)
+        if (this->_leader >= 0) {
+            ioctl(this->_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(this->_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+    /**
+        Counts since start(), -1 for unavailable counters.
+    */
+    values stop() noexcept
+    {
+        values result;
+        result.fill(-1);
+#if defined(__linux__)
+        if (this->_leader < 0)
+            return result;
+        ioctl(this->_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // PERF_FORMAT_GROUP: nr, time enabled, time running, then one value per event in the
+        // order the events joined the group
+        uint64_t data[3 + event_count];
+        const ssize_t bytes = read(this->_leader, data, sizeof(data));
+        if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)))
+            return result;
+        const uint64_t count = data[0];
+        if (count != this->_members || static_cast<size_t>(bytes) < (3 + count) * sizeof(uint64_t))
+            return result;
+        const uint64_t enabled = data[1];
+        const uint64_t running = data[2];
+        if (running == 0)
+            return result;
+        const double scale = static_cast<double>(enabled) / static_cast<double>(running);
+        for (size_t i = 0; i < count; ++i) {
+            const uint64_t value = data[3 + i];
+            result[this->_order[i]] = running == enabled ? static_cast<int64_t>(value) : static_cast<int64_t>(value * scale + 0.5);
+        }
+#endif
+        return result;
+    }
+
+private:
+#if defined(__linux__)
+    /**
+        Opens e as the group leader if there is none yet, as a member of the group otherwise.
+    */
+    void add(event e, uint32_t type, uint64_t config) noexcept
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        // members follow the leader, only the leader starts disabled
+        attr.disabled = this->_leader < 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        const int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, this->_leader, 0));
+        if (fd < 0)
+            return;
+        this->_fds[e] = fd;
+        if (this->_leader < 0)
+            this->_leader = fd;
+        this->_order[this->_members++] = e;
+    }
+#endif
+
+    std::array<int, event_count> _fds;
+    int _leader = -1;
+    /** Events in the order they joined the group, the order of the values of a group read. */
+    std::array<event, event_count> _order = {};
+    size_t _members = 0;
+};
+
+} // namespace bench
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Allocator returning memory aligned to Align bytes, with the size rounded up to a multiple
+    of Align. With the default of 64 bytes (a cache line, one AVX-512 register) every register
+    load at an aligned index below size() stays inside the allocation, so the aligned loads and
+    stores of the simd types can be used without checking the address or the tail first.
+*/
+template <typename T, size_t Align = 64>
+class aligned_allocator {
+    static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0, "alignment must be a power of two");
+    static_assert(Align % sizeof(void*) == 0, "alignment must be a multiple of the pointer size");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = aligned_allocator<U, Align>;
+    };
+
+    static constexpr size_t alignment = Align;
+
+    aligned_allocator() noexcept = default;
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Align>&) noexcept
+    {
+    }
+
+    /**
+        Number of whole elements that fit into the storage allocated for count elements.
+    */
+    static constexpr size_t padded_size(size_t count) noexcept
+    {
+        return (count * sizeof(T) + Align - 1) / Align * Align / sizeof(T);
+    }
+
+    T* allocate(size_t count)
+    {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T) - Align)
+            throw std::bad_alloc();
+        const size_t bytes = (count * sizeof(T) + Align - 1) / Align * Align;
+        void* result = nullptr;
+#if defined(_WIN32)
+        result = _aligned_malloc(bytes, Align);
+#else
+        if (posix_memalign(&result, Align, bytes) != 0)
+            result = nullptr;
+#endif
+        if (result == nullptr)
+            throw std::bad_alloc();
+        return static_cast<T*>(result);
+    }
+
+    void deallocate(T* pointer, size_t) noexcept
+    {
+#if defined(_WIN32)
+        _aligned_free(pointer);
+#else
+        free(pointer);
+#endif
+    }
+};
+
+template <typename T, typename U, size_t Align>
+bool operator==(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept
+{
+    return true;
+}
+template <typename T, typename U, size_t Align>
+bool operator!=(const aligned_allocator<T, Align>&, const aligned_allocator<U, Align>&) noexcept
+{
+    return false;
+}
+
+/**
+    std::vector with aligned, register padded storage, see aligned_allocator. Elements past
+    size() are uninitialized: results computed there have to be discarded, e.g.
+
+        aligned_vector<float> data(n);
+        for (size_t i = 0; i < n; i += 4)
+            (simdf4::load_aligned(&data[i]) * simdf4(2.0f)).store_aligned(&data[i]);
+*/
+template <typename T, size_t Align = 64>
+using aligned_vector = std::vector<T, aligned_allocator<T, Align>>;
+
+SIMD_NAMESPACE_END
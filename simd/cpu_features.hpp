@@ -0,0 +1,265 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+
+// cpuid based detection is only available on x86, independently of the simd backend in use
+#if !defined(__ANDROID__) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define SIMD_HAS_CPUID 1
+#endif
+
+#if defined(SIMD_HAS_CPUID)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+/**
+    Marks a function as compiled for a specific instruction set, e.g. SIMD_TARGET("avx2,fma"),
+    so that it may use that instruction set's intrinsics directly and the compiler may vectorize
+    its plain loops for it. Such a function may only be called after cpu_features::instance()
+    confirmed the instruction set is available.
+
+    It does not switch the simd types to their wider implementations: those are selected by the
+    preprocessor (__AVX__, __FMA__, __F16C__, ...) from the compile flags, which the attribute does
+    not change. simd<float, 8> inside an SSE2 build stays a pair of simdf4, and simdf4::fma stays a
+    multiply and an add. Code that should use them needs its own translation unit built with the
+    wider flags; the simd headers put everything into an inline namespace per level
+    (SIMD_NAMESPACE_BEGIN), so such units share no inline function with the baseline ones. The
+    float kernels of the library are built that way, see simd_dispatch.hpp.
+*/
+#if defined(__GNUC__) && defined(SIMD_HAS_CPUID)
+#define SIMD_TARGET(isa) __attribute__((target(isa), flatten))
+#else
+#define SIMD_TARGET(isa)
+#endif
+
+/**
+    Instruction set levels, ordered from the least to the most capable.
+*/
+enum class simd_isa {
+    scalar,
+    neon,
+    sse2,
+    sse3,
+    ssse3,
+    sse4_1,
+    avx,
+    avx2,
+    avx512
+};
+
+SIMD_NAMESPACE_BEGIN
+/**
+    Instruction set level the simd types of the including translation unit are compiled for,
+    from the backend and the compile flags (not from the CPU running the program).
+*/
+constexpr simd_isa compiled_isa() noexcept
+{
+    return simd_isa::SIMD_ISA_LEVEL;
+}
+SIMD_NAMESPACE_END
+
+class cpu_features {
+public:
+    enum feature : uint32_t {
+        sse2 = 1u << 0,
+        sse3 = 1u << 1,
+        ssse3 = 1u << 2,
+        sse4_1 = 1u << 3,
+        sse4_2 = 1u << 4,
+        avx = 1u << 5,
+        avx2 = 1u << 6,
+        fma = 1u << 7,
+        f16c = 1u << 8,
+        avx512f = 1u << 9,
+        avx512dq = 1u << 10,
+        avx512bw = 1u << 11,
+        avx512vl = 1u << 12,
+        neon = 1u << 13
+    };
+
+    /**
+        Features of the CPU the process is running on. Detection runs once, on first use.
+    */
+    static const cpu_features& instance() noexcept
+    {
+        static const cpu_features features(detect());
+        return features;
+    }
+
+    explicit cpu_features(uint32_t flags) noexcept
+        : _flags(flags)
+    {
+    }
+
+    bool has(feature f) const noexcept
+    {
+        return (this->_flags & f) == f;
+    }
+    uint32_t flags() const noexcept
+    {
+        return this->_flags;
+    }
+
+    bool supports(simd_isa isa) const noexcept
+    {
+        switch (isa) {
+        case simd_isa::scalar:
+            return true;
+        case simd_isa::neon:
+            return this->has(neon);
+        case simd_isa::sse2:
+            return this->has(sse2);
+        case simd_isa::sse3:
+            return this->has(sse3) && this->supports(simd_isa::sse2);
+        case simd_isa::ssse3:
+            return this->has(ssse3) && this->supports(simd_isa::sse3);
+        case simd_isa::sse4_1:
+            return this->has(sse4_1) && this->supports(simd_isa::ssse3);
+        case simd_isa::avx:
+            return this->has(avx) && this->supports(simd_isa::sse4_1);
+        case simd_isa::avx2:
+            return this->has(avx2) && this->has(fma) && this->supports(simd_isa::avx);
+        case simd_isa::avx512:
+            return this->has(avx512f) && this->has(avx512dq) && this->has(avx512bw)
+                && this->has(avx512vl) && this->supports(simd_isa::avx2);
+        }
+        return false;
+    }
+
+    simd_isa best_isa() const noexcept
+    {
+        const simd_isa levels[] = { simd_isa::avx512, simd_isa::avx2, simd_isa::avx, simd_isa::sse4_1,
+            simd_isa::ssse3, simd_isa::sse3, simd_isa::sse2, simd_isa::neon };
+        for (auto isa : levels) {
+            if (this->supports(isa))
+                return isa;
+        }
+        return simd_isa::scalar;
+    }
+
+private:
+#if defined(SIMD_HAS_CPUID)
+    static void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) noexcept
+    {
+#if defined(_MSC_VER)
+        int r[4];
+        __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+        for (int i = 0; i < 4; ++i)
+            regs[i] = static_cast<uint32_t>(r[i]);
+#else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+    static uint64_t xgetbv() noexcept
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t lo, hi;
+        __asm__ volatile("xgetbv"
+                         : "=a"(lo), "=d"(hi)
+                         : "c"(0));
+        return (static_cast<uint64_t>(hi) << 32) | lo;
+#endif
+    }
+#endif
+
+    static uint32_t detect() noexcept
+    {
+        uint32_t result = 0;
+#if defined(SIMD_HAS_CPUID)
+        uint32_t regs[4] = {};
+        cpuid(0, 0, regs);
+        const uint32_t max_leaf = regs[0];
+        if (max_leaf < 1)
+            return result;
+
+        cpuid(1, 0, regs);
+        const uint32_t ecx1 = regs[2];
+        const uint32_t edx1 = regs[3];
+        if (edx1 & (1u << 26))
+            result |= sse2;
+        if (ecx1 & (1u << 0))
+            result |= sse3;
+        if (ecx1 & (1u << 9))
+            result |= ssse3;
+        if (ecx1 & (1u << 19))
+            result |= sse4_1;
+        if (ecx1 & (1u << 20))
+            result |= sse4_2;
+
+        // AVX state has to be enabled by the OS (OSXSAVE + XCR0 bits), not only reported by the CPU
+        const bool os_xsave = (ecx1 & (1u << 27)) != 0;
+        const uint64_t xcr0 = os_xsave ? xgetbv() : 0;
+        const bool os_avx = (xcr0 & 0x6) == 0x6;
+        const bool os_avx512 = (xcr0 & 0xe6) == 0xe6;
+        if (!os_avx)
+            return result;
+
+        if (ecx1 & (1u << 28))
+            result |= avx;
+        if (ecx1 & (1u << 12))
+            result |= fma;
+        if (ecx1 & (1u << 29))
+            result |= f16c;
+
+        if (max_leaf >= 7) {
+            cpuid(7, 0, regs);
+            const uint32_t ebx7 = regs[1];
+            if (ebx7 & (1u << 5))
+                result |= avx2;
+            if (os_avx512) {
+                if (ebx7 & (1u << 16))
+                    result |= avx512f;
+                if (ebx7 & (1u << 17))
+                    result |= avx512dq;
+                if (ebx7 & (1u << 30))
+                    result |= avx512bw;
+                if (ebx7 & (1u << 31))
+                    result |= avx512vl;
+            }
+        }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        result |= neon;
+#endif
+        return result;
+    }
+
+    uint32_t _flags;
+};
+
+/**
+    Picks the implementation for the most capable instruction set supported by the running CPU,
+    among variants the caller provides (see SIMD_TARGET for how they can be built). The float
+    kernels of simd_algorithm and simd_blas pick their variant with it when SIMD_DISPATCH is
+    defined (see simd_dispatch.hpp). Candidates may be listed in any order; the result is meant to
+    be cached by the caller, e.g.:
+
+        static const auto impl = simd_select<void(float*, size_t)>({
+            { simd_isa::avx2, &kernel_avx2 },
+            { simd_isa::sse2, &kernel_sse2 } });
+        impl(data, size);
+
+    @return The best supported candidate or nullptr if none is supported.
+*/
+template <typename Fn>
+Fn* simd_select(std::initializer_list<std::pair<simd_isa, Fn*>> candidates,
+    const cpu_features& cpu = cpu_features::instance()) noexcept
+{
+    Fn* result = nullptr;
+    simd_isa result_isa = simd_isa::scalar;
+    for (const auto& c : candidates) {
+        if (cpu.supports(c.first) && (result == nullptr || c.first > result_isa)) {
+            result = c.second;
+            result_isa = c.first;
+        }
+    }
+    return result;
+}
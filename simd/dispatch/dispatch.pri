@@ -0,0 +1,26 @@
+# Runtime dispatch of the float kernels of simd_algorithm and simd_blas (simd/simd_dispatch.hpp):
+# defines SIMD_DISPATCH and compiles the AVX2 and AVX-512 variants with the flags of their level,
+# the rest of the project keeps SIMD_X86_ARCH. The variants are always optimized: the standard
+# library templates they use have to be inlined, an out-of-line copy compiled for AVX2 could be
+# picked by the linker for the whole program.
+!android:!win32-msvc*:!contains(DEFINES, SIMD_BACKEND_GENERIC) {
+    DEFINES += SIMD_DISPATCH
+
+    SIMD_DISPATCH_AVX2 = $$PWD/kernels_avx2.cpp
+    simd_dispatch_avx2.input = SIMD_DISPATCH_AVX2
+    simd_dispatch_avx2.output = ${QMAKE_VAR_OBJECTS_DIR}${QMAKE_FILE_BASE}$${first(QMAKE_EXT_OBJ)}
+    simd_dispatch_avx2.commands = $${QMAKE_CXX} $(CXXFLAGS) -O2 -mavx2 -mfma $(DEFINES) $(INCPATH) -c ${QMAKE_FILE_IN} -o ${QMAKE_FILE_OUT}
+    simd_dispatch_avx2.variable_out = OBJECTS
+
+    SIMD_DISPATCH_AVX512 = $$PWD/kernels_avx512.cpp
+    simd_dispatch_avx512.input = SIMD_DISPATCH_AVX512
+    simd_dispatch_avx512.output = ${QMAKE_VAR_OBJECTS_DIR}${QMAKE_FILE_BASE}$${first(QMAKE_EXT_OBJ)}
+    simd_dispatch_avx512.commands = $${QMAKE_CXX} $(CXXFLAGS) -O2 -mavx2 -mfma -mavx512f -mavx512dq -mavx512bw -mavx512vl $(DEFINES) $(INCPATH) -c ${QMAKE_FILE_IN} -o ${QMAKE_FILE_OUT}
+    simd_dispatch_avx512.variable_out = OBJECTS
+
+    QMAKE_EXTRA_COMPILERS += simd_dispatch_avx2 simd_dispatch_avx512
+}
+
+HEADERS += \
+    $$PWD/../simd_dispatch.hpp \
+    $$PWD/native_kernels.hpp
@@ -0,0 +1,11 @@
+#include "native_kernels.hpp"
+
+#if !defined(SIMD_DISPATCH) || !defined(SIMD_BACKEND_X86) || !defined(__AVX2__) || !defined(__FMA__)
+#error "kernels_avx2.cpp has to be compiled with SIMD_DISPATCH defined and -mavx2 -mfma"
+#endif
+
+const simd_dispatch::float_kernels& simd_dispatch::avx2_kernels()
+{
+    static const float_kernels kernels = native_float_kernels();
+    return kernels;
+}
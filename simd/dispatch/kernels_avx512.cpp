@@ -0,0 +1,11 @@
+#include "native_kernels.hpp"
+
+#if !defined(SIMD_DISPATCH) || !defined(SIMD_BACKEND_X86) || !defined(__AVX512F__) || !defined(__AVX512DQ__) || !defined(__AVX512BW__) || !defined(__AVX512VL__)
+#error "kernels_avx512.cpp has to be compiled with SIMD_DISPATCH defined and -mavx512f -mavx512dq -mavx512bw -mavx512vl"
+#endif
+
+const simd_dispatch::float_kernels& simd_dispatch::avx512_kernels()
+{
+    static const float_kernels kernels = native_float_kernels();
+    return kernels;
+}
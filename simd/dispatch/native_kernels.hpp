@@ -0,0 +1,33 @@
+#pragma once
+
+#include "../simd_blas.hpp"
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    The float kernels of simd_algorithm and simd_blas compiled for the level of the including
+    translation unit, for the tables of simd_dispatch.
+*/
+inline simd_dispatch::float_kernels native_float_kernels() noexcept
+{
+    simd_dispatch::float_kernels kernels;
+    kernels.transform[simd_dispatch::absolute_op] = &simd_algorithm::priv::transform_entry<simd_algorithm::absolute>;
+    kernels.transform[simd_dispatch::square_root_op] = &simd_algorithm::priv::transform_entry<simd_algorithm::square_root>;
+    kernels.transform_binary[simd_dispatch::plus_op] = &simd_algorithm::priv::transform_entry<simd_algorithm::plus>;
+    kernels.transform_binary[simd_dispatch::multiplies_op] = &simd_algorithm::priv::transform_entry<simd_algorithm::multiplies>;
+    kernels.transform_binary[simd_dispatch::minimum_op] = &simd_algorithm::priv::transform_entry<simd_algorithm::minimum>;
+    kernels.transform_binary[simd_dispatch::maximum_op] = &simd_algorithm::priv::transform_entry<simd_algorithm::maximum>;
+    kernels.reduce[simd_dispatch::plus_op] = &simd_algorithm::priv::reduce_entry<simd_algorithm::plus>;
+    kernels.reduce[simd_dispatch::multiplies_op] = &simd_algorithm::priv::reduce_entry<simd_algorithm::multiplies>;
+    kernels.reduce[simd_dispatch::minimum_op] = &simd_algorithm::priv::reduce_entry<simd_algorithm::minimum>;
+    kernels.reduce[simd_dispatch::maximum_op] = &simd_algorithm::priv::reduce_entry<simd_algorithm::maximum>;
+    kernels.saxpy = &simd_blas::priv::saxpy_kernel;
+    kernels.sscal = &simd_blas::priv::sscal_kernel;
+    kernels.sdot = &simd_blas::priv::sdot_kernel;
+    kernels.snrm2 = &simd_blas::priv::snrm2_kernel;
+    kernels.sgemv = &simd_blas::priv::sgemv_kernel;
+    kernels.sgemm = &simd_blas::priv::sgemm_kernel;
+    return kernels;
+}
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Storage formats for 16 bit floating point values. Neither type has arithmetic: values are
+    widened to float for computation (simdf4(const float16*), simd_algorithm::convert_span) and
+    rounded back to nearest even when stored.
+*/
+namespace priv {
+inline uint32_t float_bits(float value) noexcept
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+inline float bits_to_float(uint32_t bits) noexcept
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+} // namespace priv
+
+/**
+    IEEE 754 binary16: 1 sign, 5 exponent and 10 mantissa bits, range +-65504.
+*/
+struct float16 {
+    uint16_t bits;
+
+    static float16 from_float(float value) noexcept
+    {
+        const uint32_t all = priv::float_bits(value);
+        const uint32_t sign = (all >> 16) & 0x8000u;
+        const uint32_t f = all & 0x7fffffffu;
+        uint32_t result;
+        if (f >= 0x47800000u) {
+            // values from 65536 up become infinity, NaNs keep the top of their payload and are quieted
+            result = f > 0x7f800000u ? 0x7e00u | ((f >> 13) & 0x3ffu) : 0x7c00u;
+        } else if (f < 0x38800000u) {
+            // below 2^-14 the result is subnormal: adding 0.5 aligns the mantissa and rounds in hardware
+            result = priv::float_bits(priv::bits_to_float(f) + 0.5f) - 0x3f000000u;
+        } else {
+            // rebias the exponent and round the 13 dropped mantissa bits to nearest even
+            result = (f + 0xc8000fffu + ((f >> 13) & 1u)) >> 13;
+        }
+        return float16{ static_cast<uint16_t>(result | sign) };
+    }
+    float to_float() const noexcept
+    {
+        const uint32_t sign = static_cast<uint32_t>(this->bits & 0x8000u) << 16;
+        const uint32_t em = this->bits & 0x7fffu;
+        if (em >= 0x7c00u)
+            return priv::bits_to_float(sign | 0x7f800000u | (em & 0x3ffu) << 13 | (em != 0x7c00u ? 0x400000u : 0u));
+        if (em < 0x400u)
+            return priv::bits_to_float(sign | priv::float_bits(static_cast<float>(em) * (1.0f / 16777216.0f)));
+        return priv::bits_to_float(sign | ((em << 13) + 0x38000000u));
+    }
+};
+
+/**
+    Upper half of a float: 1 sign, 8 exponent and 7 mantissa bits, same range as float.
+*/
+struct bfloat16 {
+    uint16_t bits;
+
+    static bfloat16 from_float(float value) noexcept
+    {
+        const uint32_t f = priv::float_bits(value);
+        if ((f & 0x7fffffffu) > 0x7f800000u)
+            return bfloat16{ static_cast<uint16_t>((f | 0x400000u) >> 16) };
+        return bfloat16{ static_cast<uint16_t>((f + 0x7fffu + ((f >> 16) & 1u)) >> 16) };
+    }
+    float to_float() const noexcept
+    {
+        return priv::bits_to_float(static_cast<uint32_t>(this->bits) << 16);
+    }
+};
+
+SIMD_NAMESPACE_END
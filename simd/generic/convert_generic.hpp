@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+
+SIMD_NAMESPACE_BEGIN
+
+namespace simd_convert {
+namespace priv {
+    /**
+        Applies op to the lanes of value, To has as many lanes as From.
+    */
+    template <typename To, typename From, typename Op>
+    To convert_lanes(const From& value, Op op) noexcept
+    {
+        static_assert(To::value_count == From::value_count, "lane counts differ");
+        const auto input = value.to_array();
+        typename To::type output[To::value_count];
+        for (size_t i = 0; i < To::value_count; ++i)
+            output[i] = op(input[i]);
+        return To{ output };
+    }
+    /**
+        Lanes offset to offset + To::value_count of value, converted to the wider type of To.
+    */
+    template <typename To, typename From>
+    To widen_lanes(const From& value, size_t offset) noexcept
+    {
+        const auto input = value.to_array();
+        typename To::type output[To::value_count];
+        for (size_t i = 0; i < To::value_count; ++i)
+            output[i] = input[offset + i];
+        return To{ output };
+    }
+    /**
+        The lanes of low followed by the lanes of high, clamped to the range of To.
+    */
+    template <typename To, typename From>
+    To narrow_lanes(const From& low, const From& high) noexcept
+    {
+        using limits = std::numeric_limits<typename To::type>;
+        const auto l = low.to_array();
+        const auto h = high.to_array();
+        typename To::type output[To::value_count];
+        for (size_t i = 0; i < From::value_count; ++i) {
+            const int64_t a = l[i];
+            const int64_t b = h[i];
+            output[i] = static_cast<typename To::type>(a < limits::min() ? limits::min() : a > limits::max() ? limits::max() : a);
+            output[From::value_count + i] = static_cast<typename To::type>(b < limits::min() ? limits::min() : b > limits::max() ? limits::max() : b);
+        }
+        return To{ output };
+    }
+    /**
+        float to int32_t like cvttps2dq: NaN and values out of range give 0x80000000.
+    */
+    inline int32_t float_to_i32(float value) noexcept
+    {
+        return value >= -2147483648.0f && value < 2147483648.0f ? static_cast<int32_t>(value) : std::numeric_limits<int32_t>::min();
+    }
+    /**
+        float to uint32_t as the x86 backend does it: negative values and NaN give 0, as do
+        values from 2^32 up.
+    */
+    inline uint32_t float_to_u32(float value) noexcept
+    {
+        return value > 0.0f && value < 4294967296.0f ? static_cast<uint32_t>(value) : 0u;
+    }
+
+    template <>
+    struct converter<simd<int32_t, 4>, simd<float, 4>> {
+        static simd<int32_t, 4> convert(const simd<float, 4>& value) noexcept
+        {
+            return convert_lanes<simd<int32_t, 4>>(value, [](float x) { return float_to_i32(x); });
+        }
+        static simd<int32_t, 4> convert_nearest(const simd<float, 4>& value) noexcept
+        {
+            return convert_lanes<simd<int32_t, 4>>(value, [](float x) { return float_to_i32(std::nearbyint(x)); });
+        }
+    };
+    template <>
+    struct converter<simd<uint32_t, 4>, simd<float, 4>> {
+        static simd<uint32_t, 4> convert(const simd<float, 4>& value) noexcept
+        {
+            return convert_lanes<simd<uint32_t, 4>>(value, [](float x) { return float_to_u32(x); });
+        }
+        static simd<uint32_t, 4> convert_nearest(const simd<float, 4>& value) noexcept
+        {
+            return convert_lanes<simd<uint32_t, 4>>(value, [](float x) { return float_to_u32(std::nearbyint(x)); });
+        }
+    };
+    template <>
+    struct converter<simd<float, 4>, simd<int32_t, 4>> {
+        static simd<float, 4> convert(const simd<int32_t, 4>& value) noexcept
+        {
+            return convert_lanes<simd<float, 4>>(value, [](int32_t x) { return static_cast<float>(x); });
+        }
+    };
+    template <>
+    struct converter<simd<float, 4>, simd<uint32_t, 4>> {
+        static simd<float, 4> convert(const simd<uint32_t, 4>& value) noexcept
+        {
+            return convert_lanes<simd<float, 4>>(value, [](uint32_t x) { return static_cast<float>(x); });
+        }
+    };
+    template <>
+    struct converter<simd<uint32_t, 4>, simd<int32_t, 4>> {
+        static simd<uint32_t, 4> convert(const simd<int32_t, 4>& value) noexcept
+        {
+            return convert_lanes<simd<uint32_t, 4>>(value, [](int32_t x) { return static_cast<uint32_t>(x); });
+        }
+    };
+    template <>
+    struct converter<simd<int32_t, 4>, simd<uint32_t, 4>> {
+        static simd<int32_t, 4> convert(const simd<uint32_t, 4>& value) noexcept
+        {
+            return convert_lanes<simd<int32_t, 4>>(value, [](uint32_t x) { return static_cast<int32_t>(x); });
+        }
+    };
+    template <>
+    struct converter<simd<uint16_t, 8>, simd<int16_t, 8>> {
+        static simd<uint16_t, 8> convert(const simd<int16_t, 8>& value) noexcept
+        {
+            return convert_lanes<simd<uint16_t, 8>>(value, [](int16_t x) { return static_cast<uint16_t>(x); });
+        }
+    };
+    template <>
+    struct converter<simd<int16_t, 8>, simd<uint16_t, 8>> {
+        static simd<int16_t, 8> convert(const simd<uint16_t, 8>& value) noexcept
+        {
+            return convert_lanes<simd<int16_t, 8>>(value, [](uint16_t x) { return static_cast<int16_t>(x); });
+        }
+    };
+
+    template <>
+    struct widener<simd<uint8_t, 16>> {
+        using type = simd<uint16_t, 8>;
+        static type low(const simd<uint8_t, 16>& value) noexcept
+        {
+            return widen_lanes<type>(value, 0);
+        }
+        static type high(const simd<uint8_t, 16>& value) noexcept
+        {
+            return widen_lanes<type>(value, 8);
+        }
+    };
+    template <>
+    struct widener<simd<uint16_t, 8>> {
+        using type = simd<uint32_t, 4>;
+        static type low(const simd<uint16_t, 8>& value) noexcept
+        {
+            return widen_lanes<type>(value, 0);
+        }
+        static type high(const simd<uint16_t, 8>& value) noexcept
+        {
+            return widen_lanes<type>(value, 4);
+        }
+    };
+    template <>
+    struct widener<simd<int16_t, 8>> {
+        using type = simd<int32_t, 4>;
+        static type low(const simd<int16_t, 8>& value) noexcept
+        {
+            return widen_lanes<type>(value, 0);
+        }
+        static type high(const simd<int16_t, 8>& value) noexcept
+        {
+            return widen_lanes<type>(value, 4);
+        }
+    };
+
+    template <>
+    struct narrower<simd<int16_t, 8>, simd<int32_t, 4>> {
+        static simd<int16_t, 8> saturate(const simd<int32_t, 4>& low, const simd<int32_t, 4>& high) noexcept
+        {
+            return narrow_lanes<simd<int16_t, 8>>(low, high);
+        }
+    };
+    template <>
+    struct narrower<simd<uint16_t, 8>, simd<int32_t, 4>> {
+        static simd<uint16_t, 8> saturate(const simd<int32_t, 4>& low, const simd<int32_t, 4>& high) noexcept
+        {
+            return narrow_lanes<simd<uint16_t, 8>>(low, high);
+        }
+    };
+    template <>
+    struct narrower<simd<uint16_t, 8>, simd<uint32_t, 4>> {
+        static simd<uint16_t, 8> saturate(const simd<uint32_t, 4>& low, const simd<uint32_t, 4>& high) noexcept
+        {
+            return narrow_lanes<simd<uint16_t, 8>>(low, high);
+        }
+    };
+    template <>
+    struct narrower<simd<uint8_t, 16>, simd<int16_t, 8>> {
+        static simd<uint8_t, 16> saturate(const simd<int16_t, 8>& low, const simd<int16_t, 8>& high) noexcept
+        {
+            return narrow_lanes<simd<uint8_t, 16>>(low, high);
+        }
+    };
+    template <>
+    struct narrower<simd<uint8_t, 16>, simd<uint16_t, 8>> {
+        static simd<uint8_t, 16> saturate(const simd<uint16_t, 8>& low, const simd<uint16_t, 8>& high) noexcept
+        {
+            return narrow_lanes<simd<uint8_t, 16>>(low, high);
+        }
+    };
+} // namespace priv
+} // namespace simd_convert
+
+SIMD_NAMESPACE_END
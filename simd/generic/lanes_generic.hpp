@@ -0,0 +1,525 @@
+#pragma once
+
+#include "../permute_pattern.hpp"
+#include "../simd_base.hpp"
+
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Shared implementation of the portable backend (SIMD_BACKEND_GENERIC). Every operation is a
+    loop over the lanes with the semantics of the x86 backend, so one test suite checks both.
+    Results agree within the documented precision of each operation, not bit for bit: rcp() and
+    rsqrt() are exact, fma() is rounded once also where x86 without FMA multiplies and adds, and
+    the compiler may contract the lane loops into fma instructions. With GCC and Clang the lanes
+    live in a vector_size type and the loops compile to the vector instructions of the target,
+    other compilers get a plain array.
+*/
+namespace priv {
+
+#if defined(__GNUC__)
+template <typename T, size_t N>
+struct generic_register {
+    typedef T type __attribute__((vector_size(sizeof(T) * N)));
+};
+#else
+template <typename T, size_t N>
+struct generic_register {
+    struct alignas(sizeof(T) * N) type {
+        T lanes[N];
+
+        T& operator[](size_t index) noexcept
+        {
+            return this->lanes[index];
+        }
+        const T& operator[](size_t index) const noexcept
+        {
+            return this->lanes[index];
+        }
+    };
+};
+#endif
+
+/**
+    Unsigned integer of the given size, for bitwise operations on lanes.
+*/
+template <size_t Size>
+struct generic_bits;
+template <>
+struct generic_bits<1> {
+    using type = uint8_t;
+};
+template <>
+struct generic_bits<2> {
+    using type = uint16_t;
+};
+template <>
+struct generic_bits<4> {
+    using type = uint32_t;
+};
+template <>
+struct generic_bits<8> {
+    using type = uint64_t;
+};
+
+/**
+    Type wrapping integer arithmetic is done in: unsigned and at least as wide as int, so
+    neither integer promotion nor signed overflow get in the way.
+*/
+template <typename T>
+using generic_wrap_t = typename std::conditional<std::is_floating_point<T>::value, T,
+    typename std::conditional<(sizeof(T) > 4), uint64_t, uint32_t>::type>::type;
+
+/**
+    simd_mask of the portable backend, one bit per lane.
+*/
+template <typename Derived, size_t N>
+class generic_mask {
+public:
+    static constexpr size_t value_count = N;
+
+    generic_mask() noexcept = default;
+    explicit generic_mask(uint32_t bits) noexcept
+        : _bits(bits & all_bits())
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static Derived from_bits(uint32_t bits) noexcept
+    {
+        return Derived{ bits };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static Derived first(size_t count) noexcept
+    {
+        return Derived{ count >= N ? all_bits() : (1u << count) - 1 };
+    }
+
+    uint32_t native() const noexcept
+    {
+        return this->_bits;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return this->_bits;
+    }
+    bool any() const noexcept
+    {
+        return this->_bits != 0;
+    }
+    bool all() const noexcept
+    {
+        return this->_bits == all_bits();
+    }
+    bool none() const noexcept
+    {
+        return this->_bits == 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->_bits);
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->_bits >> index) & 1;
+    }
+
+    Derived operator&(const Derived& other) const noexcept
+    {
+        return Derived{ this->_bits & other._bits };
+    }
+    Derived operator|(const Derived& other) const noexcept
+    {
+        return Derived{ this->_bits | other._bits };
+    }
+    Derived operator^(const Derived& other) const noexcept
+    {
+        return Derived{ this->_bits ^ other._bits };
+    }
+    Derived operator~() const noexcept
+    {
+        return Derived{ ~this->_bits };
+    }
+
+protected:
+    static constexpr uint32_t all_bits() noexcept
+    {
+        return (1u << N) - 1;
+    }
+    static uint32_t bits_of(std::initializer_list<bool> lanes) noexcept
+    {
+        uint32_t result = 0;
+        uint32_t bit = 1;
+        for (bool lane : lanes) {
+            if (lane)
+                result |= bit;
+            bit <<= 1;
+        }
+        return result;
+    }
+
+private:
+    uint32_t _bits = 0;
+};
+
+/**
+    Members shared by all lane types of the portable backend. Derived is the simd<T, N>
+    specialization, which adds the constructors from N values and the type specific operations.
+*/
+template <typename Derived, typename T, size_t N>
+class generic_lanes : public simd_common<Derived> {
+public:
+    using type = T;
+    using mask_type = simd_mask<T, N>;
+    using register_type = typename generic_register<T, N>::type;
+    static constexpr size_t value_count = N;
+
+    generic_lanes() noexcept
+        : _d()
+    {
+    }
+    explicit generic_lanes(T value) noexcept
+        : _d()
+    {
+        for (size_t i = 0; i < N; ++i)
+            this->_d[i] = value;
+    }
+    explicit generic_lanes(register_type value) noexcept
+        : _d(value)
+    {
+    }
+    explicit generic_lanes(const T* input) noexcept
+        : _d()
+    {
+        std::memcpy(&this->_d, input, sizeof(this->_d));
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static Derived load_partial(const T* input, size_t count) noexcept
+    {
+        register_type result{};
+        for (size_t i = 0; i < N && i < count; ++i)
+            result[i] = input[i];
+        return Derived{ result };
+    }
+    /**
+        Loads from memory aligned to the register size, e.g. from an aligned_vector.
+    */
+    static Derived load_aligned(const T* input) noexcept
+    {
+        return Derived{ input };
+    }
+
+    register_type native() const noexcept
+    {
+        return this->_d;
+    }
+
+    void store(T* output) const noexcept
+    {
+        std::memcpy(output, &this->_d, sizeof(this->_d));
+    }
+    void store_aligned(T* output) const noexcept
+    {
+        std::memcpy(output, &this->_d, sizeof(this->_d));
+    }
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(T* output, size_t count) const noexcept
+    {
+        for (size_t i = 0; i < N && i < count; ++i)
+            output[i] = this->_d[i];
+    }
+
+    /**
+        Lane-wise arithmetic, integer lanes wrap around.
+    */
+    Derived operator+(const Derived& other) const noexcept
+    {
+        return this->map(other, [](T a, T b) { return static_cast<T>(static_cast<generic_wrap_t<T>>(a) + static_cast<generic_wrap_t<T>>(b)); });
+    }
+    Derived& operator+=(const Derived& other) noexcept
+    {
+        return self() = self() + other;
+    }
+    Derived operator-(const Derived& other) const noexcept
+    {
+        return this->map(other, [](T a, T b) { return static_cast<T>(static_cast<generic_wrap_t<T>>(a) - static_cast<generic_wrap_t<T>>(b)); });
+    }
+    Derived& operator-=(const Derived& other) noexcept
+    {
+        return self() = self() - other;
+    }
+    Derived operator*(const Derived& other) const noexcept
+    {
+        return this->map(other, [](T a, T b) { return static_cast<T>(static_cast<generic_wrap_t<T>>(a) * static_cast<generic_wrap_t<T>>(b)); });
+    }
+    Derived& operator*=(const Derived& other) noexcept
+    {
+        return self() = self() * other;
+    }
+
+    Derived operator&(const Derived& other) const noexcept
+    {
+        return this->bitwise(other, [](bits a, bits b) { return static_cast<bits>(a & b); });
+    }
+    Derived operator|(const Derived& other) const noexcept
+    {
+        return this->bitwise(other, [](bits a, bits b) { return static_cast<bits>(a | b); });
+    }
+    Derived operator^(const Derived& other) const noexcept
+    {
+        return this->bitwise(other, [](bits a, bits b) { return static_cast<bits>(a ^ b); });
+    }
+
+    /**
+        a < b ? a : b and a > b ? a : b like minps / maxps, i.e. other when either lane is NaN.
+    */
+    Derived min(const Derived& other) const noexcept
+    {
+        return this->map(other, [](T a, T b) { return a < b ? a : b; });
+    }
+    Derived max(const Derived& other) const noexcept
+    {
+        return this->map(other, [](T a, T b) { return a > b ? a : b; });
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, the indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    Derived permute() const noexcept
+    {
+        using pattern = priv::permute_pattern<idx...>;
+        static_assert(pattern::lane_count == N, "permute needs one index per lane");
+        static_assert(pattern::in_range(), "permute lane index out of range");
+        register_type result{};
+        for (unsigned i = 0; i < N; ++i)
+            result[i] = this->_d[pattern::at(i)];
+        return Derived{ result };
+    }
+
+    mask_type compare(const Derived& other, simd_base::compare_flags flag) const noexcept
+    {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < N; ++i) {
+            const T a = this->_d[i];
+            const T b = other._d[i];
+            bool lane = false;
+            switch (flag) {
+            case simd_base::compare_flags::equal:
+                lane = a == b;
+                break;
+            case simd_base::compare_flags::lower:
+                lane = a < b;
+                break;
+            case simd_base::compare_flags::lower_equal:
+                lane = a <= b;
+                break;
+            case simd_base::compare_flags::greater:
+                lane = a > b;
+                break;
+            case simd_base::compare_flags::greater_equal:
+                lane = a >= b;
+                break;
+            case simd_base::compare_flags::not_equal:
+                lane = a != b;
+                break;
+            }
+            if (lane)
+                bits |= 1u << i;
+        }
+        return mask_type::from_bits(bits);
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static Derived select(const mask_type& mask, const Derived& a, const Derived& b) noexcept
+    {
+        register_type result{};
+        for (size_t i = 0; i < N; ++i)
+            result[i] = mask[i] ? a._d[i] : b._d[i];
+        return Derived{ result };
+    }
+
+protected:
+    using bits = typename generic_bits<sizeof(T)>::type;
+
+    Derived& self() noexcept
+    {
+        return static_cast<Derived&>(*this);
+    }
+    template <typename Op>
+    Derived map(Op op) const noexcept
+    {
+        register_type result{};
+        for (size_t i = 0; i < N; ++i)
+            result[i] = op(this->_d[i]);
+        return Derived{ result };
+    }
+    template <typename Op>
+    Derived map(const Derived& other, Op op) const noexcept
+    {
+        register_type result{};
+        for (size_t i = 0; i < N; ++i)
+            result[i] = op(this->_d[i], other._d[i]);
+        return Derived{ result };
+    }
+    template <typename Op>
+    Derived bitwise(const Derived& other, Op op) const noexcept
+    {
+        return this->map(other, [op](T a, T b) {
+            bits x, y;
+            std::memcpy(&x, &a, sizeof(T));
+            std::memcpy(&y, &b, sizeof(T));
+            const bits r = op(x, y);
+            T result;
+            std::memcpy(&result, &r, sizeof(T));
+            return result;
+        });
+    }
+    /**
+        Combines all lanes with op, as the shuffle trees of the x86 backend do: lane i with lane
+        i + N / 2 first, then halving again until one lane is left.
+    */
+    template <typename R, typename Op>
+    R fold(Op op) const noexcept
+    {
+        R lanes[N];
+        for (size_t i = 0; i < N; ++i)
+            lanes[i] = this->_d[i];
+        for (size_t width = N / 2; width > 0; width /= 2) {
+            for (size_t i = 0; i < width; ++i)
+                lanes[i] = op(lanes[i], lanes[i + width]);
+        }
+        return lanes[0];
+    }
+
+    register_type _d;
+};
+
+/**
+    Members shared by the integer lane types of the portable backend, Sum is the result type of
+    sum(), wide enough to hold the sum of all lanes.
+*/
+template <typename Derived, typename T, size_t N, typename Sum>
+class generic_integer : public generic_lanes<Derived, T, N> {
+public:
+    using generic_lanes<Derived, T, N>::generic_lanes;
+
+    /**
+        a + b and a - b clamped to the range of T.
+    */
+    Derived add_saturate(const Derived& other) const noexcept
+    {
+        return this->map(other, [](T a, T b) { return clamp(int64_t(a) + int64_t(b)); });
+    }
+    Derived subtract_saturate(const Derived& other) const noexcept
+    {
+        return this->map(other, [](T a, T b) { return clamp(int64_t(a) - int64_t(b)); });
+    }
+    /**
+        High half of the double width product.
+    */
+    Derived mulhi(const Derived& other) const noexcept
+    {
+        return this->map(other, [](T a, T b) {
+            constexpr int shift = sizeof(T) * 8;
+            if (std::is_signed<T>::value)
+                return static_cast<T>((int64_t(a) * int64_t(b)) >> shift);
+            return static_cast<T>((uint64_t(a) * uint64_t(b)) >> shift);
+        });
+    }
+    /**
+        (a + b + 1) / 2 rounded down, without intermediate overflow.
+    */
+    Derived avg(const Derived& other) const noexcept
+    {
+        return this->map(other, [](T a, T b) { return static_cast<T>((int64_t(a) + int64_t(b) + 1) >> 1); });
+    }
+
+    template <int count>
+    Derived shift_left() const noexcept
+    {
+        static_assert(count >= 0 && count < int(sizeof(T) * 8), "shift count out of range");
+        return this->map([](T a) { return static_cast<T>(static_cast<generic_wrap_t<T>>(a) << count); });
+    }
+    /**
+        Logical right shift for unsigned lanes, arithmetic right shift for signed ones.
+    */
+    template <int count>
+    Derived shift_right() const noexcept
+    {
+        static_assert(count >= 0 && count < int(sizeof(T) * 8), "shift count out of range");
+        return this->map([](T a) { return static_cast<T>(a >> count); });
+    }
+    /**
+        Shifts each lane by the corresponding lane of counts, which have to be in [0, bits of T).
+    */
+    Derived shift_left(const Derived& counts) const noexcept
+    {
+        return this->map(counts, [](T a, T b) { return static_cast<T>(static_cast<generic_wrap_t<T>>(a) << b); });
+    }
+    Derived shift_right(const Derived& counts) const noexcept
+    {
+        return this->map(counts, [](T a, T b) { return static_cast<T>(a >> b); });
+    }
+
+    Derived operator~() const noexcept
+    {
+        return this->map([](T a) { return static_cast<T>(~a); });
+    }
+
+    /**
+        Sum of all lanes, widened so that it cannot overflow.
+    */
+    Sum sum() const noexcept
+    {
+        return this->template fold<Sum>([](Sum a, Sum b) { return static_cast<Sum>(a + b); });
+    }
+    /**
+        Minimum, maximum, product (wrapping), AND and OR of all lanes.
+    */
+    T reduce_min() const noexcept
+    {
+        return this->template fold<T>([](T a, T b) { return a < b ? a : b; });
+    }
+    T reduce_max() const noexcept
+    {
+        return this->template fold<T>([](T a, T b) { return a > b ? a : b; });
+    }
+    T reduce_product() const noexcept
+    {
+        return this->template fold<T>([](T a, T b) { return static_cast<T>(static_cast<generic_wrap_t<T>>(a) * static_cast<generic_wrap_t<T>>(b)); });
+    }
+    T reduce_and() const noexcept
+    {
+        return this->template fold<T>([](T a, T b) { return static_cast<T>(a & b); });
+    }
+    T reduce_or() const noexcept
+    {
+        return this->template fold<T>([](T a, T b) { return static_cast<T>(a | b); });
+    }
+
+protected:
+    static T clamp(int64_t value) noexcept
+    {
+        using limits = std::numeric_limits<T>;
+        return static_cast<T>(value < int64_t(limits::min()) ? int64_t(limits::min()) : value > int64_t(limits::max()) ? int64_t(limits::max()) : value);
+    }
+};
+
+} // namespace priv
+
+SIMD_NAMESPACE_END
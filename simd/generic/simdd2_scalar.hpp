@@ -0,0 +1,391 @@
+#pragma once
+
+#include "../permute_pattern.hpp"
+#include "../simdf4.hpp"
+
+#include <cmath>
+#include <cstring>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdd2 comparison, stored as one bit per lane.
+*/
+template <>
+class simd_mask<double, 2> {
+public:
+    static constexpr size_t value_count = 2;
+
+    simd_mask() noexcept = default;
+    simd_mask(bool s0, bool s1) noexcept
+        : _bits((s0 ? 1u : 0u) | (s1 ? 2u : 0u))
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        return simd_mask{ (bits & 1) != 0, (bits & 2) != 0 };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        return simd_mask{ count >= 1, count >= 2 };
+    }
+
+    uint32_t movemask() const noexcept
+    {
+        return this->_bits;
+    }
+    bool any() const noexcept
+    {
+        return this->_bits != 0;
+    }
+    bool all() const noexcept
+    {
+        return this->_bits == 0x3;
+    }
+    bool none() const noexcept
+    {
+        return this->_bits == 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->_bits);
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->_bits >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return from_bits(this->_bits & other._bits);
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return from_bits(this->_bits | other._bits);
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return from_bits(this->_bits ^ other._bits);
+    }
+    simd_mask operator~() const noexcept
+    {
+        return from_bits(~this->_bits);
+    }
+
+private:
+    uint32_t _bits = 0;
+};
+
+/**
+    2 x double as two scalars, for targets without double precision vector lanes (ARMv7 NEON).
+    Keeps the simdd2 interface available so code using it compiles everywhere.
+*/
+template <>
+class simd<double, 2> : public simd_common<simd<double, 2>> {
+public:
+    using type = double;
+    using mask_type = simd_mask<double, 2>;
+    static constexpr size_t value_count = 2;
+
+    simd() noexcept = default;
+    explicit simd(double value) noexcept
+        : _d{ { value, value } }
+    {
+    }
+    simd(double s0, double s1) noexcept
+        : _d{ { s0, s1 } }
+    {
+    }
+    explicit simd(const double* input) noexcept
+        : _d{ { input[0], input[1] } }
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const double* input, size_t count) noexcept
+    {
+        return simd{ count >= 1 ? input[0] : 0.0, count >= 2 ? input[1] : 0.0 };
+    }
+
+    static simd load_aligned(const double* input) noexcept
+    {
+        return simd{ input };
+    }
+
+    /**
+        Converts the low two lanes of a simdf4.
+    */
+    static simd from_float_low(const simd<float, 4>& value) noexcept
+    {
+        const auto lanes = value.to_array();
+        return simd{ lanes[0], lanes[1] };
+    }
+    /**
+        Converts the high two lanes of a simdf4.
+    */
+    static simd from_float_high(const simd<float, 4>& value) noexcept
+    {
+        const auto lanes = value.to_array();
+        return simd{ lanes[2], lanes[3] };
+    }
+    /**
+        Rounds the lanes of low and high to float, low goes to lanes 0 and 1 of the result.
+    */
+    static simd<float, 4> to_float(const simd& low, const simd& high) noexcept
+    {
+        return simd<float, 4>{ static_cast<float>(low._d[0]), static_cast<float>(low._d[1]),
+            static_cast<float>(high._d[0]), static_cast<float>(high._d[1]) };
+    }
+
+    void store(double* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        (void)cache_flags;
+        output[0] = this->_d[0];
+        output[1] = this->_d[1];
+    }
+
+    void store_aligned(double* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        this->store(output, cache_flags);
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(double* output, size_t count) const noexcept
+    {
+        if (count >= 1)
+            output[0] = this->_d[0];
+        if (count >= 2)
+            output[1] = this->_d[1];
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ this->_d[0] + other._d[0], this->_d[1] + other._d[1] };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        return *this = *this + other;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ this->_d[0] - other._d[0], this->_d[1] - other._d[1] };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        return *this = *this - other;
+    }
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ this->_d[0] * other._d[0], this->_d[1] * other._d[1] };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    simd operator/(const simd& other) const noexcept
+    {
+        return simd{ this->_d[0] / other._d[0], this->_d[1] / other._d[1] };
+    }
+    simd& operator/=(const simd& other) noexcept
+    {
+        return *this = *this / other;
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ other._d[0] < this->_d[0] ? other._d[0] : this->_d[0], other._d[1] < this->_d[1] ? other._d[1] : this->_d[1] };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ other._d[0] > this->_d[0] ? other._d[0] : this->_d[0], other._d[1] > this->_d[1] ? other._d[1] : this->_d[1] };
+    }
+    simd sqrt() const noexcept
+    {
+        return simd{ std::sqrt(this->_d[0]), std::sqrt(this->_d[1]) };
+    }
+    /**
+        1 / x, computed exactly for every precision.
+    */
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        return simd{ 1.0 } / *this;
+    }
+    /**
+        1 / sqrt(x), computed exactly for every precision.
+    */
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        return simd{ 1.0 } / this->sqrt();
+    }
+    simd abs() const noexcept
+    {
+        return simd{ std::fabs(this->_d[0]), std::fabs(this->_d[1]) };
+    }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+        return simd{ std::nearbyint(this->_d[0]), std::nearbyint(this->_d[1]) };
+    }
+    simd floor() const noexcept
+    {
+        return simd{ std::floor(this->_d[0]), std::floor(this->_d[1]) };
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-1022, 1023].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+        return simd{ std::ldexp(this->_d[0], static_cast<int>(exponent._d[0])), std::ldexp(this->_d[1], static_cast<int>(exponent._d[1])) };
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+        int e0, e1;
+        const simd result{ std::frexp(this->_d[0], &e0), std::frexp(this->_d[1], &e1) };
+        exponent = simd{ static_cast<double>(e0), static_cast<double>(e1) };
+        return result;
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return bitwise(other, [](uint64_t a, uint64_t b) { return a & b; });
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return bitwise(other, [](uint64_t a, uint64_t b) { return a | b; });
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return bitwise(other, [](uint64_t a, uint64_t b) { return a ^ b; });
+    }
+
+    /**
+        { value[idx0], value[idx1] }, the indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        using pattern = priv::permute_pattern<idx...>;
+        static_assert(pattern::lane_count == 2, "permute needs one index per lane");
+        static_assert(pattern::in_range(), "permute lane index out of range");
+        return simd{ this->_d[pattern::at(0)], this->_d[pattern::at(1)] };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        const double a0 = this->_d[0], a1 = this->_d[1], b0 = other._d[0], b1 = other._d[1];
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ a0 == b0, a1 == b1 };
+        case compare_flags::lower:
+            return mask_type{ a0 < b0, a1 < b1 };
+        case compare_flags::lower_equal:
+            return mask_type{ a0 <= b0, a1 <= b1 };
+        case compare_flags::greater:
+            return mask_type{ a0 > b0, a1 > b1 };
+        case compare_flags::greater_equal:
+            return mask_type{ a0 >= b0, a1 >= b1 };
+        case compare_flags::not_equal:
+            return mask_type{ a0 != b0, a1 != b1 };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ mask[0] ? a._d[0] : b._d[0], mask[1] ? a._d[1] : b._d[1] };
+    }
+
+    /**
+        a * b + c, rounded once.
+    */
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ std::fma(a._d[0], b._d[0], c._d[0]), std::fma(a._d[1], b._d[1], c._d[1]) };
+    }
+    /**
+        a * b - c
+    */
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ std::fma(a._d[0], b._d[0], -c._d[0]), std::fma(a._d[1], b._d[1], -c._d[1]) };
+    }
+    /**
+        c - a * b
+    */
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ std::fma(-a._d[0], b._d[0], c._d[0]), std::fma(-a._d[1], b._d[1], c._d[1]) };
+    }
+
+    /**
+        { a0 + a1, b0 + b1 }
+    */
+    static simd horizontal_add(const simd& a, const simd& b) noexcept
+    {
+        return simd{ a._d[0] + a._d[1], b._d[0] + b._d[1] };
+    }
+
+    /**
+        { a[l], b[h] }
+    */
+    template <unsigned short l, unsigned short h>
+    static simd shuffle(const simd& a, const simd& b) noexcept
+    {
+        static_assert(l < 2 && h < 2, "lane index out of range");
+        return simd{ a._d[l], b._d[h] };
+    }
+    static simd unpack_low(const simd& a, const simd& b) noexcept
+    {
+        return simd{ a._d[0], b._d[0] };
+    }
+    static simd unpack_high(const simd& a, const simd& b) noexcept
+    {
+        return simd{ a._d[1], b._d[1] };
+    }
+    static void transpose(simd& r0, simd& r1) noexcept
+    {
+        const double t = r0._d[1];
+        r0._d[1] = r1._d[0];
+        r1._d[0] = t;
+    }
+
+private:
+    template <typename Op>
+    simd bitwise(const simd& other, Op op) const noexcept
+    {
+        uint64_t a[2], b[2];
+        std::memcpy(a, this->_d.data(), sizeof(a));
+        std::memcpy(b, other._d.data(), sizeof(b));
+        a[0] = op(a[0], b[0]);
+        a[1] = op(a[1], b[1]);
+        simd result;
+        std::memcpy(result._d.data(), a, sizeof(a));
+        return result;
+    }
+
+    alignas(16) std::array<double, 2> _d = { { 0.0, 0.0 } };
+};
+
+using simdd2 = simd<double, 2>;
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,354 @@
+#pragma once
+
+#include "../simdd2.hpp"
+
+#include <utility>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdd4 comparison, stored as masks of the two halves.
+*/
+template <>
+class simd_mask<double, 4> {
+public:
+    static constexpr size_t value_count = 4;
+
+    simd_mask() noexcept = default;
+    simd_mask(const simd_mask<double, 2>& low, const simd_mask<double, 2>& high) noexcept
+        : _lo(low)
+        , _hi(high)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        return simd_mask{ simd_mask<double, 2>::from_bits(bits), simd_mask<double, 2>::from_bits(bits >> 2) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        return simd_mask{ simd_mask<double, 2>::first(count), simd_mask<double, 2>::first(count < 2 ? 0 : count - 2) };
+    }
+
+    simd_mask<double, 2> low() const noexcept
+    {
+        return this->_lo;
+    }
+    simd_mask<double, 2> high() const noexcept
+    {
+        return this->_hi;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return this->_lo.movemask() | (this->_hi.movemask() << 2);
+    }
+    bool any() const noexcept
+    {
+        return (this->_lo | this->_hi).any();
+    }
+    bool all() const noexcept
+    {
+        return (this->_lo & this->_hi).all();
+    }
+    bool none() const noexcept
+    {
+        return !this->any();
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ this->_lo & other._lo, this->_hi & other._hi };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ this->_lo | other._lo, this->_hi | other._hi };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ this->_lo ^ other._lo, this->_hi ^ other._hi };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ ~this->_lo, ~this->_hi };
+    }
+
+private:
+    simd_mask<double, 2> _lo;
+    simd_mask<double, 2> _hi;
+};
+
+/**
+    4 x double emulated with two simdd2 registers, for targets without 256 bit registers.
+    Shuffles, unpacks and horizontal adds operate on each half independently, so the
+    results match the AVX implementation lane for lane.
+*/
+template <>
+class simd<double, 4> : public simd_common<simd<double, 4>> {
+public:
+    using type = double;
+    using mask_type = simd_mask<double, 4>;
+    static constexpr size_t value_count = 4;
+
+    simd() noexcept = default;
+    explicit simd(double value) noexcept
+        : _lo(value)
+        , _hi(value)
+    {
+    }
+    simd(double s0, double s1, double s2, double s3) noexcept
+        : _lo(s0, s1)
+        , _hi(s2, s3)
+    {
+    }
+    simd(const simd<double, 2>& low, const simd<double, 2>& high) noexcept
+        : _lo(low)
+        , _hi(high)
+    {
+    }
+    /**
+        Converts the lanes of a simdf4.
+    */
+    explicit simd(const simd<float, 4>& value) noexcept
+        : _lo(simd<double, 2>::from_float_low(value))
+        , _hi(simd<double, 2>::from_float_high(value))
+    {
+    }
+    explicit simd(const double* input) noexcept
+        : _lo(input)
+        , _hi(input + 2)
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const double* input, size_t count) noexcept
+    {
+        if (count <= 2)
+            return simd{ simd<double, 2>::load_partial(input, count), simd<double, 2>{} };
+        return simd{ simd<double, 2>(input), simd<double, 2>::load_partial(input + 2, count - 2) };
+    }
+
+    simd<double, 2> low() const noexcept
+    {
+        return this->_lo;
+    }
+    simd<double, 2> high() const noexcept
+    {
+        return this->_hi;
+    }
+    /**
+        Rounds the lanes to float.
+    */
+    simd<float, 4> to_float() const noexcept
+    {
+        return simd<double, 2>::to_float(this->_lo, this->_hi);
+    }
+
+    /**
+        Loads from memory aligned to 32 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const double* input) noexcept
+    {
+        return simd{ simd<double, 2>::load_aligned(input), simd<double, 2>::load_aligned(input + 2) };
+    }
+
+    void store(double* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        this->_lo.store(output, cache_flags);
+        this->_hi.store(output + 2, cache_flags);
+    }
+
+    void store_aligned(double* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        this->_lo.store_aligned(output, cache_flags);
+        this->_hi.store_aligned(output + 2, cache_flags);
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(double* output, size_t count) const noexcept
+    {
+        if (count <= 2) {
+            this->_lo.store_partial(output, count);
+        } else {
+            this->_lo.store(output);
+            this->_hi.store_partial(output + 2, count - 2);
+        }
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ this->_lo + other._lo, this->_hi + other._hi };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        return *this = *this + other;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ this->_lo - other._lo, this->_hi - other._hi };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        return *this = *this - other;
+    }
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ this->_lo * other._lo, this->_hi * other._hi };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    simd operator/(const simd& other) const noexcept
+    {
+        return simd{ this->_lo / other._lo, this->_hi / other._hi };
+    }
+    simd& operator/=(const simd& other) noexcept
+    {
+        return *this = *this / other;
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ this->_lo.min(other._lo), this->_hi.min(other._hi) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ this->_lo.max(other._lo), this->_hi.max(other._hi) };
+    }
+    simd sqrt() const noexcept
+    {
+        return simd{ this->_lo.sqrt(), this->_hi.sqrt() };
+    }
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        return simd{ this->_lo.template rcp<P>(), this->_hi.template rcp<P>() };
+    }
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        return simd{ this->_lo.template rsqrt<P>(), this->_hi.template rsqrt<P>() };
+    }
+    simd abs() const noexcept
+    {
+        return simd{ this->_lo.abs(), this->_hi.abs() };
+    }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+        return simd{ this->_lo.round(), this->_hi.round() };
+    }
+    simd floor() const noexcept
+    {
+        return simd{ this->_lo.floor(), this->_hi.floor() };
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-1022, 1023].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+        return simd{ this->_lo.ldexp(exponent._lo), this->_hi.ldexp(exponent._hi) };
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+        return simd{ this->_lo.frexp(exponent._lo), this->_hi.frexp(exponent._hi) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ this->_lo & other._lo, this->_hi & other._hi };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ this->_lo | other._lo, this->_hi | other._hi };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ this->_lo ^ other._lo, this->_hi ^ other._hi };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        return mask_type{ this->_lo.compare(other._lo, flag), this->_hi.compare(other._hi, flag) };
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<double, 2>::select(mask.low(), a._lo, b._lo), simd<double, 2>::select(mask.high(), a._hi, b._hi) };
+    }
+
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ simd<double, 2>::fma(a._lo, b._lo, c._lo), simd<double, 2>::fma(a._hi, b._hi, c._hi) };
+    }
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ simd<double, 2>::fms(a._lo, b._lo, c._lo), simd<double, 2>::fms(a._hi, b._hi, c._hi) };
+    }
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ simd<double, 2>::fnma(a._lo, b._lo, c._lo), simd<double, 2>::fnma(a._hi, b._hi, c._hi) };
+    }
+
+    static simd horizontal_add(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<double, 2>::horizontal_add(a._lo, b._lo), simd<double, 2>::horizontal_add(a._hi, b._hi) };
+    }
+
+    template <unsigned short l, unsigned short h>
+    static simd shuffle(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<double, 2>::shuffle<l, h>(a._lo, b._lo), simd<double, 2>::shuffle<l, h>(a._hi, b._hi) };
+    }
+    static simd unpack_low(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<double, 2>::unpack_low(a._lo, b._lo), simd<double, 2>::unpack_low(a._hi, b._hi) };
+    }
+    static simd unpack_high(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<double, 2>::unpack_high(a._lo, b._lo), simd<double, 2>::unpack_high(a._hi, b._hi) };
+    }
+    static void transpose(simd& r0, simd& r1, simd& r2, simd& r3) noexcept
+    {
+        // transpose the four 2x2 blocks, then swap the off-diagonal ones
+        simd<double, 2>::transpose(r0._lo, r1._lo);
+        simd<double, 2>::transpose(r0._hi, r1._hi);
+        simd<double, 2>::transpose(r2._lo, r3._lo);
+        simd<double, 2>::transpose(r2._hi, r3._hi);
+        std::swap(r0._hi, r2._lo);
+        std::swap(r1._hi, r3._lo);
+    }
+
+private:
+    simd<double, 2> _lo;
+    simd<double, 2> _hi;
+};
+
+using simdd4 = simd<double, 4>;
+
+SIMD_NAMESPACE_END
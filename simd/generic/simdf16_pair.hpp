@@ -0,0 +1,350 @@
+#pragma once
+
+#include "../simdf8.hpp"
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdf16 comparison, stored as masks of the two halves.
+*/
+template <>
+class simd_mask<float, 16> {
+public:
+    static constexpr size_t value_count = 16;
+
+    simd_mask() noexcept = default;
+    simd_mask(const simd_mask<float, 8>& low, const simd_mask<float, 8>& high) noexcept
+        : _lo(low)
+        , _hi(high)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        return simd_mask{ simd_mask<float, 8>::from_bits(bits), simd_mask<float, 8>::from_bits(bits >> 8) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        return simd_mask{ simd_mask<float, 8>::first(count), simd_mask<float, 8>::first(count < 8 ? 0 : count - 8) };
+    }
+
+    simd_mask<float, 8> low() const noexcept
+    {
+        return this->_lo;
+    }
+    simd_mask<float, 8> high() const noexcept
+    {
+        return this->_hi;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return this->_lo.movemask() | (this->_hi.movemask() << 8);
+    }
+    bool any() const noexcept
+    {
+        return (this->_lo | this->_hi).any();
+    }
+    bool all() const noexcept
+    {
+        return (this->_lo & this->_hi).all();
+    }
+    bool none() const noexcept
+    {
+        return !this->any();
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ this->_lo & other._lo, this->_hi & other._hi };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ this->_lo | other._lo, this->_hi | other._hi };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ this->_lo ^ other._lo, this->_hi ^ other._hi };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ ~this->_lo, ~this->_hi };
+    }
+
+private:
+    simd_mask<float, 8> _lo;
+    simd_mask<float, 8> _hi;
+};
+
+/**
+    16 x float emulated with two simdf8 registers, for targets without AVX-512.
+    Results match the AVX-512 implementation lane for lane.
+*/
+template <>
+class simd<float, 16> : public simd_common<simd<float, 16>> {
+public:
+    using type = float;
+    using mask_type = simd_mask<float, 16>;
+    static constexpr size_t value_count = 16;
+
+    simd() noexcept = default;
+    explicit simd(float value) noexcept
+        : _lo(value)
+        , _hi(value)
+    {
+    }
+    simd(float s0, float s1, float s2, float s3, float s4, float s5, float s6, float s7,
+        float s8, float s9, float s10, float s11, float s12, float s13, float s14, float s15) noexcept
+        : _lo(s0, s1, s2, s3, s4, s5, s6, s7)
+        , _hi(s8, s9, s10, s11, s12, s13, s14, s15)
+    {
+    }
+    simd(const simd<float, 8>& low, const simd<float, 8>& high) noexcept
+        : _lo(low)
+        , _hi(high)
+    {
+    }
+    explicit simd(const float* input) noexcept
+        : _lo(input)
+        , _hi(input + 8)
+    {
+    }
+    /**
+        Loads the lanes selected by the mask, the other lanes are set to zero.
+        Memory of the masked out lanes is not accessed.
+    */
+    simd(const float* input, const mask_type& mask) noexcept
+    {
+        alignas(64) float data[16];
+        for (size_t i = 0; i < 16; ++i)
+            data[i] = mask[i] ? input[i] : 0.0f;
+        *this = simd(data);
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const float* input, size_t count) noexcept
+    {
+        if (count <= 8)
+            return simd{ simd<float, 8>::load_partial(input, count), simd<float, 8>{} };
+        return simd{ simd<float, 8>(input), simd<float, 8>::load_partial(input + 8, count - 8) };
+    }
+
+    simd<float, 8> low() const noexcept
+    {
+        return this->_lo;
+    }
+    simd<float, 8> high() const noexcept
+    {
+        return this->_hi;
+    }
+
+    /**
+        Loads from memory aligned to 64 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const float* input) noexcept
+    {
+        return simd{ simd<float, 8>::load_aligned(input), simd<float, 8>::load_aligned(input + 8) };
+    }
+
+    void store(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        this->_lo.store(output, cache_flags);
+        this->_hi.store(output + 8, cache_flags);
+    }
+
+    void store_aligned(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        this->_lo.store_aligned(output, cache_flags);
+        this->_hi.store_aligned(output + 8, cache_flags);
+    }
+
+    /**
+        Stores the lanes selected by the mask. Memory of the masked out lanes is not accessed.
+    */
+    void store(float* output, const mask_type& mask) const noexcept
+    {
+        const auto data = this->to_array();
+        for (size_t i = 0; i < 16; ++i) {
+            if (mask[i])
+                output[i] = data[i];
+        }
+    }
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(float* output, size_t count) const noexcept
+    {
+        if (count <= 8) {
+            this->_lo.store_partial(output, count);
+        } else {
+            this->_lo.store(output);
+            this->_hi.store_partial(output + 8, count - 8);
+        }
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ this->_lo + other._lo, this->_hi + other._hi };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        return *this = *this + other;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ this->_lo - other._lo, this->_hi - other._hi };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        return *this = *this - other;
+    }
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ this->_lo * other._lo, this->_hi * other._hi };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    simd operator/(const simd& other) const noexcept
+    {
+        return simd{ this->_lo / other._lo, this->_hi / other._hi };
+    }
+    simd& operator/=(const simd& other) noexcept
+    {
+        return *this = *this / other;
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ this->_lo.min(other._lo), this->_hi.min(other._hi) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ this->_lo.max(other._lo), this->_hi.max(other._hi) };
+    }
+    simd sqrt() const noexcept
+    {
+        return simd{ this->_lo.sqrt(), this->_hi.sqrt() };
+    }
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        return simd{ this->_lo.template rcp<P>(), this->_hi.template rcp<P>() };
+    }
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        return simd{ this->_lo.template rsqrt<P>(), this->_hi.template rsqrt<P>() };
+    }
+    simd abs() const noexcept
+    {
+        return simd{ this->_lo.abs(), this->_hi.abs() };
+    }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+        return simd{ this->_lo.round(), this->_hi.round() };
+    }
+    simd floor() const noexcept
+    {
+        return simd{ this->_lo.floor(), this->_hi.floor() };
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-126, 127].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+        return simd{ this->_lo.ldexp(exponent._lo), this->_hi.ldexp(exponent._hi) };
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+        return simd{ this->_lo.frexp(exponent._lo), this->_hi.frexp(exponent._hi) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ this->_lo & other._lo, this->_hi & other._hi };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ this->_lo | other._lo, this->_hi | other._hi };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ this->_lo ^ other._lo, this->_hi ^ other._hi };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        return mask_type{ this->_lo.compare(other._lo, flag), this->_hi.compare(other._hi, flag) };
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<float, 8>::select(mask.low(), a._lo, b._lo), simd<float, 8>::select(mask.high(), a._hi, b._hi) };
+    }
+
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ simd<float, 8>::fma(a._lo, b._lo, c._lo), simd<float, 8>::fma(a._hi, b._hi, c._hi) };
+    }
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ simd<float, 8>::fms(a._lo, b._lo, c._lo), simd<float, 8>::fms(a._hi, b._hi, c._hi) };
+    }
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ simd<float, 8>::fnma(a._lo, b._lo, c._lo), simd<float, 8>::fnma(a._hi, b._hi, c._hi) };
+    }
+
+    static simd horizontal_add(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<float, 8>::horizontal_add(a._lo, b._lo), simd<float, 8>::horizontal_add(a._hi, b._hi) };
+    }
+
+    template <unsigned short l0, unsigned short l1, unsigned short h0, unsigned short h1>
+    static simd shuffle(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<float, 8>::shuffle<l0, l1, h0, h1>(a._lo, b._lo),
+            simd<float, 8>::shuffle<l0, l1, h0, h1>(a._hi, b._hi) };
+    }
+    static simd unpack_low(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<float, 8>::unpack_low(a._lo, b._lo), simd<float, 8>::unpack_low(a._hi, b._hi) };
+    }
+    static simd unpack_high(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<float, 8>::unpack_high(a._lo, b._lo), simd<float, 8>::unpack_high(a._hi, b._hi) };
+    }
+
+private:
+    simd<float, 8> _lo;
+    simd<float, 8> _hi;
+};
+
+using simdf16 = simd<float, 16>;
+
+SIMD_NAMESPACE_END
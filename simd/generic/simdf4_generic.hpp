@@ -0,0 +1,235 @@
+#pragma once
+
+#include "../float16.hpp"
+#include "lanes_generic.hpp"
+
+#include <cmath>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdf4 comparison, one bit per lane.
+*/
+template <>
+class simd_mask<float, 4> : public priv::generic_mask<simd_mask<float, 4>, 4> {
+public:
+    using generic_mask::generic_mask;
+
+    simd_mask() noexcept = default;
+    simd_mask(bool s0, bool s1, bool s2, bool s3) noexcept
+        : generic_mask(bits_of({ s0, s1, s2, s3 }))
+    {
+    }
+};
+
+/**
+    4 x float of the portable backend. rcp() and rsqrt() are exact for every precision, fma() is
+    always rounded once.
+*/
+template <>
+class simd<float, 4> : public priv::generic_lanes<simd<float, 4>, float, 4> {
+public:
+    using generic_lanes::generic_lanes;
+
+    simd() noexcept = default;
+    simd(float s0, float s1, float s2, float s3) noexcept
+        : generic_lanes(register_type{ s0, s1, s2, s3 })
+    {
+    }
+    /**
+        Loads 4 float16 values (8 bytes) and widens them.
+    */
+    explicit simd(const float16* input) noexcept
+    {
+        for (size_t i = 0; i < 4; ++i)
+            this->_d[i] = input[i].to_float();
+    }
+    /**
+        Loads 4 bfloat16 values (8 bytes) and widens them.
+    */
+    explicit simd(const bfloat16* input) noexcept
+    {
+        for (size_t i = 0; i < 4; ++i)
+            this->_d[i] = input[i].to_float();
+    }
+
+    void store(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        (void)cache_flags;
+        generic_lanes::store(output);
+    }
+    void store_aligned(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        (void)cache_flags;
+        generic_lanes::store_aligned(output);
+    }
+    /**
+        Rounds the lanes to float16 and stores them (8 bytes).
+    */
+    void store(float16* output) const noexcept
+    {
+        for (size_t i = 0; i < 4; ++i)
+            output[i] = float16::from_float(this->_d[i]);
+    }
+    /**
+        Rounds the lanes to bfloat16 and stores them (8 bytes).
+    */
+    void store(bfloat16* output) const noexcept
+    {
+        for (size_t i = 0; i < 4; ++i)
+            output[i] = bfloat16::from_float(this->_d[i]);
+    }
+
+    simd operator/(const simd& other) const noexcept
+    {
+        return this->map(other, [](float a, float b) { return a / b; });
+    }
+    simd& operator/=(const simd& other) noexcept
+    {
+        return *this = *this / other;
+    }
+
+    simd sqrt() const noexcept
+    {
+        return this->map([](float a) { return std::sqrt(a); });
+    }
+    /**
+        1 / x, computed exactly for every precision.
+    */
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        return simd{ 1.0f } / *this;
+    }
+    /**
+        1 / sqrt(x), computed exactly for every precision.
+    */
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        return simd{ 1.0f } / this->sqrt();
+    }
+    simd abs() const noexcept
+    {
+        return this->map([](float a) { return std::fabs(a); });
+    }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+        return this->map([](float a) { return std::nearbyint(a); });
+    }
+    simd floor() const noexcept
+    {
+        return this->map([](float a) { return std::floor(a); });
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-126, 127].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+        return this->map(exponent, [](float a, float e) {
+            return a * priv::bits_to_float(static_cast<uint32_t>(static_cast<int32_t>(e) + 127) << 23);
+        });
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+        exponent = this->map([](float a) { return static_cast<float>(static_cast<int32_t>(priv::float_bits(a) >> 23) - 126); });
+        return this->map([](float a) { return priv::bits_to_float((priv::float_bits(a) & 0x007fffffu) | 0x3f000000u); });
+    }
+
+    /**
+        a * b + c, rounded once.
+    */
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        simd result;
+        for (size_t i = 0; i < 4; ++i)
+            result._d[i] = std::fma(a._d[i], b._d[i], c._d[i]);
+        return result;
+    }
+    /**
+        a * b - c
+    */
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return fma(a, b, c.map([](float x) { return -x; }));
+    }
+    /**
+        c - a * b
+    */
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return fma(a.map([](float x) { return -x; }), b, c);
+    }
+
+    /**
+        { a0 + a1, a2 + a3, b0 + b1, b2 + b3 }
+    */
+    static simd horizontal_add(const simd& a, const simd& b) noexcept
+    {
+        return simd{ a._d[0] + a._d[1], a._d[2] + a._d[3], b._d[0] + b._d[1], b._d[2] + b._d[3] };
+    }
+    /**
+        Sum of all lanes, added as (x0 + x2) + (x1 + x3).
+    */
+    float reduce_add() const noexcept
+    {
+        return this->fold<float>([](float a, float b) { return a + b; });
+    }
+    /**
+        Minimum and maximum of all lanes.
+    */
+    float reduce_min() const noexcept
+    {
+        return this->fold<float>([](float a, float b) { return a < b ? a : b; });
+    }
+    float reduce_max() const noexcept
+    {
+        return this->fold<float>([](float a, float b) { return a > b ? a : b; });
+    }
+    /**
+        Sum of the lane-wise products.
+    */
+    static float dot(const simd& a, const simd& b) noexcept
+    {
+        return (a * b).reduce_add();
+    }
+
+    /**
+        { a[l0], a[l1], b[h0], b[h1] }
+    */
+    template <unsigned short l0, unsigned short l1, unsigned short h0, unsigned short h1>
+    static simd shuffle(const simd& a, const simd& b) noexcept
+    {
+        static_assert(l0 < 4 && l1 < 4 && h0 < 4 && h1 < 4, "lane index out of range");
+        return simd{ a._d[l0], a._d[l1], b._d[h0], b._d[h1] };
+    }
+    static simd unpack_low(const simd& a, const simd& b) noexcept
+    {
+        return simd{ a._d[0], b._d[0], a._d[1], b._d[1] };
+    }
+    static simd unpack_high(const simd& a, const simd& b) noexcept
+    {
+        return simd{ a._d[2], b._d[2], a._d[3], b._d[3] };
+    }
+    static void transpose(simd& r0, simd& r1, simd& r2, simd& r3) noexcept
+    {
+        const simd c0{ r0._d[0], r1._d[0], r2._d[0], r3._d[0] };
+        const simd c1{ r0._d[1], r1._d[1], r2._d[1], r3._d[1] };
+        const simd c2{ r0._d[2], r1._d[2], r2._d[2], r3._d[2] };
+        const simd c3{ r0._d[3], r1._d[3], r2._d[3], r3._d[3] };
+        r0 = c0;
+        r1 = c1;
+        r2 = c2;
+        r3 = c3;
+    }
+};
+
+using simdf4 = simd<float, 4>;
+
+SIMD_NAMESPACE_END
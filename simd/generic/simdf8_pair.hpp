@@ -0,0 +1,343 @@
+#pragma once
+
+#include "../simdf4.hpp"
+
+#include <utility>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdf8 comparison, stored as masks of the two halves.
+*/
+template <>
+class simd_mask<float, 8> {
+public:
+    static constexpr size_t value_count = 8;
+
+    simd_mask() noexcept = default;
+    simd_mask(const simd_mask<float, 4>& low, const simd_mask<float, 4>& high) noexcept
+        : _lo(low)
+        , _hi(high)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        return simd_mask{ simd_mask<float, 4>::from_bits(bits), simd_mask<float, 4>::from_bits(bits >> 4) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        return simd_mask{ simd_mask<float, 4>::first(count), simd_mask<float, 4>::first(count < 4 ? 0 : count - 4) };
+    }
+
+    simd_mask<float, 4> low() const noexcept
+    {
+        return this->_lo;
+    }
+    simd_mask<float, 4> high() const noexcept
+    {
+        return this->_hi;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return this->_lo.movemask() | (this->_hi.movemask() << 4);
+    }
+    bool any() const noexcept
+    {
+        return (this->_lo | this->_hi).any();
+    }
+    bool all() const noexcept
+    {
+        return (this->_lo & this->_hi).all();
+    }
+    bool none() const noexcept
+    {
+        return !this->any();
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ this->_lo & other._lo, this->_hi & other._hi };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ this->_lo | other._lo, this->_hi | other._hi };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ this->_lo ^ other._lo, this->_hi ^ other._hi };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ ~this->_lo, ~this->_hi };
+    }
+
+private:
+    simd_mask<float, 4> _lo;
+    simd_mask<float, 4> _hi;
+};
+
+/**
+    8 x float emulated with two simdf4 registers, for targets without 256 bit registers.
+    Shuffles, unpacks and horizontal adds operate on each half independently, so the
+    results match the AVX implementation lane for lane.
+*/
+template <>
+class simd<float, 8> : public simd_common<simd<float, 8>> {
+public:
+    using type = float;
+    using mask_type = simd_mask<float, 8>;
+    static constexpr size_t value_count = 8;
+
+    simd() noexcept = default;
+    explicit simd(float value) noexcept
+        : _lo(value)
+        , _hi(value)
+    {
+    }
+    simd(float s0, float s1, float s2, float s3, float s4, float s5, float s6, float s7) noexcept
+        : _lo(s0, s1, s2, s3)
+        , _hi(s4, s5, s6, s7)
+    {
+    }
+    simd(const simd<float, 4>& low, const simd<float, 4>& high) noexcept
+        : _lo(low)
+        , _hi(high)
+    {
+    }
+    explicit simd(const float* input) noexcept
+        : _lo(input)
+        , _hi(input + 4)
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const float* input, size_t count) noexcept
+    {
+        if (count <= 4)
+            return simd{ simd<float, 4>::load_partial(input, count), simd<float, 4>{} };
+        return simd{ simd<float, 4>(input), simd<float, 4>::load_partial(input + 4, count - 4) };
+    }
+
+    simd<float, 4> low() const noexcept
+    {
+        return this->_lo;
+    }
+    simd<float, 4> high() const noexcept
+    {
+        return this->_hi;
+    }
+
+    /**
+        Loads from memory aligned to 32 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const float* input) noexcept
+    {
+        return simd{ simd<float, 4>::load_aligned(input), simd<float, 4>::load_aligned(input + 4) };
+    }
+
+    void store(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        this->_lo.store(output, cache_flags);
+        this->_hi.store(output + 4, cache_flags);
+    }
+
+    void store_aligned(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        this->_lo.store_aligned(output, cache_flags);
+        this->_hi.store_aligned(output + 4, cache_flags);
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(float* output, size_t count) const noexcept
+    {
+        if (count <= 4) {
+            this->_lo.store_partial(output, count);
+        } else {
+            this->_lo.store(output);
+            this->_hi.store_partial(output + 4, count - 4);
+        }
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ this->_lo + other._lo, this->_hi + other._hi };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        return *this = *this + other;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ this->_lo - other._lo, this->_hi - other._hi };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        return *this = *this - other;
+    }
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ this->_lo * other._lo, this->_hi * other._hi };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    simd operator/(const simd& other) const noexcept
+    {
+        return simd{ this->_lo / other._lo, this->_hi / other._hi };
+    }
+    simd& operator/=(const simd& other) noexcept
+    {
+        return *this = *this / other;
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ this->_lo.min(other._lo), this->_hi.min(other._hi) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ this->_lo.max(other._lo), this->_hi.max(other._hi) };
+    }
+    simd sqrt() const noexcept
+    {
+        return simd{ this->_lo.sqrt(), this->_hi.sqrt() };
+    }
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        return simd{ this->_lo.template rcp<P>(), this->_hi.template rcp<P>() };
+    }
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        return simd{ this->_lo.template rsqrt<P>(), this->_hi.template rsqrt<P>() };
+    }
+    simd abs() const noexcept
+    {
+        return simd{ this->_lo.abs(), this->_hi.abs() };
+    }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+        return simd{ this->_lo.round(), this->_hi.round() };
+    }
+    simd floor() const noexcept
+    {
+        return simd{ this->_lo.floor(), this->_hi.floor() };
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-126, 127].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+        return simd{ this->_lo.ldexp(exponent._lo), this->_hi.ldexp(exponent._hi) };
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+        return simd{ this->_lo.frexp(exponent._lo), this->_hi.frexp(exponent._hi) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ this->_lo & other._lo, this->_hi & other._hi };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ this->_lo | other._lo, this->_hi | other._hi };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ this->_lo ^ other._lo, this->_hi ^ other._hi };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        return mask_type{ this->_lo.compare(other._lo, flag), this->_hi.compare(other._hi, flag) };
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<float, 4>::select(mask.low(), a._lo, b._lo), simd<float, 4>::select(mask.high(), a._hi, b._hi) };
+    }
+
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ simd<float, 4>::fma(a._lo, b._lo, c._lo), simd<float, 4>::fma(a._hi, b._hi, c._hi) };
+    }
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ simd<float, 4>::fms(a._lo, b._lo, c._lo), simd<float, 4>::fms(a._hi, b._hi, c._hi) };
+    }
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ simd<float, 4>::fnma(a._lo, b._lo, c._lo), simd<float, 4>::fnma(a._hi, b._hi, c._hi) };
+    }
+
+    static simd horizontal_add(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<float, 4>::horizontal_add(a._lo, b._lo), simd<float, 4>::horizontal_add(a._hi, b._hi) };
+    }
+
+    template <unsigned short l0, unsigned short l1, unsigned short h0, unsigned short h1>
+    static simd shuffle(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<float, 4>::shuffle<l0, l1, h0, h1>(a._lo, b._lo),
+            simd<float, 4>::shuffle<l0, l1, h0, h1>(a._hi, b._hi) };
+    }
+    static simd unpack_low(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<float, 4>::unpack_low(a._lo, b._lo), simd<float, 4>::unpack_low(a._hi, b._hi) };
+    }
+    static simd unpack_high(const simd& a, const simd& b) noexcept
+    {
+        return simd{ simd<float, 4>::unpack_high(a._lo, b._lo), simd<float, 4>::unpack_high(a._hi, b._hi) };
+    }
+    static void transpose(simd& r0, simd& r1, simd& r2, simd& r3,
+        simd& r4, simd& r5, simd& r6, simd& r7) noexcept
+    {
+        // transpose the four 4x4 blocks, then swap the off-diagonal ones
+        simd<float, 4>::transpose(r0._lo, r1._lo, r2._lo, r3._lo);
+        simd<float, 4>::transpose(r0._hi, r1._hi, r2._hi, r3._hi);
+        simd<float, 4>::transpose(r4._lo, r5._lo, r6._lo, r7._lo);
+        simd<float, 4>::transpose(r4._hi, r5._hi, r6._hi, r7._hi);
+        std::swap(r0._hi, r4._lo);
+        std::swap(r1._hi, r5._lo);
+        std::swap(r2._hi, r6._lo);
+        std::swap(r3._hi, r7._lo);
+    }
+
+private:
+    simd<float, 4> _lo;
+    simd<float, 4> _hi;
+};
+
+using simdf8 = simd<float, 8>;
+
+SIMD_NAMESPACE_END
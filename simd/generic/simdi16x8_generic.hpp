@@ -0,0 +1,49 @@
+#pragma once
+
+#include "lanes_generic.hpp"
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdi16x8 comparison, one bit per lane.
+*/
+template <>
+class simd_mask<int16_t, 8> : public priv::generic_mask<simd_mask<int16_t, 8>, 8> {
+public:
+    using generic_mask::generic_mask;
+
+    simd_mask() noexcept = default;
+    simd_mask(bool s0, bool s1, bool s2, bool s3,
+        bool s4, bool s5, bool s6, bool s7) noexcept
+        : generic_mask(bits_of({ s0, s1, s2, s3, s4, s5, s6, s7 }))
+    {
+    }
+};
+
+/**
+    8 x int16_t of the portable backend.
+*/
+template <>
+class simd<int16_t, 8> : public priv::generic_integer<simd<int16_t, 8>, int16_t, 8, int32_t> {
+public:
+    using generic_integer::generic_integer;
+
+    simd() noexcept = default;
+    simd(int16_t s0, int16_t s1, int16_t s2, int16_t s3,
+        int16_t s4, int16_t s5, int16_t s6, int16_t s7) noexcept
+        : generic_integer(register_type{ s0, s1, s2, s3, s4, s5, s6, s7 })
+    {
+    }
+
+    /**
+        |x|, the lowest value of int16_t stays unchanged.
+    */
+    simd abs() const noexcept
+    {
+        return this->map([](int16_t a) { return a < 0 ? static_cast<int16_t>(0u - static_cast<uint16_t>(a)) : a; });
+    }
+};
+
+using simdi16x8 = simd<int16_t, 8>;
+
+SIMD_NAMESPACE_END
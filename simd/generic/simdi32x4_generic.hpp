@@ -0,0 +1,47 @@
+#pragma once
+
+#include "lanes_generic.hpp"
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdi32x4 comparison, one bit per lane.
+*/
+template <>
+class simd_mask<int32_t, 4> : public priv::generic_mask<simd_mask<int32_t, 4>, 4> {
+public:
+    using generic_mask::generic_mask;
+
+    simd_mask() noexcept = default;
+    simd_mask(bool s0, bool s1, bool s2, bool s3) noexcept
+        : generic_mask(bits_of({ s0, s1, s2, s3 }))
+    {
+    }
+};
+
+/**
+    4 x int32_t of the portable backend.
+*/
+template <>
+class simd<int32_t, 4> : public priv::generic_integer<simd<int32_t, 4>, int32_t, 4, int64_t> {
+public:
+    using generic_integer::generic_integer;
+
+    simd() noexcept = default;
+    simd(int32_t s0, int32_t s1, int32_t s2, int32_t s3) noexcept
+        : generic_integer(register_type{ s0, s1, s2, s3 })
+    {
+    }
+
+    /**
+        |x|, the lowest value of int32_t stays unchanged.
+    */
+    simd abs() const noexcept
+    {
+        return this->map([](int32_t a) { return a < 0 ? static_cast<int32_t>(0u - static_cast<uint32_t>(a)) : a; });
+    }
+};
+
+using simdi32x4 = simd<int32_t, 4>;
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "lanes_generic.hpp"
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdu16x8 comparison, one bit per lane.
+*/
+template <>
+class simd_mask<uint16_t, 8> : public priv::generic_mask<simd_mask<uint16_t, 8>, 8> {
+public:
+    using generic_mask::generic_mask;
+
+    simd_mask() noexcept = default;
+    simd_mask(bool s0, bool s1, bool s2, bool s3,
+        bool s4, bool s5, bool s6, bool s7) noexcept
+        : generic_mask(bits_of({ s0, s1, s2, s3, s4, s5, s6, s7 }))
+    {
+    }
+};
+
+/**
+    8 x uint16_t of the portable backend. As in the other backends operator+ and operator-
+    saturate; add_wrap and subtract_wrap wrap around, operator* wraps.
+*/
+template <>
+class simd<uint16_t, 8> : public priv::generic_integer<simd<uint16_t, 8>, uint16_t, 8, uint32_t> {
+public:
+    using generic_integer::generic_integer;
+
+    simd() noexcept = default;
+    simd(uint16_t s0, uint16_t s1, uint16_t s2, uint16_t s3,
+        uint16_t s4, uint16_t s5, uint16_t s6, uint16_t s7) noexcept
+        : generic_integer(register_type{ s0, s1, s2, s3, s4, s5, s6, s7 })
+    {
+    }
+    explicit simd(const uint16_t* inputLo, const uint16_t* inputHi) noexcept
+        : simd(inputLo[0], inputLo[1], inputLo[2], inputLo[3],
+              inputHi[0], inputHi[1], inputHi[2], inputHi[3])
+    {
+    }
+    /**
+        Loads 8 unsigned 8 bit integers from memory and converts them to 16 bit values.
+        @param input Memory to load the values from. This pointer needs to point to allocation of at least 8 bytes.
+    */
+    explicit simd(const uint8_t* input) noexcept
+        : simd(input[0], input[1], input[2], input[3], input[4], input[5], input[6], input[7])
+    {
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return this->add_saturate(other);
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        return *this = this->add_saturate(other);
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return this->subtract_saturate(other);
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        return *this = this->subtract_saturate(other);
+    }
+    /**
+        Wrapping a + b, unlike operator+ which saturates.
+    */
+    simd add_wrap(const simd& other) const noexcept
+    {
+        return generic_integer::operator+(other);
+    }
+    /**
+        Wrapping a - b, unlike operator- which saturates.
+    */
+    simd subtract_wrap(const simd& other) const noexcept
+    {
+        return generic_integer::operator-(other);
+    }
+
+    /**
+        Sum of all lanes clamped to 65535.
+    */
+    uint16_t sum_saturate() const noexcept
+    {
+        const uint32_t total = this->sum();
+        return static_cast<uint16_t>(total < 0xffff ? total : 0xffff);
+    }
+};
+
+using simdu16x8 = simd<uint16_t, 8>;
+
+SIMD_NAMESPACE_END
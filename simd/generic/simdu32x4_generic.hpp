@@ -0,0 +1,39 @@
+#pragma once
+
+#include "lanes_generic.hpp"
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdu32x4 comparison, one bit per lane.
+*/
+template <>
+class simd_mask<uint32_t, 4> : public priv::generic_mask<simd_mask<uint32_t, 4>, 4> {
+public:
+    using generic_mask::generic_mask;
+
+    simd_mask() noexcept = default;
+    simd_mask(bool s0, bool s1, bool s2, bool s3) noexcept
+        : generic_mask(bits_of({ s0, s1, s2, s3 }))
+    {
+    }
+};
+
+/**
+    4 x uint32_t of the portable backend.
+*/
+template <>
+class simd<uint32_t, 4> : public priv::generic_integer<simd<uint32_t, 4>, uint32_t, 4, uint64_t> {
+public:
+    using generic_integer::generic_integer;
+
+    simd() noexcept = default;
+    simd(uint32_t s0, uint32_t s1, uint32_t s2, uint32_t s3) noexcept
+        : generic_integer(register_type{ s0, s1, s2, s3 })
+    {
+    }
+};
+
+using simdu32x4 = simd<uint32_t, 4>;
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "lanes_generic.hpp"
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdu8x16 comparison, one bit per lane.
+*/
+template <>
+class simd_mask<uint8_t, 16> : public priv::generic_mask<simd_mask<uint8_t, 16>, 16> {
+public:
+    using generic_mask::generic_mask;
+
+    simd_mask() noexcept = default;
+};
+
+/**
+    16 x uint8_t of the portable backend.
+*/
+template <>
+class simd<uint8_t, 16> : public priv::generic_integer<simd<uint8_t, 16>, uint8_t, 16, uint32_t> {
+public:
+    using generic_integer::generic_integer;
+
+    simd() noexcept = default;
+    simd(uint8_t s0, uint8_t s1, uint8_t s2, uint8_t s3,
+        uint8_t s4, uint8_t s5, uint8_t s6, uint8_t s7,
+        uint8_t s8, uint8_t s9, uint8_t s10, uint8_t s11,
+        uint8_t s12, uint8_t s13, uint8_t s14, uint8_t s15) noexcept
+        : generic_integer(register_type{ s0, s1, s2, s3, s4, s5, s6, s7,
+            s8, s9, s10, s11, s12, s13, s14, s15 })
+    {
+    }
+};
+
+using simdu8x16 = simd<uint8_t, 16>;
+
+SIMD_NAMESPACE_END
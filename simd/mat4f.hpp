@@ -0,0 +1,213 @@
+#pragma once
+
+#include "simdf4.hpp"
+#include "vec3f.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    4x4 float matrix, stored as 4 simdf4 columns. Vectors are columns, i.e. a * b applies b
+    first, and the translation is in column 3.
+
+        mat4f m = mat4f::identity();
+        m = projection * view * model;
+        simdf4 clip = m * simdf4(x, y, z, 1.0f);
+*/
+class mat4f {
+public:
+    /**
+        Zero matrix, like the default constructed simd types.
+    */
+    mat4f() noexcept = default;
+    mat4f(const simdf4& c0, const simdf4& c1, const simdf4& c2, const simdf4& c3) noexcept
+        : _c{ c0, c1, c2, c3 }
+    {
+    }
+    /**
+        Loads 16 floats in column-major order (as OpenGL expects them).
+    */
+    explicit mat4f(const float* column_major) noexcept
+        : _c{ simdf4(column_major), simdf4(column_major + 4), simdf4(column_major + 8), simdf4(column_major + 12) }
+    {
+    }
+    /**
+        Loads 16 floats in row-major order (as D3D and C arrays are usually written).
+    */
+    static mat4f from_rows(const float* row_major) noexcept
+    {
+        return mat4f(row_major).transpose();
+    }
+    static mat4f identity() noexcept
+    {
+        return mat4f{ simdf4(1, 0, 0, 0), simdf4(0, 1, 0, 0), simdf4(0, 0, 1, 0), simdf4(0, 0, 0, 1) };
+    }
+
+    /**
+        Stores 16 floats in column-major order.
+    */
+    void store(float* column_major) const noexcept
+    {
+        for (size_t i = 0; i < 4; ++i)
+            this->_c[i].store(column_major + 4 * i);
+    }
+    const simdf4& column(size_t index) const noexcept
+    {
+        return this->_c[index];
+    }
+    float operator()(size_t row, size_t column) const noexcept
+    {
+        return this->_c[column].to_array()[row];
+    }
+
+    /**
+        Matrix product, column j of the result is this * other.column(j).
+    */
+    mat4f operator*(const mat4f& other) const noexcept
+    {
+        return mat4f{ *this * other._c[0], *this * other._c[1], *this * other._c[2], *this * other._c[3] };
+    }
+    mat4f& operator*=(const mat4f& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    /**
+        Matrix times column vector, as a sum of the columns scaled by the lanes of v.
+    */
+    simdf4 operator*(const simdf4& v) const noexcept
+    {
+        const simdf4 xy = simdf4::fma(this->_c[1], v.permute<1, 1, 1, 1>(), this->_c[0] * v.permute<0, 0, 0, 0>());
+        const simdf4 zw = simdf4::fma(this->_c[3], v.permute<3, 3, 3, 3>(), this->_c[2] * v.permute<2, 2, 2, 2>());
+        return xy + zw;
+    }
+
+    mat4f transpose() const noexcept
+    {
+        mat4f result = *this;
+        simdf4::transpose(result._c[0], result._c[1], result._c[2], result._c[3]);
+        return result;
+    }
+
+    /**
+        Inverse through 2x2 blocks and their adjugates. Singular matrices give infinities or NaNs,
+        check determinant() first when the input may be singular.
+    */
+    mat4f inverse() const noexcept
+    {
+        // The block formulas are written for rows; running them on the columns inverts the
+        // transpose, whose rows are the columns of the inverse.
+        simdf4 a, b, c, d;
+        this->blocks(a, b, c, d);
+        const simdf4 determinants = this->block_determinants();
+        const simdf4 det_a = determinants.permute<0, 0, 0, 0>();
+        const simdf4 det_b = determinants.permute<1, 1, 1, 1>();
+        const simdf4 det_c = determinants.permute<2, 2, 2, 2>();
+        const simdf4 det_d = determinants.permute<3, 3, 3, 3>();
+
+        const simdf4 d_c = adjugate_multiply(d, c);
+        const simdf4 a_b = adjugate_multiply(a, b);
+        // the adjugates of the blocks of the inverse
+        const simdf4 x = det_d * a - multiply(b, d_c);
+        const simdf4 w = det_a * d - multiply(c, a_b);
+        const simdf4 y = det_b * c - multiply_adjugate(d, a_b);
+        const simdf4 z = det_c * b - multiply_adjugate(a, d_c);
+
+        // |M| = |a| |d| + |b| |c| - trace((a# b) (d# c))
+        const float trace = (a_b * d_c.permute<0, 2, 1, 3>()).reduce_add();
+        const simdf4 determinant = det_a * det_d + det_b * det_c - simdf4(trace);
+        const simdf4 scale = simdf4(1, -1, -1, 1) / determinant;
+
+        const simdf4 xs = x * scale;
+        const simdf4 ys = y * scale;
+        const simdf4 zs = z * scale;
+        const simdf4 ws = w * scale;
+        return mat4f{ simdf4::shuffle<3, 1, 3, 1>(xs, ys), simdf4::shuffle<2, 0, 2, 0>(xs, ys),
+            simdf4::shuffle<3, 1, 3, 1>(zs, ws), simdf4::shuffle<2, 0, 2, 0>(zs, ws) };
+    }
+    float determinant() const noexcept
+    {
+        simdf4 a, b, c, d;
+        this->blocks(a, b, c, d);
+        const auto det = this->block_determinants().to_array();
+        const float trace = (adjugate_multiply(a, b) * adjugate_multiply(d, c).permute<0, 2, 1, 3>()).reduce_add();
+        return det[0] * det[3] + det[1] * det[2] - trace;
+    }
+
+private:
+    /**
+        The 2x2 blocks of the transpose, each in row-major order:
+        | a b |
+        | c d |
+    */
+    void blocks(simdf4& a, simdf4& b, simdf4& c, simdf4& d) const noexcept
+    {
+        a = simdf4::shuffle<0, 1, 0, 1>(this->_c[0], this->_c[1]);
+        b = simdf4::shuffle<2, 3, 2, 3>(this->_c[0], this->_c[1]);
+        c = simdf4::shuffle<0, 1, 0, 1>(this->_c[2], this->_c[3]);
+        d = simdf4::shuffle<2, 3, 2, 3>(this->_c[2], this->_c[3]);
+    }
+    /**
+        { |a|, |b|, |c|, |d| }
+    */
+    simdf4 block_determinants() const noexcept
+    {
+        return simdf4::shuffle<0, 2, 0, 2>(this->_c[0], this->_c[2]) * simdf4::shuffle<1, 3, 1, 3>(this->_c[1], this->_c[3])
+            - simdf4::shuffle<1, 3, 1, 3>(this->_c[0], this->_c[2]) * simdf4::shuffle<0, 2, 0, 2>(this->_c[1], this->_c[3]);
+    }
+    // 2x2 blocks in row-major order: a * b, a# * b and a * b# (# is the adjugate)
+    static simdf4 multiply(const simdf4& a, const simdf4& b) noexcept
+    {
+        return a * b.permute<0, 3, 0, 3>() + a.permute<1, 0, 3, 2>() * b.permute<2, 1, 2, 1>();
+    }
+    static simdf4 adjugate_multiply(const simdf4& a, const simdf4& b) noexcept
+    {
+        return a.permute<3, 3, 0, 0>() * b - a.permute<1, 1, 2, 2>() * b.permute<2, 3, 0, 1>();
+    }
+    static simdf4 multiply_adjugate(const simdf4& a, const simdf4& b) noexcept
+    {
+        return a * b.permute<3, 0, 3, 0>() - a.permute<1, 0, 3, 2>() * b.permute<2, 1, 2, 1>();
+    }
+
+    simdf4 _c[4];
+};
+
+/**
+    output[i] = m * (input[i], 1) for count points, dropping w: the bottom row of m is taken as
+    (0, 0, 0, 1) and not read, so projections need a divide by w of their own.
+    Four points (three registers) are loaded at a time and transposed to x, y and z registers,
+    then each output coordinate is three fmas. input and output may be the same array.
+*/
+inline void transform_points(const vec3f* input, size_t count, vec3f* output, const mat4f& m) noexcept
+{
+    const auto c0 = m.column(0).to_array();
+    const auto c1 = m.column(1).to_array();
+    const auto c2 = m.column(2).to_array();
+    const auto c3 = m.column(3).to_array();
+    // m(row, column) broadcast
+    const simdf4 m00(c0[0]), m01(c1[0]), m02(c2[0]), m03(c3[0]);
+    const simdf4 m10(c0[1]), m11(c1[1]), m12(c2[1]), m13(c3[1]);
+    const simdf4 m20(c0[2]), m21(c1[2]), m22(c2[2]), m23(c3[2]);
+
+    const auto transform_4 = [&](const vec3f* in, vec3f* out) {
+        const vec3f4 p = vec3f4::load(in);
+        const simdf4 x = simdf4::fma(m02, p.z, simdf4::fma(m01, p.y, simdf4::fma(m00, p.x, m03)));
+        const simdf4 y = simdf4::fma(m12, p.z, simdf4::fma(m11, p.y, simdf4::fma(m10, p.x, m13)));
+        const simdf4 z = simdf4::fma(m22, p.z, simdf4::fma(m21, p.y, simdf4::fma(m20, p.x, m23)));
+        vec3f4{ x, y, z }.store(out);
+    };
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        transform_4(input + i, output + i);
+    if (i < count) {
+        // the tail goes through a buffer, so it is rounded exactly like the body
+        vec3f buffer[4] = {};
+        std::memcpy(buffer, input + i, (count - i) * sizeof(vec3f));
+        transform_4(buffer, buffer);
+        std::memcpy(output + i, buffer, (count - i) * sizeof(vec3f));
+    }
+}
+
+SIMD_NAMESPACE_END
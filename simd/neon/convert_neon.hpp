@@ -0,0 +1,174 @@
+#pragma once
+
+extern "C" {
+#include <arm_neon.h>
+}
+
+SIMD_NAMESPACE_BEGIN
+
+namespace simd_convert {
+namespace priv {
+    /**
+        Rounds to the nearest integral float, ties to even.
+    */
+    inline float32x4_t round_nearest(float32x4_t value) noexcept
+    {
+#if defined(__aarch64__)
+        return vrndnq_f32(value);
+#else
+        // adding and subtracting 1.5 * 2^23 drops the fraction bits, magnitudes from 2^22 up are integral already
+        const float32x4_t magic = vdupq_n_f32(12582912.0f);
+        const float32x4_t rounded = vsubq_f32(vaddq_f32(value, magic), magic);
+        return vbslq_f32(vcaltq_f32(value, vdupq_n_f32(4194304.0f)), rounded, value);
+#endif
+    }
+
+    template <>
+    struct converter<simd<int32_t, 4>, simd<float, 4>> {
+        static simd<int32_t, 4> convert(const simd<float, 4>& value) noexcept
+        {
+            return simd<int32_t, 4>{ vcvtq_s32_f32(value.native()) };
+        }
+        static simd<int32_t, 4> convert_nearest(const simd<float, 4>& value) noexcept
+        {
+#if defined(__aarch64__)
+            return simd<int32_t, 4>{ vcvtnq_s32_f32(value.native()) };
+#else
+            return simd<int32_t, 4>{ vcvtq_s32_f32(round_nearest(value.native())) };
+#endif
+        }
+    };
+    template <>
+    struct converter<simd<uint32_t, 4>, simd<float, 4>> {
+        static simd<uint32_t, 4> convert(const simd<float, 4>& value) noexcept
+        {
+            return simd<uint32_t, 4>{ vcvtq_u32_f32(value.native()) };
+        }
+        static simd<uint32_t, 4> convert_nearest(const simd<float, 4>& value) noexcept
+        {
+#if defined(__aarch64__)
+            return simd<uint32_t, 4>{ vcvtnq_u32_f32(value.native()) };
+#else
+            return simd<uint32_t, 4>{ vcvtq_u32_f32(round_nearest(value.native())) };
+#endif
+        }
+    };
+    template <>
+    struct converter<simd<float, 4>, simd<int32_t, 4>> {
+        static simd<float, 4> convert(const simd<int32_t, 4>& value) noexcept
+        {
+            return simd<float, 4>{ vcvtq_f32_s32(value.native()) };
+        }
+    };
+    template <>
+    struct converter<simd<float, 4>, simd<uint32_t, 4>> {
+        static simd<float, 4> convert(const simd<uint32_t, 4>& value) noexcept
+        {
+            return simd<float, 4>{ vcvtq_f32_u32(value.native()) };
+        }
+    };
+    template <>
+    struct converter<simd<uint32_t, 4>, simd<int32_t, 4>> {
+        static simd<uint32_t, 4> convert(const simd<int32_t, 4>& value) noexcept
+        {
+            return simd<uint32_t, 4>{ vreinterpretq_u32_s32(value.native()) };
+        }
+    };
+    template <>
+    struct converter<simd<int32_t, 4>, simd<uint32_t, 4>> {
+        static simd<int32_t, 4> convert(const simd<uint32_t, 4>& value) noexcept
+        {
+            return simd<int32_t, 4>{ vreinterpretq_s32_u32(value.native()) };
+        }
+    };
+    template <>
+    struct converter<simd<uint16_t, 8>, simd<int16_t, 8>> {
+        static simd<uint16_t, 8> convert(const simd<int16_t, 8>& value) noexcept
+        {
+            return simd<uint16_t, 8>{ vreinterpretq_u16_s16(value.native()) };
+        }
+    };
+    template <>
+    struct converter<simd<int16_t, 8>, simd<uint16_t, 8>> {
+        static simd<int16_t, 8> convert(const simd<uint16_t, 8>& value) noexcept
+        {
+            return simd<int16_t, 8>{ vreinterpretq_s16_u16(value.native()) };
+        }
+    };
+
+    template <>
+    struct widener<simd<uint8_t, 16>> {
+        using type = simd<uint16_t, 8>;
+        static type low(const simd<uint8_t, 16>& value) noexcept
+        {
+            return type{ vmovl_u8(vget_low_u8(value.native())) };
+        }
+        static type high(const simd<uint8_t, 16>& value) noexcept
+        {
+            return type{ vmovl_u8(vget_high_u8(value.native())) };
+        }
+    };
+    template <>
+    struct widener<simd<uint16_t, 8>> {
+        using type = simd<uint32_t, 4>;
+        static type low(const simd<uint16_t, 8>& value) noexcept
+        {
+            return type{ vmovl_u16(vget_low_u16(value.native())) };
+        }
+        static type high(const simd<uint16_t, 8>& value) noexcept
+        {
+            return type{ vmovl_u16(vget_high_u16(value.native())) };
+        }
+    };
+    template <>
+    struct widener<simd<int16_t, 8>> {
+        using type = simd<int32_t, 4>;
+        static type low(const simd<int16_t, 8>& value) noexcept
+        {
+            return type{ vmovl_s16(vget_low_s16(value.native())) };
+        }
+        static type high(const simd<int16_t, 8>& value) noexcept
+        {
+            return type{ vmovl_s16(vget_high_s16(value.native())) };
+        }
+    };
+
+    template <>
+    struct narrower<simd<int16_t, 8>, simd<int32_t, 4>> {
+        static simd<int16_t, 8> saturate(const simd<int32_t, 4>& low, const simd<int32_t, 4>& high) noexcept
+        {
+            return simd<int16_t, 8>{ vcombine_s16(vqmovn_s32(low.native()), vqmovn_s32(high.native())) };
+        }
+    };
+    template <>
+    struct narrower<simd<uint16_t, 8>, simd<int32_t, 4>> {
+        static simd<uint16_t, 8> saturate(const simd<int32_t, 4>& low, const simd<int32_t, 4>& high) noexcept
+        {
+            return simd<uint16_t, 8>{ vcombine_u16(vqmovun_s32(low.native()), vqmovun_s32(high.native())) };
+        }
+    };
+    template <>
+    struct narrower<simd<uint16_t, 8>, simd<uint32_t, 4>> {
+        static simd<uint16_t, 8> saturate(const simd<uint32_t, 4>& low, const simd<uint32_t, 4>& high) noexcept
+        {
+            return simd<uint16_t, 8>{ vcombine_u16(vqmovn_u32(low.native()), vqmovn_u32(high.native())) };
+        }
+    };
+    template <>
+    struct narrower<simd<uint8_t, 16>, simd<int16_t, 8>> {
+        static simd<uint8_t, 16> saturate(const simd<int16_t, 8>& low, const simd<int16_t, 8>& high) noexcept
+        {
+            return simd<uint8_t, 16>{ vcombine_u8(vqmovun_s16(low.native()), vqmovun_s16(high.native())) };
+        }
+    };
+    template <>
+    struct narrower<simd<uint8_t, 16>, simd<uint16_t, 8>> {
+        static simd<uint8_t, 16> saturate(const simd<uint16_t, 8>& low, const simd<uint16_t, 8>& high) noexcept
+        {
+            return simd<uint8_t, 16>{ vcombine_u8(vqmovn_u16(low.native()), vqmovn_u16(high.native())) };
+        }
+    };
+} // namespace priv
+} // namespace simd_convert
+
+SIMD_NAMESPACE_END
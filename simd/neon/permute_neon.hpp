@@ -0,0 +1,252 @@
+#pragma once
+
+#include "../permute_pattern.hpp"
+
+extern "C" {
+#include <arm_neon.h>
+}
+
+#include <cstdint>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    permute<idx...>() for the 128 bit NEON registers. Broadcasts, rotations (vext), reversals
+    (vrev), zip / unzip / transpose of the register with itself and lanes moving in wider groups
+    take one or two instructions; other 32 bit patterns combine two 64 bit halves, other narrow
+    patterns use a table lookup (vqtbl1q on AArch64, two vtbl2 on ARMv7).
+*/
+namespace priv {
+
+template <typename P>
+constexpr permute_strategy neon_permute_strategy() noexcept
+{
+    return P::is_identity() ? permute_identity
+        : P::is_broadcast() ? permute_broadcast
+        : P::rotation() != 0 ? permute_rotate
+        : P::reverse_mask() != 0 && (P::reverse_mask() & (P::reverse_mask() + 1)) == 0
+            && (P::reverse_mask() < P::lane_count / 2 || P::reverse_mask() == P::lane_count - 1)
+        ? permute_reverse
+        : P::is_interleave(permute_zip_low) ? permute_zip_low
+        : P::is_interleave(permute_zip_high) ? permute_zip_high
+        : P::is_interleave(permute_unzip_even) ? permute_unzip_even
+        : P::is_interleave(permute_unzip_odd) ? permute_unzip_odd
+        : P::is_interleave(permute_transpose_even) ? permute_transpose_even
+        : P::is_interleave(permute_transpose_odd) ? permute_transpose_odd
+        : P::lane_count > 4 && P::is_grouped(2) ? permute_grouped
+                                                : permute_general;
+}
+
+/**
+    { value[x], value[y] }, at most one instruction besides taking the 64 bit halves.
+*/
+template <unsigned x, unsigned y>
+uint32x2_t neon_pick2(uint32x4_t value) noexcept
+{
+    const uint32x2_t hx = x < 2 ? vget_low_u32(value) : vget_high_u32(value);
+    const uint32x2_t hy = y < 2 ? vget_low_u32(value) : vget_high_u32(value);
+    if (x % 2 == 0 && y % 2 == 1)
+        return (x < 2) == (y < 2) ? hx : vbsl_u32(vcreate_u32(0xffffffff00000000ull), hy, hx);
+    if (x % 2 == 1 && y % 2 == 0)
+        return vext_u32(hx, hy, 1);
+    return vzip_u32(hx, hy).val[x % 2];
+}
+
+template <typename P, size_t... b>
+uint8x16_t neon_permute_table(uint8x16_t value, std::index_sequence<b...>) noexcept
+{
+    alignas(16) static const uint8_t table[16] = { static_cast<uint8_t>(P::byte_at(16 / P::lane_count, b))... };
+    const uint8x16_t indices = vld1q_u8(table);
+#if defined(__aarch64__)
+    return vqtbl1q_u8(value, indices);
+#else
+    const uint8x8x2_t source = { { vget_low_u8(value), vget_high_u8(value) } };
+    return vcombine_u8(vtbl2_u8(source, vget_low_u8(indices)), vtbl2_u8(source, vget_high_u8(indices)));
+#endif
+}
+
+// 32 bit lanes
+
+template <typename P>
+uint32x4_t neon_permute(uint32x4_t value, permute_tag<permute_identity>) noexcept
+{
+    return value;
+}
+template <typename P>
+uint32x4_t neon_permute(uint32x4_t value, permute_tag<permute_broadcast>) noexcept
+{
+#if defined(__aarch64__)
+    return vdupq_laneq_u32(value, P::at(0));
+#else
+    return vdupq_lane_u32(P::at(0) < 2 ? vget_low_u32(value) : vget_high_u32(value), P::at(0) % 2);
+#endif
+}
+template <typename P>
+uint32x4_t neon_permute(uint32x4_t value, permute_tag<permute_rotate>) noexcept
+{
+    return vextq_u32(value, value, P::rotation());
+}
+template <typename P>
+uint32x4_t neon_permute(uint32x4_t value, permute_tag<permute_reverse>) noexcept
+{
+    const uint32x4_t pairs = vrev64q_u32(value);
+    return P::reverse_mask() == 1 ? pairs : vextq_u32(pairs, pairs, 2);
+}
+/**
+    zip / unzip / transpose of the register with itself.
+*/
+template <typename P, permute_strategy S>
+uint32x4_t neon_permute(uint32x4_t value, permute_tag<S>) noexcept
+{
+    return S == permute_zip_low ? vzipq_u32(value, value).val[0]
+        : S == permute_zip_high ? vzipq_u32(value, value).val[1]
+        : S == permute_unzip_even ? vuzpq_u32(value, value).val[0]
+        : S == permute_unzip_odd ? vuzpq_u32(value, value).val[1]
+        : S == permute_transpose_even ? vtrnq_u32(value, value).val[0]
+                                      : vtrnq_u32(value, value).val[1];
+}
+template <typename P>
+uint32x4_t neon_permute(uint32x4_t value, permute_tag<permute_general>) noexcept
+{
+    return vcombine_u32(neon_pick2<P::at(0), P::at(1)>(value), neon_pick2<P::at(2), P::at(3)>(value));
+}
+template <unsigned... idx>
+uint32x4_t neon_permute(uint32x4_t value) noexcept
+{
+    using P = permute_pattern<idx...>;
+    static_assert(P::lane_count == 4, "permute needs one index per lane");
+    static_assert(P::in_range(), "permute lane index out of range");
+    return neon_permute<P>(value, permute_tag<neon_permute_strategy<P>()>{});
+}
+
+// 16 bit lanes
+
+template <typename P>
+uint16x8_t neon_permute(uint16x8_t value, permute_tag<permute_identity>) noexcept
+{
+    return value;
+}
+template <typename P>
+uint16x8_t neon_permute(uint16x8_t value, permute_tag<permute_broadcast>) noexcept
+{
+#if defined(__aarch64__)
+    return vdupq_laneq_u16(value, P::at(0));
+#else
+    return vdupq_lane_u16(P::at(0) < 4 ? vget_low_u16(value) : vget_high_u16(value), P::at(0) % 4);
+#endif
+}
+template <typename P>
+uint16x8_t neon_permute(uint16x8_t value, permute_tag<permute_rotate>) noexcept
+{
+    return vextq_u16(value, value, P::rotation());
+}
+template <typename P>
+uint16x8_t neon_permute(uint16x8_t value, permute_tag<permute_reverse>) noexcept
+{
+    if (P::reverse_mask() == 1)
+        return vrev32q_u16(value);
+    const uint16x8_t quads = vrev64q_u16(value);
+    return P::reverse_mask() == 3 ? quads : vextq_u16(quads, quads, 4);
+}
+template <typename P, permute_strategy S>
+uint16x8_t neon_permute(uint16x8_t value, permute_tag<S>) noexcept
+{
+    return S == permute_zip_low ? vzipq_u16(value, value).val[0]
+        : S == permute_zip_high ? vzipq_u16(value, value).val[1]
+        : S == permute_unzip_even ? vuzpq_u16(value, value).val[0]
+        : S == permute_unzip_odd ? vuzpq_u16(value, value).val[1]
+        : S == permute_transpose_even ? vtrnq_u16(value, value).val[0]
+                                      : vtrnq_u16(value, value).val[1];
+}
+template <typename P, size_t... g>
+uint16x8_t neon_permute_groups(uint16x8_t value, std::index_sequence<g...>) noexcept
+{
+    return vreinterpretq_u16_u32(neon_permute<P::group_at(2, g)...>(vreinterpretq_u32_u16(value)));
+}
+template <typename P>
+uint16x8_t neon_permute(uint16x8_t value, permute_tag<permute_grouped>) noexcept
+{
+    return neon_permute_groups<P>(value, std::make_index_sequence<4>{});
+}
+template <typename P>
+uint16x8_t neon_permute(uint16x8_t value, permute_tag<permute_general>) noexcept
+{
+    return vreinterpretq_u16_u8(neon_permute_table<P>(vreinterpretq_u8_u16(value), std::make_index_sequence<16>{}));
+}
+template <unsigned... idx>
+uint16x8_t neon_permute(uint16x8_t value) noexcept
+{
+    using P = permute_pattern<idx...>;
+    static_assert(P::lane_count == 8, "permute needs one index per lane");
+    static_assert(P::in_range(), "permute lane index out of range");
+    return neon_permute<P>(value, permute_tag<neon_permute_strategy<P>()>{});
+}
+
+// 8 bit lanes
+
+template <typename P>
+uint8x16_t neon_permute(uint8x16_t value, permute_tag<permute_identity>) noexcept
+{
+    return value;
+}
+template <typename P>
+uint8x16_t neon_permute(uint8x16_t value, permute_tag<permute_broadcast>) noexcept
+{
+#if defined(__aarch64__)
+    return vdupq_laneq_u8(value, P::at(0));
+#else
+    return vdupq_lane_u8(P::at(0) < 8 ? vget_low_u8(value) : vget_high_u8(value), P::at(0) % 8);
+#endif
+}
+template <typename P>
+uint8x16_t neon_permute(uint8x16_t value, permute_tag<permute_rotate>) noexcept
+{
+    return vextq_u8(value, value, P::rotation());
+}
+template <typename P>
+uint8x16_t neon_permute(uint8x16_t value, permute_tag<permute_reverse>) noexcept
+{
+    if (P::reverse_mask() == 1)
+        return vrev16q_u8(value);
+    if (P::reverse_mask() == 3)
+        return vrev32q_u8(value);
+    const uint8x16_t octets = vrev64q_u8(value);
+    return P::reverse_mask() == 7 ? octets : vextq_u8(octets, octets, 8);
+}
+template <typename P, permute_strategy S>
+uint8x16_t neon_permute(uint8x16_t value, permute_tag<S>) noexcept
+{
+    return S == permute_zip_low ? vzipq_u8(value, value).val[0]
+        : S == permute_zip_high ? vzipq_u8(value, value).val[1]
+        : S == permute_unzip_even ? vuzpq_u8(value, value).val[0]
+        : S == permute_unzip_odd ? vuzpq_u8(value, value).val[1]
+        : S == permute_transpose_even ? vtrnq_u8(value, value).val[0]
+                                      : vtrnq_u8(value, value).val[1];
+}
+template <typename P, size_t... g>
+uint8x16_t neon_permute_groups(uint8x16_t value, std::index_sequence<g...>) noexcept
+{
+    return vreinterpretq_u8_u16(neon_permute<P::group_at(2, g)...>(vreinterpretq_u16_u8(value)));
+}
+template <typename P>
+uint8x16_t neon_permute(uint8x16_t value, permute_tag<permute_grouped>) noexcept
+{
+    return neon_permute_groups<P>(value, std::make_index_sequence<8>{});
+}
+template <typename P>
+uint8x16_t neon_permute(uint8x16_t value, permute_tag<permute_general>) noexcept
+{
+    return neon_permute_table<P>(value, std::make_index_sequence<16>{});
+}
+template <unsigned... idx>
+uint8x16_t neon_permute(uint8x16_t value) noexcept
+{
+    using P = permute_pattern<idx...>;
+    static_assert(P::lane_count == 16, "permute needs one index per lane");
+    static_assert(P::in_range(), "permute lane index out of range");
+    return neon_permute<P>(value, permute_tag<neon_permute_strategy<P>()>{});
+}
+
+} // namespace priv
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,427 @@
+#pragma once
+
+#include "simdf4_neon.hpp"
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdd2 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<double, 2> {
+public:
+    static constexpr size_t value_count = 2;
+
+    simd_mask() noexcept
+        : _m(vdupq_n_u64(0))
+    {
+    }
+    simd_mask(bool s0, bool s1) noexcept
+        : _m(vcombine_u64(vdup_n_u64(s0 ? ~uint64_t(0) : 0), vdup_n_u64(s1 ? ~uint64_t(0) : 0)))
+    {
+    }
+    explicit simd_mask(uint64x2_t value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        return simd_mask{ (bits & 1) != 0, (bits & 2) != 0 };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        return simd_mask{ count >= 1, count >= 2 };
+    }
+
+    uint64x2_t native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return static_cast<uint32_t>((vgetq_lane_u64(this->_m, 0) & 1) | ((vgetq_lane_u64(this->_m, 1) & 1) << 1));
+    }
+    bool any() const noexcept
+    {
+        return this->movemask() != 0;
+    }
+    bool all() const noexcept
+    {
+        return this->movemask() == 0x3;
+    }
+    bool none() const noexcept
+    {
+        return this->movemask() == 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vandq_u64(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vorrq_u64(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ veorq_u64(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ veorq_u64(this->_m, vdupq_n_u64(~uint64_t(0))) };
+    }
+
+private:
+    uint64x2_t _m;
+};
+
+/**
+    2 x double, AArch64 only: ARMv7 NEON has no double precision lanes.
+*/
+template <>
+class simd<double, 2> : public simd_common<simd<double, 2>> {
+public:
+    using type = double;
+    using mask_type = simd_mask<double, 2>;
+    static constexpr size_t value_count = 2;
+
+    simd() noexcept
+        : _d(vdupq_n_f64(0))
+    {
+    }
+    explicit simd(double value) noexcept
+        : _d(vdupq_n_f64(value))
+    {
+    }
+    simd(double s0, double s1) noexcept
+        : _d(vcombine_f64(vdup_n_f64(s0), vdup_n_f64(s1)))
+    {
+    }
+    explicit simd(float64x2_t value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const double* input) noexcept
+        : _d(vld1q_f64(input))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const double* input, size_t count) noexcept
+    {
+        switch (count) {
+        case 0:
+            return simd{};
+        case 1:
+            return simd{ vcombine_f64(vld1_f64(input), vdup_n_f64(0)) };
+        default:
+            return simd{ vld1q_f64(input) };
+        }
+    }
+
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const double* input) noexcept
+    {
+        return simd{ vld1q_f64(input) };
+    }
+
+    /**
+        Converts the low two lanes of a simdf4.
+    */
+    static simd from_float_low(const simd<float, 4>& value) noexcept
+    {
+        return simd{ vcvt_f64_f32(vget_low_f32(value.native())) };
+    }
+    /**
+        Converts the high two lanes of a simdf4.
+    */
+    static simd from_float_high(const simd<float, 4>& value) noexcept
+    {
+        return simd{ vcvt_high_f64_f32(value.native()) };
+    }
+    /**
+        Rounds the lanes of low and high to float, low goes to lanes 0 and 1 of the result.
+    */
+    static simd<float, 4> to_float(const simd& low, const simd& high) noexcept
+    {
+        return simd<float, 4>{ vcvt_high_f32_f64(vcvt_f32_f64(low._d), high._d) };
+    }
+
+    float64x2_t native() const noexcept
+    {
+        return this->_d;
+    }
+
+    void store(double* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        (void)cache_flags;
+        vst1q_f64(output, this->_d);
+    }
+
+    void store_aligned(double* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        (void)cache_flags;
+        vst1q_f64(output, this->_d);
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(double* output, size_t count) const noexcept
+    {
+        switch (count) {
+        case 0:
+            break;
+        case 1:
+            vst1_f64(output, vget_low_f64(this->_d));
+            break;
+        default:
+            vst1q_f64(output, this->_d);
+            break;
+        }
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ vaddq_f64(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        return *this = *this + other;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ vsubq_f64(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        return *this = *this - other;
+    }
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ vmulq_f64(this->_d, other._d) };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    simd operator/(const simd& other) const noexcept
+    {
+        return simd{ vdivq_f64(this->_d, other._d) };
+    }
+    simd& operator/=(const simd& other) noexcept
+    {
+        return *this = *this / other;
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ vminq_f64(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ vmaxq_f64(this->_d, other._d) };
+    }
+    simd sqrt() const noexcept
+    {
+        return simd{ vsqrtq_f64(this->_d) };
+    }
+    /**
+        Approximate 1 / x, see simd_base::precision. The estimate has 8 bits, each
+        Newton-Raphson step doubles them.
+    */
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        if (P == exact)
+            return simd{ vdivq_f64(vdupq_n_f64(1.0), this->_d) };
+        auto x = vrecpeq_f64(this->_d);
+        if (P >= newton_1)
+            x = vmulq_f64(x, vrecpsq_f64(this->_d, x));
+        if (P >= newton_2)
+            x = vmulq_f64(x, vrecpsq_f64(this->_d, x));
+        return simd{ x };
+    }
+    /**
+        Approximate 1 / sqrt(x), see rcp() for the estimate.
+    */
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        if (P == exact)
+            return simd{ vdivq_f64(vdupq_n_f64(1.0), vsqrtq_f64(this->_d)) };
+        auto y = vrsqrteq_f64(this->_d);
+        if (P >= newton_1)
+            y = vmulq_f64(y, vrsqrtsq_f64(vmulq_f64(this->_d, y), y));
+        if (P >= newton_2)
+            y = vmulq_f64(y, vrsqrtsq_f64(vmulq_f64(this->_d, y), y));
+        return simd{ y };
+    }
+    simd abs() const noexcept
+    {
+        return simd{ vabsq_f64(this->_d) };
+    }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+        return simd{ vrndnq_f64(this->_d) };
+    }
+    simd floor() const noexcept
+    {
+        return simd{ vrndmq_f64(this->_d) };
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-1022, 1023].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+        const int64x2_t biased = vaddq_s64(vcvtq_s64_f64(exponent._d), vdupq_n_s64(1023));
+        return simd{ vmulq_f64(this->_d, vreinterpretq_f64_s64(vshlq_n_s64(biased, 52))) };
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+        const uint64x2_t bits = vreinterpretq_u64_f64(this->_d);
+        exponent._d = vsubq_f64(vcvtq_f64_u64(vshrq_n_u64(bits, 52)), vdupq_n_f64(1022));
+        const uint64x2_t mantissa = vorrq_u64(vandq_u64(bits, vdupq_n_u64(0x000fffffffffffffull)), vdupq_n_u64(0x3fe0000000000000ull));
+        return simd{ vreinterpretq_f64_u64(mantissa) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ vreinterpretq_f64_u64(vandq_u64(vreinterpretq_u64_f64(this->_d), vreinterpretq_u64_f64(other._d))) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ vreinterpretq_f64_u64(vorrq_u64(vreinterpretq_u64_f64(this->_d), vreinterpretq_u64_f64(other._d))) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(this->_d), vreinterpretq_u64_f64(other._d))) };
+    }
+
+    /**
+        { value[idx0], value[idx1] }, the indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        using pattern = priv::permute_pattern<idx...>;
+        static_assert(pattern::lane_count == 2, "permute needs one index per lane");
+        static_assert(pattern::in_range(), "permute lane index out of range");
+        return pattern::is_identity() ? *this
+            : pattern::rotation() != 0 ? simd{ vextq_f64(this->_d, this->_d, 1) }
+                                       : simd{ vdupq_laneq_f64(this->_d, pattern::at(0)) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ vceqq_f64(this->_d, other._d) };
+        case compare_flags::lower:
+            return mask_type{ vcltq_f64(this->_d, other._d) };
+        case compare_flags::lower_equal:
+            return mask_type{ vcleq_f64(this->_d, other._d) };
+        case compare_flags::greater:
+            return mask_type{ vcgtq_f64(this->_d, other._d) };
+        case compare_flags::greater_equal:
+            return mask_type{ vcgeq_f64(this->_d, other._d) };
+        case compare_flags::not_equal:
+            return ~mask_type{ vceqq_f64(this->_d, other._d) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ vbslq_f64(mask.native(), a._d, b._d) };
+    }
+
+    /**
+        a * b + c, rounded once.
+    */
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ vfmaq_f64(c._d, a._d, b._d) };
+    }
+    /**
+        a * b - c
+    */
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ vnegq_f64(vfmsq_f64(c._d, a._d, b._d)) };
+    }
+    /**
+        c - a * b
+    */
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ vfmsq_f64(c._d, a._d, b._d) };
+    }
+
+    /**
+        { a0 + a1, b0 + b1 }
+    */
+    static simd horizontal_add(const simd& a, const simd& b) noexcept
+    {
+        return simd{ vpaddq_f64(a._d, b._d) };
+    }
+
+    /**
+        { a[l], b[h] }
+    */
+    template <unsigned short l, unsigned short h>
+    static simd shuffle(const simd& a, const simd& b) noexcept
+    {
+        static_assert(l < 2 && h < 2, "lane index out of range");
+        return simd{ vcombine_f64(l == 0 ? vget_low_f64(a._d) : vget_high_f64(a._d),
+            h == 0 ? vget_low_f64(b._d) : vget_high_f64(b._d)) };
+    }
+    static simd unpack_low(const simd& a, const simd& b) noexcept
+    {
+        return simd{ vzip1q_f64(a._d, b._d) };
+    }
+    static simd unpack_high(const simd& a, const simd& b) noexcept
+    {
+        return simd{ vzip2q_f64(a._d, b._d) };
+    }
+    static void transpose(simd& r0, simd& r1) noexcept
+    {
+        const float64x2_t t0 = vzip1q_f64(r0._d, r1._d);
+        r1._d = vzip2q_f64(r0._d, r1._d);
+        r0._d = t0;
+    }
+
+private:
+    float64x2_t _d;
+};
+
+using simdd2 = simd<double, 2>;
+
+SIMD_NAMESPACE_END
@@ -1,31 +1,172 @@
 #pragma once
 
+#include "../float16.hpp"
 #include "../simd_base.hpp"
+#include "permute_neon.hpp"
 extern "C" {
 #include <arm_neon.h>
 }
 
+SIMD_NAMESPACE_BEGIN
+
 namespace priv {
-template <unsigned short l0, unsigned short l1, unsigned short h0, unsigned short h1>
-float32x4_t neon_shuffle(float32x4_t a, float32x4_t b)
+/**
+    Widens 4 float16 values.
+*/
+inline float32x4_t half_to_float(uint16x4_t half) noexcept
 {
-    float __attribute__((aligned(16))) data[] = { vgetq_lane_f32(a, l0), vgetq_lane_f32(a, l1), vgetq_lane_f32(b, h0), vgetq_lane_f32(b, h1) };
-    return vld1q_f32(data);
+#if defined(__aarch64__) || (defined(__ARM_FP) && (__ARM_FP & 2))
+    return vcvt_f32_f16(vreinterpret_f16_u16(half));
+#else
+    // ARMv7 NEON flushes denormals, so subnormals are converted as integers
+    const uint32x4_t h = vmovl_u16(half);
+    const uint32x4_t sign = vshlq_n_u32(vandq_u32(h, vdupq_n_u32(0x8000)), 16);
+    const uint32x4_t em = vandq_u32(h, vdupq_n_u32(0x7fff));
+    const uint32x4_t shifted = vshlq_n_u32(em, 13);
+    const uint32x4_t normal = vaddq_u32(shifted, vdupq_n_u32(0x38000000));
+    const uint32x4_t subnormal = vreinterpretq_u32_f32(vmulq_f32(vcvtq_f32_u32(em), vdupq_n_f32(1.0f / 16777216.0f)));
+    const uint32x4_t quiet = vandq_u32(vcgtq_u32(em, vdupq_n_u32(0x7c00)), vdupq_n_u32(0x400000));
+    const uint32x4_t special = vorrq_u32(vorrq_u32(shifted, vdupq_n_u32(0x7f800000)), quiet);
+    uint32x4_t result = vbslq_u32(vcltq_u32(em, vdupq_n_u32(0x400)), subnormal, normal);
+    result = vbslq_u32(vcgeq_u32(em, vdupq_n_u32(0x7c00)), special, result);
+    return vreinterpretq_f32_u32(vorrq_u32(result, sign));
+#endif
 }
-
-//TODO: more optimized versions
-template <>
-inline float32x4_t neon_shuffle<0, 1, 2, 3>(float32x4_t a, float32x4_t b)
+/**
+    Rounds to float16, nearest even.
+*/
+inline uint16x4_t float_to_half(float32x4_t value) noexcept
 {
-    return vcombine_f32(vget_low_f32(a), vget_high_f32(b));
+#if defined(__aarch64__) || (defined(__ARM_FP) && (__ARM_FP & 2))
+    return vreinterpret_u16_f16(vcvt_f16_f32(value));
+#else
+    // same steps as float16::from_float, evaluated for all three ranges and then selected
+    const uint32x4_t all = vreinterpretq_u32_f32(value);
+    const uint32x4_t sign = vandq_u32(all, vdupq_n_u32(0x80000000u));
+    const uint32x4_t f = veorq_u32(all, sign);
+    const uint32x4_t odd = vandq_u32(vshrq_n_u32(f, 13), vdupq_n_u32(1));
+    const uint32x4_t normal = vshrq_n_u32(vaddq_u32(vaddq_u32(f, vdupq_n_u32(0xc8000fffu)), odd), 13);
+    const uint32x4_t subnormal = vsubq_u32(vreinterpretq_u32_f32(vaddq_f32(vreinterpretq_f32_u32(f), vdupq_n_f32(0.5f))), vdupq_n_u32(0x3f000000));
+    const uint32x4_t payload = vorrq_u32(vdupq_n_u32(0x200), vandq_u32(vshrq_n_u32(f, 13), vdupq_n_u32(0x3ff)));
+    const uint32x4_t special = vorrq_u32(vdupq_n_u32(0x7c00), vandq_u32(vcgtq_u32(f, vdupq_n_u32(0x7f800000)), payload));
+    uint32x4_t result = vbslq_u32(vcltq_u32(f, vdupq_n_u32(0x38800000)), subnormal, normal);
+    result = vbslq_u32(vcgeq_u32(f, vdupq_n_u32(0x47800000)), special, result);
+    return vmovn_u32(vorrq_u32(result, vshrq_n_u32(sign, 16)));
+#endif
+}
+/**
+    Rounds to bfloat16, nearest even, NaNs are quieted.
+*/
+inline uint16x4_t float_to_bfloat16(float32x4_t value) noexcept
+{
+    const uint32x4_t f = vreinterpretq_u32_f32(value);
+    const uint32x4_t odd = vandq_u32(vshrq_n_u32(f, 16), vdupq_n_u32(1));
+    const uint32x4_t rounded = vaddq_u32(f, vaddq_u32(vdupq_n_u32(0x7fff), odd));
+    const uint32x4_t is_nan = vmvnq_u32(vceqq_f32(value, value));
+    return vshrn_n_u32(vbslq_u32(is_nan, vorrq_u32(f, vdupq_n_u32(0x400000)), rounded), 16);
 }
 
 } // namespace priv
 
+/**
+    Result of a simdf4 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<float, 4> {
+public:
+    static constexpr size_t value_count = 4;
+
+    simd_mask() noexcept
+        : _m(vdupq_n_u32(0))
+    {
+    }
+    simd_mask(bool s0, bool s1, bool s2, bool s3) noexcept
+    {
+        const uint32_t __attribute__((aligned(16))) data[] = { s0 ? ~0u : 0u, s1 ? ~0u : 0u, s2 ? ~0u : 0u, s3 ? ~0u : 0u };
+        this->_m = vld1q_u32(data);
+    }
+    explicit simd_mask(uint32x4_t value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        const uint32_t __attribute__((aligned(16))) lanes[] = { 1, 2, 4, 8 };
+        return simd_mask{ vtstq_u32(vdupq_n_u32(bits), vld1q_u32(lanes)) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        const uint32_t __attribute__((aligned(16))) index[] = { 0, 1, 2, 3 };
+        return simd_mask{ vcltq_u32(vld1q_u32(index), vdupq_n_u32(static_cast<uint32_t>(count < 4 ? count : 4))) };
+    }
+
+    uint32x4_t native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        const int32_t __attribute__((aligned(16))) shifts[] = { 0, 1, 2, 3 };
+        const uint32x4_t bits = vshlq_u32(vshrq_n_u32(this->_m, 31), vld1q_s32(shifts));
+        uint32x2_t sum = vorr_u32(vget_low_u32(bits), vget_high_u32(bits));
+        sum = vpadd_u32(sum, sum);
+        return vget_lane_u32(sum, 0);
+    }
+    bool any() const noexcept
+    {
+        const uint32x2_t folded = vorr_u32(vget_low_u32(this->_m), vget_high_u32(this->_m));
+        return vget_lane_u64(vreinterpret_u64_u32(folded), 0) != 0;
+    }
+    bool all() const noexcept
+    {
+        const uint32x2_t folded = vand_u32(vget_low_u32(this->_m), vget_high_u32(this->_m));
+        return vget_lane_u64(vreinterpret_u64_u32(folded), 0) == ~uint64_t(0);
+    }
+    bool none() const noexcept
+    {
+        return !this->any();
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vandq_u32(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vorrq_u32(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ veorq_u32(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ vmvnq_u32(this->_m) };
+    }
+
+private:
+    uint32x4_t _m;
+};
+
 template <>
 class simd<float, 4> : public simd_common<simd<float, 4>> {
 public:
     using type = float;
+    using mask_type = simd_mask<float, 4>;
     static constexpr size_t value_count = 4;
 
     simd() noexcept
@@ -49,6 +190,52 @@ public:
         : _d(vld1q_f32(input))
     {
     }
+    /**
+        Loads 4 float16 values (8 bytes) and widens them.
+    */
+    explicit simd(const float16* input) noexcept
+        : _d(priv::half_to_float(vld1_u16(reinterpret_cast<const uint16_t*>(input))))
+    {
+    }
+    /**
+        Loads 4 bfloat16 values (8 bytes) and widens them.
+    */
+    explicit simd(const bfloat16* input) noexcept
+        : _d(vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(reinterpret_cast<const uint16_t*>(input)), 16)))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const float* input, size_t count) noexcept
+    {
+        switch (count) {
+        case 0:
+            return simd{};
+        case 1:
+            return simd{ vld1q_lane_f32(input, vdupq_n_f32(0), 0) };
+        case 2:
+            return simd{ vcombine_f32(vld1_f32(input), vdup_n_f32(0)) };
+        case 3:
+            return simd{ vcombine_f32(vld1_f32(input), vld1_lane_f32(input + 2, vdup_n_f32(0), 0)) };
+        default:
+            return simd{ vld1q_f32(input) };
+        }
+    }
+
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const float* input) noexcept
+    {
+        return simd{ vld1q_f32(input) };
+    }
+
+    float32x4_t native() const noexcept
+    {
+        return this->_d;
+    }
 
     void store(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
     {
@@ -64,6 +251,45 @@ public:
         }
     }
 
+    /**
+        Rounds the lanes to float16 and stores them (8 bytes).
+    */
+    void store(float16* output) const noexcept
+    {
+        vst1_u16(reinterpret_cast<uint16_t*>(output), priv::float_to_half(this->_d));
+    }
+    /**
+        Rounds the lanes to bfloat16 and stores them (8 bytes).
+    */
+    void store(bfloat16* output) const noexcept
+    {
+        vst1_u16(reinterpret_cast<uint16_t*>(output), priv::float_to_bfloat16(this->_d));
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(float* output, size_t count) const noexcept
+    {
+        switch (count) {
+        case 0:
+            break;
+        case 1:
+            vst1q_lane_f32(output, this->_d, 0);
+            break;
+        case 2:
+            vst1_f32(output, vget_low_f32(this->_d));
+            break;
+        case 3:
+            vst1_f32(output, vget_low_f32(this->_d));
+            vst1q_lane_f32(output + 2, this->_d, 2);
+            break;
+        default:
+            vst1q_f32(output, this->_d);
+            break;
+        }
+    }
+
     simd operator+(const simd& other) const noexcept
     {
         return simd{ vaddq_f32(this->_d, other._d) };
@@ -90,11 +316,12 @@ public:
     }
     simd operator/(const simd& other) const noexcept
     {
-        float32x4_t recp = vrecpeq_f32(other._d);
-        recp = vmulq_f32(vrecpsq_f32(other._d, recp), recp);
-        recp = vmulq_f32(vrecpsq_f32(other._d, recp), recp);
+#if defined(__aarch64__)
+        return simd{ vdivq_f32(this->_d, other._d) };
+#else
         // a / b = a * (1/b)
-        return simd{ vmulq_f32(this->_d, recp) };
+        return *this * other.rcp<newton_2>();
+#endif
     }
     simd& operator/=(const simd& other) noexcept
     {
@@ -111,14 +338,112 @@ public:
     }
     simd sqrt() const noexcept
     {
-        auto xi = vrsqrteq_f32(this->_d);
-        xi = vrsqrtsq_f32(this->_d * xi, xi) * xi;
-        return simd{ vrsqrtsq_f32(this->_d * xi, xi) * xi * this->_d };
+#if defined(__aarch64__)
+        return simd{ vsqrtq_f32(this->_d) };
+#else
+        // sqrt(x) = x * (1/sqrt(x)), the estimate is infinite for zero
+        const auto zero = vceqq_f32(this->_d, vdupq_n_f32(0.0f));
+        return simd{ vbslq_f32(zero, this->_d, vmulq_f32(this->_d, this->rsqrt<newton_2>()._d)) };
+#endif
+    }
+    /**
+        Approximate 1 / x, see simd_base::precision. ARMv7 has no vector division,
+        there exact is the same as newton_2.
+    */
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+#if defined(__aarch64__)
+        if (P == exact)
+            return simd{ vdivq_f32(vdupq_n_f32(1.0f), this->_d) };
+#endif
+        float32x4_t x = vrecpeq_f32(this->_d);
+        // vrecps(d, x) = 2 - d * x
+        if (P >= newton_1)
+            x = vmulq_f32(vrecpsq_f32(this->_d, x), x);
+        if (P >= newton_2)
+            x = vmulq_f32(vrecpsq_f32(this->_d, x), x);
+        return simd{ x };
+    }
+    /**
+        Approximate 1 / sqrt(x), see simd_base::precision. On ARMv7 exact is the same as newton_2.
+    */
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+#if defined(__aarch64__)
+        if (P == exact)
+            return simd{ vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(this->_d)) };
+#endif
+        float32x4_t y = vrsqrteq_f32(this->_d);
+        // vrsqrts(a, b) = (3 - a * b) / 2
+        if (P >= newton_1)
+            y = vmulq_f32(vrsqrtsq_f32(vmulq_f32(this->_d, y), y), y);
+        if (P >= newton_2)
+            y = vmulq_f32(vrsqrtsq_f32(vmulq_f32(this->_d, y), y), y);
+        return simd{ y };
     }
     simd abs() const noexcept
     {
         return simd{ vabsq_f32(this->_d) };
     }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+#if defined(__aarch64__)
+        return simd{ vrndnq_f32(this->_d) };
+#else
+        // adding and subtracting 2^23 drops the fraction bits, larger values are integral already
+        const float32x4_t magic = vdupq_n_f32(8388608.0f);
+        const float32x4_t magnitude = vabsq_f32(this->_d);
+        const uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(this->_d), vdupq_n_u32(0x80000000u));
+        const float32x4_t rounded = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(vsubq_f32(vaddq_f32(magnitude, magic), magic)), sign));
+        return simd{ vbslq_f32(vcltq_f32(magnitude, magic), rounded, this->_d) };
+#endif
+    }
+    simd floor() const noexcept
+    {
+#if defined(__aarch64__)
+        return simd{ vrndmq_f32(this->_d) };
+#else
+        const float32x4_t rounded = this->round()._d;
+        const uint32x4_t too_big = vcgtq_f32(rounded, this->_d);
+        return simd{ vsubq_f32(rounded, vreinterpretq_f32_u32(vandq_u32(too_big, vreinterpretq_u32_f32(vdupq_n_f32(1.0f))))) };
+#endif
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-126, 127].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+        const int32x4_t biased = vaddq_s32(vcvtq_s32_f32(exponent._d), vdupq_n_s32(127));
+        return simd{ vmulq_f32(this->_d, vreinterpretq_f32_s32(vshlq_n_s32(biased, 23))) };
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+        const uint32x4_t bits = vreinterpretq_u32_f32(this->_d);
+        exponent._d = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(126)));
+        const uint32x4_t mantissa = vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f000000));
+        return simd{ vreinterpretq_f32_u32(mantissa) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(this->_d), vreinterpretq_u32_f32(other._d))) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(this->_d), vreinterpretq_u32_f32(other._d))) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(this->_d), vreinterpretq_u32_f32(other._d))) };
+    }
 
     uint32x4_t compare_native(const simd& other, compare_flags flag) const noexcept
     {
@@ -139,9 +464,58 @@ public:
         return uint32x4_t{};
     }
 
-    simd compare(const simd& other, compare_flags flag) const noexcept
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ vreinterpretq_f32_u32(priv::neon_permute<idx...>(vreinterpretq_u32_f32(this->_d))) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        return mask_type{ this->compare_native(other, flag) };
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ vbslq_f32(mask.native(), a._d, b._d) };
+    }
+
+    /**
+        a * b + c, fused on AArch64 and VFPv4. Older ARMv7 cores only have vmla,
+        which rounds the product before the addition.
+    */
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
     {
-        return simd{ vcvtq_f32_u32(this->compare_native(other, flag)) };
+#if defined(__aarch64__) || defined(__ARM_FEATURE_FMA)
+        return simd{ vfmaq_f32(c._d, a._d, b._d) };
+#else
+        return simd{ vmlaq_f32(c._d, a._d, b._d) };
+#endif
+    }
+    /**
+        a * b - c
+    */
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return fma(a, b, simd{ vnegq_f32(c._d) });
+    }
+    /**
+        c - a * b
+    */
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__aarch64__) || defined(__ARM_FEATURE_FMA)
+        return simd{ vfmsq_f32(c._d, a._d, b._d) };
+#else
+        return simd{ vmlsq_f32(c._d, a._d, b._d) };
+#endif
     }
 
     static simd horizontal_add(const simd& a, const simd& b) noexcept
@@ -151,10 +525,54 @@ public:
             vpadd_f32(vget_low_f32(b._d), vget_high_f32(b._d))) };
     }
 
+    /**
+        Sum of all lanes, added in pairs.
+    */
+    float reduce_add() const noexcept
+    {
+#if defined(__aarch64__)
+        return vaddvq_f32(this->_d);
+#else
+        const float32x2_t pairs = vadd_f32(vget_low_f32(this->_d), vget_high_f32(this->_d));
+        return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+#endif
+    }
+    /**
+        Minimum and maximum of all lanes.
+    */
+    float reduce_min() const noexcept
+    {
+#if defined(__aarch64__)
+        return vminvq_f32(this->_d);
+#else
+        const float32x2_t pairs = vmin_f32(vget_low_f32(this->_d), vget_high_f32(this->_d));
+        return vget_lane_f32(vpmin_f32(pairs, pairs), 0);
+#endif
+    }
+    float reduce_max() const noexcept
+    {
+#if defined(__aarch64__)
+        return vmaxvq_f32(this->_d);
+#else
+        const float32x2_t pairs = vmax_f32(vget_low_f32(this->_d), vget_high_f32(this->_d));
+        return vget_lane_f32(vpmax_f32(pairs, pairs), 0);
+#endif
+    }
+    /**
+        Sum of the lane-wise products.
+    */
+    static float dot(const simd& a, const simd& b) noexcept
+    {
+        return (a * b).reduce_add();
+    }
+
     template <unsigned short l0, unsigned short l1, unsigned short h0, unsigned short h1>
     static simd shuffle(const simd& a, const simd& b) noexcept
     {
-        return simd{ priv::neon_shuffle<l0, l1, h0, h1>(a._d, b._d) };
+        static_assert(l0 < 4 && l1 < 4 && h0 < 4 && h1 < 4, "lane index out of range");
+        const uint32x2_t low = priv::neon_pick2<l0, l1>(vreinterpretq_u32_f32(a._d));
+        const uint32x2_t high = priv::neon_pick2<h0, h1>(vreinterpretq_u32_f32(b._d));
+        return simd{ vreinterpretq_f32_u32(vcombine_u32(low, high)) };
     }
 
     static simd unpack_low(const simd& a, const simd& b) noexcept
@@ -183,3 +601,5 @@ private:
 };
 
 using simdf4 = simd<float, 4>;
+
+SIMD_NAMESPACE_END
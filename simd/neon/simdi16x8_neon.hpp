@@ -0,0 +1,415 @@
+#pragma once
+
+#include "../simd_base.hpp"
+#include "permute_neon.hpp"
+extern "C" {
+#include <arm_neon.h>
+}
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdi16x8 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<int16_t, 8> {
+public:
+    static constexpr size_t value_count = 8;
+
+    simd_mask() noexcept
+        : _m(vdupq_n_u16(0))
+    {
+    }
+    simd_mask(bool s0, bool s1, bool s2, bool s3,
+        bool s4, bool s5, bool s6, bool s7) noexcept
+    {
+        alignas(16) const uint16_t data[] = { s0, s1, s2, s3,
+            s4, s5, s6, s7 };
+        this->_m = vtstq_u16(vld1q_u16(data), vld1q_u16(data));
+    }
+    explicit simd_mask(uint16x8_t value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        alignas(16) const uint16_t lanes[] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+        return simd_mask{ vtstq_u16(vdupq_n_u16(static_cast<uint16_t>(bits)), vld1q_u16(lanes)) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        alignas(16) const uint16_t index[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        return simd_mask{ vcltq_u16(vld1q_u16(index), vdupq_n_u16(static_cast<uint16_t>(count < 8 ? count : 8))) };
+    }
+
+    uint16x8_t native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        alignas(16) const int16_t shifts[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        const uint16x8_t bits = vshlq_u16(vshrq_n_u16(this->_m, 15), vld1q_s16(shifts));
+        uint16x4_t sum = vorr_u16(vget_low_u16(bits), vget_high_u16(bits));
+        sum = vpadd_u16(sum, sum);
+        sum = vpadd_u16(sum, sum);
+        return vget_lane_u16(sum, 0);
+    }
+    bool any() const noexcept
+    {
+        const uint16x4_t folded = vorr_u16(vget_low_u16(this->_m), vget_high_u16(this->_m));
+        return vget_lane_u64(vreinterpret_u64_u16(folded), 0) != 0;
+    }
+    bool all() const noexcept
+    {
+        const uint16x4_t folded = vand_u16(vget_low_u16(this->_m), vget_high_u16(this->_m));
+        return vget_lane_u64(vreinterpret_u64_u16(folded), 0) == ~uint64_t(0);
+    }
+    bool none() const noexcept
+    {
+        return !this->any();
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vandq_u16(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vorrq_u16(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ veorq_u16(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ vmvnq_u16(this->_m) };
+    }
+
+private:
+    uint16x8_t _m;
+};
+
+/**
+    Lanes of 16 bit signed integers. operator+, operator- and operator* wrap around, add_saturate and
+    subtract_saturate clamp to the range of the lane type.
+*/
+template <>
+class simd<int16_t, 8> : public simd_common<simd<int16_t, 8>> {
+public:
+    using type = int16_t;
+    using mask_type = simd_mask<int16_t, 8>;
+    static constexpr size_t value_count = 8;
+
+    simd() noexcept
+        : _d(vdupq_n_s16(0))
+    {
+    }
+    explicit simd(int16_t value) noexcept
+        : _d(vdupq_n_s16(value))
+    {
+    }
+    simd(int16_t s0, int16_t s1, int16_t s2, int16_t s3,
+        int16_t s4, int16_t s5, int16_t s6, int16_t s7) noexcept
+    {
+        alignas(16) const int16_t data[] = { s0, s1, s2, s3,
+            s4, s5, s6, s7 };
+        this->_d = vld1q_s16(data);
+    }
+    explicit simd(int16x8_t value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const int16_t* input) noexcept
+        : _d(vld1q_s16(input))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const int16_t* input, size_t count) noexcept
+    {
+        if (count >= 8)
+            return simd{ input };
+        alignas(16) int16_t buffer[8] = {};
+        std::memcpy(buffer, input, count * sizeof(int16_t));
+        return load_aligned(buffer);
+    }
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const int16_t* input) noexcept
+    {
+        return simd{ vld1q_s16(input) };
+    }
+
+    int16x8_t native() const noexcept
+    {
+        return this->_d;
+    }
+
+    void store(int16_t* output) const noexcept
+    {
+        vst1q_s16(output, this->_d);
+    }
+
+    void store_aligned(int16_t* output) const noexcept
+    {
+        vst1q_s16(output, this->_d);
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(int16_t* output, size_t count) const noexcept
+    {
+        if (count >= 8) {
+            vst1q_s16(output, this->_d);
+            return;
+        }
+        alignas(16) int16_t buffer[8];
+        this->store_aligned(buffer);
+        std::memcpy(output, buffer, count * sizeof(int16_t));
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ vaddq_s16(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        this->_d = vaddq_s16(this->_d, other._d);
+        return *this;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ vsubq_s16(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        this->_d = vsubq_s16(this->_d, other._d);
+        return *this;
+    }
+    /**
+        a + b clamped to the range of int16_t.
+    */
+    simd add_saturate(const simd& other) const noexcept
+    {
+        return simd{ vqaddq_s16(this->_d, other._d) };
+    }
+    /**
+        a - b clamped to the range of int16_t.
+    */
+    simd subtract_saturate(const simd& other) const noexcept
+    {
+        return simd{ vqsubq_s16(this->_d, other._d) };
+    }
+    /**
+        Low half of the product, i.e. the wrapping a * b.
+    */
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ vmulq_s16(this->_d, other._d) };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        this->_d = vmulq_s16(this->_d, other._d);
+        return *this;
+    }
+    /**
+        High half of the 32 bit product.
+    */
+    simd mulhi(const simd& other) const noexcept
+    {
+        const auto low = vmull_s16(vget_low_s16(this->_d), vget_low_s16(other._d));
+        const auto high = vmull_s16(vget_high_s16(this->_d), vget_high_s16(other._d));
+        return simd{ vcombine_s16(vshrn_n_s32(low, 16), vshrn_n_s32(high, 16)) };
+    }
+
+    template <int count>
+    simd shift_left() const noexcept
+    {
+        static_assert(count >= 0 && count < 16, "shift count out of range");
+        return simd{ vshlq_n_s16(this->_d, count) };
+    }
+    /**
+        Arithmetic right shift.
+    */
+    template <int count>
+    simd shift_right() const noexcept
+    {
+        static_assert(count >= 0 && count < 16, "shift count out of range");
+        // vshrq_n does not accept 0, a shift left by a negative constant compiles to the same instruction
+        return simd{ vshlq_s16(this->_d, vdupq_n_s16(-count)) };
+    }
+    /**
+        Shifts each lane left by the corresponding lane of counts, which have to be in [0, 16).
+    */
+    simd shift_left(const simd& counts) const noexcept
+    {
+        return simd{ vshlq_s16(this->_d, counts._d) };
+    }
+    /**
+        Arithmetic right shift of each lane by the corresponding lane of counts, which have to be in [0, 16).
+    */
+    simd shift_right(const simd& counts) const noexcept
+    {
+        return simd{ vshlq_s16(this->_d, vnegq_s16(counts._d)) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ vandq_s16(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ vorrq_s16(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ veorq_s16(this->_d, other._d) };
+    }
+    simd operator~() const noexcept
+    {
+        return simd{ vmvnq_s16(this->_d) };
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ vminq_s16(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ vmaxq_s16(this->_d, other._d) };
+    }
+    /**
+        |x|, the lowest value of int16_t stays unchanged.
+    */
+    simd abs() const noexcept
+    {
+        return simd{ vabsq_s16(this->_d) };
+    }
+    /**
+        (a + b + 1) / 2 rounded down, without intermediate overflow.
+    */
+    simd avg(const simd& other) const noexcept
+    {
+        return simd{ vrhaddq_s16(this->_d, other._d) };
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ vreinterpretq_s16_u16(priv::neon_permute<idx...>(vreinterpretq_u16_s16(this->_d))) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ vceqq_s16(this->_d, other._d) };
+        case compare_flags::lower:
+            return mask_type{ vcltq_s16(this->_d, other._d) };
+        case compare_flags::lower_equal:
+            return mask_type{ vcleq_s16(this->_d, other._d) };
+        case compare_flags::greater:
+            return mask_type{ vcgtq_s16(this->_d, other._d) };
+        case compare_flags::greater_equal:
+            return mask_type{ vcgeq_s16(this->_d, other._d) };
+        case compare_flags::not_equal:
+            return mask_type{ vmvnq_u16(vceqq_s16(this->_d, other._d)) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ vbslq_s16(mask.native(), a._d, b._d) };
+    }
+
+    /**
+        Sum of all lanes, widened so that it cannot overflow.
+    */
+    int32_t sum() const noexcept
+    {
+#if defined(__aarch64__)
+        return static_cast<int32_t>(vaddlvq_s16(this->_d));
+#else
+        const int64x2_t halves = vpaddlq_s32(vpaddlq_s16(this->_d));
+        return static_cast<int32_t>(vgetq_lane_s64(halves, 0) + vgetq_lane_s64(halves, 1));
+#endif
+    }
+    /**
+        Minimum, maximum, product (wrapping), AND and OR of all lanes.
+    */
+    int16_t reduce_min() const noexcept
+    {
+#if defined(__aarch64__)
+        return vminvq_s16(this->_d);
+#else
+        return fold_halves([](int16x4_t a, int16x4_t b) { return vmin_s16(a, b); });
+#endif
+    }
+    int16_t reduce_max() const noexcept
+    {
+#if defined(__aarch64__)
+        return vmaxvq_s16(this->_d);
+#else
+        return fold_halves([](int16x4_t a, int16x4_t b) { return vmax_s16(a, b); });
+#endif
+    }
+    int16_t reduce_product() const noexcept
+    {
+        return fold_halves([](int16x4_t a, int16x4_t b) { return vmul_s16(a, b); });
+    }
+    int16_t reduce_and() const noexcept
+    {
+        return fold_halves([](int16x4_t a, int16x4_t b) { return vand_s16(a, b); });
+    }
+    int16_t reduce_or() const noexcept
+    {
+        return fold_halves([](int16x4_t a, int16x4_t b) { return vorr_s16(a, b); });
+    }
+
+private:
+    /**
+        Combines the two halves with op, then keeps halving by rotating the upper lanes down.
+    */
+    template <typename Op>
+    int16_t fold_halves(Op op) const noexcept
+    {
+        int16x4_t result = op(vget_low_s16(this->_d), vget_high_s16(this->_d));
+        result = op(result, vext_s16(result, result, 2));
+        result = op(result, vext_s16(result, result, 1));
+        return vget_lane_s16(result, 0);
+    }
+
+    int16x8_t _d;
+};
+
+using simdi16x8 = simd<int16_t, 8>;
+
+SIMD_NAMESPACE_END
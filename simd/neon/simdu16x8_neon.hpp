@@ -1,16 +1,121 @@
 #pragma once
 
 #include "../simd_base.hpp"
+#include "permute_neon.hpp"
 extern "C" {
 #include <arm_neon.h>
 }
 
 #include <iostream>
 
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdu16x8 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<uint16_t, 8> {
+public:
+    static constexpr size_t value_count = 8;
+
+    simd_mask() noexcept
+        : _m(vdupq_n_u16(0))
+    {
+    }
+    simd_mask(bool s0, bool s1, bool s2, bool s3,
+        bool s4, bool s5, bool s6, bool s7) noexcept
+    {
+        alignas(16) const uint16_t data[] = { s0, s1, s2, s3,
+            s4, s5, s6, s7 };
+        this->_m = vtstq_u16(vld1q_u16(data), vld1q_u16(data));
+    }
+    explicit simd_mask(uint16x8_t value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        alignas(16) const uint16_t lanes[] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+        return simd_mask{ vtstq_u16(vdupq_n_u16(static_cast<uint16_t>(bits)), vld1q_u16(lanes)) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        alignas(16) const uint16_t index[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        return simd_mask{ vcltq_u16(vld1q_u16(index), vdupq_n_u16(static_cast<uint16_t>(count < 8 ? count : 8))) };
+    }
+
+    uint16x8_t native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        alignas(16) const int16_t shifts[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        const uint16x8_t bits = vshlq_u16(vshrq_n_u16(this->_m, 15), vld1q_s16(shifts));
+        uint16x4_t sum = vorr_u16(vget_low_u16(bits), vget_high_u16(bits));
+        sum = vpadd_u16(sum, sum);
+        sum = vpadd_u16(sum, sum);
+        return vget_lane_u16(sum, 0);
+    }
+    bool any() const noexcept
+    {
+        const uint16x4_t folded = vorr_u16(vget_low_u16(this->_m), vget_high_u16(this->_m));
+        return vget_lane_u64(vreinterpret_u64_u16(folded), 0) != 0;
+    }
+    bool all() const noexcept
+    {
+        const uint16x4_t folded = vand_u16(vget_low_u16(this->_m), vget_high_u16(this->_m));
+        return vget_lane_u64(vreinterpret_u64_u16(folded), 0) == ~uint64_t(0);
+    }
+    bool none() const noexcept
+    {
+        return !this->any();
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vandq_u16(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vorrq_u16(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ veorq_u16(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ vmvnq_u16(this->_m) };
+    }
+
+private:
+    uint16x8_t _m;
+};
+
+/**
+    Lanes of 16 bit unsigned integers. Unlike the other integer types, operator+ and operator-
+    saturate; add_wrap and subtract_wrap wrap around, operator* wraps.
+*/
 template <>
 class simd<uint16_t, 8> : public simd_common<simd<uint16_t, 8>> {
 public:
     using type = uint16_t;
+    using mask_type = simd_mask<uint16_t, 8>;
     static constexpr size_t value_count = 8;
 
     simd() noexcept
@@ -35,6 +140,39 @@ public:
         : _d(vld1q_u16(input))
     {
     }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const uint16_t* input, size_t count) noexcept
+    {
+        if (count >= 8)
+            return simd{ vld1q_u16(input) };
+        uint16x8_t result = count >= 4 ? vcombine_u16(vld1_u16(input), vdup_n_u16(0)) : vdupq_n_u16(0);
+        switch (count) {
+        case 7:
+            result = vld1q_lane_u16(input + 6, result, 6);
+            // fall through
+        case 6:
+            result = vld1q_lane_u16(input + 5, result, 5);
+            // fall through
+        case 5:
+            result = vld1q_lane_u16(input + 4, result, 4);
+            break;
+        case 3:
+            result = vld1q_lane_u16(input + 2, result, 2);
+            // fall through
+        case 2:
+            result = vld1q_lane_u16(input + 1, result, 1);
+            // fall through
+        case 1:
+            result = vld1q_lane_u16(input, result, 0);
+            break;
+        default:
+            break;
+        }
+        return simd{ result };
+    }
 
     explicit simd(const uint16_t* inputLo, const uint16_t* inputHi) noexcept
         : simd(inputLo[0], inputLo[1], inputLo[2], inputLo[3],
@@ -51,15 +189,22 @@ public:
     {
     }
 
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const uint16_t* input) noexcept
+    {
+        return simd{ vld1q_u16(input) };
+    }
+
+    uint16x8_t native() const noexcept
+    {
+        return this->_d;
+    }
+
     void store(uint16_t* output) const noexcept
     {
-        if (is_aligned(output, 16)) {
-            this->store_aligned(output);
-        } else {
-            alignas(16) uint16_t tmp[8];
-            this->store_aligned(tmp);
-            memcpy(output, tmp, 8 * sizeof(tmp[0]));
-        }
+        vst1q_u16(output, this->_d);
     }
 
     void store_aligned(uint16_t* output) const noexcept
@@ -67,6 +212,41 @@ public:
         vst1q_u16(output, this->_d);
     }
 
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(uint16_t* output, size_t count) const noexcept
+    {
+        if (count >= 8) {
+            vst1q_u16(output, this->_d);
+            return;
+        }
+        if (count >= 4)
+            vst1_u16(output, vget_low_u16(this->_d));
+        switch (count) {
+        case 7:
+            vst1q_lane_u16(output + 6, this->_d, 6);
+            // fall through
+        case 6:
+            vst1q_lane_u16(output + 5, this->_d, 5);
+            // fall through
+        case 5:
+            vst1q_lane_u16(output + 4, this->_d, 4);
+            break;
+        case 3:
+            vst1q_lane_u16(output + 2, this->_d, 2);
+            // fall through
+        case 2:
+            vst1q_lane_u16(output + 1, this->_d, 1);
+            // fall through
+        case 1:
+            vst1q_lane_u16(output, this->_d, 0);
+            break;
+        default:
+            break;
+        }
+    }
+
     simd operator+(const simd& other) const noexcept
     {
         return simd(vqaddq_u16(this->_d, other._d));
@@ -94,15 +274,212 @@ public:
         this->_d = vmulq_u16(this->_d, other._d);
         return *this;
     }
-    uint16_t sum() const noexcept
+    /**
+        Wrapping a + b, unlike operator+ which saturates.
+    */
+    simd add_wrap(const simd& other) const noexcept
+    {
+        return simd{ vaddq_u16(this->_d, other._d) };
+    }
+    /**
+        Wrapping a - b, unlike operator- which saturates.
+    */
+    simd subtract_wrap(const simd& other) const noexcept
+    {
+        return simd{ vsubq_u16(this->_d, other._d) };
+    }
+    /**
+        a + b clamped to the range of uint16_t.
+    */
+    simd add_saturate(const simd& other) const noexcept
+    {
+        return simd{ vqaddq_u16(this->_d, other._d) };
+    }
+    /**
+        a - b clamped to the range of uint16_t.
+    */
+    simd subtract_saturate(const simd& other) const noexcept
+    {
+        return simd{ vqsubq_u16(this->_d, other._d) };
+    }
+    /**
+        High half of the 32 bit product.
+    */
+    simd mulhi(const simd& other) const noexcept
+    {
+        const auto low = vmull_u16(vget_low_u16(this->_d), vget_low_u16(other._d));
+        const auto high = vmull_u16(vget_high_u16(this->_d), vget_high_u16(other._d));
+        return simd{ vcombine_u16(vshrn_n_u32(low, 16), vshrn_n_u32(high, 16)) };
+    }
+
+    template <int count>
+    simd shift_left() const noexcept
+    {
+        static_assert(count >= 0 && count < 16, "shift count out of range");
+        return simd{ vshlq_n_u16(this->_d, count) };
+    }
+    /**
+        Logical right shift.
+    */
+    template <int count>
+    simd shift_right() const noexcept
+    {
+        static_assert(count >= 0 && count < 16, "shift count out of range");
+        // vshrq_n does not accept 0, a shift left by a negative constant compiles to the same instruction
+        return simd{ vshlq_u16(this->_d, vdupq_n_s16(-count)) };
+    }
+    /**
+        Shifts each lane left by the corresponding lane of counts, which have to be in [0, 16).
+    */
+    simd shift_left(const simd& counts) const noexcept
+    {
+        return simd{ vshlq_u16(this->_d, vreinterpretq_s16_u16(counts._d)) };
+    }
+    /**
+        Logical right shift of each lane by the corresponding lane of counts, which have to be in [0, 16).
+    */
+    simd shift_right(const simd& counts) const noexcept
+    {
+        return simd{ vshlq_u16(this->_d, vnegq_s16(vreinterpretq_s16_u16(counts._d))) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ vandq_u16(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ vorrq_u16(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ veorq_u16(this->_d, other._d) };
+    }
+    simd operator~() const noexcept
+    {
+        return simd{ vmvnq_u16(this->_d) };
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ vminq_u16(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ vmaxq_u16(this->_d, other._d) };
+    }
+    /**
+        (a + b + 1) / 2 rounded down, without intermediate overflow.
+    */
+    simd avg(const simd& other) const noexcept
+    {
+        return simd{ vrhaddq_u16(this->_d, other._d) };
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ priv::neon_permute<idx...>(this->_d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ vceqq_u16(this->_d, other._d) };
+        case compare_flags::lower:
+            return mask_type{ vcltq_u16(this->_d, other._d) };
+        case compare_flags::lower_equal:
+            return mask_type{ vcleq_u16(this->_d, other._d) };
+        case compare_flags::greater:
+            return mask_type{ vcgtq_u16(this->_d, other._d) };
+        case compare_flags::greater_equal:
+            return mask_type{ vcgeq_u16(this->_d, other._d) };
+        case compare_flags::not_equal:
+            return mask_type{ vmvnq_u16(vceqq_u16(this->_d, other._d)) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ vbslq_u16(mask.native(), a._d, b._d) };
+    }
+    /**
+        Sum of all lanes, widened so that it cannot overflow.
+    */
+    uint32_t sum() const noexcept
+    {
+#if defined(__aarch64__)
+        return static_cast<uint32_t>(vaddlvq_u16(this->_d));
+#else
+        const uint64x2_t halves = vpaddlq_u32(vpaddlq_u16(this->_d));
+        return static_cast<uint32_t>(vgetq_lane_u64(halves, 0) + vgetq_lane_u64(halves, 1));
+#endif
+    }
+    /**
+        Sum of all lanes clamped to 65535.
+    */
+    uint16_t sum_saturate() const noexcept
+    {
+        const uint32_t total = this->sum();
+        return static_cast<uint16_t>(total < 0xffff ? total : 0xffff);
+    }
+    /**
+        Minimum, maximum, product (wrapping), AND and OR of all lanes.
+    */
+    uint16_t reduce_min() const noexcept
+    {
+#if defined(__aarch64__)
+        return vminvq_u16(this->_d);
+#else
+        return fold_halves([](uint16x4_t a, uint16x4_t b) { return vmin_u16(a, b); });
+#endif
+    }
+    uint16_t reduce_max() const noexcept
+    {
+#if defined(__aarch64__)
+        return vmaxvq_u16(this->_d);
+#else
+        return fold_halves([](uint16x4_t a, uint16x4_t b) { return vmax_u16(a, b); });
+#endif
+    }
+    uint16_t reduce_product() const noexcept
     {
-        uint16x4_t res = vadd_u16(vget_low_u16(this->_d), vget_high_u16(this->_d));
-        res = vpadd_u16(res, res);
-        return vget_lane_u16(res, 0) + vget_lane_u16(res, 1);
+        return fold_halves([](uint16x4_t a, uint16x4_t b) { return vmul_u16(a, b); });
+    }
+    uint16_t reduce_and() const noexcept
+    {
+        return fold_halves([](uint16x4_t a, uint16x4_t b) { return vand_u16(a, b); });
+    }
+    uint16_t reduce_or() const noexcept
+    {
+        return fold_halves([](uint16x4_t a, uint16x4_t b) { return vorr_u16(a, b); });
     }
 
 private:
+    /**
+        Combines the two halves with op, then keeps halving by rotating the upper lanes down.
+    */
+    template <typename Op>
+    uint16_t fold_halves(Op op) const noexcept
+    {
+        uint16x4_t result = op(vget_low_u16(this->_d), vget_high_u16(this->_d));
+        result = op(result, vext_u16(result, result, 2));
+        result = op(result, vext_u16(result, result, 1));
+        return vget_lane_u16(result, 0);
+    }
+
     uint16x8_t _d;
 };
 
 using simdu16x8 = simd<uint16_t, 8>;
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,402 @@
+#pragma once
+
+#include "../simd_base.hpp"
+#include "permute_neon.hpp"
+extern "C" {
+#include <arm_neon.h>
+}
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdu32x4 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<uint32_t, 4> {
+public:
+    static constexpr size_t value_count = 4;
+
+    simd_mask() noexcept
+        : _m(vdupq_n_u32(0))
+    {
+    }
+    simd_mask(bool s0, bool s1, bool s2, bool s3) noexcept
+    {
+        alignas(16) const uint32_t data[] = { s0 ? ~0u : 0u, s1 ? ~0u : 0u, s2 ? ~0u : 0u, s3 ? ~0u : 0u };
+        this->_m = vld1q_u32(data);
+    }
+    explicit simd_mask(uint32x4_t value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        alignas(16) const uint32_t lanes[] = { 1, 2, 4, 8 };
+        return simd_mask{ vtstq_u32(vdupq_n_u32(bits), vld1q_u32(lanes)) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        alignas(16) const uint32_t index[] = { 0, 1, 2, 3 };
+        return simd_mask{ vcltq_u32(vld1q_u32(index), vdupq_n_u32(static_cast<uint32_t>(count < 4 ? count : 4))) };
+    }
+
+    uint32x4_t native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        alignas(16) const int32_t shifts[] = { 0, 1, 2, 3 };
+        const uint32x4_t bits = vshlq_u32(vshrq_n_u32(this->_m, 31), vld1q_s32(shifts));
+        uint32x2_t sum = vorr_u32(vget_low_u32(bits), vget_high_u32(bits));
+        sum = vpadd_u32(sum, sum);
+        return vget_lane_u32(sum, 0);
+    }
+    bool any() const noexcept
+    {
+        const uint32x2_t folded = vorr_u32(vget_low_u32(this->_m), vget_high_u32(this->_m));
+        return vget_lane_u64(vreinterpret_u64_u32(folded), 0) != 0;
+    }
+    bool all() const noexcept
+    {
+        const uint32x2_t folded = vand_u32(vget_low_u32(this->_m), vget_high_u32(this->_m));
+        return vget_lane_u64(vreinterpret_u64_u32(folded), 0) == ~uint64_t(0);
+    }
+    bool none() const noexcept
+    {
+        return !this->any();
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vandq_u32(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vorrq_u32(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ veorq_u32(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ vmvnq_u32(this->_m) };
+    }
+
+private:
+    uint32x4_t _m;
+};
+
+/**
+    Lanes of 32 bit unsigned integers. operator+, operator- and operator* wrap around, add_saturate and
+    subtract_saturate clamp to the range of the lane type.
+*/
+template <>
+class simd<uint32_t, 4> : public simd_common<simd<uint32_t, 4>> {
+public:
+    using type = uint32_t;
+    using mask_type = simd_mask<uint32_t, 4>;
+    static constexpr size_t value_count = 4;
+
+    simd() noexcept
+        : _d(vdupq_n_u32(0))
+    {
+    }
+    explicit simd(uint32_t value) noexcept
+        : _d(vdupq_n_u32(value))
+    {
+    }
+    simd(uint32_t s0, uint32_t s1, uint32_t s2, uint32_t s3) noexcept
+    {
+        alignas(16) const uint32_t data[] = { s0, s1, s2, s3 };
+        this->_d = vld1q_u32(data);
+    }
+    explicit simd(uint32x4_t value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const uint32_t* input) noexcept
+        : _d(vld1q_u32(input))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const uint32_t* input, size_t count) noexcept
+    {
+        if (count >= 4)
+            return simd{ input };
+        alignas(16) uint32_t buffer[4] = {};
+        std::memcpy(buffer, input, count * sizeof(uint32_t));
+        return load_aligned(buffer);
+    }
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const uint32_t* input) noexcept
+    {
+        return simd{ vld1q_u32(input) };
+    }
+
+    uint32x4_t native() const noexcept
+    {
+        return this->_d;
+    }
+
+    void store(uint32_t* output) const noexcept
+    {
+        vst1q_u32(output, this->_d);
+    }
+
+    void store_aligned(uint32_t* output) const noexcept
+    {
+        vst1q_u32(output, this->_d);
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(uint32_t* output, size_t count) const noexcept
+    {
+        if (count >= 4) {
+            vst1q_u32(output, this->_d);
+            return;
+        }
+        alignas(16) uint32_t buffer[4];
+        this->store_aligned(buffer);
+        std::memcpy(output, buffer, count * sizeof(uint32_t));
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ vaddq_u32(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        this->_d = vaddq_u32(this->_d, other._d);
+        return *this;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ vsubq_u32(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        this->_d = vsubq_u32(this->_d, other._d);
+        return *this;
+    }
+    /**
+        a + b clamped to the range of uint32_t.
+    */
+    simd add_saturate(const simd& other) const noexcept
+    {
+        return simd{ vqaddq_u32(this->_d, other._d) };
+    }
+    /**
+        a - b clamped to the range of uint32_t.
+    */
+    simd subtract_saturate(const simd& other) const noexcept
+    {
+        return simd{ vqsubq_u32(this->_d, other._d) };
+    }
+    /**
+        Low half of the product, i.e. the wrapping a * b.
+    */
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ vmulq_u32(this->_d, other._d) };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        this->_d = vmulq_u32(this->_d, other._d);
+        return *this;
+    }
+    /**
+        High half of the 64 bit product.
+    */
+    simd mulhi(const simd& other) const noexcept
+    {
+        const auto low = vmull_u32(vget_low_u32(this->_d), vget_low_u32(other._d));
+        const auto high = vmull_u32(vget_high_u32(this->_d), vget_high_u32(other._d));
+        return simd{ vcombine_u32(vshrn_n_u64(low, 32), vshrn_n_u64(high, 32)) };
+    }
+
+    template <int count>
+    simd shift_left() const noexcept
+    {
+        static_assert(count >= 0 && count < 32, "shift count out of range");
+        return simd{ vshlq_n_u32(this->_d, count) };
+    }
+    /**
+        Logical right shift.
+    */
+    template <int count>
+    simd shift_right() const noexcept
+    {
+        static_assert(count >= 0 && count < 32, "shift count out of range");
+        // vshrq_n does not accept 0, a shift left by a negative constant compiles to the same instruction
+        return simd{ vshlq_u32(this->_d, vdupq_n_s32(-count)) };
+    }
+    /**
+        Shifts each lane left by the corresponding lane of counts, which have to be in [0, 32).
+    */
+    simd shift_left(const simd& counts) const noexcept
+    {
+        return simd{ vshlq_u32(this->_d, vreinterpretq_s32_u32(counts._d)) };
+    }
+    /**
+        Logical right shift of each lane by the corresponding lane of counts, which have to be in [0, 32).
+    */
+    simd shift_right(const simd& counts) const noexcept
+    {
+        return simd{ vshlq_u32(this->_d, vnegq_s32(vreinterpretq_s32_u32(counts._d))) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ vandq_u32(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ vorrq_u32(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ veorq_u32(this->_d, other._d) };
+    }
+    simd operator~() const noexcept
+    {
+        return simd{ vmvnq_u32(this->_d) };
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ vminq_u32(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ vmaxq_u32(this->_d, other._d) };
+    }
+    /**
+        (a + b + 1) / 2 rounded down, without intermediate overflow.
+    */
+    simd avg(const simd& other) const noexcept
+    {
+        return simd{ vrhaddq_u32(this->_d, other._d) };
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ priv::neon_permute<idx...>(this->_d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ vceqq_u32(this->_d, other._d) };
+        case compare_flags::lower:
+            return mask_type{ vcltq_u32(this->_d, other._d) };
+        case compare_flags::lower_equal:
+            return mask_type{ vcleq_u32(this->_d, other._d) };
+        case compare_flags::greater:
+            return mask_type{ vcgtq_u32(this->_d, other._d) };
+        case compare_flags::greater_equal:
+            return mask_type{ vcgeq_u32(this->_d, other._d) };
+        case compare_flags::not_equal:
+            return mask_type{ vmvnq_u32(vceqq_u32(this->_d, other._d)) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ vbslq_u32(mask.native(), a._d, b._d) };
+    }
+
+    /**
+        Sum of all lanes, widened so that it cannot overflow.
+    */
+    uint64_t sum() const noexcept
+    {
+#if defined(__aarch64__)
+        return static_cast<uint64_t>(vaddlvq_u32(this->_d));
+#else
+        const uint64x2_t halves = vpaddlq_u32(this->_d);
+        return static_cast<uint64_t>(vgetq_lane_u64(halves, 0) + vgetq_lane_u64(halves, 1));
+#endif
+    }
+    /**
+        Minimum, maximum, product (wrapping), AND and OR of all lanes.
+    */
+    uint32_t reduce_min() const noexcept
+    {
+#if defined(__aarch64__)
+        return vminvq_u32(this->_d);
+#else
+        return fold_halves([](uint32x2_t a, uint32x2_t b) { return vmin_u32(a, b); });
+#endif
+    }
+    uint32_t reduce_max() const noexcept
+    {
+#if defined(__aarch64__)
+        return vmaxvq_u32(this->_d);
+#else
+        return fold_halves([](uint32x2_t a, uint32x2_t b) { return vmax_u32(a, b); });
+#endif
+    }
+    uint32_t reduce_product() const noexcept
+    {
+        return fold_halves([](uint32x2_t a, uint32x2_t b) { return vmul_u32(a, b); });
+    }
+    uint32_t reduce_and() const noexcept
+    {
+        return fold_halves([](uint32x2_t a, uint32x2_t b) { return vand_u32(a, b); });
+    }
+    uint32_t reduce_or() const noexcept
+    {
+        return fold_halves([](uint32x2_t a, uint32x2_t b) { return vorr_u32(a, b); });
+    }
+
+private:
+    /**
+        Combines the two halves with op, then keeps halving by rotating the upper lanes down.
+    */
+    template <typename Op>
+    uint32_t fold_halves(Op op) const noexcept
+    {
+        uint32x2_t result = op(vget_low_u32(this->_d), vget_high_u32(this->_d));
+        result = op(result, vext_u32(result, result, 1));
+        return vget_lane_u32(result, 0);
+    }
+
+    uint32x4_t _d;
+};
+
+using simdu32x4 = simd<uint32_t, 4>;
+
+SIMD_NAMESPACE_END
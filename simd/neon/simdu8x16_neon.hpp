@@ -0,0 +1,409 @@
+#pragma once
+
+#include "../simd_base.hpp"
+#include "permute_neon.hpp"
+extern "C" {
+#include <arm_neon.h>
+}
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdu8x16 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<uint8_t, 16> {
+public:
+    static constexpr size_t value_count = 16;
+
+    simd_mask() noexcept
+        : _m(vdupq_n_u8(0))
+    {
+    }
+    explicit simd_mask(uint8x16_t value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        alignas(16) const uint8_t lanes[] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+        // the low byte of bits to lanes 0 - 7, the high byte to lanes 8 - 15
+        const uint8x16_t bytes = vcombine_u8(vdup_n_u8(static_cast<uint8_t>(bits)), vdup_n_u8(static_cast<uint8_t>(bits >> 8)));
+        return simd_mask{ vtstq_u8(bytes, vld1q_u8(lanes)) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        alignas(16) const uint8_t index[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+        return simd_mask{ vcltq_u8(vld1q_u8(index), vdupq_n_u8(static_cast<uint8_t>(count < 16 ? count : 16))) };
+    }
+
+    uint8x16_t native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        alignas(16) const int8_t shifts[] = { 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7 };
+        const uint8x16_t bits = vshlq_u8(vshrq_n_u8(this->_m, 7), vld1q_s8(shifts));
+        // the lanes 0 - 7 sum up to the low byte in lane 0, the lanes 8 - 15 to the high byte in lane 1
+        uint8x8_t sum = vpadd_u8(vget_low_u8(bits), vget_high_u8(bits));
+        sum = vpadd_u8(sum, sum);
+        sum = vpadd_u8(sum, sum);
+        return vget_lane_u8(sum, 0) | (static_cast<uint32_t>(vget_lane_u8(sum, 1)) << 8);
+    }
+    bool any() const noexcept
+    {
+        const uint8x8_t folded = vorr_u8(vget_low_u8(this->_m), vget_high_u8(this->_m));
+        return vget_lane_u64(vreinterpret_u64_u8(folded), 0) != 0;
+    }
+    bool all() const noexcept
+    {
+        const uint8x8_t folded = vand_u8(vget_low_u8(this->_m), vget_high_u8(this->_m));
+        return vget_lane_u64(vreinterpret_u64_u8(folded), 0) == ~uint64_t(0);
+    }
+    bool none() const noexcept
+    {
+        return !this->any();
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vandq_u8(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ vorrq_u8(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ veorq_u8(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ vmvnq_u8(this->_m) };
+    }
+
+private:
+    uint8x16_t _m;
+};
+
+/**
+    Lanes of 8 bit unsigned integers. operator+, operator- and operator* wrap around, add_saturate and
+    subtract_saturate clamp to the range of the lane type.
+*/
+template <>
+class simd<uint8_t, 16> : public simd_common<simd<uint8_t, 16>> {
+public:
+    using type = uint8_t;
+    using mask_type = simd_mask<uint8_t, 16>;
+    static constexpr size_t value_count = 16;
+
+    simd() noexcept
+        : _d(vdupq_n_u8(0))
+    {
+    }
+    explicit simd(uint8_t value) noexcept
+        : _d(vdupq_n_u8(value))
+    {
+    }
+    simd(uint8_t s0, uint8_t s1, uint8_t s2, uint8_t s3,
+        uint8_t s4, uint8_t s5, uint8_t s6, uint8_t s7,
+        uint8_t s8, uint8_t s9, uint8_t s10, uint8_t s11,
+        uint8_t s12, uint8_t s13, uint8_t s14, uint8_t s15) noexcept
+    {
+        alignas(16) const uint8_t data[] = { s0, s1, s2, s3,
+            s4, s5, s6, s7,
+            s8, s9, s10, s11,
+            s12, s13, s14, s15 };
+        this->_d = vld1q_u8(data);
+    }
+    explicit simd(uint8x16_t value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const uint8_t* input) noexcept
+        : _d(vld1q_u8(input))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const uint8_t* input, size_t count) noexcept
+    {
+        if (count >= 16)
+            return simd{ input };
+        alignas(16) uint8_t buffer[16] = {};
+        std::memcpy(buffer, input, count * sizeof(uint8_t));
+        return load_aligned(buffer);
+    }
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const uint8_t* input) noexcept
+    {
+        return simd{ vld1q_u8(input) };
+    }
+
+    uint8x16_t native() const noexcept
+    {
+        return this->_d;
+    }
+
+    void store(uint8_t* output) const noexcept
+    {
+        vst1q_u8(output, this->_d);
+    }
+
+    void store_aligned(uint8_t* output) const noexcept
+    {
+        vst1q_u8(output, this->_d);
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(uint8_t* output, size_t count) const noexcept
+    {
+        if (count >= 16) {
+            vst1q_u8(output, this->_d);
+            return;
+        }
+        alignas(16) uint8_t buffer[16];
+        this->store_aligned(buffer);
+        std::memcpy(output, buffer, count * sizeof(uint8_t));
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ vaddq_u8(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        this->_d = vaddq_u8(this->_d, other._d);
+        return *this;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ vsubq_u8(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        this->_d = vsubq_u8(this->_d, other._d);
+        return *this;
+    }
+    /**
+        a + b clamped to the range of uint8_t.
+    */
+    simd add_saturate(const simd& other) const noexcept
+    {
+        return simd{ vqaddq_u8(this->_d, other._d) };
+    }
+    /**
+        a - b clamped to the range of uint8_t.
+    */
+    simd subtract_saturate(const simd& other) const noexcept
+    {
+        return simd{ vqsubq_u8(this->_d, other._d) };
+    }
+    /**
+        Low half of the product, i.e. the wrapping a * b.
+    */
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ vmulq_u8(this->_d, other._d) };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        this->_d = vmulq_u8(this->_d, other._d);
+        return *this;
+    }
+    /**
+        High half of the 16 bit product.
+    */
+    simd mulhi(const simd& other) const noexcept
+    {
+        const auto low = vmull_u8(vget_low_u8(this->_d), vget_low_u8(other._d));
+        const auto high = vmull_u8(vget_high_u8(this->_d), vget_high_u8(other._d));
+        return simd{ vcombine_u8(vshrn_n_u16(low, 8), vshrn_n_u16(high, 8)) };
+    }
+
+    template <int count>
+    simd shift_left() const noexcept
+    {
+        static_assert(count >= 0 && count < 8, "shift count out of range");
+        return simd{ vshlq_n_u8(this->_d, count) };
+    }
+    /**
+        Logical right shift.
+    */
+    template <int count>
+    simd shift_right() const noexcept
+    {
+        static_assert(count >= 0 && count < 8, "shift count out of range");
+        // vshrq_n does not accept 0, a shift left by a negative constant compiles to the same instruction
+        return simd{ vshlq_u8(this->_d, vdupq_n_s8(-count)) };
+    }
+    /**
+        Shifts each lane left by the corresponding lane of counts, which have to be in [0, 8).
+    */
+    simd shift_left(const simd& counts) const noexcept
+    {
+        return simd{ vshlq_u8(this->_d, vreinterpretq_s8_u8(counts._d)) };
+    }
+    /**
+        Logical right shift of each lane by the corresponding lane of counts, which have to be in [0, 8).
+    */
+    simd shift_right(const simd& counts) const noexcept
+    {
+        return simd{ vshlq_u8(this->_d, vnegq_s8(vreinterpretq_s8_u8(counts._d))) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ vandq_u8(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ vorrq_u8(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ veorq_u8(this->_d, other._d) };
+    }
+    simd operator~() const noexcept
+    {
+        return simd{ vmvnq_u8(this->_d) };
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ vminq_u8(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ vmaxq_u8(this->_d, other._d) };
+    }
+    /**
+        (a + b + 1) / 2 rounded down, without intermediate overflow.
+    */
+    simd avg(const simd& other) const noexcept
+    {
+        return simd{ vrhaddq_u8(this->_d, other._d) };
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ priv::neon_permute<idx...>(this->_d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ vceqq_u8(this->_d, other._d) };
+        case compare_flags::lower:
+            return mask_type{ vcltq_u8(this->_d, other._d) };
+        case compare_flags::lower_equal:
+            return mask_type{ vcleq_u8(this->_d, other._d) };
+        case compare_flags::greater:
+            return mask_type{ vcgtq_u8(this->_d, other._d) };
+        case compare_flags::greater_equal:
+            return mask_type{ vcgeq_u8(this->_d, other._d) };
+        case compare_flags::not_equal:
+            return mask_type{ vmvnq_u8(vceqq_u8(this->_d, other._d)) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ vbslq_u8(mask.native(), a._d, b._d) };
+    }
+
+    /**
+        Sum of all lanes, widened so that it cannot overflow.
+    */
+    uint32_t sum() const noexcept
+    {
+#if defined(__aarch64__)
+        return static_cast<uint32_t>(vaddlvq_u8(this->_d));
+#else
+        const uint64x2_t halves = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(this->_d)));
+        return static_cast<uint32_t>(vgetq_lane_u64(halves, 0) + vgetq_lane_u64(halves, 1));
+#endif
+    }
+    /**
+        Minimum, maximum, product (wrapping), AND and OR of all lanes.
+    */
+    uint8_t reduce_min() const noexcept
+    {
+#if defined(__aarch64__)
+        return vminvq_u8(this->_d);
+#else
+        return fold_halves([](uint8x8_t a, uint8x8_t b) { return vmin_u8(a, b); });
+#endif
+    }
+    uint8_t reduce_max() const noexcept
+    {
+#if defined(__aarch64__)
+        return vmaxvq_u8(this->_d);
+#else
+        return fold_halves([](uint8x8_t a, uint8x8_t b) { return vmax_u8(a, b); });
+#endif
+    }
+    uint8_t reduce_product() const noexcept
+    {
+        return fold_halves([](uint8x8_t a, uint8x8_t b) { return vmul_u8(a, b); });
+    }
+    uint8_t reduce_and() const noexcept
+    {
+        return fold_halves([](uint8x8_t a, uint8x8_t b) { return vand_u8(a, b); });
+    }
+    uint8_t reduce_or() const noexcept
+    {
+        return fold_halves([](uint8x8_t a, uint8x8_t b) { return vorr_u8(a, b); });
+    }
+
+private:
+    /**
+        Combines the two halves with op, then keeps halving by rotating the upper lanes down.
+    */
+    template <typename Op>
+    uint8_t fold_halves(Op op) const noexcept
+    {
+        uint8x8_t result = op(vget_low_u8(this->_d), vget_high_u8(this->_d));
+        result = op(result, vext_u8(result, result, 4));
+        result = op(result, vext_u8(result, result, 2));
+        result = op(result, vext_u8(result, result, 1));
+        return vget_lane_u8(result, 0);
+    }
+
+    uint8x16_t _d;
+};
+
+using simdu8x16 = simd<uint8_t, 16>;
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+SIMD_NAMESPACE_BEGIN
+
+namespace priv {
+
+/**
+    Instruction patterns a permute can be mapped to, see permute_pattern.
+*/
+enum permute_strategy {
+    permute_identity,
+    permute_broadcast,
+    permute_rotate,
+    permute_reverse,
+    permute_zip_low,
+    permute_zip_high,
+    permute_unzip_even,
+    permute_unzip_odd,
+    permute_transpose_even,
+    permute_transpose_odd,
+    permute_grouped,
+    permute_halves,
+    permute_general
+};
+
+template <permute_strategy S>
+using permute_tag = std::integral_constant<permute_strategy, S>;
+
+/**
+    Compile time properties of the lane indices of permute<idx...>(): lane i of the result is
+    lane idx[i] of the input. The backends use them to pick the cheapest instruction sequence.
+*/
+template <unsigned... idx>
+struct permute_pattern {
+    static constexpr unsigned lane_count = sizeof...(idx);
+
+    static constexpr unsigned at(unsigned lane) noexcept
+    {
+        const unsigned values[] = { idx... };
+        return values[lane];
+    }
+    static constexpr bool in_range() noexcept
+    {
+        for (unsigned i = 0; i < lane_count; ++i) {
+            if (at(i) >= lane_count)
+                return false;
+        }
+        return true;
+    }
+    static constexpr bool is_identity() noexcept
+    {
+        for (unsigned i = 0; i < lane_count; ++i) {
+            if (at(i) != i)
+                return false;
+        }
+        return true;
+    }
+    static constexpr bool is_broadcast() noexcept
+    {
+        for (unsigned i = 1; i < lane_count; ++i) {
+            if (at(i) != at(0))
+                return false;
+        }
+        return true;
+    }
+    /**
+        k if idx[i] == (i + k) % lane_count, i.e. the lanes are rotated towards lane 0 by k, otherwise 0.
+    */
+    static constexpr unsigned rotation() noexcept
+    {
+        for (unsigned k = 1; k < lane_count; ++k) {
+            bool match = true;
+            for (unsigned i = 0; i < lane_count; ++i)
+                match = match && at(i) == (i + k) % lane_count;
+            if (match)
+                return k;
+        }
+        return 0;
+    }
+    /**
+        m if idx[i] == i ^ m, i.e. the lanes are reversed within groups of m + 1 lanes, otherwise 0.
+    */
+    static constexpr unsigned reverse_mask() noexcept
+    {
+        const unsigned mask = at(0);
+        for (unsigned i = 0; i < lane_count; ++i) {
+            if (at(i) != (i ^ mask))
+                return 0;
+        }
+        return mask;
+    }
+    /**
+        True if aligned groups of size consecutive lanes move together, so the permute can be done
+        on lanes size times wider with the indices group_at(size, g).
+    */
+    static constexpr bool is_grouped(unsigned size) noexcept
+    {
+        for (unsigned i = 0; i < lane_count; ++i) {
+            if (at(i) % size != i % size || at(i) - i % size != at(i - i % size))
+                return false;
+        }
+        return true;
+    }
+    static constexpr unsigned group_at(unsigned size, unsigned group) noexcept
+    {
+        return at(group * size) / size;
+    }
+    /**
+        True if no lane crosses between the low and the high 64 bits.
+    */
+    static constexpr bool within_halves() noexcept
+    {
+        for (unsigned i = 0; i < lane_count; ++i) {
+            if ((at(i) < lane_count / 2) != (i < lane_count / 2))
+                return false;
+        }
+        return true;
+    }
+    /**
+        Lane i of zip / unzip / transpose of the register with itself, e.g. for 4 lanes zip low is
+        { 0, 0, 1, 1 }, unzip even is { 0, 2, 0, 2 } and transpose even is { 0, 0, 2, 2 }.
+    */
+    static constexpr unsigned interleave_lane(permute_strategy strategy, unsigned i) noexcept
+    {
+        return strategy == permute_zip_low ? i / 2
+            : strategy == permute_zip_high ? lane_count / 2 + i / 2
+            : strategy == permute_unzip_even ? (2 * i) % lane_count
+            : strategy == permute_unzip_odd ? (2 * i + 1) % lane_count
+            : strategy == permute_transpose_even ? i & ~1u
+                                                 : i | 1u;
+    }
+    static constexpr bool is_interleave(permute_strategy strategy) noexcept
+    {
+        for (unsigned i = 0; i < lane_count; ++i) {
+            if (at(i) != interleave_lane(strategy, i))
+                return false;
+        }
+        return true;
+    }
+    /**
+        Source byte of byte b of the result, for lanes of lane_bytes bytes.
+    */
+    static constexpr unsigned byte_at(unsigned lane_bytes, unsigned b) noexcept
+    {
+        return at(b / lane_bytes) * lane_bytes + b % lane_bytes;
+    }
+};
+
+} // namespace priv
+
+SIMD_NAMESPACE_END
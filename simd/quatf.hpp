@@ -0,0 +1,279 @@
+#pragma once
+
+#include "simd_math.hpp"
+#include "simdf4.hpp"
+#include "vec3f.hpp"
+
+#include <cmath>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Rotation quaternion in one simdf4, lanes { x, y, z, w } with w the real part. Products
+    compose like matrices: (a * b).rotate(v) == a.rotate(b.rotate(v)).
+*/
+class quatf {
+public:
+    /**
+        Zero quaternion, like the default constructed simd types. Use identity() for no rotation.
+    */
+    quatf() noexcept = default;
+    quatf(float x, float y, float z, float w) noexcept
+        : _q(x, y, z, w)
+    {
+    }
+    explicit quatf(const simdf4& xyzw) noexcept
+        : _q(xyzw)
+    {
+    }
+    static quatf identity() noexcept
+    {
+        return quatf{ 0, 0, 0, 1 };
+    }
+    /**
+        Rotation by angle radians around axis, which has to be normalized.
+    */
+    static quatf from_axis_angle(const vec3f& axis, float angle) noexcept
+    {
+        const float s = std::sin(0.5f * angle);
+        return quatf{ axis.x * s, axis.y * s, axis.z * s, std::cos(0.5f * angle) };
+    }
+
+    const simdf4& native() const noexcept
+    {
+        return this->_q;
+    }
+    std::array<float, 4> to_array() const noexcept
+    {
+        return this->_q.to_array();
+    }
+
+    /**
+        Hamilton product, the rotation other followed by this one.
+    */
+    quatf operator*(const quatf& other) const noexcept
+    {
+        const simdf4& b = other._q;
+        // x, y and z each multiply a signed permutation of b, w multiplies b itself
+        const simdf4 bx = b.permute<3, 2, 1, 0>() ^ simdf4(0.0f, -0.0f, 0.0f, -0.0f);
+        const simdf4 by = b.permute<2, 3, 0, 1>() ^ simdf4(0.0f, 0.0f, -0.0f, -0.0f);
+        const simdf4 bz = b.permute<1, 0, 3, 2>() ^ simdf4(-0.0f, 0.0f, 0.0f, -0.0f);
+        const simdf4 xy = simdf4::fma(this->_q.permute<1, 1, 1, 1>(), by, this->_q.permute<0, 0, 0, 0>() * bx);
+        const simdf4 zw = simdf4::fma(this->_q.permute<2, 2, 2, 2>(), bz, this->_q.permute<3, 3, 3, 3>() * b);
+        return quatf{ xy + zw };
+    }
+    quatf& operator*=(const quatf& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    /**
+        The inverse rotation of a unit quaternion.
+    */
+    quatf conjugate() const noexcept
+    {
+        return quatf{ this->_q ^ simdf4(-0.0f, -0.0f, -0.0f, 0.0f) };
+    }
+    static float dot(const quatf& a, const quatf& b) noexcept
+    {
+        return simdf4::dot(a._q, b._q);
+    }
+    /**
+        Scales to unit length with rsqrt, see simd_base::precision.
+    */
+    template <simd_base::precision P = simd_base::newton_1>
+    quatf normalize() const noexcept
+    {
+        return quatf{ this->_q * simdf4(dot(*this, *this)).rsqrt<P>() };
+    }
+
+    /**
+        Normalized linear interpolation along the shorter arc. Cheaper than slerp, the angular
+        speed is not constant but the result is the same at t = 0, 0.5 and 1.
+    */
+    template <simd_base::precision P = simd_base::newton_1>
+    static quatf nlerp(const quatf& a, const quatf& b, float t) noexcept
+    {
+        const simdf4 near_b = dot(a, b) < 0 ? b._q ^ simdf4(-0.0f) : b._q;
+        return quatf{ simdf4::fma(simdf4(t), near_b - a._q, a._q) }.normalize<P>();
+    }
+    /**
+        Spherical linear interpolation along the shorter arc, a and b have to be normalized.
+        Falls back to nlerp when the angle is too small for the sine ratios to be accurate.
+    */
+    static quatf slerp(const quatf& a, const quatf& b, float t) noexcept
+    {
+        float d = dot(a, b);
+        const simdf4 near_b = d < 0 ? b._q ^ simdf4(-0.0f) : b._q;
+        d = std::fabs(d);
+        if (d > 0.9995f)
+            return nlerp<simd_base::exact>(a, quatf{ near_b }, t);
+        const float angle = std::acos(d);
+        const float scale = 1.0f / std::sin(angle);
+        const float wa = std::sin((1.0f - t) * angle) * scale;
+        const float wb = std::sin(t * angle) * scale;
+        return quatf{ simdf4::fma(a._q, simdf4(wa), near_b * simdf4(wb)) };
+    }
+
+    /**
+        Rotates lanes 0 to 2 of v by this unit quaternion, lane 3 is passed through:
+        v + w t + q x t with t = 2 q x v.
+    */
+    simdf4 rotate(const simdf4& v) const noexcept
+    {
+        const simdf4 t = cross(this->_q, v) * simdf4(2.0f);
+        const simdf4 r = simdf4::fma(this->_q.permute<3, 3, 3, 3>(), t, v) + cross(this->_q, t);
+        return simdf4::select(simdf4::mask_type::first(3), r, v);
+    }
+    vec3f rotate(const vec3f& v) const noexcept
+    {
+        const auto r = this->rotate(simdf4(v.x, v.y, v.z, 0.0f)).to_array();
+        return vec3f{ r[0], r[1], r[2] };
+    }
+    /**
+        Rigid transform: rotation by this quaternion, then translation.
+    */
+    vec3f transform(const vec3f& v, const vec3f& translation) const noexcept
+    {
+        const auto r = (this->rotate(simdf4(v.x, v.y, v.z, 0.0f)) + simdf4(translation.x, translation.y, translation.z, 0.0f)).to_array();
+        return vec3f{ r[0], r[1], r[2] };
+    }
+
+private:
+    /**
+        a x b in lanes 0 to 2, lane 3 is unspecified.
+    */
+    static simdf4 cross(const simdf4& a, const simdf4& b) noexcept
+    {
+        return a.permute<1, 2, 0, 3>() * b.permute<2, 0, 1, 3>() - a.permute<2, 0, 1, 3>() * b.permute<1, 2, 0, 3>();
+    }
+
+    simdf4 _q;
+};
+
+/**
+    4 quaternions in SoA form, one register per component, for batches of rotations. The
+    operations are those of quatf, lane i of each register belongs to quaternion i.
+*/
+struct quatf4 {
+    simdf4 x;
+    simdf4 y;
+    simdf4 z;
+    simdf4 w;
+
+    /**
+        Loads 4 consecutive quatf and transposes them.
+    */
+    static quatf4 load(const quatf* input) noexcept
+    {
+        quatf4 result{ input[0].native(), input[1].native(), input[2].native(), input[3].native() };
+        simdf4::transpose(result.x, result.y, result.z, result.w);
+        return result;
+    }
+    /**
+        Stores the 4 quaternions as consecutive quatf.
+    */
+    void store(quatf* output) const noexcept
+    {
+        simdf4 q0 = this->x, q1 = this->y, q2 = this->z, q3 = this->w;
+        simdf4::transpose(q0, q1, q2, q3);
+        output[0] = quatf{ q0 };
+        output[1] = quatf{ q1 };
+        output[2] = quatf{ q2 };
+        output[3] = quatf{ q3 };
+    }
+
+    quatf4 operator*(const quatf4& b) const noexcept
+    {
+        return quatf4{ simdf4::fma(this->w, b.x, simdf4::fma(this->x, b.w, simdf4::fms(this->y, b.z, this->z * b.y))),
+            simdf4::fma(this->w, b.y, simdf4::fma(this->y, b.w, simdf4::fms(this->z, b.x, this->x * b.z))),
+            simdf4::fma(this->w, b.z, simdf4::fma(this->z, b.w, simdf4::fms(this->x, b.y, this->y * b.x))),
+            simdf4::fms(this->w, b.w, simdf4::fma(this->x, b.x, simdf4::fma(this->y, b.y, this->z * b.z))) };
+    }
+    quatf4 conjugate() const noexcept
+    {
+        const simdf4 sign(-0.0f);
+        return quatf4{ this->x ^ sign, this->y ^ sign, this->z ^ sign, this->w };
+    }
+    static simdf4 dot(const quatf4& a, const quatf4& b) noexcept
+    {
+        return simdf4::fma(a.x, b.x, simdf4::fma(a.y, b.y, simdf4::fma(a.z, b.z, a.w * b.w)));
+    }
+    template <simd_base::precision P = simd_base::newton_1>
+    quatf4 normalize() const noexcept
+    {
+        return this->scale(dot(*this, *this).rsqrt<P>());
+    }
+
+    template <simd_base::precision P = simd_base::newton_1>
+    static quatf4 nlerp(const quatf4& a, const quatf4& b, const simdf4& t) noexcept
+    {
+        const quatf4 near_b = b.flip_sign(dot(a, b));
+        return quatf4{ simdf4::fma(t, near_b.x - a.x, a.x), simdf4::fma(t, near_b.y - a.y, a.y),
+            simdf4::fma(t, near_b.z - a.z, a.z), simdf4::fma(t, near_b.w - a.w, a.w) }
+            .normalize<P>();
+    }
+    /**
+        Like quatf::slerp for each lane, with the sines from simd_math (3 ulp).
+    */
+    static quatf4 slerp(const quatf4& a, const quatf4& b, const simdf4& t) noexcept
+    {
+        const simdf4 d = dot(a, b);
+        const quatf4 near_b = b.flip_sign(d);
+        const simdf4 cos_angle = d.abs().min(simdf4(1.0f));
+        const simdf4 sin_angle = (simdf4(1.0f) - cos_angle * cos_angle).sqrt();
+        const simdf4 angle = simd_math::atan2(sin_angle, cos_angle);
+        const simdf4 scale = simdf4(1.0f) / sin_angle;
+        const auto close = cos_angle.compare(simdf4(0.9995f), simd_base::compare_flags::greater);
+        const simdf4 wa = simdf4::select(close, simdf4(1.0f) - t, simd_math::sin((simdf4(1.0f) - t) * angle) * scale);
+        const simdf4 wb = simdf4::select(close, t, simd_math::sin(t * angle) * scale);
+        const quatf4 result = a.scale(wa).add(near_b.scale(wb));
+        // the linear fallback lanes need normalizing, the others stay (nearly) unchanged
+        const simdf4 length = simdf4::select(close, dot(result, result).rsqrt(), simdf4(1.0f));
+        return result.scale(length);
+    }
+
+    /**
+        Rotates lane i of v by quaternion i, see quatf::rotate.
+    */
+    vec3f4 rotate(const vec3f4& v) const noexcept
+    {
+        const vec3f4 t = cross(*this, v);
+        const vec3f4 t2{ t.x + t.x, t.y + t.y, t.z + t.z };
+        const vec3f4 c = cross(*this, t2);
+        return vec3f4{ simdf4::fma(this->w, t2.x, v.x) + c.x, simdf4::fma(this->w, t2.y, v.y) + c.y,
+            simdf4::fma(this->w, t2.z, v.z) + c.z };
+    }
+    /**
+        Rigid transforms: rotation of lane i of v by quaternion i, then translation by lane i of
+        translation.
+    */
+    vec3f4 transform(const vec3f4& v, const vec3f4& translation) const noexcept
+    {
+        const vec3f4 r = this->rotate(v);
+        return vec3f4{ r.x + translation.x, r.y + translation.y, r.z + translation.z };
+    }
+
+private:
+    quatf4 scale(const simdf4& s) const noexcept
+    {
+        return quatf4{ this->x * s, this->y * s, this->z * s, this->w * s };
+    }
+    quatf4 add(const quatf4& other) const noexcept
+    {
+        return quatf4{ this->x + other.x, this->y + other.y, this->z + other.z, this->w + other.w };
+    }
+    /**
+        Negates the lanes where sign is negative, for the shorter arc.
+    */
+    quatf4 flip_sign(const simdf4& sign) const noexcept
+    {
+        const simdf4 bit = sign & simdf4(-0.0f);
+        return quatf4{ this->x ^ bit, this->y ^ bit, this->z ^ bit, this->w ^ bit };
+    }
+    static vec3f4 cross(const quatf4& q, const vec3f4& v) noexcept
+    {
+        return vec3f4{ q.y * v.z - q.z * v.y, q.z * v.x - q.x * v.z, q.x * v.y - q.y * v.x };
+    }
+};
+
+SIMD_NAMESPACE_END
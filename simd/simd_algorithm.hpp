@@ -0,0 +1,494 @@
+#pragma once
+
+#include "simd_dispatch.hpp"
+#include "simdd2.hpp"
+#include "simdd4.hpp"
+#include "simdf16.hpp"
+#include "simdf4.hpp"
+#include "simdf8.hpp"
+#include "simdi16x8.hpp"
+#include "simdi32x4.hpp"
+#include "simdu16x8.hpp"
+#include "simdu32x4.hpp"
+#include "simdu8x16.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Loops over whole arrays, built on the simd types. The kernels are generic callables applied
+    to simd<T, N> values, e.g.
+
+        simd_algorithm::transform(input, count, output, [](auto v) { return v * v; });
+
+    Each algorithm peels the head up to the register alignment of the output (of the input for
+    reduce), runs the body four registers per iteration, and finishes the tail with partial loads
+    and stores, so memory outside of the given ranges is never accessed. The register width is the
+    widest one native to the compile flags, see native_width. With the operations below on float
+    arrays, transform and reduce instead run the kernel of the widest level the CPU supports when
+    SIMD_DISPATCH is defined (see simd_dispatch.hpp):
+
+        simd_algorithm::reduce(input, count, 0.0f, simd_algorithm::plus());
+
+    (The namespace is not called simd, that name is taken by the class template.)
+*/
+namespace simd_algorithm {
+
+/**
+    Number of lanes of the widest register for T supported by the compile flags (the dispatched
+    float kernels may use wider ones).
+*/
+template <typename T>
+struct native_width;
+
+template <>
+struct native_width<float> : std::integral_constant<size_t,
+#if defined(SIMD_BACKEND_X86) && defined(__AVX512F__)
+                                 16
+#elif defined(SIMD_BACKEND_X86) && defined(__AVX__)
+                                 8
+#else
+                                 4
+#endif
+                                 > {
+};
+template <>
+struct native_width<double> : std::integral_constant<size_t,
+#if defined(SIMD_BACKEND_X86) && defined(__AVX__)
+                                  4
+#else
+                                  2
+#endif
+                                  > {
+};
+template <>
+struct native_width<int32_t> : std::integral_constant<size_t, 4> {
+};
+template <>
+struct native_width<uint32_t> : std::integral_constant<size_t, 4> {
+};
+template <>
+struct native_width<int16_t> : std::integral_constant<size_t, 8> {
+};
+template <>
+struct native_width<uint16_t> : std::integral_constant<size_t, 8> {
+};
+template <>
+struct native_width<uint8_t> : std::integral_constant<size_t, 16> {
+};
+
+namespace priv {
+    /**
+        Number of leading elements to process separately so that address + result is aligned to
+        the register size of V.
+    */
+    template <typename V, typename T>
+    size_t head_count(const T* address, size_t count) noexcept
+    {
+        constexpr size_t register_bytes = V::bit_count() / 8;
+        const size_t misalignment = reinterpret_cast<uintptr_t>(address) % register_bytes;
+        if (misalignment == 0)
+            return 0;
+        const size_t head = (register_bytes - misalignment) / sizeof(T);
+        return head < count ? head : count;
+    }
+} // namespace priv
+
+/**
+    a + b, a * b, a.min(b) and a.max(b), for reduce and the binary transform.
+*/
+struct plus {
+    template <typename V>
+    V operator()(const V& a, const V& b) const noexcept
+    {
+        return a + b;
+    }
+};
+struct multiplies {
+    template <typename V>
+    V operator()(const V& a, const V& b) const noexcept
+    {
+        return a * b;
+    }
+};
+struct minimum {
+    template <typename V>
+    V operator()(const V& a, const V& b) const noexcept
+    {
+        return a.min(b);
+    }
+};
+struct maximum {
+    template <typename V>
+    V operator()(const V& a, const V& b) const noexcept
+    {
+        return a.max(b);
+    }
+};
+/**
+    v.abs() and v.sqrt(), for the unary transform of float and double.
+*/
+struct absolute {
+    template <typename V>
+    V operator()(const V& v) const noexcept
+    {
+        return v.abs();
+    }
+};
+struct square_root {
+    template <typename V>
+    V operator()(const V& v) const noexcept
+    {
+        return v.sqrt();
+    }
+};
+
+namespace priv {
+    /**
+        Index of Op into the tables of simd_dispatch::float_kernels, -1 if it has no dispatched
+        kernel.
+    */
+    template <typename Op>
+    struct unary_op_index : std::integral_constant<int, -1> {
+    };
+    template <>
+    struct unary_op_index<absolute> : std::integral_constant<int, simd_dispatch::absolute_op> {
+    };
+    template <>
+    struct unary_op_index<square_root> : std::integral_constant<int, simd_dispatch::square_root_op> {
+    };
+    template <typename Op>
+    struct binary_op_index : std::integral_constant<int, -1> {
+    };
+    template <>
+    struct binary_op_index<plus> : std::integral_constant<int, simd_dispatch::plus_op> {
+    };
+    template <>
+    struct binary_op_index<multiplies> : std::integral_constant<int, simd_dispatch::multiplies_op> {
+    };
+    template <>
+    struct binary_op_index<minimum> : std::integral_constant<int, simd_dispatch::minimum_op> {
+    };
+    template <>
+    struct binary_op_index<maximum> : std::integral_constant<int, simd_dispatch::maximum_op> {
+    };
+
+    template <typename T, typename Index>
+    using dispatched = std::integral_constant<bool,
+        simd_dispatch::enabled && std::is_same<T, float>::value && (Index::value >= 0)>;
+
+    /**
+        The loops of transform and reduce at the compiled level.
+    */
+    template <typename T, typename UnaryOp>
+    void transform_kernel(const T* input, size_t count, T* output, UnaryOp op)
+    {
+        constexpr size_t N = native_width<T>::value;
+        using V = simd<T, N>;
+
+        size_t i = priv::head_count<V>(output, count);
+        if (i != 0)
+            op(V::load_partial(input, i)).store_partial(output, i);
+        for (; i + 4 * N <= count; i += 4 * N) {
+            const V r0 = op(V(input + i));
+            const V r1 = op(V(input + i + N));
+            const V r2 = op(V(input + i + 2 * N));
+            const V r3 = op(V(input + i + 3 * N));
+            r0.store_aligned(output + i);
+            r1.store_aligned(output + i + N);
+            r2.store_aligned(output + i + 2 * N);
+            r3.store_aligned(output + i + 3 * N);
+        }
+        for (; i + N <= count; i += N)
+            op(V(input + i)).store_aligned(output + i);
+        if (i < count)
+            op(V::load_partial(input + i, count - i)).store_partial(output + i, count - i);
+    }
+    template <typename T, typename BinaryOp>
+    void transform_kernel(const T* input1, const T* input2, size_t count, T* output, BinaryOp op)
+    {
+        constexpr size_t N = native_width<T>::value;
+        using V = simd<T, N>;
+
+        size_t i = priv::head_count<V>(output, count);
+        if (i != 0)
+            op(V::load_partial(input1, i), V::load_partial(input2, i)).store_partial(output, i);
+        for (; i + 4 * N <= count; i += 4 * N) {
+            const V r0 = op(V(input1 + i), V(input2 + i));
+            const V r1 = op(V(input1 + i + N), V(input2 + i + N));
+            const V r2 = op(V(input1 + i + 2 * N), V(input2 + i + 2 * N));
+            const V r3 = op(V(input1 + i + 3 * N), V(input2 + i + 3 * N));
+            r0.store_aligned(output + i);
+            r1.store_aligned(output + i + N);
+            r2.store_aligned(output + i + 2 * N);
+            r3.store_aligned(output + i + 3 * N);
+        }
+        for (; i + N <= count; i += N)
+            op(V(input1 + i), V(input2 + i)).store_aligned(output + i);
+        if (i < count) {
+            const size_t rest = count - i;
+            op(V::load_partial(input1 + i, rest), V::load_partial(input2 + i, rest)).store_partial(output + i, rest);
+        }
+    }
+    /**
+        op(init, op(lane 0, op(lane 1, ...))) over the first count lanes of acc.
+    */
+    template <typename T, typename V, typename BinaryOp>
+    T fold_lanes(const V& acc, size_t count, T init, BinaryOp op)
+    {
+        const auto lanes = acc.to_array();
+        T result = lanes[0];
+        for (size_t lane = 1; lane < count; ++lane)
+            result = op(V(result), V(lanes[lane])).to_array()[0];
+        return op(V(init), V(result)).to_array()[0];
+    }
+
+    template <typename T, typename BinaryOp>
+    T reduce_kernel(const T* input, size_t count, T init, BinaryOp op)
+    {
+        constexpr size_t N = native_width<T>::value;
+        using V = simd<T, N>;
+        using mask = typename V::mask_type;
+
+        if (count == 0)
+            return init;
+        const size_t head = priv::head_count<V>(input, count);
+        if (count - head < N) {
+            // no whole aligned register: the first load seeds the lanes that are used at all
+            const size_t used = count < N ? count : N;
+            V acc = V::load_partial(input, used);
+            for (size_t i = used; i < count; i += N) {
+                const size_t n = count - i < N ? count - i : N;
+                acc = V::select(mask::first(n), op(acc, V::load_partial(input + i, n)), acc);
+            }
+            return fold_lanes(acc, used, init, op);
+        }
+
+        size_t i = head;
+        V acc0 = V::load_aligned(input + i);
+        if (i + 4 * N <= count) {
+            V acc1 = V::load_aligned(input + i + N);
+            V acc2 = V::load_aligned(input + i + 2 * N);
+            V acc3 = V::load_aligned(input + i + 3 * N);
+            for (i += 4 * N; i + 4 * N <= count; i += 4 * N) {
+                acc0 = op(acc0, V::load_aligned(input + i));
+                acc1 = op(acc1, V::load_aligned(input + i + N));
+                acc2 = op(acc2, V::load_aligned(input + i + 2 * N));
+                acc3 = op(acc3, V::load_aligned(input + i + 3 * N));
+            }
+            acc0 = op(op(acc0, acc1), op(acc2, acc3));
+        } else {
+            i += N;
+        }
+        for (; i + N <= count; i += N)
+            acc0 = op(acc0, V::load_aligned(input + i));
+        if (head != 0)
+            acc0 = V::select(mask::first(head), op(acc0, V::load_partial(input, head)), acc0);
+        if (i < count)
+            acc0 = V::select(mask::first(count - i), op(acc0, V::load_partial(input + i, count - i)), acc0);
+        return fold_lanes(acc0, N, init, op);
+    }
+
+    /**
+        Entry points of the kernels for simd_dispatch::float_kernels.
+    */
+    template <typename UnaryOp>
+    void transform_entry(const float* input, size_t count, float* output)
+    {
+        transform_kernel(input, count, output, UnaryOp());
+    }
+    template <typename BinaryOp>
+    void transform_entry(const float* input1, const float* input2, size_t count, float* output)
+    {
+        transform_kernel(input1, input2, count, output, BinaryOp());
+    }
+    template <typename BinaryOp>
+    float reduce_entry(const float* input, size_t count, float init)
+    {
+        return reduce_kernel(input, count, init, BinaryOp());
+    }
+
+    template <typename T, typename UnaryOp>
+    void transform(const T* input, size_t count, T* output, UnaryOp op, std::false_type)
+    {
+        transform_kernel(input, count, output, op);
+    }
+    template <typename UnaryOp>
+    void transform(const float* input, size_t count, float* output, UnaryOp, std::true_type)
+    {
+        static const auto kernel = simd_dispatch::select(compiled_isa(), &transform_entry<UnaryOp>,
+            &simd_dispatch::float_kernels::transform, unary_op_index<UnaryOp>::value);
+        kernel(input, count, output);
+    }
+    template <typename T, typename BinaryOp>
+    void transform(const T* input1, const T* input2, size_t count, T* output, BinaryOp op, std::false_type)
+    {
+        transform_kernel(input1, input2, count, output, op);
+    }
+    template <typename BinaryOp>
+    void transform(const float* input1, const float* input2, size_t count, float* output, BinaryOp, std::true_type)
+    {
+        static const auto kernel = simd_dispatch::select(compiled_isa(), &transform_entry<BinaryOp>,
+            &simd_dispatch::float_kernels::transform_binary, binary_op_index<BinaryOp>::value);
+        kernel(input1, input2, count, output);
+    }
+    template <typename T, typename BinaryOp>
+    T reduce(const T* input, size_t count, T init, BinaryOp op, std::false_type)
+    {
+        return reduce_kernel(input, count, init, op);
+    }
+    template <typename BinaryOp>
+    float reduce(const float* input, size_t count, float init, BinaryOp, std::true_type)
+    {
+        static const auto kernel = simd_dispatch::select(compiled_isa(), &reduce_entry<BinaryOp>,
+            &simd_dispatch::float_kernels::reduce, binary_op_index<BinaryOp>::value);
+        return kernel(input, count, init);
+    }
+} // namespace priv
+
+/**
+    output[i] = op(input[i]) for i in [0, count), evaluated a register at a time.
+    input and output may be the same array.
+*/
+template <typename T, typename UnaryOp>
+void transform(const T* input, size_t count, T* output, UnaryOp op)
+{
+    priv::transform(input, count, output, op, priv::dispatched<T, priv::unary_op_index<UnaryOp>>());
+}
+
+/**
+    output[i] = op(input1[i], input2[i]) for i in [0, count).
+    output may be the same array as either input.
+*/
+template <typename T, typename BinaryOp>
+void transform(const T* input1, const T* input2, size_t count, T* output, BinaryOp op)
+{
+    priv::transform(input1, input2, count, output, op, priv::dispatched<T, priv::binary_op_index<BinaryOp>>());
+}
+
+/**
+    op(init, v) where v combines all values with op, which has to be associative and commutative.
+    Like std::reduce, init is applied exactly once and returned for an empty input.
+
+    The order of the combinations depends on the register width and the alignment of input,
+    so floating point sums may differ in the last bits between builds (and between CPUs for the
+    dispatched kernels).
+*/
+template <typename T, typename BinaryOp>
+T reduce(const T* input, size_t count, T init, BinaryOp op)
+{
+    return priv::reduce(input, count, init, op, priv::dispatched<T, priv::binary_op_index<BinaryOp>>());
+}
+
+/**
+    Sets count values of output to value.
+*/
+template <typename T>
+void fill(T* output, size_t count, T value)
+{
+    constexpr size_t N = native_width<T>::value;
+    using V = simd<T, N>;
+
+    const V v(value);
+    size_t i = priv::head_count<V>(output, count);
+    if (i != 0)
+        v.store_partial(output, i);
+    for (; i + 4 * N <= count; i += 4 * N) {
+        v.store_aligned(output + i);
+        v.store_aligned(output + i + N);
+        v.store_aligned(output + i + 2 * N);
+        v.store_aligned(output + i + 3 * N);
+    }
+    for (; i + N <= count; i += N)
+        v.store_aligned(output + i);
+    if (i < count)
+        v.store_partial(output + i, count - i);
+}
+
+/**
+    Copies count values, the ranges must not overlap.
+*/
+template <typename T>
+void copy(const T* input, size_t count, T* output)
+{
+    using V = simd<T, native_width<T>::value>;
+    transform(input, count, output, [](const V& v) { return v; });
+}
+
+namespace priv {
+    template <typename Half>
+    void widen_span(const Half* input, size_t count, float* output) noexcept
+    {
+        using V = simd<float, 4>;
+        size_t i = head_count<V>(output, count);
+        for (size_t j = 0; j < i; ++j)
+            output[j] = input[j].to_float();
+        for (; i + 16 <= count; i += 16) {
+            const V r0(input + i);
+            const V r1(input + i + 4);
+            const V r2(input + i + 8);
+            const V r3(input + i + 12);
+            r0.store_aligned(output + i);
+            r1.store_aligned(output + i + 4);
+            r2.store_aligned(output + i + 8);
+            r3.store_aligned(output + i + 12);
+        }
+        for (; i + 4 <= count; i += 4)
+            V(input + i).store_aligned(output + i);
+        for (; i < count; ++i)
+            output[i] = input[i].to_float();
+    }
+    template <typename Half>
+    void narrow_span(const float* input, size_t count, Half* output) noexcept
+    {
+        using V = simd<float, 4>;
+        size_t i = head_count<V>(input, count);
+        for (size_t j = 0; j < i; ++j)
+            output[j] = Half::from_float(input[j]);
+        for (; i + 16 <= count; i += 16) {
+            V::load_aligned(input + i).store(output + i);
+            V::load_aligned(input + i + 4).store(output + i + 4);
+            V::load_aligned(input + i + 8).store(output + i + 8);
+            V::load_aligned(input + i + 12).store(output + i + 12);
+        }
+        for (; i + 4 <= count; i += 4)
+            V::load_aligned(input + i).store(output + i);
+        for (; i < count; ++i)
+            output[i] = Half::from_float(input[i]);
+    }
+} // namespace priv
+
+/**
+    Widens count float16 values to float. Conversions are exact.
+*/
+inline void convert_span(const float16* input, size_t count, float* output) noexcept
+{
+    priv::widen_span(input, count, output);
+}
+/**
+    Widens count bfloat16 values to float. Conversions are exact.
+*/
+inline void convert_span(const bfloat16* input, size_t count, float* output) noexcept
+{
+    priv::widen_span(input, count, output);
+}
+/**
+    Rounds count floats to float16, nearest even. Magnitudes from 65520 up become infinity.
+*/
+inline void convert_span(const float* input, size_t count, float16* output) noexcept
+{
+    priv::narrow_span(input, count, output);
+}
+/**
+    Rounds count floats to bfloat16, nearest even.
+*/
+inline void convert_span(const float* input, size_t count, bfloat16* output) noexcept
+{
+    priv::narrow_span(input, count, output);
+}
+
+} // namespace simd_algorithm
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,62 @@
+#pragma once
+
+/**
+    Selects the implementation behind the simd types:
+
+        SIMD_BACKEND_X86        SSE / AVX / AVX-512 intrinsics (x86/), the default on x86 targets
+        SIMD_BACKEND_NEON       NEON intrinsics (neon/), the default on Android and ARM targets with NEON
+        SIMD_BACKEND_GENERIC    portable lane loops (generic/), the default on every other target
+
+    Defining SIMD_BACKEND_GENERIC before including any simd header (e.g. -DSIMD_BACKEND_GENERIC)
+    forces the portable backend on any target, so its results can be compared against the
+    native one with the same tests on the same machine.
+*/
+#if defined(SIMD_BACKEND_GENERIC)
+#elif defined(__ANDROID__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SIMD_BACKEND_NEON
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_BACKEND_X86
+#else
+#define SIMD_BACKEND_GENERIC
+#endif
+
+/**
+    Instruction set level the simd types are compiled for, one of the enumerators of simd_isa
+    (see compiled_isa()), and the inline namespace holding the simd types and everything built on
+    them for that level:
+
+        SIMD_NAMESPACE_BEGIN
+        ...
+        SIMD_NAMESPACE_END
+
+    Code refers to the types without the namespace (simd<float, 4>, simd_blas::sgemm). Translation
+    units compiled for different levels, like the runtime dispatch variants in simd/dispatch/, so
+    share no inline function of the library: the linker cannot substitute the AVX2 copy of an
+    inline function for the SSE2 one. Translation units of the same level have to be compiled with
+    the same flags.
+*/
+#if defined(SIMD_BACKEND_GENERIC)
+#define SIMD_ISA_LEVEL scalar
+#elif defined(SIMD_BACKEND_NEON)
+#define SIMD_ISA_LEVEL neon
+#elif defined(__AVX512F__) && defined(__AVX512DQ__) && defined(__AVX512BW__) && defined(__AVX512VL__)
+#define SIMD_ISA_LEVEL avx512
+#elif defined(__AVX2__) && defined(__FMA__)
+#define SIMD_ISA_LEVEL avx2
+#elif defined(__AVX__)
+#define SIMD_ISA_LEVEL avx
+#elif defined(__SSE4_1__)
+#define SIMD_ISA_LEVEL sse4_1
+#elif defined(__SSSE3__)
+#define SIMD_ISA_LEVEL ssse3
+#elif defined(__SSE3__)
+#define SIMD_ISA_LEVEL sse3
+#else
+#define SIMD_ISA_LEVEL sse2
+#endif
+
+#define SIMD_CONCAT_IMPL(a, b) a##b
+#define SIMD_CONCAT(a, b) SIMD_CONCAT_IMPL(a, b)
+#define SIMD_ISA_NAMESPACE SIMD_CONCAT(simd_, SIMD_ISA_LEVEL)
+#define SIMD_NAMESPACE_BEGIN inline namespace SIMD_ISA_NAMESPACE {
+#define SIMD_NAMESPACE_END }
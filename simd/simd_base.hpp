@@ -1,8 +1,14 @@
 #pragma once
 
+#include "cpu_features.hpp"
+#include "simd_backend.hpp"
+
 #include <array>
-#include <iosfwd>
-#ifndef __ANDROID__
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#if defined(SIMD_BACKEND_X86)
 extern "C" {
 #include <emmintrin.h>
 #include <pmmintrin.h>
@@ -10,10 +16,26 @@ extern "C" {
 }
 #endif
 
+SIMD_NAMESPACE_BEGIN
+
 template <typename T, size_t ValueCount>
 class simd;
+template <typename T, size_t ValueCount>
+class simd_mask;
+
+namespace priv {
+inline size_t popcount(uint32_t value) noexcept
+{
+#if defined(__GNUC__)
+    return static_cast<size_t>(__builtin_popcount(value));
+#else
+    value = value - ((value >> 1) & 0x55555555u);
+    value = (value & 0x33333333u) + ((value >> 2) & 0x33333333u);
+    return static_cast<size_t>((((value + (value >> 4)) & 0x0f0f0f0fu) * 0x01010101u) >> 24);
+#endif
+}
+} // namespace priv
 
-//TODO: add CPUID checks
 class simd_base {
 public:
     enum cache_coherence {
@@ -28,19 +50,40 @@ public:
         greater_equal,
         not_equal
     };
+    /**
+        Accuracy of rcp() and rsqrt(): the raw hardware estimate (12 bits on SSE/AVX, 14 bits on
+        AVX-512, 8 bits on NEON), the estimate refined by one or two Newton-Raphson steps, or a
+        full precision division / square root. The refined variants are unspecified for zero and
+        infinite inputs.
+    */
+    enum precision {
+        estimate,
+        newton_1,
+        newton_2,
+        exact
+    };
     static void load_fence()
     {
-#ifndef __ANDROID__
+#if defined(SIMD_BACKEND_X86)
         //TODO: optional assert for SSE2 support
         _mm_lfence();
 #endif
     }
     static void store_fence()
     {
-#ifndef __ANDROID__
+#if defined(SIMD_BACKEND_X86)
         _mm_sfence();
 #endif
     }
+    /**
+        Instruction sets available at runtime. The simd types are compiled for the instruction set
+        selected by the compiler flags; this can check that the CPU supports it, or pick between
+        kernel variants like the dispatched kernels of the library do (see simd_select).
+    */
+    static const cpu_features& cpu() noexcept
+    {
+        return cpu_features::instance();
+    }
     static bool is_aligned(const void* address, uint32_t alignment) noexcept
     {
         return reinterpret_cast<uint64_t>(address) % alignment == 0;
@@ -57,7 +100,7 @@ public:
 
     auto to_array() const noexcept
     {
-        alignas(16) std::array<typename SimdClass::type, SimdClass::value_count> result;
+        alignas(bit_count() / 8) std::array<typename SimdClass::type, SimdClass::value_count> result;
         static_cast<const SimdClass*>(this)->store_aligned(result.data());
         return result;
     }
@@ -71,3 +114,5 @@ public:
         return out << data[data.size() - 1] << ']';
     }
 };
+
+SIMD_NAMESPACE_END
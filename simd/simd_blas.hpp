@@ -0,0 +1,356 @@
+#pragma once
+
+#include "simd_algorithm.hpp"
+#include "simd_gemm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Level 1 and 2 kernels on contiguous float arrays, with the argument order of CBLAS without the
+    increments (see sgemm for layout and operation):
+
+        simd_blas::saxpy(n, 2.0f, x, y);   // y = 2 x + y
+        simd_blas::sgemv(simd_blas::row_major, simd_blas::no_transpose, m, n, 1.0f, a, n, x, 0.0f, y);
+
+    The loops run four registers of the native width per iteration, the reductions keep four
+    independent accumulators. Their results may differ in the last bits between builds, like
+    simd_algorithm::reduce. Kernels that write a vector take a cache_coherence flag:
+    non_temporal stores the aligned part of the output past the caches, for outputs that are too
+    large to stay cached and are not read again soon. It saves the most memory traffic when the
+    output is not read first, as in sgemv with beta = 0.
+
+    With SIMD_DISPATCH defined, every kernel runs at the widest level the CPU supports (see
+    simd_dispatch.hpp), whatever the compile flags.
+*/
+namespace simd_blas {
+
+namespace priv {
+    using vector = simd<float, simd_algorithm::native_width<float>::value>;
+
+    inline float sum_lanes(const vector& v) noexcept
+    {
+        const auto lanes = v.to_array();
+        float sum = lanes[0];
+        for (size_t i = 1; i < lanes.size(); ++i)
+            sum += lanes[i];
+        return sum;
+    }
+
+    /**
+        y[i] = op(x[i], y[i]) for i in [0, n), stored with cache_flags.
+    */
+    template <typename UpdateOp>
+    void update(size_t n, const float* x, float* y, simd_base::cache_coherence cache_flags, UpdateOp op) noexcept
+    {
+        using V = vector;
+        constexpr size_t N = V::value_count;
+
+        size_t i = simd_algorithm::priv::head_count<V>(y, n);
+        if (i != 0)
+            op(V::load_partial(x, i), V::load_partial(y, i)).store_partial(y, i);
+        for (; i + 4 * N <= n; i += 4 * N) {
+            const V r0 = op(V(x + i), V::load_aligned(y + i));
+            const V r1 = op(V(x + i + N), V::load_aligned(y + i + N));
+            const V r2 = op(V(x + i + 2 * N), V::load_aligned(y + i + 2 * N));
+            const V r3 = op(V(x + i + 3 * N), V::load_aligned(y + i + 3 * N));
+            r0.store_aligned(y + i, cache_flags);
+            r1.store_aligned(y + i + N, cache_flags);
+            r2.store_aligned(y + i + 2 * N, cache_flags);
+            r3.store_aligned(y + i + 3 * N, cache_flags);
+        }
+        for (; i + N <= n; i += N)
+            op(V(x + i), V::load_aligned(y + i)).store_aligned(y + i, cache_flags);
+        if (i < n)
+            op(V::load_partial(x + i, n - i), V::load_partial(y + i, n - i)).store_partial(y + i, n - i);
+        if (cache_flags == simd_base::cache_coherence::non_temporal)
+            simd_base::store_fence();
+    }
+
+    /**
+        Sum of x[i] * x[i] * scale * scale.
+    */
+    inline float sum_of_squares(size_t n, const float* x, float scale) noexcept
+    {
+        using V = vector;
+        constexpr size_t N = V::value_count;
+
+        const V s(scale);
+        V acc0, acc1, acc2, acc3;
+        size_t i = simd_algorithm::priv::head_count<V>(x, n);
+        if (i != 0) {
+            const V v = V::load_partial(x, i) * s;
+            acc0 = v * v;
+        }
+        for (; i + 4 * N <= n; i += 4 * N) {
+            const V v0 = V::load_aligned(x + i) * s;
+            const V v1 = V::load_aligned(x + i + N) * s;
+            const V v2 = V::load_aligned(x + i + 2 * N) * s;
+            const V v3 = V::load_aligned(x + i + 3 * N) * s;
+            acc0 = V::fma(v0, v0, acc0);
+            acc1 = V::fma(v1, v1, acc1);
+            acc2 = V::fma(v2, v2, acc2);
+            acc3 = V::fma(v3, v3, acc3);
+        }
+        for (; i + N <= n; i += N) {
+            const V v = V::load_aligned(x + i) * s;
+            acc0 = V::fma(v, v, acc0);
+        }
+        if (i < n) {
+            const V v = V::load_partial(x + i, n - i) * s;
+            acc1 = V::fma(v, v, acc1);
+        }
+        return sum_lanes((acc0 + acc1) + (acc2 + acc3));
+    }
+
+    /**
+        The kernels behind the public functions at the compiled level, the entry points of
+        simd_dispatch::float_kernels.
+    */
+    inline void saxpy_kernel(size_t n, float alpha, const float* x, float* y, bool non_temporal) noexcept
+    {
+        const vector a(alpha);
+        update(n, x, y, non_temporal ? simd_base::cache_coherence::non_temporal : simd_base::cache_coherence::coherent,
+            [&a](const vector& xv, const vector& yv) { return vector::fma(a, xv, yv); });
+    }
+    inline void sscal_kernel(size_t n, float alpha, float* x, bool non_temporal) noexcept
+    {
+        const vector a(alpha);
+        update(n, x, x, non_temporal ? simd_base::cache_coherence::non_temporal : simd_base::cache_coherence::coherent,
+            [&a](const vector& xv, const vector&) { return a * xv; });
+    }
+    inline float sdot_kernel(size_t n, const float* x, const float* y) noexcept
+    {
+        using V = vector;
+        constexpr size_t N = V::value_count;
+
+        V acc0, acc1, acc2, acc3;
+        size_t i = simd_algorithm::priv::head_count<V>(x, n);
+        if (i != 0)
+            acc0 = V::load_partial(x, i) * V::load_partial(y, i);
+        for (; i + 4 * N <= n; i += 4 * N) {
+            acc0 = V::fma(V::load_aligned(x + i), V(y + i), acc0);
+            acc1 = V::fma(V::load_aligned(x + i + N), V(y + i + N), acc1);
+            acc2 = V::fma(V::load_aligned(x + i + 2 * N), V(y + i + 2 * N), acc2);
+            acc3 = V::fma(V::load_aligned(x + i + 3 * N), V(y + i + 3 * N), acc3);
+        }
+        for (; i + N <= n; i += N)
+            acc0 = V::fma(V::load_aligned(x + i), V(y + i), acc0);
+        if (i < n)
+            acc1 = V::fma(V::load_partial(x + i, n - i), V::load_partial(y + i, n - i), acc1);
+        return sum_lanes((acc0 + acc1) + (acc2 + acc3));
+    }
+    inline float snrm2_kernel(size_t n, const float* x) noexcept
+    {
+        const float sum = sum_of_squares(n, x, 1.0f);
+        if (sum < std::numeric_limits<float>::max() && sum > std::numeric_limits<float>::min() / std::numeric_limits<float>::epsilon())
+            return std::sqrt(sum);
+
+        using V = vector;
+        const float largest = simd_algorithm::reduce(x, n, 0.0f, [](const V& a, const V& b) { return a.abs().max(b.abs()); });
+        if (largest == 0.0f || !(largest < std::numeric_limits<float>::infinity()))
+            return largest;
+        // 2^127 is the largest float power of 2, enough to bring denormal values into the normal range
+        const float scale = std::ldexp(1.0f, std::min(-std::ilogb(largest), 127));
+        return std::sqrt(sum_of_squares(n, x, scale)) / scale;
+    }
+} // namespace priv
+
+/**
+    y = alpha * x + y.
+*/
+inline void saxpy(size_t n, float alpha, const float* x, float* y,
+    simd_base::cache_coherence cache_flags = simd_base::cache_coherence::coherent) noexcept
+{
+    const bool non_temporal = cache_flags == simd_base::cache_coherence::non_temporal;
+    if (!simd_dispatch::enabled) {
+        priv::saxpy_kernel(n, alpha, x, y, non_temporal);
+        return;
+    }
+    static const auto kernel = simd_dispatch::select(compiled_isa(), &priv::saxpy_kernel, &simd_dispatch::float_kernels::saxpy);
+    kernel(n, alpha, x, y, non_temporal);
+}
+
+/**
+    x = alpha * x.
+*/
+inline void sscal(size_t n, float alpha, float* x,
+    simd_base::cache_coherence cache_flags = simd_base::cache_coherence::coherent) noexcept
+{
+    const bool non_temporal = cache_flags == simd_base::cache_coherence::non_temporal;
+    if (!simd_dispatch::enabled) {
+        priv::sscal_kernel(n, alpha, x, non_temporal);
+        return;
+    }
+    static const auto kernel = simd_dispatch::select(compiled_isa(), &priv::sscal_kernel, &simd_dispatch::float_kernels::sscal);
+    kernel(n, alpha, x, non_temporal);
+}
+
+/**
+    Sum of x[i] * y[i].
+*/
+inline float sdot(size_t n, const float* x, const float* y) noexcept
+{
+    if (!simd_dispatch::enabled)
+        return priv::sdot_kernel(n, x, y);
+    static const auto kernel = simd_dispatch::select(compiled_isa(), &priv::sdot_kernel, &simd_dispatch::float_kernels::sdot);
+    return kernel(n, x, y);
+}
+
+/**
+    Euclidean norm of x. The sum of squares is computed once without scaling; only if it
+    overflows or loses precision to underflow, it is recomputed for x scaled by the power of 2
+    that brings max |x[i]| near 1.
+*/
+inline float snrm2(size_t n, const float* x) noexcept
+{
+    if (!simd_dispatch::enabled)
+        return priv::snrm2_kernel(n, x);
+    static const auto kernel = simd_dispatch::select(compiled_isa(), &priv::snrm2_kernel, &simd_dispatch::float_kernels::snrm2);
+    return kernel(n, x);
+}
+
+namespace priv {
+    /**
+        y[i] = alpha * dot(row i of a, x) + beta * y[i], four rows at a time sharing the loads of x.
+    */
+    inline void gemv_rows(size_t m, size_t n, float alpha, const float* a, size_t lda, const float* x, float beta, float* y) noexcept
+    {
+        using V = vector;
+        constexpr size_t N = V::value_count;
+
+        const auto finish = [alpha, beta](float sum, float& out) {
+            out = beta == 0.0f ? alpha * sum : alpha * sum + beta * out;
+        };
+        const size_t grouped_rows = m - m % 4;
+        for (size_t i = 0; i < grouped_rows; i += 4) {
+            const float* a0 = a + i * lda;
+            const float* a1 = a0 + lda;
+            const float* a2 = a1 + lda;
+            const float* a3 = a2 + lda;
+            V acc0, acc1, acc2, acc3;
+            size_t p = 0;
+            for (; p + N <= n; p += N) {
+                const V xv(x + p);
+                acc0 = V::fma(V(a0 + p), xv, acc0);
+                acc1 = V::fma(V(a1 + p), xv, acc1);
+                acc2 = V::fma(V(a2 + p), xv, acc2);
+                acc3 = V::fma(V(a3 + p), xv, acc3);
+            }
+            if (p < n) {
+                const size_t rest = n - p;
+                const V xv = V::load_partial(x + p, rest);
+                acc0 = V::fma(V::load_partial(a0 + p, rest), xv, acc0);
+                acc1 = V::fma(V::load_partial(a1 + p, rest), xv, acc1);
+                acc2 = V::fma(V::load_partial(a2 + p, rest), xv, acc2);
+                acc3 = V::fma(V::load_partial(a3 + p, rest), xv, acc3);
+            }
+            finish(sum_lanes(acc0), y[i]);
+            finish(sum_lanes(acc1), y[i + 1]);
+            finish(sum_lanes(acc2), y[i + 2]);
+            finish(sum_lanes(acc3), y[i + 3]);
+        }
+        for (size_t i = grouped_rows; i < m; ++i)
+            finish(sdot_kernel(n, a + i * lda, x), y[i]);
+    }
+
+    /**
+        y = alpha * acc + beta * y for one register of y, stored with cache_flags when y is aligned.
+    */
+    inline void gemv_store(const vector& acc, float alpha, float beta, float* y, simd_base::cache_coherence cache_flags) noexcept
+    {
+        const vector result = beta == 0.0f ? acc * vector(alpha) : vector::fma(acc, vector(alpha), vector::load_aligned(y) * vector(beta));
+        result.store_aligned(y, cache_flags);
+    }
+    /**
+        gemv_columns for rows < N values of y, at the start or the end of y.
+    */
+    inline void gemv_column_partial(size_t rows, size_t n, float alpha, const float* a, size_t lda, const float* x, float beta, float* y) noexcept
+    {
+        using V = vector;
+        V acc;
+        for (size_t j = 0; j < n; ++j)
+            acc = V::fma(V::load_partial(a + j * lda, rows), V(x[j]), acc);
+        const V result = beta == 0.0f ? acc * V(alpha) : V::fma(acc, V(alpha), V::load_partial(y, rows) * V(beta));
+        result.store_partial(y, rows);
+    }
+
+    /**
+        y = alpha * sum over j of x[j] * column j of a + beta * y. Four registers of y at a time stay
+        in accumulators across all columns, so y is read and written once.
+    */
+    inline void gemv_columns(size_t m, size_t n, float alpha, const float* a, size_t lda, const float* x, float beta, float* y,
+        simd_base::cache_coherence cache_flags) noexcept
+    {
+        using V = vector;
+        constexpr size_t N = V::value_count;
+
+        size_t i = simd_algorithm::priv::head_count<V>(y, m);
+        if (i != 0)
+            gemv_column_partial(i, n, alpha, a, lda, x, beta, y);
+        for (; i + 4 * N <= m; i += 4 * N) {
+            V acc0, acc1, acc2, acc3;
+            for (size_t j = 0; j < n; ++j) {
+                const V xj(x[j]);
+                const float* column = a + i + j * lda;
+                acc0 = V::fma(V(column), xj, acc0);
+                acc1 = V::fma(V(column + N), xj, acc1);
+                acc2 = V::fma(V(column + 2 * N), xj, acc2);
+                acc3 = V::fma(V(column + 3 * N), xj, acc3);
+            }
+            gemv_store(acc0, alpha, beta, y + i, cache_flags);
+            gemv_store(acc1, alpha, beta, y + i + N, cache_flags);
+            gemv_store(acc2, alpha, beta, y + i + 2 * N, cache_flags);
+            gemv_store(acc3, alpha, beta, y + i + 3 * N, cache_flags);
+        }
+        for (; i + N <= m; i += N) {
+            V acc;
+            for (size_t j = 0; j < n; ++j)
+                acc = V::fma(V(a + i + j * lda), V(x[j]), acc);
+            gemv_store(acc, alpha, beta, y + i, cache_flags);
+        }
+        if (i < m)
+            gemv_column_partial(m - i, n, alpha, a + i, lda, x, beta, y + i);
+        if (cache_flags == simd_base::cache_coherence::non_temporal)
+            simd_base::store_fence();
+    }
+
+    /**
+        sgemv with rows = (order == row_major) == (op_a == no_transpose).
+    */
+    inline void sgemv_kernel(bool rows, size_t m, size_t n, float alpha, const float* a, size_t lda, const float* x, float beta,
+        float* y, bool non_temporal) noexcept
+    {
+        if (rows)
+            gemv_rows(m, n, alpha, a, lda, x, beta, y);
+        else
+            gemv_columns(m, n, alpha, a, lda, x, beta, y,
+                non_temporal ? simd_base::cache_coherence::non_temporal : simd_base::cache_coherence::coherent);
+    }
+} // namespace priv
+
+/**
+    y = alpha * op(A) * x + beta * y with op(A) m x n, lda as for sgemm. With beta = 0, y is not
+    read. cache_flags applies when y is computed a register at a time (column_major no_transpose,
+    row_major transpose); the other cases write one value of y per row of A.
+*/
+inline void sgemv(layout order, operation op_a, size_t m, size_t n, float alpha, const float* a, size_t lda,
+    const float* x, float beta, float* y, simd_base::cache_coherence cache_flags = simd_base::cache_coherence::coherent) noexcept
+{
+    const bool rows = (order == row_major) == (op_a == no_transpose);
+    const bool non_temporal = cache_flags == simd_base::cache_coherence::non_temporal;
+    if (!simd_dispatch::enabled) {
+        priv::sgemv_kernel(rows, m, n, alpha, a, lda, x, beta, y, non_temporal);
+        return;
+    }
+    static const auto kernel = simd_dispatch::select(compiled_isa(), &priv::sgemv_kernel, &simd_dispatch::float_kernels::sgemv);
+    kernel(rows, m, n, alpha, a, lda, x, beta, y, non_temporal);
+}
+
+} // namespace simd_blas
+
+SIMD_NAMESPACE_END
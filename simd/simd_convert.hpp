@@ -0,0 +1,114 @@
+#pragma once
+
+#include "simdd2.hpp"
+#include "simdf4.hpp"
+#include "simdi16x8.hpp"
+#include "simdi32x4.hpp"
+#include "simdu16x8.hpp"
+#include "simdu32x4.hpp"
+#include "simdu8x16.hpp"
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Conversions between the 128 bit lane types.
+
+    convert<To>(x)          same lane count, value conversion:
+                                simdf4 <-> simdi32x4, simdf4 <-> simdu32x4 (float to integer truncates)
+                                simdi32x4 <-> simdu32x4, simdi16x8 <-> simdu16x8 (bit pattern kept, i.e. modulo 2^n)
+    convert_nearest<To>(x)  simdf4 -> simdi32x4 / simdu32x4, rounding to nearest even
+    widen_low(x), widen_high(x)
+                            the low / high half of the lanes at twice the width, keeping the value:
+                                simdu8x16 -> simdu16x8, simdu16x8 -> simdu32x4, simdi16x8 -> simdi32x4,
+                                simdf4 -> simdd2
+    narrow_saturate<To>(low, high)
+                            the lanes of low followed by the lanes of high at half the width,
+                            clamped to the range of To:
+                                simdi32x4 -> simdi16x8, simdi32x4 -> simdu16x8, simdu32x4 -> simdu16x8,
+                                simdi16x8 -> simdu8x16, simdu16x8 -> simdu8x16
+
+    Float to integer conversions clamp negative values to 0 for unsigned results; other values
+    outside the range of the result, and NaNs, give unspecified lanes.
+
+    Other pairs fail to compile, chain the conversions instead, e.g. u8 to float is
+    convert<simdf4>(widen_low(widen_low(bytes))).
+*/
+namespace simd_convert {
+
+namespace priv {
+    template <typename To, typename From>
+    struct converter {
+        static_assert(sizeof(To) == 0, "no conversion between these lane types");
+    };
+    template <typename From>
+    struct widener {
+        static_assert(sizeof(From) == 0, "no wider lane type");
+    };
+    template <typename To, typename From>
+    struct narrower {
+        static_assert(sizeof(To) == 0, "no saturating narrowing between these lane types");
+    };
+
+    template <>
+    struct widener<simd<float, 4>> {
+        using type = simd<double, 2>;
+        static type low(const simd<float, 4>& value) noexcept
+        {
+            return type::from_float_low(value);
+        }
+        static type high(const simd<float, 4>& value) noexcept
+        {
+            return type::from_float_high(value);
+        }
+    };
+} // namespace priv
+
+} // namespace simd_convert
+
+SIMD_NAMESPACE_END
+
+#if defined(SIMD_BACKEND_X86)
+#include "x86/convert_sse.hpp"
+#elif defined(SIMD_BACKEND_NEON)
+#include "neon/convert_neon.hpp"
+#else
+#include "generic/convert_generic.hpp"
+#endif
+
+SIMD_NAMESPACE_BEGIN
+
+namespace simd_convert {
+
+template <typename To, typename From>
+To convert(const From& value) noexcept
+{
+    return priv::converter<To, From>::convert(value);
+}
+
+template <typename To, typename From>
+To convert_nearest(const From& value) noexcept
+{
+    return priv::converter<To, From>::convert_nearest(value);
+}
+
+template <typename From>
+typename priv::widener<From>::type widen_low(const From& value) noexcept
+{
+    return priv::widener<From>::low(value);
+}
+
+template <typename From>
+typename priv::widener<From>::type widen_high(const From& value) noexcept
+{
+    return priv::widener<From>::high(value);
+}
+
+template <typename To, typename From>
+To narrow_saturate(const From& low, const From& high) noexcept
+{
+    return priv::narrower<To, From>::saturate(low, high);
+}
+
+} // namespace simd_convert
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "cpu_features.hpp"
+
+#include <cstddef>
+
+/**
+    Runtime selection of the float kernels of simd_algorithm and simd_blas, so that one binary
+    built for a baseline instruction set runs them at the widest level the CPU supports:
+
+        simd_blas::sdot, saxpy, sscal, snrm2, sgemv, sgemm
+        simd_algorithm::transform with absolute or square_root on float arrays
+        simd_algorithm::transform and reduce with plus, multiplies, minimum or maximum on float arrays
+
+    Each kernel picks its implementation with simd_select on its first call: the one of the
+    calling translation unit (compiled_isa()), or one of the variants compiled for AVX2 + FMA and
+    AVX-512 in simd/dispatch/. Everything else, including transform and reduce with other
+    operations, runs at the compile-time level: the simd types themselves are selected by the
+    preprocessor.
+
+    Dispatch is enabled by defining SIMD_DISPATCH for the whole build on x86 and linking
+    simd/dispatch/kernels_avx2.cpp and kernels_avx512.cpp, each compiled with the flags of its
+    level (simd/dispatch/dispatch.pri does both for qmake projects). Without it the library stays
+    header-only and the kernels are called directly.
+*/
+namespace simd_dispatch {
+
+#if defined(SIMD_DISPATCH) && defined(SIMD_BACKEND_X86)
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+/**
+    Operations of simd_algorithm with dispatched float kernels, indices into float_kernels.
+*/
+enum unary_op {
+    absolute_op,
+    square_root_op,
+    unary_op_count
+};
+enum binary_op {
+    plus_op,
+    multiplies_op,
+    minimum_op,
+    maximum_op,
+    binary_op_count
+};
+
+/**
+    Entry points of the float kernels compiled for one instruction set level. Only plain types
+    cross between levels, the simd types and the enums of the library differ per level.
+*/
+struct float_kernels {
+    void (*transform[unary_op_count])(const float* input, size_t count, float* output);
+    void (*transform_binary[binary_op_count])(const float* input1, const float* input2, size_t count, float* output);
+    float (*reduce[binary_op_count])(const float* input, size_t count, float init);
+    void (*saxpy)(size_t n, float alpha, const float* x, float* y, bool non_temporal);
+    void (*sscal)(size_t n, float alpha, float* x, bool non_temporal);
+    float (*sdot)(size_t n, const float* x, const float* y);
+    float (*snrm2)(size_t n, const float* x);
+    /**
+        rows: y[i] = dot(row i of a, x) with rows lda apart, otherwise y = sum of x[j] * column j
+        of a with columns lda apart.
+    */
+    void (*sgemv)(bool rows, size_t m, size_t n, float alpha, const float* a, size_t lda, const float* x, float beta,
+        float* y, bool non_temporal);
+    /**
+        Column-major C = alpha * op(A) * op(B) + beta * C.
+    */
+    void (*sgemm)(size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda, bool transpose_a,
+        const float* b, size_t ldb, bool transpose_b, float beta, float* c, size_t ldc);
+};
+
+#if defined(SIMD_DISPATCH) && defined(SIMD_BACKEND_X86)
+/**
+    Kernels compiled with -mavx2 -mfma, defined in simd/dispatch/kernels_avx2.cpp.
+*/
+const float_kernels& avx2_kernels();
+/**
+    Kernels compiled with -mavx512f -mavx512dq -mavx512bw -mavx512vl, defined in
+    simd/dispatch/kernels_avx512.cpp.
+*/
+const float_kernels& avx512_kernels();
+#endif
+
+/**
+    Level of the kernels select picks for cpu, for callers compiled for level: the most capable
+    of level and the variants in simd/dispatch/ that cpu supports.
+*/
+inline simd_isa kernel_isa(simd_isa level, const cpu_features& cpu = cpu_features::instance()) noexcept
+{
+#if defined(SIMD_DISPATCH) && defined(SIMD_BACKEND_X86)
+    // the tables are only touched for a level cpu supports, even their initialization may use its instructions
+    using table = const float_kernels&();
+    table* const best = simd_select<table>({ { simd_isa::avx2, &avx2_kernels }, { simd_isa::avx512, &avx512_kernels } }, cpu);
+    const simd_isa best_level = best == &avx512_kernels ? simd_isa::avx512 : simd_isa::avx2;
+    if (best != nullptr && best_level > level)
+        return best_level;
+#else
+    static_cast<void>(cpu);
+#endif
+    return level;
+}
+
+namespace priv {
+    /**
+        Keeps the native kernel out of the deduction of Fn, so that it may be noexcept.
+    */
+    template <typename T>
+    struct identity {
+        using type = T;
+    };
+
+    template <typename Fn, typename Get>
+    Fn* select(simd_isa level, Fn* native, Get get, const cpu_features& cpu) noexcept
+    {
+#if defined(SIMD_DISPATCH) && defined(SIMD_BACKEND_X86)
+        const simd_isa isa = kernel_isa(level, cpu);
+        if (isa != level)
+            return get(isa == simd_isa::avx512 ? avx512_kernels() : avx2_kernels());
+#else
+        static_cast<void>(level);
+        static_cast<void>(get);
+        static_cast<void>(cpu);
+#endif
+        return native;
+    }
+} // namespace priv
+
+/**
+    The implementation of a kernel for cpu: native, compiled for level (the compiled_isa() of the
+    caller), or the member of the float_kernels of kernel_isa(level, cpu), e.g.
+
+        static const auto kernel = simd_dispatch::select(compiled_isa(), &priv::sdot_kernel, &simd_dispatch::float_kernels::sdot);
+
+    The level is a parameter rather than read here, so that this function is the same in all
+    translation units.
+*/
+template <typename Fn>
+Fn* select(simd_isa level, typename priv::identity<Fn>::type* native, Fn* float_kernels::*member, const cpu_features& cpu = cpu_features::instance()) noexcept
+{
+    return priv::select(level, native, [member](const float_kernels& k) { return k.*member; }, cpu);
+}
+/**
+    select for the kernels of simd_algorithm, e.g. select(compiled_isa(), &kernel, &float_kernels::reduce, plus_op).
+*/
+template <typename Fn, size_t Count>
+Fn* select(simd_isa level, typename priv::identity<Fn>::type* native, Fn* (float_kernels::*member)[Count], size_t op,
+    const cpu_features& cpu = cpu_features::instance()) noexcept
+{
+    return priv::select(level, native, [member, op](const float_kernels& k) { return (k.*member)[op]; }, cpu);
+}
+
+} // namespace simd_dispatch
@@ -0,0 +1,253 @@
+#pragma once
+
+#include "aligned_allocator.hpp"
+#include "simd_algorithm.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Matrix products on float arrays, built on simd<float, N> at the native width.
+
+        simd_blas::sgemm(simd_blas::row_major, simd_blas::no_transpose, simd_blas::no_transpose,
+            m, n, k, 1.0f, a, k, b, n, 0.0f, c, n);
+
+    The arguments follow CBLAS: C (m x n) = alpha * op(A) * op(B) + beta * C, with op(A) m x k,
+    op(B) k x n and the leading dimensions lda, ldb and ldc the distance between consecutive
+    rows (row_major) or columns (column_major) of each array. With beta = 0, C is not read.
+*/
+namespace simd_blas {
+
+enum layout {
+    row_major,
+    column_major
+};
+enum operation {
+    no_transpose,
+    transpose
+};
+
+namespace priv {
+    /**
+        Register tile of the micro-kernel and the cache blocking around it, BLIS style: the
+        micro-kernel keeps an mr x nr block of C in 2 * nr registers and streams a packed mr x kc
+        sliver of A (from the L1 cache) against a packed kc x nr sliver of B; an mc x kc block of
+        A stays in the L2 cache while all slivers of a kc x nc panel of B pass by.
+    */
+    template <size_t N>
+    struct gemm_blocking {
+        static constexpr size_t mr = 2 * N;
+        static constexpr size_t nr = 6;
+        static constexpr size_t kc = 256;
+        static constexpr size_t mc = 8 * mr;
+        static constexpr size_t nc = 64 * nr;
+    };
+
+    /**
+        Read access to op(X) of a column-major matrix.
+    */
+    struct matrix_view {
+        const float* data;
+        size_t ld;
+        bool transposed;
+
+        float operator()(size_t row, size_t column) const noexcept
+        {
+            return this->transposed ? this->data[column + row * this->ld] : this->data[row + column * this->ld];
+        }
+    };
+
+    /**
+        Copies rows x depth of A, starting at (row0, p0), into slivers of mr rows: for each p the mr
+        values of a column are contiguous. Rows past the end are zero.
+    */
+    template <size_t mr>
+    void pack_a(const matrix_view& a, size_t row0, size_t rows, size_t p0, size_t depth, float* packed) noexcept
+    {
+        for (size_t i = 0; i < rows; i += mr) {
+            const size_t height = std::min(mr, rows - i);
+            for (size_t p = 0; p < depth; ++p) {
+                if (!a.transposed && height == mr) {
+                    std::memcpy(packed, a.data + (row0 + i) + (p0 + p) * a.ld, mr * sizeof(float));
+                } else {
+                    for (size_t r = 0; r < mr; ++r)
+                        packed[r] = r < height ? a(row0 + i + r, p0 + p) : 0.0f;
+                }
+                packed += mr;
+            }
+        }
+    }
+    /**
+        Copies depth x columns of B, starting at (p0, column0), into slivers of nr columns: for each
+        p the nr values of a row are contiguous. Columns past the end are zero.
+    */
+    template <size_t nr>
+    void pack_b(const matrix_view& b, size_t p0, size_t depth, size_t column0, size_t columns, float* packed) noexcept
+    {
+        for (size_t j = 0; j < columns; j += nr) {
+            const size_t width = std::min(nr, columns - j);
+            for (size_t p = 0; p < depth; ++p) {
+                for (size_t c = 0; c < nr; ++c)
+                    packed[c] = c < width ? b(p0 + p, column0 + j + c) : 0.0f;
+                packed += nr;
+            }
+        }
+    }
+
+    /**
+        lo / hi += a_lo / a_hi * b, one column of the register tile.
+    */
+    template <typename V>
+    void gemm_update(V& lo, V& hi, const V& a_lo, const V& a_hi, float b) noexcept
+    {
+        const V broadcast(b);
+        lo = V::fma(a_lo, broadcast, lo);
+        hi = V::fma(a_hi, broadcast, hi);
+    }
+    /**
+        Stores column = alpha * lo / hi + beta * column, beta == 0 does not read it.
+    */
+    template <typename V>
+    void gemm_store(float* column, const V& lo, const V& hi, float alpha, float beta) noexcept
+    {
+        constexpr size_t N = V::value_count;
+        if (beta == 0.0f) {
+            (lo * V(alpha)).store(column);
+            (hi * V(alpha)).store(column + N);
+        } else {
+            V::fma(lo, V(alpha), V(column) * V(beta)).store(column);
+            V::fma(hi, V(alpha), V(column + N) * V(beta)).store(column + N);
+        }
+    }
+    /**
+        C (mr x nr, column-major) = alpha * A sliver * B sliver + beta * C. The 12 accumulators are
+        named variables rather than an array, so that they stay in registers.
+    */
+    template <size_t N>
+    void gemm_micro_kernel(size_t depth, float alpha, const float* a, const float* b, float beta, float* c, size_t ldc) noexcept
+    {
+        using V = simd<float, N>;
+        static_assert(gemm_blocking<N>::nr == 6, "the micro-kernel is written for 6 columns");
+
+        V c0_lo, c0_hi, c1_lo, c1_hi, c2_lo, c2_hi, c3_lo, c3_hi, c4_lo, c4_hi, c5_lo, c5_hi;
+        for (size_t p = 0; p < depth; ++p) {
+            const V a_lo = V::load_aligned(a);
+            const V a_hi = V::load_aligned(a + N);
+            gemm_update(c0_lo, c0_hi, a_lo, a_hi, b[0]);
+            gemm_update(c1_lo, c1_hi, a_lo, a_hi, b[1]);
+            gemm_update(c2_lo, c2_hi, a_lo, a_hi, b[2]);
+            gemm_update(c3_lo, c3_hi, a_lo, a_hi, b[3]);
+            gemm_update(c4_lo, c4_hi, a_lo, a_hi, b[4]);
+            gemm_update(c5_lo, c5_hi, a_lo, a_hi, b[5]);
+            a += 2 * N;
+            b += 6;
+        }
+        gemm_store(c, c0_lo, c0_hi, alpha, beta);
+        gemm_store(c + ldc, c1_lo, c1_hi, alpha, beta);
+        gemm_store(c + 2 * ldc, c2_lo, c2_hi, alpha, beta);
+        gemm_store(c + 3 * ldc, c3_lo, c3_hi, alpha, beta);
+        gemm_store(c + 4 * ldc, c4_lo, c4_hi, alpha, beta);
+        gemm_store(c + 5 * ldc, c5_lo, c5_hi, alpha, beta);
+    }
+
+    /**
+        Column-major C = alpha * op(A) * op(B) + beta * C.
+    */
+    template <size_t N>
+    void gemm(size_t m, size_t n, size_t k, float alpha, const matrix_view& a, const matrix_view& b, float beta, float* c, size_t ldc)
+    {
+        using blocking = gemm_blocking<N>;
+        constexpr size_t mr = blocking::mr;
+        constexpr size_t nr = blocking::nr;
+
+        if (m == 0 || n == 0)
+            return;
+        if (k == 0 || alpha == 0.0f) {
+            for (size_t j = 0; j < n; ++j) {
+                for (size_t i = 0; i < m; ++i)
+                    c[i + j * ldc] = beta == 0.0f ? 0.0f : beta * c[i + j * ldc];
+            }
+            return;
+        }
+
+        // no larger than the matrices need, small products should not pay for zeroing full blocks
+        const size_t max_depth = std::min(blocking::kc, k);
+        aligned_vector<float> packed_a(std::min(blocking::mc, (m + mr - 1) / mr * mr) * max_depth);
+        aligned_vector<float> packed_b(std::min(blocking::nc, (n + nr - 1) / nr * nr) * max_depth);
+        alignas(64) float edge[mr * nr];
+
+        for (size_t j0 = 0; j0 < n; j0 += blocking::nc) {
+            const size_t columns = std::min(blocking::nc, n - j0);
+            for (size_t p0 = 0; p0 < k; p0 += blocking::kc) {
+                const size_t depth = std::min(blocking::kc, k - p0);
+                // the first block of the sum scales C by beta, the others add to it
+                const float block_beta = p0 == 0 ? beta : 1.0f;
+                pack_b<nr>(b, p0, depth, j0, columns, packed_b.data());
+
+                for (size_t i0 = 0; i0 < m; i0 += blocking::mc) {
+                    const size_t rows = std::min(blocking::mc, m - i0);
+                    pack_a<mr>(a, i0, rows, p0, depth, packed_a.data());
+
+                    for (size_t j = 0; j < columns; j += nr) {
+                        const float* b_sliver = packed_b.data() + j * depth;
+                        for (size_t i = 0; i < rows; i += mr) {
+                            const float* a_sliver = packed_a.data() + i * depth;
+                            float* tile = c + (i0 + i) + (j0 + j) * ldc;
+                            const size_t height = std::min(mr, rows - i);
+                            const size_t width = std::min(nr, columns - j);
+                            if (height == mr && width == nr) {
+                                gemm_micro_kernel<N>(depth, alpha, a_sliver, b_sliver, block_beta, tile, ldc);
+                                continue;
+                            }
+                            // partial tiles at the edges of C go through a buffer, zeroed so that
+                            // the micro-kernel reads no indeterminate values past the tile; C is
+                            // copied in only when the micro-kernel reads it
+                            std::fill(edge, edge + mr * nr, 0.0f);
+                            if (block_beta != 0.0f) {
+                                for (size_t jj = 0; jj < width; ++jj)
+                                    std::memcpy(edge + jj * mr, tile + jj * ldc, height * sizeof(float));
+                            }
+                            gemm_micro_kernel<N>(depth, alpha, a_sliver, b_sliver, block_beta, edge, mr);
+                            for (size_t jj = 0; jj < width; ++jj)
+                                std::memcpy(tile + jj * ldc, edge + jj * mr, height * sizeof(float));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+        sgemm on column-major arrays, the entry point of simd_dispatch::float_kernels.
+    */
+    inline void sgemm_kernel(size_t m, size_t n, size_t k, float alpha, const float* a, size_t lda, bool transpose_a,
+        const float* b, size_t ldb, bool transpose_b, float beta, float* c, size_t ldc)
+    {
+        constexpr size_t N = simd_algorithm::native_width<float>::value;
+        gemm<N>(m, n, k, alpha, matrix_view{ a, lda, transpose_a }, matrix_view{ b, ldb, transpose_b }, beta, c, ldc);
+    }
+} // namespace priv
+
+/**
+    C = alpha * op(A) * op(B) + beta * C for single precision matrices, see the namespace
+    documentation for the arguments.
+*/
+inline void sgemm(layout order, operation op_a, operation op_b, size_t m, size_t n, size_t k,
+    float alpha, const float* a, size_t lda, const float* b, size_t ldb, float beta, float* c, size_t ldc)
+{
+    static const auto kernel = simd_dispatch::select(compiled_isa(), &priv::sgemm_kernel, &simd_dispatch::float_kernels::sgemm);
+    if (order == column_major) {
+        kernel(m, n, k, alpha, a, lda, op_a == transpose, b, ldb, op_b == transpose, beta, c, ldc);
+    } else {
+        // read as column-major, each row-major array is the transpose of its matrix:
+        // C^T = op(B)^T * op(A)^T, where op(B)^T is the column-major view of b with op_b applied
+        kernel(n, m, k, alpha, b, ldb, op_b == transpose, a, lda, op_a == transpose, beta, c, ldc);
+    }
+}
+
+} // namespace simd_blas
+
+SIMD_NAMESPACE_END
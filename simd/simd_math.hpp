@@ -0,0 +1,324 @@
+#pragma once
+
+#include "simd_base.hpp"
+
+#include <cstring>
+#include <limits>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Elementary functions for simd<float, N>, implemented with range reduction and
+    polynomial approximations (coefficients based on Cephes).
+
+    Maximum error measured against double precision libm over all finite float inputs
+    of the documented range (round to nearest, denormal results included unless noted):
+
+        exp     1 ulp       exp2    2 ulp
+        log     1 ulp       log2    2 ulp
+        sin     3 ulp       cos     3 ulp       (|x| <= 8192, accuracy degrades above)
+        tan     4 ulp                           (|x| <= 8192)
+        atan2   4 ulp
+        pow     3 ulp + 1 ulp per unit of |y * log2(x)|
+        tanh    2 ulp
+        erf     3 ulp
+
+    Special values (NaN, infinities, zeros) follow the C standard library.
+*/
+namespace simd_math {
+
+namespace priv {
+    template <typename V>
+    V horner(const V&, float c0) noexcept
+    {
+        return V(c0);
+    }
+    /**
+        Evaluates c0 + c1 * x + c2 * x^2 + ...
+    */
+    template <typename V, typename... Coefficients>
+    V horner(const V& x, float c0, Coefficients... rest) noexcept
+    {
+        return V::fma(horner(x, rest...), x, V(c0));
+    }
+
+    template <typename V>
+    V sign_bit(const V& x) noexcept
+    {
+        return x & V(-0.0f);
+    }
+    template <typename V>
+    typename V::mask_type is_nan(const V& x) noexcept
+    {
+        return x.compare(x, simd_base::compare_flags::not_equal);
+    }
+    inline float from_bits(uint32_t bits) noexcept
+    {
+        float result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+    /**
+        True for lanes with the sign bit set, including -0 and -NaN.
+    */
+    template <typename V>
+    typename V::mask_type is_negative(const V& x) noexcept
+    {
+        return (sign_bit(x) | V(1.0f)).compare(V(), simd_base::compare_flags::lower);
+    }
+    /**
+        x * 2^n for integral n in range [-252, 254], split in two steps to stay within the exponent range.
+    */
+    template <typename V>
+    V ldexp_wide(const V& x, const V& n) noexcept
+    {
+        const V half = (n * V(0.5f)).floor();
+        return x.ldexp(half).ldexp(n - half);
+    }
+
+    /**
+        2^f for f in range [-0.5, 0.5].
+    */
+    template <typename V>
+    V exp2_poly(const V& f) noexcept
+    {
+        return horner(f, 1.0f, 6.931472028550421E-1f, 2.402264791363012E-1f, 5.550332471162809E-2f,
+            9.618437357674640E-3f, 1.339887440266574E-3f, 1.535336188319500E-4f);
+    }
+
+    /**
+        Natural logarithm of the mantissa (without the exponent part) and the exponent
+        of positive finite x, such that log(x) = log_mantissa + exponent * ln(2).
+    */
+    template <typename V>
+    V log_reduce(const V& x, V& exponent) noexcept
+    {
+        // denormals are scaled into the normal range first
+        const auto denormal = x.compare(V(std::numeric_limits<float>::min()), simd_base::compare_flags::lower);
+        V m = V::select(denormal, x * V(8388608.0f), x).frexp(exponent);
+        exponent = V::select(denormal, exponent - V(23.0f), exponent);
+
+        // m in [sqrt(0.5), sqrt(2)) - 1
+        const auto small = m.compare(V(0.707106781186547524f), simd_base::compare_flags::lower);
+        exponent = V::select(small, exponent - V(1.0f), exponent);
+        m = V::select(small, m + m, m) - V(1.0f);
+
+        const V z = m * m;
+        const V p = horner(m, 3.3333331174E-1f, -2.4999993993E-1f, 2.0000714765E-1f, -1.6668057665E-1f,
+            1.4249322787E-1f, -1.2420140846E-1f, 1.1676998740E-1f, -1.1514610310E-1f, 7.0376836292E-2f);
+        return m + V::fnma(V(0.5f), z, m * z * p);
+    }
+    template <typename V>
+    V log_special(const V& x, const V& result) noexcept
+    {
+        const V inf(std::numeric_limits<float>::infinity());
+        V r = V::select(x.compare(inf, simd_base::compare_flags::equal), inf, result);
+        r = V::select(x.compare(V(), simd_base::compare_flags::equal), V(-std::numeric_limits<float>::infinity()), r);
+        return V::select(x.compare(V(), simd_base::compare_flags::lower) | is_nan(x),
+            V(std::numeric_limits<float>::quiet_NaN()), r);
+    }
+
+    template <typename V>
+    void sincos(const V& x, V& sin_result, V& cos_result) noexcept
+    {
+        using mask = typename V::mask_type;
+        const V ax = x.abs();
+        // quadrant and remainder in [-pi/4, pi/4], pi/2 split in 11 bit parts so that q * part is exact
+        const V q = (ax * V(0.636619772367581343f)).round();
+        const V r = (((ax - q * V(1.5703125f)) - q * V(4.837512969970703125e-4f))
+                        - q * V(7.54953362047672271728515625e-8f))
+            - q * V(2.56334406825708960298e-12f);
+        const V quadrant = q - (q * V(0.25f)).floor() * V(4.0f);
+
+        const V z = r * r;
+        const V sin_poly = V::fma(r * z, horner(z, -1.6666654611E-1f, 8.3321608736E-3f, -1.9515295891E-4f), r);
+        const V cos_poly = V::fma(z * z, horner(z, 4.166664568298827E-2f, -1.388731625493765E-3f, 2.443315711809948E-5f),
+            V::fnma(V(0.5f), z, V(1.0f)));
+
+        const mask q1 = quadrant.compare(V(1.0f), simd_base::compare_flags::equal);
+        const mask q2 = quadrant.compare(V(2.0f), simd_base::compare_flags::equal);
+        const mask q3 = quadrant.compare(V(3.0f), simd_base::compare_flags::equal);
+        const mask odd = q1 | q3;
+        const V negative(-0.0f);
+
+        // sin(|x|) for quadrants 0..3: sin r, cos r, -sin r, -cos r
+        sin_result = V::select(odd, cos_poly, sin_poly) ^ V::select(q2 | q3, negative, V()) ^ sign_bit(x);
+        // cos(|x|) for quadrants 0..3: cos r, -sin r, -cos r, sin r
+        cos_result = V::select(odd, sin_poly, cos_poly) ^ V::select(q1 | q2, negative, V());
+    }
+} // namespace priv
+
+template <size_t N>
+simd<float, N> exp(const simd<float, N>& x) noexcept
+{
+    using V = simd<float, N>;
+    // results overflow to infinity and underflow to zero past the clamped range
+    const V xc = x.max(V(-104.0f)).min(V(89.0f));
+    const V n = (xc * V(1.44269504088896341f)).round();
+    const V r = (xc - n * V(0.693359375f)) + n * V(2.12194440e-4f);
+    const V p = priv::horner(r, 5.0000001201E-1f, 1.6666665459E-1f, 4.1665795894E-2f,
+        8.3334519073E-3f, 1.3981999507E-3f, 1.9875691500E-4f);
+    // 1 + r + r^2 * p with the rounding error of 1 + r carried into the tail (|r| <= 1 so it is
+    // exact), otherwise that rounding and the final one add up to more than 1 ulp below 1
+    const V head = V(1.0f) + r;
+    const V y = head + V::fma(p, r * r, (V(1.0f) - head) + r);
+    return V::select(priv::is_nan(x), x, priv::ldexp_wide(y, n));
+}
+
+template <size_t N>
+simd<float, N> exp2(const simd<float, N>& x) noexcept
+{
+    using V = simd<float, N>;
+    const V xc = x.max(V(-151.0f)).min(V(129.0f));
+    const V n = xc.round();
+    return V::select(priv::is_nan(x), x, priv::ldexp_wide(priv::exp2_poly(xc - n), n));
+}
+
+template <size_t N>
+simd<float, N> log(const simd<float, N>& x) noexcept
+{
+    using V = simd<float, N>;
+    V e;
+    const V m = priv::log_reduce(x, e);
+    const V result = (m - e * V(2.12194440e-4f)) + e * V(0.693359375f);
+    return priv::log_special(x, result);
+}
+
+template <size_t N>
+simd<float, N> log2(const simd<float, N>& x) noexcept
+{
+    using V = simd<float, N>;
+    V e;
+    const V m = priv::log_reduce(x, e);
+    return priv::log_special(x, m * V(1.44269504088896341f) + e);
+}
+
+template <size_t N>
+simd<float, N> sin(const simd<float, N>& x) noexcept
+{
+    simd<float, N> s, c;
+    priv::sincos(x, s, c);
+    return s;
+}
+
+template <size_t N>
+simd<float, N> cos(const simd<float, N>& x) noexcept
+{
+    simd<float, N> s, c;
+    priv::sincos(x, s, c);
+    return c;
+}
+
+template <size_t N>
+void sincos(const simd<float, N>& x, simd<float, N>& sin_result, simd<float, N>& cos_result) noexcept
+{
+    priv::sincos(x, sin_result, cos_result);
+}
+
+template <size_t N>
+simd<float, N> tan(const simd<float, N>& x) noexcept
+{
+    simd<float, N> s, c;
+    priv::sincos(x, s, c);
+    return s / c;
+}
+
+template <size_t N>
+simd<float, N> atan2(const simd<float, N>& y, const simd<float, N>& x) noexcept
+{
+    using V = simd<float, N>;
+    const V ax = x.abs();
+    const V ay = y.abs();
+    const V largest = ax.max(ay);
+    // t in [0, 1], equal magnitudes (including two infinities) give exactly pi/4
+    const V t = V::select(ax.compare(ay, simd_base::compare_flags::equal), V(1.0f), ax.min(ay) / largest);
+
+    const auto above_pi8 = t.compare(V(0.414213562373095f), simd_base::compare_flags::greater);
+    const V tt = V::select(above_pi8, (t - V(1.0f)) / (t + V(1.0f)), t);
+    const V z = tt * tt;
+    V a = V::select(above_pi8, V(0.785398163397448f), V())
+        + V::fma(tt * z, priv::horner(z, -3.33329491539E-1f, 1.99777106478E-1f, -1.38776856032E-1f, 8.05374449538E-2f), tt);
+
+    a = V::select(ay.compare(ax, simd_base::compare_flags::greater), V(1.57079632679489662f) - a, a);
+    a = V::select(largest.compare(V(), simd_base::compare_flags::equal), V(), a);
+    a = V::select(priv::is_negative(x), V(3.14159265358979324f) - a, a);
+    return V::select(priv::is_nan(x) | priv::is_nan(y), x + y, a | priv::sign_bit(y));
+}
+
+/**
+    x^y computed as exp2(y * log2(|x|)), with the integral part of the product kept exact.
+    Negative x is supported for integral y.
+*/
+template <size_t N>
+simd<float, N> pow(const simd<float, N>& x, const simd<float, N>& y) noexcept
+{
+    using V = simd<float, N>;
+    using mask = typename V::mask_type;
+    const V inf(std::numeric_limits<float>::infinity());
+    const V ax = x.abs();
+
+    // log2(|x|) = e + l, y * e = y_hi * e (exact) + y_lo * e
+    V e;
+    const V l = priv::log_reduce(ax, e) * V(1.44269504088896341f);
+    // |log2(x)| >= 0.5 for e != 0, clamping y there keeps the product finite and the result saturated
+    const V yc = V::select(e.compare(V(), simd_base::compare_flags::equal), y, y.max(V(-1024.0f)).min(V(1024.0f)));
+    const V y_hi = yc & V(priv::from_bits(0xfffff000u));
+    const V y_lo = yc - y_hi;
+    const V a = y_hi * e;
+    const V a_int = a.round();
+    const V frac = (a - a_int) + (y_lo * e + yc * l);
+    const V frac_int = frac.round();
+    const V n = (a_int + frac_int).max(V(-252.0f)).min(V(254.0f));
+    V result = priv::ldexp_wide(priv::exp2_poly(frac - frac_int), n);
+
+    const mask y_positive = y.compare(V(), simd_base::compare_flags::greater);
+    result = V::select(ax.compare(V(), simd_base::compare_flags::equal), V::select(y_positive, V(), inf), result);
+    result = V::select(ax.compare(inf, simd_base::compare_flags::equal), V::select(y_positive, inf, V()), result);
+    const mask ax_above_one = ax.compare(V(1.0f), simd_base::compare_flags::greater);
+    result = V::select(y.abs().compare(inf, simd_base::compare_flags::equal),
+        V::select(ax.compare(V(1.0f), simd_base::compare_flags::equal), V(1.0f), V::select(ax_above_one ^ y_positive, V(), inf)),
+        result);
+
+    const mask y_integral = y.floor().compare(y, simd_base::compare_flags::equal);
+    const V half_y = y * V(0.5f);
+    const mask y_odd = y_integral & half_y.floor().compare(half_y, simd_base::compare_flags::not_equal);
+    result = V::select(priv::is_negative(x) & y_odd, result ^ V(-0.0f), result);
+    const mask x_negative_finite = x.compare(V(), simd_base::compare_flags::lower) & ax.compare(inf, simd_base::compare_flags::lower);
+    result = V::select(x_negative_finite & ~y_integral, V(std::numeric_limits<float>::quiet_NaN()), result);
+    result = V::select(priv::is_nan(x) | priv::is_nan(y), x + y, result);
+    return V::select(y.compare(V(), simd_base::compare_flags::equal) | x.compare(V(1.0f), simd_base::compare_flags::equal),
+        V(1.0f), result);
+}
+
+template <size_t N>
+simd<float, N> tanh(const simd<float, N>& x) noexcept
+{
+    using V = simd<float, N>;
+    const V ax = x.abs();
+    const V z = x * x;
+    const V small = V::fma(x * z, priv::horner(z, -3.33332819422E-1f, 1.33314422036E-1f, -5.37397155531E-2f, 2.06390887954E-2f, -5.70498872745E-3f), x) | priv::sign_bit(x);
+    const V large = (V(1.0f) - V(2.0f) / (exp(ax + ax) + V(1.0f))) | priv::sign_bit(x);
+    return V::select(ax.compare(V(0.625f), simd_base::compare_flags::lower), small, large);
+}
+
+template <size_t N>
+simd<float, N> erf(const simd<float, N>& x) noexcept
+{
+    using V = simd<float, N>;
+    const V ax = x.abs();
+    const V z = x * x;
+    const V small = x * priv::horner(z, 1.1283791657E+0f, -3.7612625824E-1f, 1.1283585151E-1f, -2.6853812034E-2f,
+                            5.1883278691E-3f, -8.0101952044E-4f, 7.8538664837E-5f);
+
+    // erfc(x) * exp(x^2) as a polynomial of 1/x for x in [1, 4], erf rounds to 1 above
+    const V axc = ax.max(V(1.0f)).min(V(4.0f));
+    const V t = V(1.0f) / axc;
+    const V q = priv::horner(t, 3.3292703120E-4f, 5.5797930305E-1f, 4.9612286835E-2f, -5.0155113567E-1f,
+        5.6782763738E-1f, -3.4574089383E-1f, 1.1580190468E-1f, -1.6678391845E-2f);
+    const V large = V::fnma(exp(V() - axc * axc), q, V(1.0f)) | priv::sign_bit(x);
+    return V::select(priv::is_nan(x), x, V::select(ax.compare(V(1.0f), simd_base::compare_flags::lower), small, large));
+}
+
+} // namespace simd_math
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,283 @@
+#pragma once
+
+#include "aligned_allocator.hpp"
+#include "simd_algorithm.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+    Runs bulk kernels on several cores. parallel_for splits an index range into chunks and runs
+    a kernel on each chunk from a pool of threads:
+
+        simd_parallel::parallel_for<float>({ 0, count }, 1 << 14, [&](simd_parallel::range chunk) {
+            simd_algorithm::transform(input + chunk.begin, chunk.size(), output + chunk.begin, op);
+        });
+
+    The chunk boundaries are multiples of the elements of T in a cache line (64 bytes), so with
+    arrays allocated by aligned_allocator no two chunks write to the same cache line. The chunks
+    depend only on the range and the grain, not on the number of threads, and parallel_reduce
+    combines the chunk results in chunk order: results are the same on every machine and run.
+*/
+namespace simd_parallel {
+
+const size_t cache_line_bytes = 64;
+
+struct range {
+    size_t begin;
+    size_t end;
+
+    size_t size() const noexcept
+    {
+        return this->end - this->begin;
+    }
+};
+
+/**
+    Fixed set of worker threads that run the tasks of one call to run() at a time, together with
+    the calling thread. Tasks must not throw. A run() from inside a task of any pool runs its
+    tasks on the calling thread, so nested parallel loops do not deadlock.
+*/
+class thread_pool {
+public:
+    /**
+        thread_count includes the thread calling run(), 1 runs everything on that thread.
+    */
+    explicit thread_pool(size_t thread_count = std::max(1u, std::thread::hardware_concurrency()))
+    {
+        for (size_t i = 1; i < thread_count; ++i)
+            this->_workers.emplace_back([this] { this->work(); });
+    }
+    ~thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_stop = true;
+        }
+        this->_wake.notify_all();
+        for (auto& worker : this->_workers)
+            worker.join();
+    }
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    size_t thread_count() const noexcept
+    {
+        return this->_workers.size() + 1;
+    }
+
+    /**
+        Calls task(i) for i in [0, task_count) and returns when all calls have finished.
+        Concurrent calls from several threads are serialized. The calling thread runs task with
+        its static type, the workers through one type-erased call per task index.
+    */
+    template <typename Task>
+    void run(size_t task_count, const Task& task)
+    {
+        if (this->_workers.empty() || task_count < 2 || inside_task()) {
+            for (size_t i = 0; i < task_count; ++i)
+                task(i);
+            return;
+        }
+        std::lock_guard<std::mutex> run_lock(this->_run_mutex);
+        {
+            std::lock_guard<std::mutex> lock(this->_mutex);
+            this->_context = &task;
+            this->_invoke = &invoke<Task>;
+            this->_task_count = task_count;
+            this->_next.store(0, std::memory_order_relaxed);
+            this->_active = this->_workers.size();
+            ++this->_generation;
+        }
+        this->_wake.notify_all();
+        this->execute_tasks(task);
+
+        std::unique_lock<std::mutex> lock(this->_mutex);
+        this->_done.wait(lock, [this] { return this->_active == 0; });
+        this->_context = nullptr;
+    }
+
+private:
+    static bool& inside_task() noexcept
+    {
+        static thread_local bool inside = false;
+        return inside;
+    }
+    template <typename Task>
+    static void invoke(const void* context, size_t i)
+    {
+        (*static_cast<const Task*>(context))(i);
+    }
+    /**
+        Takes task indices until none are left, on a worker or the calling thread.
+    */
+    template <typename Task>
+    void execute_tasks(const Task& task)
+    {
+        inside_task() = true;
+        for (size_t i = this->_next.fetch_add(1, std::memory_order_relaxed); i < this->_task_count;
+             i = this->_next.fetch_add(1, std::memory_order_relaxed))
+            task(i);
+        inside_task() = false;
+    }
+    void work()
+    {
+        size_t generation = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(this->_mutex);
+                this->_wake.wait(lock, [this, generation] { return this->_stop || this->_generation != generation; });
+                if (this->_stop)
+                    return;
+                generation = this->_generation;
+            }
+            this->execute_tasks([this](size_t i) { this->_invoke(this->_context, i); });
+            {
+                std::lock_guard<std::mutex> lock(this->_mutex);
+                if (--this->_active != 0)
+                    continue;
+            }
+            this->_done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::mutex _run_mutex;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    const void* _context = nullptr;
+    void (*_invoke)(const void*, size_t) = nullptr;
+    size_t _task_count = 0;
+    std::atomic<size_t> _next{ 0 };
+    size_t _active = 0;
+    size_t _generation = 0;
+    bool _stop = false;
+};
+
+/**
+    Pool with one thread per hardware thread, created on first use.
+*/
+inline thread_pool& default_pool()
+{
+    static thread_pool pool;
+    return pool;
+}
+
+namespace priv {
+    /**
+        Chunks of r: the first starts at r.begin, all others at multiples of chunk_size, which is
+        grain rounded up to whole cache lines of T. A grain past the end of the range gives one
+        chunk, also for grains like SIZE_MAX that would overflow the rounding.
+    */
+    template <typename T>
+    struct chunking {
+        size_t base;
+        size_t chunk_size;
+        size_t count;
+
+        chunking(range r, size_t grain) noexcept
+        {
+            constexpr size_t line = cache_line_bytes / sizeof(T) > 0 ? cache_line_bytes / sizeof(T) : 1;
+            const size_t limit = std::max<size_t>(r.end, 1);
+            this->chunk_size = (std::min(std::max<size_t>(grain, 1), limit) + line - 1) / line * line;
+            // rounding up overflows only for r.end close to SIZE_MAX
+            if (this->chunk_size == 0)
+                this->chunk_size = limit;
+            this->base = r.begin - r.begin % this->chunk_size;
+            const size_t covered = r.end - this->base;
+            this->count = r.end > r.begin ? covered / this->chunk_size + (covered % this->chunk_size != 0) : 0;
+        }
+        range operator[](size_t i) const noexcept
+        {
+            return range{ this->base + i * this->chunk_size, this->base + (i + 1) * this->chunk_size };
+        }
+    };
+} // namespace priv
+
+/**
+    Calls kernel(chunk) for chunks covering r, in parallel on pool. The chunk boundaries are the
+    multiples of grain rounded up to whole cache lines of T, the first and last chunks are clipped
+    to r and can be much smaller than grain. The chunks are aligned to cache lines only if the
+    array indexed by r is.
+*/
+template <typename T, typename Kernel>
+void parallel_for(range r, size_t grain, Kernel kernel, thread_pool& pool = default_pool())
+{
+    const priv::chunking<T> chunks(r, grain);
+    pool.run(chunks.count, [&](size_t i) {
+        const range chunk = chunks[i];
+        kernel(range{ std::max(chunk.begin, r.begin), std::min(chunk.end, r.end) });
+    });
+}
+
+/**
+    Maps each chunk of r to a Result with kernel(chunk) in parallel, then folds the results in
+    chunk order on the calling thread: combine(...combine(combine(init, result0), result1)...).
+*/
+template <typename T, typename Result, typename Kernel, typename Combine>
+Result parallel_reduce(range r, size_t grain, Result init, Kernel kernel, Combine combine, thread_pool& pool = default_pool())
+{
+    const priv::chunking<T> chunks(r, grain);
+    std::vector<Result> results(chunks.count, init);
+    pool.run(chunks.count, [&](size_t i) {
+        const range chunk = chunks[i];
+        results[i] = kernel(range{ std::max(chunk.begin, r.begin), std::min(chunk.end, r.end) });
+    });
+    Result result = init;
+    for (const auto& chunk_result : results)
+        result = combine(result, chunk_result);
+    return result;
+}
+
+/**
+    The wrappers of the simd_algorithm kernels depend on the instruction set level of the calling
+    translation unit, like the simd types, so they are put into its inline namespace. The thread
+    pool and the loops above are shared by all levels.
+*/
+SIMD_NAMESPACE_BEGIN
+
+/**
+    simd_algorithm::transform on chunks of the arrays in parallel. op should be a lambda or a
+    function object: a function pointer reaches the worker threads as a runtime value and is
+    called indirectly for every register instead of being inlined.
+*/
+template <typename T, typename UnaryOp>
+void transform(const T* input, size_t count, T* output, UnaryOp op, size_t grain = 1 << 14, thread_pool& pool = default_pool())
+{
+    parallel_for<T>({ 0, count }, grain, [&](range chunk) {
+        simd_algorithm::transform(input + chunk.begin, chunk.size(), output + chunk.begin, op);
+    }, pool);
+}
+template <typename T, typename BinaryOp>
+void transform(const T* input1, const T* input2, size_t count, T* output, BinaryOp op, size_t grain = 1 << 14,
+    thread_pool& pool = default_pool())
+{
+    parallel_for<T>({ 0, count }, grain, [&](range chunk) {
+        simd_algorithm::transform(input1 + chunk.begin, input2 + chunk.begin, chunk.size(), output + chunk.begin, op);
+    }, pool);
+}
+
+/**
+    op(init, v) where v combines all values with op, like simd_algorithm::reduce. Each chunk is
+    reduced without init (seeded with its first value), and init is applied once when the chunk
+    results are combined in chunk order, so the result does not depend on the number of chunks
+    for an exact op. op should be a lambda like for transform.
+*/
+template <typename T, typename BinaryOp>
+T reduce(const T* input, size_t count, T init, BinaryOp op, size_t grain = 1 << 14, thread_pool& pool = default_pool())
+{
+    using V = simd<T, simd_algorithm::native_width<T>::value>;
+    return parallel_reduce<T>({ 0, count }, grain, init,
+        [&](range chunk) { return simd_algorithm::reduce(input + chunk.begin + 1, chunk.size() - 1, input[chunk.begin], op); },
+        [&op](T a, T b) { return op(V(a), V(b)).to_array()[0]; }, pool);
+}
+
+SIMD_NAMESPACE_END
+
+} // namespace simd_parallel
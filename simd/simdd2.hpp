@@ -0,0 +1,11 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#if defined(SIMD_BACKEND_X86)
+#include "x86/simdd2_sse.hpp"
+#elif defined(SIMD_BACKEND_NEON) && defined(__aarch64__)
+#include "neon/simdd2_neon.hpp"
+#else
+#include "generic/simdd2_scalar.hpp"
+#endif
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#if defined(SIMD_BACKEND_X86) && defined(__AVX__)
+#include "x86/simdd4_avx.hpp"
+#else
+#include "generic/simdd4_pair.hpp"
+#endif
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#if defined(SIMD_BACKEND_X86) && defined(__AVX512F__)
+#include "x86/simdf16_avx512.hpp"
+#else
+#include "generic/simdf16_pair.hpp"
+#endif
@@ -1,7 +1,11 @@
 #pragma once
 
-#if !defined(__ANDROID__)
+#include "simd_backend.hpp"
+
+#if defined(SIMD_BACKEND_X86)
 #include "x86/simdf4_sse.hpp"
-#else
+#elif defined(SIMD_BACKEND_NEON)
 #include "neon/simdf4_neon.hpp"
+#else
+#include "generic/simdf4_generic.hpp"
 #endif
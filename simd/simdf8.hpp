@@ -0,0 +1,9 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#if defined(SIMD_BACKEND_X86) && defined(__AVX__)
+#include "x86/simdf8_avx.hpp"
+#else
+#include "generic/simdf8_pair.hpp"
+#endif
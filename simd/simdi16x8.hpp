@@ -0,0 +1,11 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#if defined(SIMD_BACKEND_X86)
+#include "x86/simdi16x8_sse.hpp"
+#elif defined(SIMD_BACKEND_NEON)
+#include "neon/simdi16x8_neon.hpp"
+#else
+#include "generic/simdi16x8_generic.hpp"
+#endif
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#if defined(SIMD_BACKEND_X86)
+#include "x86/simdi32x4_sse.hpp"
+#elif defined(SIMD_BACKEND_NEON)
+#include "neon/simdi32x4_neon.hpp"
+#else
+#include "generic/simdi32x4_generic.hpp"
+#endif
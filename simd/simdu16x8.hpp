@@ -1,7 +1,11 @@
 #pragma once
 
-#if !defined(__ANDROID__)
+#include "simd_backend.hpp"
+
+#if defined(SIMD_BACKEND_X86)
 #include "x86/simdu16x8_sse.hpp"
-#else
+#elif defined(SIMD_BACKEND_NEON)
 #include "neon/simdu16x8_neon.hpp"
+#else
+#include "generic/simdu16x8_generic.hpp"
 #endif
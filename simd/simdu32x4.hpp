@@ -0,0 +1,11 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#if defined(SIMD_BACKEND_X86)
+#include "x86/simdu32x4_sse.hpp"
+#elif defined(SIMD_BACKEND_NEON)
+#include "neon/simdu32x4_neon.hpp"
+#else
+#include "generic/simdu32x4_generic.hpp"
+#endif
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "simd_backend.hpp"
+
+#if defined(SIMD_BACKEND_X86)
+#include "x86/simdu8x16_sse.hpp"
+#elif defined(SIMD_BACKEND_NEON)
+#include "neon/simdu8x16_neon.hpp"
+#else
+#include "generic/simdu8x16_generic.hpp"
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "simdf4.hpp"
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    3 floats, the layout of vertex positions (12 bytes, no padding).
+*/
+struct vec3f {
+    float x;
+    float y;
+    float z;
+};
+static_assert(sizeof(vec3f) == 3 * sizeof(float), "vec3f has to be tightly packed");
+
+/**
+    4 vec3f in SoA form, one register per coordinate.
+*/
+struct vec3f4 {
+    simdf4 x;
+    simdf4 y;
+    simdf4 z;
+
+    /**
+        Loads 4 consecutive vec3f (three registers) and transposes them.
+    */
+    static vec3f4 load(const vec3f* input) noexcept
+    {
+        // x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+        const float* in = &input->x;
+        const simdf4 a(in);
+        const simdf4 b(in + 4);
+        const simdf4 c(in + 8);
+        return vec3f4{ simdf4::shuffle<0, 3, 0, 2>(a, simdf4::shuffle<2, 2, 1, 1>(b, c)),
+            simdf4::shuffle<0, 2, 0, 2>(simdf4::shuffle<1, 1, 0, 0>(a, b), simdf4::shuffle<3, 3, 2, 2>(b, c)),
+            simdf4::shuffle<0, 2, 0, 2>(simdf4::shuffle<2, 2, 1, 1>(a, b), simdf4::shuffle<0, 0, 3, 3>(c, c)) };
+    }
+    /**
+        Stores the 4 vectors as consecutive vec3f.
+    */
+    void store(vec3f* output) const noexcept
+    {
+        float* out = &output->x;
+        simdf4::shuffle<0, 2, 0, 2>(simdf4::shuffle<0, 0, 0, 0>(this->x, this->y), simdf4::shuffle<0, 0, 1, 1>(this->z, this->x)).store(out);
+        simdf4::shuffle<0, 2, 0, 2>(simdf4::shuffle<1, 1, 1, 1>(this->y, this->z), simdf4::shuffle<2, 2, 2, 2>(this->x, this->y)).store(out + 4);
+        simdf4::shuffle<0, 2, 0, 2>(simdf4::shuffle<2, 2, 3, 3>(this->z, this->x), simdf4::shuffle<3, 3, 3, 3>(this->y, this->z)).store(out + 8);
+    }
+};
+
+SIMD_NAMESPACE_END
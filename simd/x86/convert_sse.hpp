@@ -0,0 +1,213 @@
+#pragma once
+
+#include <immintrin.h>
+
+SIMD_NAMESPACE_BEGIN
+
+namespace simd_convert {
+namespace priv {
+    /**
+        Packs 32 bit lanes in range [0, 65535] into 16 bit lanes.
+    */
+    inline __m128i pack_u32_u16(__m128i low, __m128i high) noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return _mm_packus_epi32(low, high);
+#else
+        // move the range to the signed one for the signed pack, then back
+        const __m128i bias = _mm_set1_epi32(0x8000);
+        return _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(low, bias), _mm_sub_epi32(high, bias)), _mm_set1_epi16(-0x8000));
+#endif
+    }
+    /**
+        Truncating (or with Nearest, rounding) float to uint32_t, negative values become 0.
+    */
+    template <bool Nearest>
+    __m128i float_to_u32(__m128 value) noexcept
+    {
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+        const __m128 clamped = _mm_max_ps(value, _mm_setzero_ps());
+        return Nearest ? _mm_cvtps_epu32(clamped) : _mm_cvttps_epu32(clamped);
+#else
+        // values from 2^31 up are converted with 2^31 subtracted, which sets the top bit back
+        const __m128 clamped = _mm_max_ps(value, _mm_setzero_ps());
+        const __m128 two_31 = _mm_set1_ps(2147483648.0f);
+        const __m128 big = _mm_cmpge_ps(clamped, two_31);
+        const __m128 reduced = _mm_sub_ps(clamped, _mm_and_ps(big, two_31));
+        const __m128i converted = Nearest ? _mm_cvtps_epi32(reduced) : _mm_cvttps_epi32(reduced);
+        return _mm_xor_si128(converted, _mm_slli_epi32(_mm_castps_si128(big), 31));
+#endif
+    }
+
+    template <>
+    struct converter<simd<int32_t, 4>, simd<float, 4>> {
+        static simd<int32_t, 4> convert(const simd<float, 4>& value) noexcept
+        {
+            return simd<int32_t, 4>{ _mm_cvttps_epi32(value.native()) };
+        }
+        static simd<int32_t, 4> convert_nearest(const simd<float, 4>& value) noexcept
+        {
+            return simd<int32_t, 4>{ _mm_cvtps_epi32(value.native()) };
+        }
+    };
+    template <>
+    struct converter<simd<uint32_t, 4>, simd<float, 4>> {
+        static simd<uint32_t, 4> convert(const simd<float, 4>& value) noexcept
+        {
+            return simd<uint32_t, 4>{ float_to_u32<false>(value.native()) };
+        }
+        static simd<uint32_t, 4> convert_nearest(const simd<float, 4>& value) noexcept
+        {
+            return simd<uint32_t, 4>{ float_to_u32<true>(value.native()) };
+        }
+    };
+    template <>
+    struct converter<simd<float, 4>, simd<int32_t, 4>> {
+        static simd<float, 4> convert(const simd<int32_t, 4>& value) noexcept
+        {
+            return simd<float, 4>{ _mm_cvtepi32_ps(value.native()) };
+        }
+    };
+    template <>
+    struct converter<simd<float, 4>, simd<uint32_t, 4>> {
+        static simd<float, 4> convert(const simd<uint32_t, 4>& value) noexcept
+        {
+#if defined(__AVX512F__) && defined(__AVX512VL__)
+            return simd<float, 4>{ _mm_cvtepu32_ps(value.native()) };
+#else
+            // both halves convert exactly, the sum is rounded once
+            const __m128 high = _mm_cvtepi32_ps(_mm_srli_epi32(value.native(), 16));
+            const __m128 low = _mm_cvtepi32_ps(_mm_and_si128(value.native(), _mm_set1_epi32(0xffff)));
+            return simd<float, 4>{ _mm_add_ps(_mm_mul_ps(high, _mm_set1_ps(65536.0f)), low) };
+#endif
+        }
+    };
+    template <>
+    struct converter<simd<uint32_t, 4>, simd<int32_t, 4>> {
+        static simd<uint32_t, 4> convert(const simd<int32_t, 4>& value) noexcept
+        {
+            return simd<uint32_t, 4>{ value.native() };
+        }
+    };
+    template <>
+    struct converter<simd<int32_t, 4>, simd<uint32_t, 4>> {
+        static simd<int32_t, 4> convert(const simd<uint32_t, 4>& value) noexcept
+        {
+            return simd<int32_t, 4>{ value.native() };
+        }
+    };
+    template <>
+    struct converter<simd<uint16_t, 8>, simd<int16_t, 8>> {
+        static simd<uint16_t, 8> convert(const simd<int16_t, 8>& value) noexcept
+        {
+            return simd<uint16_t, 8>{ value.native() };
+        }
+    };
+    template <>
+    struct converter<simd<int16_t, 8>, simd<uint16_t, 8>> {
+        static simd<int16_t, 8> convert(const simd<uint16_t, 8>& value) noexcept
+        {
+            return simd<int16_t, 8>{ value.native() };
+        }
+    };
+
+    template <>
+    struct widener<simd<uint8_t, 16>> {
+        using type = simd<uint16_t, 8>;
+        static type low(const simd<uint8_t, 16>& value) noexcept
+        {
+#if defined(__SSE4_1__) || defined(__AVX__)
+            return type{ _mm_cvtepu8_epi16(value.native()) };
+#else
+            return type{ _mm_unpacklo_epi8(value.native(), _mm_setzero_si128()) };
+#endif
+        }
+        static type high(const simd<uint8_t, 16>& value) noexcept
+        {
+            return type{ _mm_unpackhi_epi8(value.native(), _mm_setzero_si128()) };
+        }
+    };
+    template <>
+    struct widener<simd<uint16_t, 8>> {
+        using type = simd<uint32_t, 4>;
+        static type low(const simd<uint16_t, 8>& value) noexcept
+        {
+#if defined(__SSE4_1__) || defined(__AVX__)
+            return type{ _mm_cvtepu16_epi32(value.native()) };
+#else
+            return type{ _mm_unpacklo_epi16(value.native(), _mm_setzero_si128()) };
+#endif
+        }
+        static type high(const simd<uint16_t, 8>& value) noexcept
+        {
+            return type{ _mm_unpackhi_epi16(value.native(), _mm_setzero_si128()) };
+        }
+    };
+    template <>
+    struct widener<simd<int16_t, 8>> {
+        using type = simd<int32_t, 4>;
+        static type low(const simd<int16_t, 8>& value) noexcept
+        {
+#if defined(__SSE4_1__) || defined(__AVX__)
+            return type{ _mm_cvtepi16_epi32(value.native()) };
+#else
+            // duplicate each lane into both halves of 32 bits and shift the copy in the low half out
+            return type{ _mm_srai_epi32(_mm_unpacklo_epi16(value.native(), value.native()), 16) };
+#endif
+        }
+        static type high(const simd<int16_t, 8>& value) noexcept
+        {
+            return type{ _mm_srai_epi32(_mm_unpackhi_epi16(value.native(), value.native()), 16) };
+        }
+    };
+
+    template <>
+    struct narrower<simd<int16_t, 8>, simd<int32_t, 4>> {
+        static simd<int16_t, 8> saturate(const simd<int32_t, 4>& low, const simd<int32_t, 4>& high) noexcept
+        {
+            return simd<int16_t, 8>{ _mm_packs_epi32(low.native(), high.native()) };
+        }
+    };
+    template <>
+    struct narrower<simd<uint16_t, 8>, simd<int32_t, 4>> {
+        static simd<uint16_t, 8> saturate(const simd<int32_t, 4>& low, const simd<int32_t, 4>& high) noexcept
+        {
+#if defined(__SSE4_1__) || defined(__AVX__)
+            return simd<uint16_t, 8>{ _mm_packus_epi32(low.native(), high.native()) };
+#else
+            const simd<int32_t, 4> zero{};
+            const simd<int32_t, 4> limit{ 65535 };
+            return simd<uint16_t, 8>{ pack_u32_u16(low.max(zero).min(limit).native(), high.max(zero).min(limit).native()) };
+#endif
+        }
+    };
+    template <>
+    struct narrower<simd<uint16_t, 8>, simd<uint32_t, 4>> {
+        static simd<uint16_t, 8> saturate(const simd<uint32_t, 4>& low, const simd<uint32_t, 4>& high) noexcept
+        {
+            const simd<uint32_t, 4> limit{ 65535u };
+            return simd<uint16_t, 8>{ pack_u32_u16(low.min(limit).native(), high.min(limit).native()) };
+        }
+    };
+    template <>
+    struct narrower<simd<uint8_t, 16>, simd<int16_t, 8>> {
+        static simd<uint8_t, 16> saturate(const simd<int16_t, 8>& low, const simd<int16_t, 8>& high) noexcept
+        {
+            return simd<uint8_t, 16>{ _mm_packus_epi16(low.native(), high.native()) };
+        }
+    };
+    template <>
+    struct narrower<simd<uint8_t, 16>, simd<uint16_t, 8>> {
+        static simd<uint8_t, 16> saturate(const simd<uint16_t, 8>& low, const simd<uint16_t, 8>& high) noexcept
+        {
+            // min(x, 255) as x - saturated(x - 255), then the signed pack only sees [0, 255]
+            const __m128i limit = _mm_set1_epi16(255);
+            const __m128i l = _mm_sub_epi16(low.native(), _mm_subs_epu16(low.native(), limit));
+            const __m128i h = _mm_sub_epi16(high.native(), _mm_subs_epu16(high.native(), limit));
+            return simd<uint8_t, 16>{ _mm_packus_epi16(l, h) };
+        }
+    };
+} // namespace priv
+} // namespace simd_convert
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "../permute_pattern.hpp"
+
+#include <immintrin.h>
+
+#include <cstdint>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    permute<idx...>() for the 128 bit registers. 32 and 64 bit lanes always take one shufps / pshufd,
+    narrower lanes go to the widest lanes that move together, then to pshuflw / pshufhw or a
+    byte rotation, and only arbitrary patterns take pshufb (SSSE3) or lane by lane moves (SSE2).
+*/
+namespace priv {
+
+template <typename P>
+constexpr int shuffle_immediate() noexcept
+{
+    return static_cast<int>(P::at(0) | (P::at(1) << 2) | (P::at(2) << 4) | (P::at(3) << 6));
+}
+
+template <typename P>
+constexpr permute_strategy sse_permute_strategy(unsigned lane_bytes) noexcept
+{
+    return P::is_identity() ? permute_identity
+        : lane_bytes < 4 && P::is_grouped(2) ? permute_grouped
+        : lane_bytes == 2 && P::within_halves() ? permute_halves
+        : P::rotation() != 0 ? permute_rotate
+                             : permute_general;
+}
+
+template <unsigned... idx>
+__m128i permute_epi32(__m128i value) noexcept
+{
+    using P = permute_pattern<idx...>;
+    static_assert(P::lane_count == 4, "permute needs one index per lane");
+    static_assert(P::in_range(), "permute lane index out of range");
+    return P::is_identity() ? value : _mm_shuffle_epi32(value, shuffle_immediate<P>());
+}
+
+template <unsigned... idx>
+__m128 permute_ps(__m128 value) noexcept
+{
+    using P = permute_pattern<idx...>;
+    static_assert(P::lane_count == 4, "permute needs one index per lane");
+    static_assert(P::in_range(), "permute lane index out of range");
+    return P::is_identity() ? value : _mm_shuffle_ps(value, value, shuffle_immediate<P>());
+}
+
+template <unsigned... idx>
+__m128d permute_pd(__m128d value) noexcept
+{
+    using P = permute_pattern<idx...>;
+    static_assert(P::lane_count == 2, "permute needs one index per lane");
+    static_assert(P::in_range(), "permute lane index out of range");
+    return P::is_identity() ? value : _mm_shuffle_pd(value, value, static_cast<int>(P::at(0) | (P::at(1) << 1)));
+}
+
+template <typename P>
+__m128i rotate_bytes(__m128i value) noexcept
+{
+    constexpr int shift = static_cast<int>(P::rotation() * (16 / P::lane_count));
+#if defined(__SSSE3__) || defined(__AVX__)
+    return _mm_alignr_epi8(value, value, shift);
+#else
+    return _mm_or_si128(_mm_srli_si128(value, shift), _mm_slli_si128(value, 16 - shift));
+#endif
+}
+
+#if defined(__SSSE3__) || defined(__AVX__)
+template <typename P, size_t... b>
+__m128i permute_table(__m128i value, std::index_sequence<b...>) noexcept
+{
+    return _mm_shuffle_epi8(value, _mm_setr_epi8(static_cast<char>(P::byte_at(16 / P::lane_count, b))...));
+}
+#endif
+
+template <typename P, size_t... g>
+__m128i permute_epi16_groups(__m128i value, std::index_sequence<g...>) noexcept
+{
+    return permute_epi32<P::group_at(2, g)...>(value);
+}
+template <typename P>
+__m128i permute_epi16(__m128i value, permute_tag<permute_identity>) noexcept
+{
+    return value;
+}
+template <typename P>
+__m128i permute_epi16(__m128i value, permute_tag<permute_grouped>) noexcept
+{
+    return permute_epi16_groups<P>(value, std::make_index_sequence<4>{});
+}
+template <typename P>
+__m128i permute_epi16(__m128i value, permute_tag<permute_halves>) noexcept
+{
+    constexpr int low = static_cast<int>(P::at(0) | (P::at(1) << 2) | (P::at(2) << 4) | (P::at(3) << 6));
+    constexpr int high = static_cast<int>((P::at(4) - 4) | ((P::at(5) - 4) << 2) | ((P::at(6) - 4) << 4) | ((P::at(7) - 4) << 6));
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, low), high);
+}
+template <typename P>
+__m128i permute_epi16(__m128i value, permute_tag<permute_rotate>) noexcept
+{
+    return rotate_bytes<P>(value);
+}
+template <typename P, size_t... i>
+__m128i permute_epi16_lanes(__m128i value, std::index_sequence<i...>) noexcept
+{
+    return _mm_setr_epi16(static_cast<short>(_mm_extract_epi16(value, P::at(i)))...);
+}
+template <typename P>
+__m128i permute_epi16(__m128i value, permute_tag<permute_general>) noexcept
+{
+#if defined(__SSSE3__) || defined(__AVX__)
+    return permute_table<P>(value, std::make_index_sequence<16>{});
+#else
+    return permute_epi16_lanes<P>(value, std::make_index_sequence<8>{});
+#endif
+}
+template <unsigned... idx>
+__m128i permute_epi16(__m128i value) noexcept
+{
+    using P = permute_pattern<idx...>;
+    static_assert(P::lane_count == 8, "permute needs one index per lane");
+    static_assert(P::in_range(), "permute lane index out of range");
+    return permute_epi16<P>(value, permute_tag<sse_permute_strategy<P>(2)>{});
+}
+
+template <typename P, size_t... g>
+__m128i permute_epi8_groups(__m128i value, std::index_sequence<g...>) noexcept
+{
+    return permute_epi16<P::group_at(2, g)...>(value);
+}
+template <typename P>
+__m128i permute_epi8(__m128i value, permute_tag<permute_identity>) noexcept
+{
+    return value;
+}
+template <typename P>
+__m128i permute_epi8(__m128i value, permute_tag<permute_grouped>) noexcept
+{
+    return permute_epi8_groups<P>(value, std::make_index_sequence<8>{});
+}
+template <typename P>
+__m128i permute_epi8(__m128i value, permute_tag<permute_rotate>) noexcept
+{
+    return rotate_bytes<P>(value);
+}
+template <typename P, size_t... i>
+__m128i permute_epi8_lanes(__m128i value, std::index_sequence<i...>) noexcept
+{
+    // SSE2 has no byte shuffle
+    alignas(16) uint8_t bytes[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(bytes), value);
+    return _mm_setr_epi8(static_cast<char>(bytes[P::at(i)])...);
+}
+template <typename P>
+__m128i permute_epi8(__m128i value, permute_tag<permute_general>) noexcept
+{
+#if defined(__SSSE3__) || defined(__AVX__)
+    return permute_table<P>(value, std::make_index_sequence<16>{});
+#else
+    return permute_epi8_lanes<P>(value, std::make_index_sequence<16>{});
+#endif
+}
+template <unsigned... idx>
+__m128i permute_epi8(__m128i value) noexcept
+{
+    using P = permute_pattern<idx...>;
+    static_assert(P::lane_count == 16, "permute needs one index per lane");
+    static_assert(P::in_range(), "permute lane index out of range");
+    return permute_epi8<P>(value, permute_tag<sse_permute_strategy<P>(1)>{});
+}
+
+} // namespace priv
+
+SIMD_NAMESPACE_END
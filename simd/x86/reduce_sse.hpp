@@ -0,0 +1,50 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include <cstddef>
+#include <cstdint>
+
+SIMD_NAMESPACE_BEGIN
+
+namespace priv {
+/**
+    Combines the lanes of value with op, halving the number of lanes per step by shifting the
+    upper half down. Lane 0 of the result holds the combination of all lanes, the other lanes
+    are unspecified.
+*/
+template <typename V, typename Op>
+V fold_lanes(const V& value, Op op) noexcept
+{
+    constexpr size_t lane_bytes = 16 / V::value_count;
+    V result = op(value, V{ _mm_shuffle_epi32(value.native(), _MM_SHUFFLE(1, 0, 3, 2)) });
+    if (lane_bytes <= 4)
+        result = op(result, V{ _mm_shuffle_epi32(result.native(), _MM_SHUFFLE(2, 3, 0, 1)) });
+    if (lane_bytes <= 2)
+        result = op(result, V{ _mm_srli_epi32(result.native(), 16) });
+    if (lane_bytes <= 1)
+        result = op(result, V{ _mm_srli_epi16(result.native(), 8) });
+    return result;
+}
+
+/**
+    Sum of the four 32 bit lanes, modulo 2^32.
+*/
+inline int32_t sum_epi32(__m128i value) noexcept
+{
+    const __m128i pairs = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+    return _mm_cvtsi128_si32(_mm_add_epi32(pairs, _mm_shuffle_epi32(pairs, _MM_SHUFFLE(2, 3, 0, 1))));
+}
+
+/**
+    Sum of the two 64 bit lanes.
+*/
+inline uint64_t sum_epi64(__m128i value) noexcept
+{
+    uint64_t result;
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&result), _mm_add_epi64(value, _mm_unpackhi_epi64(value, value)));
+    return result;
+}
+} // namespace priv
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,472 @@
+#pragma once
+
+#include "simdf4_sse.hpp"
+
+#include <immintrin.h>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdd2 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<double, 2> {
+public:
+    static constexpr size_t value_count = 2;
+
+    simd_mask() noexcept
+        : _m(_mm_setzero_pd())
+    {
+    }
+    simd_mask(bool s0, bool s1) noexcept
+        : _m(_mm_castsi128_pd(_mm_setr_epi32(s0 ? -1 : 0, s0 ? -1 : 0, s1 ? -1 : 0, s1 ? -1 : 0)))
+    {
+    }
+    explicit simd_mask(__m128d value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        const __m128i lanes = _mm_setr_epi32(1, 1, 2, 2);
+        const __m128i selected = _mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), lanes);
+        return simd_mask{ _mm_castsi128_pd(_mm_cmpeq_epi32(selected, lanes)) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        const __m128d limit = _mm_set1_pd(static_cast<double>(count < 2 ? count : 2));
+        return simd_mask{ _mm_cmplt_pd(_mm_setr_pd(0, 1), limit) };
+    }
+
+    __m128d native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return static_cast<uint32_t>(_mm_movemask_pd(this->_m));
+    }
+    bool any() const noexcept
+    {
+        return this->movemask() != 0;
+    }
+    bool all() const noexcept
+    {
+        return this->movemask() == 0x3;
+    }
+    bool none() const noexcept
+    {
+        return this->movemask() == 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_and_pd(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_or_pd(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_xor_pd(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ _mm_xor_pd(this->_m, _mm_castsi128_pd(_mm_set1_epi32(-1))) };
+    }
+
+private:
+    __m128d _m;
+};
+
+template <>
+class simd<double, 2> : public simd_common<simd<double, 2>> {
+public:
+    using type = double;
+    using mask_type = simd_mask<double, 2>;
+    static constexpr size_t value_count = 2;
+
+    simd() noexcept
+        : _d(_mm_setzero_pd())
+    {
+    }
+    explicit simd(double value) noexcept
+        : _d(_mm_set1_pd(value))
+    {
+    }
+    simd(double s0, double s1) noexcept
+        : _d(_mm_setr_pd(s0, s1))
+    {
+    }
+    explicit simd(__m128d value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const double* input) noexcept
+        : _d(_mm_loadu_pd(input))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const double* input, size_t count) noexcept
+    {
+        switch (count) {
+        case 0:
+            return simd{};
+        case 1:
+            return simd{ _mm_load_sd(input) };
+        default:
+            return simd{ _mm_loadu_pd(input) };
+        }
+    }
+
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const double* input) noexcept
+    {
+        return simd{ _mm_load_pd(input) };
+    }
+
+    /**
+        Converts the low two lanes of a simdf4.
+    */
+    static simd from_float_low(const simd<float, 4>& value) noexcept
+    {
+        return simd{ _mm_cvtps_pd(value.native()) };
+    }
+    /**
+        Converts the high two lanes of a simdf4.
+    */
+    static simd from_float_high(const simd<float, 4>& value) noexcept
+    {
+        return simd{ _mm_cvtps_pd(_mm_movehl_ps(value.native(), value.native())) };
+    }
+    /**
+        Rounds the lanes of low and high to float, low goes to lanes 0 and 1 of the result.
+    */
+    static simd<float, 4> to_float(const simd& low, const simd& high) noexcept
+    {
+        return simd<float, 4>{ _mm_movelh_ps(_mm_cvtpd_ps(low._d), _mm_cvtpd_ps(high._d)) };
+    }
+
+    __m128d native() const noexcept
+    {
+        return this->_d;
+    }
+
+    void store(double* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        if (cache_flags == cache_coherence::coherent) {
+            _mm_storeu_pd(output, this->_d);
+        } else if (cache_flags == cache_coherence::non_temporal) {
+            _mm_stream_pd(output, this->_d);
+        }
+    }
+
+    void store_aligned(double* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        if (cache_flags == cache_coherence::coherent) {
+            _mm_store_pd(output, this->_d);
+        } else if (cache_flags == cache_coherence::non_temporal) {
+            _mm_stream_pd(output, this->_d);
+        }
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(double* output, size_t count) const noexcept
+    {
+        switch (count) {
+        case 0:
+            break;
+        case 1:
+            _mm_store_sd(output, this->_d);
+            break;
+        default:
+            _mm_storeu_pd(output, this->_d);
+            break;
+        }
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ _mm_add_pd(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        return *this = *this + other;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ _mm_sub_pd(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        return *this = *this - other;
+    }
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ _mm_mul_pd(this->_d, other._d) };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    simd operator/(const simd& other) const noexcept
+    {
+        return simd{ _mm_div_pd(this->_d, other._d) };
+    }
+    simd& operator/=(const simd& other) noexcept
+    {
+        return *this = *this / other;
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ _mm_min_pd(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ _mm_max_pd(this->_d, other._d) };
+    }
+    simd sqrt() const noexcept
+    {
+        return simd{ _mm_sqrt_pd(this->_d) };
+    }
+    /**
+        Approximate 1 / x, see simd_base::precision. There is no double estimate instruction,
+        the estimate is the float one (12 bits), so it requires values in the float range.
+        Each Newton-Raphson step doubles the correct bits.
+    */
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        if (P == exact)
+            return simd{ _mm_div_pd(_mm_set1_pd(1.0), this->_d) };
+        auto x = _mm_cvtps_pd(_mm_rcp_ps(_mm_cvtpd_ps(this->_d)));
+        // x' = x * (2 - d * x)
+        if (P >= newton_1)
+            x = _mm_mul_pd(x, _mm_sub_pd(_mm_set1_pd(2.0), _mm_mul_pd(this->_d, x)));
+        if (P >= newton_2)
+            x = _mm_mul_pd(x, _mm_sub_pd(_mm_set1_pd(2.0), _mm_mul_pd(this->_d, x)));
+        return simd{ x };
+    }
+    /**
+        Approximate 1 / sqrt(x), see rcp() for the estimate.
+    */
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        if (P == exact)
+            return simd{ _mm_div_pd(_mm_set1_pd(1.0), _mm_sqrt_pd(this->_d)) };
+        auto y = _mm_cvtps_pd(_mm_rsqrt_ps(_mm_cvtpd_ps(this->_d)));
+        // y' = y * (1.5 - 0.5 * d * y * y)
+        const auto half_d = _mm_mul_pd(_mm_set1_pd(0.5), this->_d);
+        if (P >= newton_1)
+            y = _mm_mul_pd(y, _mm_sub_pd(_mm_set1_pd(1.5), _mm_mul_pd(half_d, _mm_mul_pd(y, y))));
+        if (P >= newton_2)
+            y = _mm_mul_pd(y, _mm_sub_pd(_mm_set1_pd(1.5), _mm_mul_pd(half_d, _mm_mul_pd(y, y))));
+        return simd{ y };
+    }
+    simd abs() const noexcept
+    {
+        return simd{ _mm_andnot_pd(_mm_set1_pd(-0.0), this->_d) };
+    }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_round_pd(this->_d, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) };
+#else
+        // adding and subtracting 2^52 drops the fraction bits, larger values are integral already
+        const __m128d magic = _mm_set1_pd(4503599627370496.0);
+        const __m128d sign = _mm_and_pd(this->_d, _mm_set1_pd(-0.0));
+        const __m128d magnitude = _mm_andnot_pd(_mm_set1_pd(-0.0), this->_d);
+        const __m128d rounded = _mm_or_pd(_mm_sub_pd(_mm_add_pd(magnitude, magic), magic), sign);
+        const __m128d small = _mm_cmplt_pd(magnitude, magic);
+        return simd{ _mm_or_pd(_mm_and_pd(small, rounded), _mm_andnot_pd(small, this->_d)) };
+#endif
+    }
+    simd floor() const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_floor_pd(this->_d) };
+#else
+        const __m128d rounded = this->round()._d;
+        return simd{ _mm_sub_pd(rounded, _mm_and_pd(_mm_cmpgt_pd(rounded, this->_d), _mm_set1_pd(1.0))) };
+#endif
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-1022, 1023].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+        // the biased exponents are positive, so zero extending them to 64 bit is enough
+        const __m128i biased = _mm_add_epi32(_mm_cvtpd_epi32(exponent._d), _mm_set1_epi32(1023));
+        const __m128i scale = _mm_slli_epi64(_mm_unpacklo_epi32(biased, _mm_setzero_si128()), 52);
+        return simd{ _mm_mul_pd(this->_d, _mm_castsi128_pd(scale)) };
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+        const __m128i bits = _mm_castpd_si128(this->_d);
+        const __m128i biased = _mm_shuffle_epi32(_mm_srli_epi64(bits, 52), _MM_SHUFFLE(3, 1, 2, 0));
+        exponent._d = _mm_cvtepi32_pd(_mm_sub_epi32(biased, _mm_set1_epi32(1022)));
+        const __m128i mantissa = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi64x(0x000fffffffffffffll)), _mm_set1_epi64x(0x3fe0000000000000ll));
+        return simd{ _mm_castsi128_pd(mantissa) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ _mm_and_pd(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ _mm_or_pd(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ _mm_xor_pd(this->_d, other._d) };
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ priv::permute_pd<idx...>(this->_d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ _mm_cmpeq_pd(this->_d, other._d) };
+        case compare_flags::lower:
+            return mask_type{ _mm_cmplt_pd(this->_d, other._d) };
+        case compare_flags::lower_equal:
+            return mask_type{ _mm_cmple_pd(this->_d, other._d) };
+        case compare_flags::greater:
+            return mask_type{ _mm_cmpgt_pd(this->_d, other._d) };
+        case compare_flags::greater_equal:
+            return mask_type{ _mm_cmpge_pd(this->_d, other._d) };
+        case compare_flags::not_equal:
+            return mask_type{ _mm_cmpneq_pd(this->_d, other._d) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_blendv_pd(b._d, a._d, mask.native()) };
+#else
+        return simd{ _mm_or_pd(_mm_and_pd(mask.native(), a._d), _mm_andnot_pd(mask.native(), b._d)) };
+#endif
+    }
+
+    /**
+        a * b + c, rounded once when compiled with FMA support (e.g. -mfma or -march=haswell),
+        otherwise a multiplication followed by an addition.
+    */
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm_fmadd_pd(a._d, b._d, c._d) };
+#else
+        return a * b + c;
+#endif
+    }
+    /**
+        a * b - c
+    */
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm_fmsub_pd(a._d, b._d, c._d) };
+#else
+        return a * b - c;
+#endif
+    }
+    /**
+        c - a * b
+    */
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm_fnmadd_pd(a._d, b._d, c._d) };
+#else
+        return c - a * b;
+#endif
+    }
+
+    /**
+        { a0 + a1, b0 + b1 }
+    */
+    static simd horizontal_add(const simd& a, const simd& b) noexcept
+    {
+#if defined(__SSE3__) || defined(__AVX__)
+        return simd{ _mm_hadd_pd(a._d, b._d) };
+#else
+        return simd{ _mm_add_pd(_mm_unpacklo_pd(a._d, b._d), _mm_unpackhi_pd(a._d, b._d)) };
+#endif
+    }
+
+    /**
+        { a[l], b[h] }
+    */
+    template <unsigned short l, unsigned short h>
+    static simd shuffle(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm_shuffle_pd(a._d, b._d, _MM_SHUFFLE2(h, l)) };
+    }
+    static simd unpack_low(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm_unpacklo_pd(a._d, b._d) };
+    }
+    static simd unpack_high(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm_unpackhi_pd(a._d, b._d) };
+    }
+    static void transpose(simd& r0, simd& r1) noexcept
+    {
+        const __m128d t0 = _mm_unpacklo_pd(r0._d, r1._d);
+        r1._d = _mm_unpackhi_pd(r0._d, r1._d);
+        r0._d = t0;
+    }
+
+private:
+    __m128d _d;
+};
+
+using simdd2 = simd<double, 2>;
+
+SIMD_NAMESPACE_END
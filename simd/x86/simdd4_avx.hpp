@@ -0,0 +1,454 @@
+#pragma once
+
+#include "simdd2_sse.hpp"
+
+#include <immintrin.h>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdd4 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<double, 4> {
+public:
+    static constexpr size_t value_count = 4;
+
+    simd_mask() noexcept
+        : _m(_mm256_setzero_pd())
+    {
+    }
+    simd_mask(const simd_mask<double, 2>& low, const simd_mask<double, 2>& high) noexcept
+        : _m(_mm256_insertf128_pd(_mm256_castpd128_pd256(low.native()), high.native(), 1))
+    {
+    }
+    explicit simd_mask(__m256d value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        return simd_mask{ simd_mask<double, 2>::from_bits(bits), simd_mask<double, 2>::from_bits(bits >> 2) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        const __m256d index = _mm256_setr_pd(0, 1, 2, 3);
+        const __m256d limit = _mm256_set1_pd(static_cast<double>(count < 4 ? count : 4));
+        return simd_mask{ _mm256_cmp_pd(index, limit, _CMP_LT_OQ) };
+    }
+
+    __m256d native() const noexcept
+    {
+        return this->_m;
+    }
+    simd_mask<double, 2> low() const noexcept
+    {
+        return simd_mask<double, 2>{ _mm256_castpd256_pd128(this->_m) };
+    }
+    simd_mask<double, 2> high() const noexcept
+    {
+        return simd_mask<double, 2>{ _mm256_extractf128_pd(this->_m, 1) };
+    }
+    uint32_t movemask() const noexcept
+    {
+        return static_cast<uint32_t>(_mm256_movemask_pd(this->_m));
+    }
+    bool any() const noexcept
+    {
+        return _mm256_testz_pd(this->_m, this->_m) == 0;
+    }
+    bool all() const noexcept
+    {
+        return this->movemask() == 0xf;
+    }
+    bool none() const noexcept
+    {
+        return _mm256_testz_pd(this->_m, this->_m) != 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm256_and_pd(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm256_or_pd(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm256_xor_pd(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ _mm256_xor_pd(this->_m, _mm256_castsi256_pd(_mm256_set1_epi32(-1))) };
+    }
+
+private:
+    __m256d _m;
+};
+
+/**
+    4 x double backed by a single AVX register. Shuffles, unpacks and horizontal adds
+    operate on each 128 bit half independently, the same way the AVX instructions do.
+*/
+template <>
+class simd<double, 4> : public simd_common<simd<double, 4>> {
+public:
+    using type = double;
+    using mask_type = simd_mask<double, 4>;
+    static constexpr size_t value_count = 4;
+
+    simd() noexcept
+        : _d(_mm256_setzero_pd())
+    {
+    }
+    explicit simd(double value) noexcept
+        : _d(_mm256_set1_pd(value))
+    {
+    }
+    simd(double s0, double s1, double s2, double s3) noexcept
+        : _d(_mm256_setr_pd(s0, s1, s2, s3))
+    {
+    }
+    simd(const simd<double, 2>& low, const simd<double, 2>& high) noexcept
+        : _d(_mm256_insertf128_pd(_mm256_castpd128_pd256(low.native()), high.native(), 1))
+    {
+    }
+    /**
+        Converts the lanes of a simdf4.
+    */
+    explicit simd(const simd<float, 4>& value) noexcept
+        : _d(_mm256_cvtps_pd(value.native()))
+    {
+    }
+    explicit simd(__m256d value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const double* input) noexcept
+        : _d(_mm256_loadu_pd(input))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const double* input, size_t count) noexcept
+    {
+        return simd{ _mm256_maskload_pd(input, _mm256_castpd_si256(mask_type::first(count).native())) };
+    }
+
+    /**
+        Loads from memory aligned to 32 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const double* input) noexcept
+    {
+        return simd{ _mm256_load_pd(input) };
+    }
+
+    __m256d native() const noexcept
+    {
+        return this->_d;
+    }
+    simd<double, 2> low() const noexcept
+    {
+        return simd<double, 2>{ _mm256_castpd256_pd128(this->_d) };
+    }
+    simd<double, 2> high() const noexcept
+    {
+        return simd<double, 2>{ _mm256_extractf128_pd(this->_d, 1) };
+    }
+    /**
+        Rounds the lanes to float.
+    */
+    simd<float, 4> to_float() const noexcept
+    {
+        return simd<float, 4>{ _mm256_cvtpd_ps(this->_d) };
+    }
+
+    void store(double* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        if (cache_flags == cache_coherence::coherent) {
+            _mm256_storeu_pd(output, this->_d);
+        } else if (cache_flags == cache_coherence::non_temporal) {
+            _mm256_stream_pd(output, this->_d);
+        }
+    }
+
+    void store_aligned(double* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        if (cache_flags == cache_coherence::coherent) {
+            _mm256_store_pd(output, this->_d);
+        } else if (cache_flags == cache_coherence::non_temporal) {
+            _mm256_stream_pd(output, this->_d);
+        }
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(double* output, size_t count) const noexcept
+    {
+        _mm256_maskstore_pd(output, _mm256_castpd_si256(mask_type::first(count).native()), this->_d);
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ _mm256_add_pd(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        return *this = *this + other;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ _mm256_sub_pd(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        return *this = *this - other;
+    }
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ _mm256_mul_pd(this->_d, other._d) };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    simd operator/(const simd& other) const noexcept
+    {
+        return simd{ _mm256_div_pd(this->_d, other._d) };
+    }
+    simd& operator/=(const simd& other) noexcept
+    {
+        return *this = *this / other;
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ _mm256_min_pd(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ _mm256_max_pd(this->_d, other._d) };
+    }
+    simd sqrt() const noexcept
+    {
+        return simd{ _mm256_sqrt_pd(this->_d) };
+    }
+    /**
+        Approximate 1 / x, see simd_base::precision. The estimate is the float one (12 bits),
+        so it requires values in the float range.
+    */
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        if (P == exact)
+            return simd{ _mm256_div_pd(_mm256_set1_pd(1.0), this->_d) };
+        auto x = _mm256_cvtps_pd(_mm_rcp_ps(_mm256_cvtpd_ps(this->_d)));
+        // x' = x * (2 - d * x)
+        if (P >= newton_1)
+            x = _mm256_mul_pd(x, _mm256_sub_pd(_mm256_set1_pd(2.0), _mm256_mul_pd(this->_d, x)));
+        if (P >= newton_2)
+            x = _mm256_mul_pd(x, _mm256_sub_pd(_mm256_set1_pd(2.0), _mm256_mul_pd(this->_d, x)));
+        return simd{ x };
+    }
+    /**
+        Approximate 1 / sqrt(x), see rcp() for the estimate.
+    */
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        if (P == exact)
+            return simd{ _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(this->_d)) };
+        auto y = _mm256_cvtps_pd(_mm_rsqrt_ps(_mm256_cvtpd_ps(this->_d)));
+        // y' = y * (1.5 - 0.5 * d * y * y)
+        const auto half_d = _mm256_mul_pd(_mm256_set1_pd(0.5), this->_d);
+        if (P >= newton_1)
+            y = _mm256_mul_pd(y, _mm256_sub_pd(_mm256_set1_pd(1.5), _mm256_mul_pd(half_d, _mm256_mul_pd(y, y))));
+        if (P >= newton_2)
+            y = _mm256_mul_pd(y, _mm256_sub_pd(_mm256_set1_pd(1.5), _mm256_mul_pd(half_d, _mm256_mul_pd(y, y))));
+        return simd{ y };
+    }
+    simd abs() const noexcept
+    {
+        return simd{ _mm256_andnot_pd(_mm256_set1_pd(-0.0), this->_d) };
+    }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+        return simd{ _mm256_round_pd(this->_d, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) };
+    }
+    simd floor() const noexcept
+    {
+        return simd{ _mm256_floor_pd(this->_d) };
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-1022, 1023].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+#if defined(__AVX2__)
+        const __m128i biased = _mm_add_epi32(_mm256_cvtpd_epi32(exponent._d), _mm_set1_epi32(1023));
+        const __m256i scale = _mm256_slli_epi64(_mm256_cvtepu32_epi64(biased), 52);
+        return simd{ _mm256_mul_pd(this->_d, _mm256_castsi256_pd(scale)) };
+#else
+        return simd{ this->low().ldexp(exponent.low()), this->high().ldexp(exponent.high()) };
+#endif
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+#if defined(__AVX2__)
+        const __m256i bits = _mm256_castpd_si256(this->_d);
+        // small integers convert to double by placing them in the mantissa of 2^52
+        const __m256d magic = _mm256_set1_pd(4503599627370496.0);
+        const __m256i biased = _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_castpd_si256(magic));
+        exponent._d = _mm256_sub_pd(_mm256_castsi256_pd(biased), _mm256_add_pd(magic, _mm256_set1_pd(1022.0)));
+        const __m256i mantissa = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000fffffffffffffll)), _mm256_set1_epi64x(0x3fe0000000000000ll));
+        return simd{ _mm256_castsi256_pd(mantissa) };
+#else
+        simd<double, 2> exp_lo, exp_hi;
+        const simd result{ this->low().frexp(exp_lo), this->high().frexp(exp_hi) };
+        exponent = simd{ exp_lo, exp_hi };
+        return result;
+#endif
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ _mm256_and_pd(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ _mm256_or_pd(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ _mm256_xor_pd(this->_d, other._d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ _mm256_cmp_pd(this->_d, other._d, _CMP_EQ_OQ) };
+        case compare_flags::lower:
+            return mask_type{ _mm256_cmp_pd(this->_d, other._d, _CMP_LT_OS) };
+        case compare_flags::lower_equal:
+            return mask_type{ _mm256_cmp_pd(this->_d, other._d, _CMP_LE_OS) };
+        case compare_flags::greater:
+            return mask_type{ _mm256_cmp_pd(this->_d, other._d, _CMP_GT_OS) };
+        case compare_flags::greater_equal:
+            return mask_type{ _mm256_cmp_pd(this->_d, other._d, _CMP_GE_OS) };
+        case compare_flags::not_equal:
+            return mask_type{ _mm256_cmp_pd(this->_d, other._d, _CMP_NEQ_UQ) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm256_blendv_pd(b._d, a._d, mask.native()) };
+    }
+
+    /**
+        a * b + c, rounded once when compiled with FMA support (e.g. -mfma or -march=haswell),
+        otherwise a multiplication followed by an addition.
+    */
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm256_fmadd_pd(a._d, b._d, c._d) };
+#else
+        return a * b + c;
+#endif
+    }
+    /**
+        a * b - c
+    */
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm256_fmsub_pd(a._d, b._d, c._d) };
+#else
+        return a * b - c;
+#endif
+    }
+    /**
+        c - a * b
+    */
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm256_fnmadd_pd(a._d, b._d, c._d) };
+#else
+        return c - a * b;
+#endif
+    }
+
+    /**
+        { a0 + a1, b0 + b1, a2 + a3, b2 + b3 }
+    */
+    static simd horizontal_add(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm256_hadd_pd(a._d, b._d) };
+    }
+
+    /**
+        { a[l], b[h], a[2 + l], b[2 + h] }
+    */
+    template <unsigned short l, unsigned short h>
+    static simd shuffle(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm256_shuffle_pd(a._d, b._d, l | (h << 1) | (l << 2) | (h << 3)) };
+    }
+    static simd unpack_low(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm256_unpacklo_pd(a._d, b._d) };
+    }
+    static simd unpack_high(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm256_unpackhi_pd(a._d, b._d) };
+    }
+    static void transpose(simd& r0, simd& r1, simd& r2, simd& r3) noexcept
+    {
+        const __m256d t0 = _mm256_unpacklo_pd(r0._d, r1._d);
+        const __m256d t1 = _mm256_unpackhi_pd(r0._d, r1._d);
+        const __m256d t2 = _mm256_unpacklo_pd(r2._d, r3._d);
+        const __m256d t3 = _mm256_unpackhi_pd(r2._d, r3._d);
+        r0._d = _mm256_permute2f128_pd(t0, t2, 0x20);
+        r1._d = _mm256_permute2f128_pd(t1, t3, 0x20);
+        r2._d = _mm256_permute2f128_pd(t0, t2, 0x31);
+        r3._d = _mm256_permute2f128_pd(t1, t3, 0x31);
+    }
+
+private:
+    __m256d _d;
+};
+
+using simdd4 = simd<double, 4>;
+
+SIMD_NAMESPACE_END
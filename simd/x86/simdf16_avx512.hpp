@@ -0,0 +1,394 @@
+#pragma once
+
+#include "simdf8_avx.hpp"
+
+#include <immintrin.h>
+
+SIMD_NAMESPACE_BEGIN
+
+template <>
+class simd_mask<float, 16> {
+public:
+    static constexpr size_t value_count = 16;
+
+    simd_mask() noexcept
+        : _m(0)
+    {
+    }
+    explicit simd_mask(__mmask16 value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        return simd_mask(static_cast<__mmask16>(bits));
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        return simd_mask(static_cast<__mmask16>(count >= 16 ? 0xffff : (1u << count) - 1));
+    }
+
+    __mmask16 native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return this->_m;
+    }
+    bool any() const noexcept
+    {
+        return this->_m != 0;
+    }
+    bool all() const noexcept
+    {
+        return this->_m == 0xffff;
+    }
+    bool none() const noexcept
+    {
+        return this->_m == 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->_m);
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->_m >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask(static_cast<__mmask16>(this->_m & other._m));
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask(static_cast<__mmask16>(this->_m | other._m));
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask(static_cast<__mmask16>(this->_m ^ other._m));
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask(static_cast<__mmask16>(~this->_m));
+    }
+
+private:
+    __mmask16 _m;
+};
+
+/**
+    16 x float backed by a single AVX-512 register. Compare results stay in a mask register
+    (simd_mask<float, 16>), which also drives the masked loads, stores and blends.
+    Shuffles, unpacks and horizontal adds operate on each 128 bit quarter independently.
+*/
+template <>
+class simd<float, 16> : public simd_common<simd<float, 16>> {
+public:
+    using type = float;
+    using mask_type = simd_mask<float, 16>;
+    static constexpr size_t value_count = 16;
+
+    simd() noexcept
+        : _d(_mm512_setzero_ps())
+    {
+    }
+    explicit simd(float value) noexcept
+        : _d(_mm512_set1_ps(value))
+    {
+    }
+    simd(float s0, float s1, float s2, float s3, float s4, float s5, float s6, float s7,
+        float s8, float s9, float s10, float s11, float s12, float s13, float s14, float s15) noexcept
+        : _d(_mm512_setr_ps(s0, s1, s2, s3, s4, s5, s6, s7, s8, s9, s10, s11, s12, s13, s14, s15))
+    {
+    }
+    simd(const simd<float, 8>& low, const simd<float, 8>& high) noexcept
+        : _d(_mm512_castpd_ps(_mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_castps_pd(low.native())),
+              _mm256_castps_pd(high.native()), 1)))
+    {
+    }
+    explicit simd(__m512 value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const float* input) noexcept
+        : _d(_mm512_loadu_ps(input))
+    {
+    }
+    /**
+        Loads the lanes selected by the mask, the other lanes are set to zero.
+        Memory of the masked out lanes is not accessed.
+    */
+    simd(const float* input, const mask_type& mask) noexcept
+        : _d(_mm512_maskz_loadu_ps(mask.native(), input))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const float* input, size_t count) noexcept
+    {
+        return simd(input, mask_type::first(count));
+    }
+
+    /**
+        Loads from memory aligned to 64 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const float* input) noexcept
+    {
+        return simd{ _mm512_load_ps(input) };
+    }
+
+    __m512 native() const noexcept
+    {
+        return this->_d;
+    }
+    simd<float, 8> low() const noexcept
+    {
+        return simd<float, 8>{ _mm512_castps512_ps256(this->_d) };
+    }
+    simd<float, 8> high() const noexcept
+    {
+        return simd<float, 8>{ _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(this->_d), 1)) };
+    }
+
+    void store(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        if (cache_flags == cache_coherence::coherent) {
+            _mm512_storeu_ps(output, this->_d);
+        } else if (cache_flags == cache_coherence::non_temporal) {
+            _mm512_stream_ps(output, this->_d);
+        }
+    }
+
+    void store_aligned(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        if (cache_flags == cache_coherence::coherent) {
+            _mm512_store_ps(output, this->_d);
+        } else if (cache_flags == cache_coherence::non_temporal) {
+            _mm512_stream_ps(output, this->_d);
+        }
+    }
+
+    /**
+        Stores the lanes selected by the mask. Memory of the masked out lanes is not accessed.
+    */
+    void store(float* output, const mask_type& mask) const noexcept
+    {
+        _mm512_mask_storeu_ps(output, mask.native(), this->_d);
+    }
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(float* output, size_t count) const noexcept
+    {
+        this->store(output, mask_type::first(count));
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ _mm512_add_ps(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        return *this = *this + other;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ _mm512_sub_ps(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        return *this = *this - other;
+    }
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ _mm512_mul_ps(this->_d, other._d) };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    simd operator/(const simd& other) const noexcept
+    {
+        return simd{ _mm512_div_ps(this->_d, other._d) };
+    }
+    simd& operator/=(const simd& other) noexcept
+    {
+        return *this = *this / other;
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ _mm512_min_ps(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ _mm512_max_ps(this->_d, other._d) };
+    }
+    simd sqrt() const noexcept
+    {
+        return simd{ _mm512_sqrt_ps(this->_d) };
+    }
+    /**
+        Approximate 1 / x, see simd_base::precision.
+    */
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        if (P == exact)
+            return simd{ _mm512_div_ps(_mm512_set1_ps(1.0f), this->_d) };
+        auto x = _mm512_rcp14_ps(this->_d);
+        // x' = x * (2 - d * x)
+        if (P >= newton_1)
+            x = _mm512_mul_ps(x, _mm512_sub_ps(_mm512_set1_ps(2.0f), _mm512_mul_ps(this->_d, x)));
+        if (P >= newton_2)
+            x = _mm512_mul_ps(x, _mm512_sub_ps(_mm512_set1_ps(2.0f), _mm512_mul_ps(this->_d, x)));
+        return simd{ x };
+    }
+    /**
+        Approximate 1 / sqrt(x), see simd_base::precision.
+    */
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        if (P == exact)
+            return simd{ _mm512_div_ps(_mm512_set1_ps(1.0f), _mm512_sqrt_ps(this->_d)) };
+        auto y = _mm512_rsqrt14_ps(this->_d);
+        // y' = y * (1.5 - 0.5 * d * y * y)
+        const auto half_d = _mm512_mul_ps(_mm512_set1_ps(0.5f), this->_d);
+        if (P >= newton_1)
+            y = _mm512_mul_ps(y, _mm512_sub_ps(_mm512_set1_ps(1.5f), _mm512_mul_ps(half_d, _mm512_mul_ps(y, y))));
+        if (P >= newton_2)
+            y = _mm512_mul_ps(y, _mm512_sub_ps(_mm512_set1_ps(1.5f), _mm512_mul_ps(half_d, _mm512_mul_ps(y, y))));
+        return simd{ y };
+    }
+    simd abs() const noexcept
+    {
+        return simd{ _mm512_abs_ps(this->_d) };
+    }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+        return simd{ _mm512_roundscale_ps(this->_d, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) };
+    }
+    simd floor() const noexcept
+    {
+        return simd{ _mm512_roundscale_ps(this->_d, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC) };
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-126, 127].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+        return simd{ _mm512_scalef_ps(this->_d, exponent._d) };
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+        exponent._d = _mm512_add_ps(_mm512_getexp_ps(this->_d), _mm512_set1_ps(1.0f));
+        return simd{ _mm512_getmant_ps(this->_d, _MM_MANT_NORM_p5_1, _MM_MANT_SIGN_src) };
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(this->_d), _mm512_castps_si512(other._d))) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(this->_d), _mm512_castps_si512(other._d))) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(this->_d), _mm512_castps_si512(other._d))) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ _mm512_cmp_ps_mask(this->_d, other._d, _CMP_EQ_OQ) };
+        case compare_flags::lower:
+            return mask_type{ _mm512_cmp_ps_mask(this->_d, other._d, _CMP_LT_OS) };
+        case compare_flags::lower_equal:
+            return mask_type{ _mm512_cmp_ps_mask(this->_d, other._d, _CMP_LE_OS) };
+        case compare_flags::greater:
+            return mask_type{ _mm512_cmp_ps_mask(this->_d, other._d, _CMP_GT_OS) };
+        case compare_flags::greater_equal:
+            return mask_type{ _mm512_cmp_ps_mask(this->_d, other._d, _CMP_GE_OS) };
+        case compare_flags::not_equal:
+            return mask_type{ _mm512_cmp_ps_mask(this->_d, other._d, _CMP_NEQ_UQ) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm512_mask_blend_ps(mask.native(), b._d, a._d) };
+    }
+
+    /**
+        Fused a * b + c, rounded once.
+    */
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ _mm512_fmadd_ps(a._d, b._d, c._d) };
+    }
+    /**
+        a * b - c
+    */
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ _mm512_fmsub_ps(a._d, b._d, c._d) };
+    }
+    /**
+        c - a * b
+    */
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+        return simd{ _mm512_fnmadd_ps(a._d, b._d, c._d) };
+    }
+
+    static simd horizontal_add(const simd& a, const simd& b) noexcept
+    {
+        const __m512 even = _mm512_shuffle_ps(a._d, b._d, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m512 odd = _mm512_shuffle_ps(a._d, b._d, _MM_SHUFFLE(3, 1, 3, 1));
+        return simd{ _mm512_add_ps(even, odd) };
+    }
+
+    template <unsigned short l0, unsigned short l1, unsigned short h0, unsigned short h1>
+    static simd shuffle(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm512_shuffle_ps(a._d, b._d, _MM_SHUFFLE(h1, h0, l1, l0)) };
+    }
+    static simd unpack_low(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm512_unpacklo_ps(a._d, b._d) };
+    }
+    static simd unpack_high(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm512_unpackhi_ps(a._d, b._d) };
+    }
+
+private:
+    __m512 _d;
+};
+
+using simdf16 = simd<float, 16>;
+
+SIMD_NAMESPACE_END
@@ -1,11 +1,176 @@
 #pragma once
 
+#include "../float16.hpp"
 #include "../simd_base.hpp"
+#include "permute_sse.hpp"
+
+#include <immintrin.h>
+
+SIMD_NAMESPACE_BEGIN
+
+namespace priv {
+/**
+    Widens the 4 float16 values in the low 64 bits.
+*/
+inline __m128 half_to_float(__m128i half) noexcept
+{
+#if defined(__F16C__)
+    return _mm_cvtph_ps(half);
+#else
+    const __m128i h = _mm_unpacklo_epi16(half, _mm_setzero_si128());
+    const __m128i sign = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16);
+    const __m128i em = _mm_and_si128(h, _mm_set1_epi32(0x7fff));
+    const __m128i shifted = _mm_slli_epi32(em, 13);
+    // subnormals are converted as integers so the result does not depend on denormals-are-zero
+    const __m128i normal = _mm_add_epi32(shifted, _mm_set1_epi32(0x38000000));
+    const __m128i subnormal = _mm_castps_si128(_mm_mul_ps(_mm_cvtepi32_ps(em), _mm_set1_ps(1.0f / 16777216.0f)));
+    const __m128i quiet = _mm_and_si128(_mm_cmpgt_epi32(em, _mm_set1_epi32(0x7c00)), _mm_set1_epi32(0x400000));
+    const __m128i special = _mm_or_si128(_mm_or_si128(shifted, _mm_set1_epi32(0x7f800000)), quiet);
+    const __m128i is_subnormal = _mm_cmplt_epi32(em, _mm_set1_epi32(0x400));
+    const __m128i is_special = _mm_cmpgt_epi32(em, _mm_set1_epi32(0x7bff));
+    __m128i result = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal), _mm_andnot_si128(is_subnormal, normal));
+    result = _mm_or_si128(_mm_and_si128(is_special, special), _mm_andnot_si128(is_special, result));
+    return _mm_castsi128_ps(_mm_or_si128(result, sign));
+#endif
+}
+/**
+    Rounds to float16 (nearest even), the result is in the low 64 bits.
+*/
+inline __m128i float_to_half(__m128 value) noexcept
+{
+#if defined(__F16C__)
+    return _mm_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT);
+#else
+    // same steps as float16::from_float, evaluated for all three ranges and then selected
+    const __m128i all = _mm_castps_si128(value);
+    const __m128i sign = _mm_and_si128(all, _mm_set1_epi32(static_cast<int>(0x80000000u)));
+    const __m128i f = _mm_xor_si128(all, sign);
+    const __m128i odd = _mm_and_si128(_mm_srli_epi32(f, 13), _mm_set1_epi32(1));
+    const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(f, _mm_set1_epi32(static_cast<int>(0xc8000fffu))), odd), 13);
+    const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(f), _mm_set1_ps(0.5f))), _mm_set1_epi32(0x3f000000));
+    const __m128i is_nan = _mm_cmpgt_epi32(f, _mm_set1_epi32(0x7f800000));
+    const __m128i payload = _mm_or_si128(_mm_set1_epi32(0x200), _mm_and_si128(_mm_srli_epi32(f, 13), _mm_set1_epi32(0x3ff)));
+    const __m128i special = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(is_nan, payload));
+    const __m128i is_subnormal = _mm_cmplt_epi32(f, _mm_set1_epi32(0x38800000));
+    const __m128i is_special = _mm_cmpgt_epi32(f, _mm_set1_epi32(0x477fffff));
+    __m128i result = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal), _mm_andnot_si128(is_subnormal, normal));
+    result = _mm_or_si128(_mm_and_si128(is_special, special), _mm_andnot_si128(is_special, result));
+    result = _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+    // sign extend so that the signed saturating pack keeps all 16 bits
+    result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+    return _mm_packs_epi32(result, result);
+#endif
+}
+/**
+    Rounds to bfloat16 (nearest even, NaNs are quieted), the result is in the low 64 bits.
+*/
+inline __m128i float_to_bfloat16(__m128 value) noexcept
+{
+    const __m128i f = _mm_castps_si128(value);
+    const __m128i odd = _mm_and_si128(_mm_srli_epi32(f, 16), _mm_set1_epi32(1));
+    const __m128i rounded = _mm_add_epi32(f, _mm_add_epi32(_mm_set1_epi32(0x7fff), odd));
+    const __m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(value, value));
+    const __m128i quiet = _mm_or_si128(f, _mm_set1_epi32(0x400000));
+    const __m128i result = _mm_or_si128(_mm_and_si128(is_nan, quiet), _mm_andnot_si128(is_nan, rounded));
+    // the arithmetic shift sign extends, so the signed saturating pack keeps all 16 bits
+    const __m128i high = _mm_srai_epi32(result, 16);
+    return _mm_packs_epi32(high, high);
+}
+} // namespace priv
+
+/**
+    Result of a simdf4 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<float, 4> {
+public:
+    static constexpr size_t value_count = 4;
+
+    simd_mask() noexcept
+        : _m(_mm_setzero_ps())
+    {
+    }
+    simd_mask(bool s0, bool s1, bool s2, bool s3) noexcept
+        : _m(_mm_castsi128_ps(_mm_setr_epi32(s0 ? -1 : 0, s1 ? -1 : 0, s2 ? -1 : 0, s3 ? -1 : 0)))
+    {
+    }
+    explicit simd_mask(__m128 value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+        const __m128i selected = _mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), lanes);
+        return simd_mask{ _mm_castsi128_ps(_mm_cmpeq_epi32(selected, lanes)) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        const __m128i limit = _mm_set1_epi32(static_cast<int>(count < 4 ? count : 4));
+        return simd_mask{ _mm_castsi128_ps(_mm_cmplt_epi32(_mm_setr_epi32(0, 1, 2, 3), limit)) };
+    }
+
+    __m128 native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return static_cast<uint32_t>(_mm_movemask_ps(this->_m));
+    }
+    bool any() const noexcept
+    {
+        return this->movemask() != 0;
+    }
+    bool all() const noexcept
+    {
+        return this->movemask() == 0xf;
+    }
+    bool none() const noexcept
+    {
+        return this->movemask() == 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_and_ps(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_or_ps(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_xor_ps(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ _mm_xor_ps(this->_m, _mm_castsi128_ps(_mm_set1_epi32(-1))) };
+    }
+
+private:
+    __m128 _m;
+};
 
 template <>
 class simd<float, 4> : public simd_common<simd<float, 4>> {
 public:
     using type = float;
+    using mask_type = simd_mask<float, 4>;
     static constexpr size_t value_count = 4;
 
     simd() noexcept
@@ -25,18 +190,60 @@ public:
     {
     }
     explicit simd(const float* input) noexcept
-        : _d(is_aligned(input, 16) ? _mm_load_ps(input) : _mm_loadu_ps(input))
+        : _d(_mm_loadu_ps(input))
+    {
+    }
+    /**
+        Loads 4 float16 values (8 bytes) and widens them.
+    */
+    explicit simd(const float16* input) noexcept
+        : _d(priv::half_to_float(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input))))
+    {
+    }
+    /**
+        Loads 4 bfloat16 values (8 bytes) and widens them.
+    */
+    explicit simd(const bfloat16* input) noexcept
+        : _d(_mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input)))))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const float* input, size_t count) noexcept
+    {
+        switch (count) {
+        case 0:
+            return simd{};
+        case 1:
+            return simd{ _mm_load_ss(input) };
+        case 2:
+            return simd{ _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(input))) };
+        case 3:
+            return simd{ _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(input))), _mm_load_ss(input + 2)) };
+        default:
+            return simd{ _mm_loadu_ps(input) };
+        }
+    }
+
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const float* input) noexcept
+    {
+        return simd{ _mm_load_ps(input) };
+    }
+
+    __m128 native() const noexcept
     {
+        return this->_d;
     }
 
     void store(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
     {
         if (cache_flags == cache_coherence::coherent) {
-            if (is_aligned(output, 16)) {
-                _mm_store_ps(output, this->_d);
-            } else {
-                _mm_storeu_ps(output, this->_d);
-            }
+            _mm_storeu_ps(output, this->_d);
         } else if (cache_flags == cache_coherence::non_temporal) {
             //TODO: assert aligned
             _mm_stream_ps(output, this->_d);
@@ -46,12 +253,51 @@ public:
     void store_aligned(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
     {
         if (cache_flags == cache_coherence::coherent) {
-            _mm_storeu_ps(output, this->_d);
+            _mm_store_ps(output, this->_d);
         } else if (cache_flags == cache_coherence::non_temporal) {
             _mm_stream_ps(output, this->_d);
         }
     }
 
+    /**
+        Rounds the lanes to float16 and stores them (8 bytes).
+    */
+    void store(float16* output) const noexcept
+    {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output), priv::float_to_half(this->_d));
+    }
+    /**
+        Rounds the lanes to bfloat16 and stores them (8 bytes).
+    */
+    void store(bfloat16* output) const noexcept
+    {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(output), priv::float_to_bfloat16(this->_d));
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(float* output, size_t count) const noexcept
+    {
+        switch (count) {
+        case 0:
+            break;
+        case 1:
+            _mm_store_ss(output, this->_d);
+            break;
+        case 2:
+            _mm_store_sd(reinterpret_cast<double*>(output), _mm_castps_pd(this->_d));
+            break;
+        case 3:
+            _mm_store_sd(reinterpret_cast<double*>(output), _mm_castps_pd(this->_d));
+            _mm_store_ss(output + 2, _mm_movehl_ps(this->_d, this->_d));
+            break;
+        default:
+            _mm_storeu_ps(output, this->_d);
+            break;
+        }
+    }
+
     simd operator+(const simd& other) const noexcept
     {
         return simd{ _mm_add_ps(this->_d, other._d) };
@@ -97,35 +343,215 @@ public:
     {
         return simd{ _mm_sqrt_ps(this->_d) };
     }
+    /**
+        Approximate 1 / x, see simd_base::precision.
+    */
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        if (P == exact)
+            return simd{ _mm_div_ps(_mm_set1_ps(1.0f), this->_d) };
+        auto x = _mm_rcp_ps(this->_d);
+        // x' = x * (2 - d * x)
+        if (P >= newton_1)
+            x = _mm_mul_ps(x, _mm_sub_ps(_mm_set1_ps(2.0f), _mm_mul_ps(this->_d, x)));
+        if (P >= newton_2)
+            x = _mm_mul_ps(x, _mm_sub_ps(_mm_set1_ps(2.0f), _mm_mul_ps(this->_d, x)));
+        return simd{ x };
+    }
+    /**
+        Approximate 1 / sqrt(x), see simd_base::precision.
+    */
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        if (P == exact)
+            return simd{ _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(this->_d)) };
+        auto y = _mm_rsqrt_ps(this->_d);
+        // y' = y * (1.5 - 0.5 * d * y * y)
+        const auto half_d = _mm_mul_ps(_mm_set1_ps(0.5f), this->_d);
+        if (P >= newton_1)
+            y = _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half_d, _mm_mul_ps(y, y))));
+        if (P >= newton_2)
+            y = _mm_mul_ps(y, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(half_d, _mm_mul_ps(y, y))));
+        return simd{ y };
+    }
     simd abs() const noexcept
     {
         const auto mask = _mm_set1_ps(-1 * 0.0f);
         return simd{ _mm_andnot_ps(mask, this->_d) };
     }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_round_ps(this->_d, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) };
+#else
+        // adding and subtracting 2^23 drops the fraction bits, larger values are integral already
+        const __m128 magic = _mm_set1_ps(8388608.0f);
+        const __m128 sign = _mm_and_ps(this->_d, _mm_set1_ps(-0.0f));
+        const __m128 magnitude = _mm_andnot_ps(_mm_set1_ps(-0.0f), this->_d);
+        const __m128 rounded = _mm_or_ps(_mm_sub_ps(_mm_add_ps(magnitude, magic), magic), sign);
+        const __m128 small = _mm_cmplt_ps(magnitude, magic);
+        return simd{ _mm_or_ps(_mm_and_ps(small, rounded), _mm_andnot_ps(small, this->_d)) };
+#endif
+    }
+    simd floor() const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_floor_ps(this->_d) };
+#else
+        const __m128 rounded = this->round()._d;
+        return simd{ _mm_sub_ps(rounded, _mm_and_ps(_mm_cmpgt_ps(rounded, this->_d), _mm_set1_ps(1.0f))) };
+#endif
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-126, 127].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+        const __m128i biased = _mm_add_epi32(_mm_cvtps_epi32(exponent._d), _mm_set1_epi32(127));
+        return simd{ _mm_mul_ps(this->_d, _mm_castsi128_ps(_mm_slli_epi32(biased, 23))) };
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+        const __m128i bits = _mm_castps_si128(this->_d);
+        exponent._d = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+        const __m128i mantissa = _mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f000000));
+        return simd{ _mm_castsi128_ps(mantissa) };
+    }
 
-    simd compare(const simd& other, compare_flags flag) const noexcept
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ _mm_and_ps(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ _mm_or_ps(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ _mm_xor_ps(this->_d, other._d) };
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ priv::permute_ps<idx...>(this->_d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
     {
         switch (flag) {
         case compare_flags::equal:
-            return simd{ _mm_cmpeq_ps(this->_d, other._d) };
+            return mask_type{ _mm_cmpeq_ps(this->_d, other._d) };
         case compare_flags::lower:
-            return simd{ _mm_cmplt_ps(this->_d, other._d) };
+            return mask_type{ _mm_cmplt_ps(this->_d, other._d) };
         case compare_flags::lower_equal:
-            return simd{ _mm_cmple_ps(this->_d, other._d) };
+            return mask_type{ _mm_cmple_ps(this->_d, other._d) };
         case compare_flags::greater:
-            return simd{ _mm_cmpgt_ps(this->_d, other._d) };
+            return mask_type{ _mm_cmpgt_ps(this->_d, other._d) };
         case compare_flags::greater_equal:
-            return simd{ _mm_cmpge_ps(this->_d, other._d) };
+            return mask_type{ _mm_cmpge_ps(this->_d, other._d) };
         case compare_flags::not_equal:
-            return simd{ _mm_cmpneq_ps(this->_d, other._d) };
+            return mask_type{ _mm_cmpneq_ps(this->_d, other._d) };
         }
-        return simd{};
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_blendv_ps(b._d, a._d, mask.native()) };
+#else
+        return simd{ _mm_or_ps(_mm_and_ps(mask.native(), a._d), _mm_andnot_ps(mask.native(), b._d)) };
+#endif
+    }
+
+    /**
+        a * b + c, rounded once when compiled with FMA support (e.g. -mfma or -march=haswell),
+        otherwise a multiplication followed by an addition.
+    */
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm_fmadd_ps(a._d, b._d, c._d) };
+#else
+        return a * b + c;
+#endif
+    }
+    /**
+        a * b - c
+    */
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm_fmsub_ps(a._d, b._d, c._d) };
+#else
+        return a * b - c;
+#endif
+    }
+    /**
+        c - a * b
+    */
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm_fnmadd_ps(a._d, b._d, c._d) };
+#else
+        return c - a * b;
+#endif
     }
 
     static simd horizontal_add(const simd& a, const simd& b) noexcept
     {
-        //SSE3
+#if defined(__SSE3__) || defined(__AVX__)
         return simd{ _mm_hadd_ps(a._d, b._d) };
+#else
+        const __m128 even = _mm_shuffle_ps(a._d, b._d, _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 odd = _mm_shuffle_ps(a._d, b._d, _MM_SHUFFLE(3, 1, 3, 1));
+        return simd{ _mm_add_ps(even, odd) };
+#endif
+    }
+
+    /**
+        Sum of all lanes, added as (x0 + x2) + (x1 + x3). Cheaper than calling horizontal_add
+        twice, haddps is three uops on most cores.
+    */
+    float reduce_add() const noexcept
+    {
+        return fold_lanes([](__m128 a, __m128 b) { return _mm_add_ps(a, b); });
+    }
+    /**
+        Minimum and maximum of all lanes.
+    */
+    float reduce_min() const noexcept
+    {
+        return fold_lanes([](__m128 a, __m128 b) { return _mm_min_ps(a, b); });
+    }
+    float reduce_max() const noexcept
+    {
+        return fold_lanes([](__m128 a, __m128 b) { return _mm_max_ps(a, b); });
+    }
+    /**
+        Sum of the lane-wise products. A multiplication and the shuffle tree of reduce_add have a
+        shorter latency than dpps, which is not faster in throughput either.
+    */
+    static float dot(const simd& a, const simd& b) noexcept
+    {
+        return (a * b).reduce_add();
     }
 
     template <unsigned short l0, unsigned short l1, unsigned short h0, unsigned short h1>
@@ -147,7 +573,24 @@ public:
     }
 
 private:
+    /**
+        Combines the upper half with the lower one, then lane 1 with lane 0.
+    */
+    template <typename Op>
+    float fold_lanes(Op op) const noexcept
+    {
+        const __m128 pairs = op(this->_d, _mm_movehl_ps(this->_d, this->_d));
+#if defined(__SSE3__) || defined(__AVX__)
+        const __m128 odd = _mm_movehdup_ps(pairs);
+#else
+        const __m128 odd = _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1));
+#endif
+        return _mm_cvtss_f32(op(pairs, odd));
+    }
+
     __m128 _d;
 };
 
 using simdf4 = simd<float, 4>;
+
+SIMD_NAMESPACE_END
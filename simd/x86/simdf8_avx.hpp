@@ -0,0 +1,447 @@
+#pragma once
+
+#include "simdf4_sse.hpp"
+
+#include <immintrin.h>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdf8 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<float, 8> {
+public:
+    static constexpr size_t value_count = 8;
+
+    simd_mask() noexcept
+        : _m(_mm256_setzero_ps())
+    {
+    }
+    simd_mask(const simd_mask<float, 4>& low, const simd_mask<float, 4>& high) noexcept
+        : _m(_mm256_insertf128_ps(_mm256_castps128_ps256(low.native()), high.native(), 1))
+    {
+    }
+    explicit simd_mask(__m256 value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        return simd_mask{ simd_mask<float, 4>::from_bits(bits), simd_mask<float, 4>::from_bits(bits >> 4) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        const __m256 index = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256 limit = _mm256_set1_ps(static_cast<float>(count < 8 ? count : 8));
+        return simd_mask{ _mm256_cmp_ps(index, limit, _CMP_LT_OQ) };
+    }
+
+    __m256 native() const noexcept
+    {
+        return this->_m;
+    }
+    simd_mask<float, 4> low() const noexcept
+    {
+        return simd_mask<float, 4>{ _mm256_castps256_ps128(this->_m) };
+    }
+    simd_mask<float, 4> high() const noexcept
+    {
+        return simd_mask<float, 4>{ _mm256_extractf128_ps(this->_m, 1) };
+    }
+    uint32_t movemask() const noexcept
+    {
+        return static_cast<uint32_t>(_mm256_movemask_ps(this->_m));
+    }
+    bool any() const noexcept
+    {
+        return _mm256_testz_ps(this->_m, this->_m) == 0;
+    }
+    bool all() const noexcept
+    {
+        return this->movemask() == 0xff;
+    }
+    bool none() const noexcept
+    {
+        return _mm256_testz_ps(this->_m, this->_m) != 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm256_and_ps(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm256_or_ps(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm256_xor_ps(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ _mm256_xor_ps(this->_m, _mm256_castsi256_ps(_mm256_set1_epi32(-1))) };
+    }
+
+private:
+    __m256 _m;
+};
+
+/**
+    8 x float backed by a single AVX register. Shuffles, unpacks and horizontal adds
+    operate on each 128 bit half independently, the same way the AVX instructions do.
+*/
+template <>
+class simd<float, 8> : public simd_common<simd<float, 8>> {
+public:
+    using type = float;
+    using mask_type = simd_mask<float, 8>;
+    static constexpr size_t value_count = 8;
+
+    simd() noexcept
+        : _d(_mm256_setzero_ps())
+    {
+    }
+    explicit simd(float value) noexcept
+        : _d(_mm256_set1_ps(value))
+    {
+    }
+    simd(float s0, float s1, float s2, float s3, float s4, float s5, float s6, float s7) noexcept
+        : _d(_mm256_setr_ps(s0, s1, s2, s3, s4, s5, s6, s7))
+    {
+    }
+    simd(const simd<float, 4>& low, const simd<float, 4>& high) noexcept
+        : _d(_mm256_insertf128_ps(_mm256_castps128_ps256(low.native()), high.native(), 1))
+    {
+    }
+    explicit simd(__m256 value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const float* input) noexcept
+        : _d(_mm256_loadu_ps(input))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const float* input, size_t count) noexcept
+    {
+        return simd{ _mm256_maskload_ps(input, _mm256_castps_si256(mask_type::first(count).native())) };
+    }
+
+    /**
+        Loads from memory aligned to 32 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const float* input) noexcept
+    {
+        return simd{ _mm256_load_ps(input) };
+    }
+
+    __m256 native() const noexcept
+    {
+        return this->_d;
+    }
+    simd<float, 4> low() const noexcept
+    {
+        return simd<float, 4>{ _mm256_castps256_ps128(this->_d) };
+    }
+    simd<float, 4> high() const noexcept
+    {
+        return simd<float, 4>{ _mm256_extractf128_ps(this->_d, 1) };
+    }
+
+    void store(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        if (cache_flags == cache_coherence::coherent) {
+            _mm256_storeu_ps(output, this->_d);
+        } else if (cache_flags == cache_coherence::non_temporal) {
+            _mm256_stream_ps(output, this->_d);
+        }
+    }
+
+    void store_aligned(float* output, cache_coherence cache_flags = cache_coherence::coherent) const noexcept
+    {
+        if (cache_flags == cache_coherence::coherent) {
+            _mm256_store_ps(output, this->_d);
+        } else if (cache_flags == cache_coherence::non_temporal) {
+            _mm256_stream_ps(output, this->_d);
+        }
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(float* output, size_t count) const noexcept
+    {
+        _mm256_maskstore_ps(output, _mm256_castps_si256(mask_type::first(count).native()), this->_d);
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ _mm256_add_ps(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        return *this = *this + other;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ _mm256_sub_ps(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        return *this = *this - other;
+    }
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ _mm256_mul_ps(this->_d, other._d) };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    simd operator/(const simd& other) const noexcept
+    {
+        return simd{ _mm256_div_ps(this->_d, other._d) };
+    }
+    simd& operator/=(const simd& other) noexcept
+    {
+        return *this = *this / other;
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ _mm256_min_ps(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ _mm256_max_ps(this->_d, other._d) };
+    }
+    simd sqrt() const noexcept
+    {
+        return simd{ _mm256_sqrt_ps(this->_d) };
+    }
+    /**
+        Approximate 1 / x, see simd_base::precision.
+    */
+    template <precision P = exact>
+    simd rcp() const noexcept
+    {
+        if (P == exact)
+            return simd{ _mm256_div_ps(_mm256_set1_ps(1.0f), this->_d) };
+        auto x = _mm256_rcp_ps(this->_d);
+        // x' = x * (2 - d * x)
+        if (P >= newton_1)
+            x = _mm256_mul_ps(x, _mm256_sub_ps(_mm256_set1_ps(2.0f), _mm256_mul_ps(this->_d, x)));
+        if (P >= newton_2)
+            x = _mm256_mul_ps(x, _mm256_sub_ps(_mm256_set1_ps(2.0f), _mm256_mul_ps(this->_d, x)));
+        return simd{ x };
+    }
+    /**
+        Approximate 1 / sqrt(x), see simd_base::precision.
+    */
+    template <precision P = exact>
+    simd rsqrt() const noexcept
+    {
+        if (P == exact)
+            return simd{ _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(this->_d)) };
+        auto y = _mm256_rsqrt_ps(this->_d);
+        // y' = y * (1.5 - 0.5 * d * y * y)
+        const auto half_d = _mm256_mul_ps(_mm256_set1_ps(0.5f), this->_d);
+        if (P >= newton_1)
+            y = _mm256_mul_ps(y, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(half_d, _mm256_mul_ps(y, y))));
+        if (P >= newton_2)
+            y = _mm256_mul_ps(y, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(half_d, _mm256_mul_ps(y, y))));
+        return simd{ y };
+    }
+    simd abs() const noexcept
+    {
+        const auto mask = _mm256_set1_ps(-1 * 0.0f);
+        return simd{ _mm256_andnot_ps(mask, this->_d) };
+    }
+    /**
+        Rounds to the nearest integer, ties to even.
+    */
+    simd round() const noexcept
+    {
+        return simd{ _mm256_round_ps(this->_d, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC) };
+    }
+    simd floor() const noexcept
+    {
+        return simd{ _mm256_floor_ps(this->_d) };
+    }
+    /**
+        Multiplies by 2^exponent. The exponent lanes have to be integral values in range [-126, 127].
+    */
+    simd ldexp(const simd& exponent) const noexcept
+    {
+#if defined(__AVX2__)
+        const __m256i biased = _mm256_add_epi32(_mm256_cvtps_epi32(exponent._d), _mm256_set1_epi32(127));
+        return simd{ _mm256_mul_ps(this->_d, _mm256_castsi256_ps(_mm256_slli_epi32(biased, 23))) };
+#else
+        return simd{ this->low().ldexp(exponent.low()), this->high().ldexp(exponent.high()) };
+#endif
+    }
+    /**
+        Splits positive normal values into mantissa in range [0.5, 1) (returned) and exponent.
+    */
+    simd frexp(simd& exponent) const noexcept
+    {
+#if defined(__AVX2__)
+        const __m256i bits = _mm256_castps_si256(this->_d);
+        exponent._d = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+        const __m256i mantissa = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)), _mm256_set1_epi32(0x3f000000));
+        return simd{ _mm256_castsi256_ps(mantissa) };
+#else
+        simd<float, 4> exp_lo, exp_hi;
+        const simd result{ this->low().frexp(exp_lo), this->high().frexp(exp_hi) };
+        exponent = simd{ exp_lo, exp_hi };
+        return result;
+#endif
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ _mm256_and_ps(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ _mm256_or_ps(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ _mm256_xor_ps(this->_d, other._d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ _mm256_cmp_ps(this->_d, other._d, _CMP_EQ_OQ) };
+        case compare_flags::lower:
+            return mask_type{ _mm256_cmp_ps(this->_d, other._d, _CMP_LT_OS) };
+        case compare_flags::lower_equal:
+            return mask_type{ _mm256_cmp_ps(this->_d, other._d, _CMP_LE_OS) };
+        case compare_flags::greater:
+            return mask_type{ _mm256_cmp_ps(this->_d, other._d, _CMP_GT_OS) };
+        case compare_flags::greater_equal:
+            return mask_type{ _mm256_cmp_ps(this->_d, other._d, _CMP_GE_OS) };
+        case compare_flags::not_equal:
+            return mask_type{ _mm256_cmp_ps(this->_d, other._d, _CMP_NEQ_UQ) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm256_blendv_ps(b._d, a._d, mask.native()) };
+    }
+
+    /**
+        a * b + c, rounded once when compiled with FMA support (e.g. -mfma or -march=haswell),
+        otherwise a multiplication followed by an addition.
+    */
+    static simd fma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm256_fmadd_ps(a._d, b._d, c._d) };
+#else
+        return a * b + c;
+#endif
+    }
+    /**
+        a * b - c
+    */
+    static simd fms(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm256_fmsub_ps(a._d, b._d, c._d) };
+#else
+        return a * b - c;
+#endif
+    }
+    /**
+        c - a * b
+    */
+    static simd fnma(const simd& a, const simd& b, const simd& c) noexcept
+    {
+#if defined(__FMA__)
+        return simd{ _mm256_fnmadd_ps(a._d, b._d, c._d) };
+#else
+        return c - a * b;
+#endif
+    }
+
+    static simd horizontal_add(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm256_hadd_ps(a._d, b._d) };
+    }
+
+    template <unsigned short l0, unsigned short l1, unsigned short h0, unsigned short h1>
+    static simd shuffle(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm256_shuffle_ps(a._d, b._d, _MM_SHUFFLE(h1, h0, l1, l0)) };
+    }
+    static simd unpack_low(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm256_unpacklo_ps(a._d, b._d) };
+    }
+    static simd unpack_high(const simd& a, const simd& b) noexcept
+    {
+        return simd{ _mm256_unpackhi_ps(a._d, b._d) };
+    }
+    static void transpose(simd& r0, simd& r1, simd& r2, simd& r3,
+        simd& r4, simd& r5, simd& r6, simd& r7) noexcept
+    {
+        const __m256 t0 = _mm256_unpacklo_ps(r0._d, r1._d);
+        const __m256 t1 = _mm256_unpackhi_ps(r0._d, r1._d);
+        const __m256 t2 = _mm256_unpacklo_ps(r2._d, r3._d);
+        const __m256 t3 = _mm256_unpackhi_ps(r2._d, r3._d);
+        const __m256 t4 = _mm256_unpacklo_ps(r4._d, r5._d);
+        const __m256 t5 = _mm256_unpackhi_ps(r4._d, r5._d);
+        const __m256 t6 = _mm256_unpacklo_ps(r6._d, r7._d);
+        const __m256 t7 = _mm256_unpackhi_ps(r6._d, r7._d);
+        const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+        r0._d = _mm256_permute2f128_ps(s0, s4, 0x20);
+        r1._d = _mm256_permute2f128_ps(s1, s5, 0x20);
+        r2._d = _mm256_permute2f128_ps(s2, s6, 0x20);
+        r3._d = _mm256_permute2f128_ps(s3, s7, 0x20);
+        r4._d = _mm256_permute2f128_ps(s0, s4, 0x31);
+        r5._d = _mm256_permute2f128_ps(s1, s5, 0x31);
+        r6._d = _mm256_permute2f128_ps(s2, s6, 0x31);
+        r7._d = _mm256_permute2f128_ps(s3, s7, 0x31);
+    }
+
+private:
+    __m256 _d;
+};
+
+using simdf8 = simd<float, 8>;
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,425 @@
+#pragma once
+
+#include "../simd_base.hpp"
+#include "permute_sse.hpp"
+#include "reduce_sse.hpp"
+
+#include <immintrin.h>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdi16x8 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<int16_t, 8> {
+public:
+    static constexpr size_t value_count = 8;
+
+    simd_mask() noexcept
+        : _m(_mm_setzero_si128())
+    {
+    }
+    simd_mask(bool s0, bool s1, bool s2, bool s3,
+        bool s4, bool s5, bool s6, bool s7) noexcept
+        : _m(_mm_setr_epi16(s0 ? -1 : 0, s1 ? -1 : 0, s2 ? -1 : 0, s3 ? -1 : 0,
+            s4 ? -1 : 0, s5 ? -1 : 0, s6 ? -1 : 0, s7 ? -1 : 0))
+    {
+    }
+    explicit simd_mask(__m128i value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        const __m128i lanes = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+        const __m128i selected = _mm_and_si128(_mm_set1_epi16(static_cast<short>(bits)), lanes);
+        return simd_mask{ _mm_cmpeq_epi16(selected, lanes) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        const __m128i limit = _mm_set1_epi16(static_cast<short>(count < 8 ? count : 8));
+        return simd_mask{ _mm_cmplt_epi16(_mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7), limit) };
+    }
+
+    __m128i native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(this->_m, _mm_setzero_si128())));
+    }
+    bool any() const noexcept
+    {
+        return this->movemask() != 0;
+    }
+    bool all() const noexcept
+    {
+        return this->movemask() == 0xff;
+    }
+    bool none() const noexcept
+    {
+        return this->movemask() == 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_and_si128(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_or_si128(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_xor_si128(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ _mm_xor_si128(this->_m, _mm_set1_epi32(-1)) };
+    }
+
+private:
+    __m128i _m;
+};
+
+/**
+    Lanes of 16 bit signed integers. operator+, operator- and operator* wrap around, add_saturate and
+    subtract_saturate clamp to the range of the lane type.
+*/
+template <>
+class simd<int16_t, 8> : public simd_common<simd<int16_t, 8>> {
+public:
+    using type = int16_t;
+    using mask_type = simd_mask<int16_t, 8>;
+    static constexpr size_t value_count = 8;
+
+    simd() noexcept
+        : _d(_mm_setzero_si128())
+    {
+    }
+    explicit simd(int16_t value) noexcept
+        : _d(_mm_set1_epi16(value))
+    {
+    }
+    simd(int16_t s0, int16_t s1, int16_t s2, int16_t s3,
+        int16_t s4, int16_t s5, int16_t s6, int16_t s7) noexcept
+        : _d(_mm_setr_epi16(s0, s1, s2, s3,
+            s4, s5, s6, s7))
+    {
+    }
+    explicit simd(__m128i value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const int16_t* input) noexcept
+        : _d(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input)))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const int16_t* input, size_t count) noexcept
+    {
+        if (count >= 8)
+            return simd{ input };
+        alignas(16) int16_t buffer[8] = {};
+        std::memcpy(buffer, input, count * sizeof(int16_t));
+        return load_aligned(buffer);
+    }
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const int16_t* input) noexcept
+    {
+        return simd{ _mm_load_si128(reinterpret_cast<const __m128i*>(input)) };
+    }
+
+    __m128i native() const noexcept
+    {
+        return this->_d;
+    }
+
+    void store(int16_t* output) const noexcept
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), this->_d);
+    }
+
+    void store_aligned(int16_t* output) const noexcept
+    {
+        _mm_store_si128(reinterpret_cast<__m128i*>(output), this->_d);
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(int16_t* output, size_t count) const noexcept
+    {
+        if (count >= 8) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), this->_d);
+            return;
+        }
+        alignas(16) int16_t buffer[8];
+        this->store_aligned(buffer);
+        std::memcpy(output, buffer, count * sizeof(int16_t));
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ _mm_add_epi16(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        this->_d = _mm_add_epi16(this->_d, other._d);
+        return *this;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ _mm_sub_epi16(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        this->_d = _mm_sub_epi16(this->_d, other._d);
+        return *this;
+    }
+    /**
+        a + b clamped to the range of int16_t.
+    */
+    simd add_saturate(const simd& other) const noexcept
+    {
+        return simd{ _mm_adds_epi16(this->_d, other._d) };
+    }
+    /**
+        a - b clamped to the range of int16_t.
+    */
+    simd subtract_saturate(const simd& other) const noexcept
+    {
+        return simd{ _mm_subs_epi16(this->_d, other._d) };
+    }
+    /**
+        Low half of the product, i.e. the wrapping a * b.
+    */
+    simd operator*(const simd& other) const noexcept
+    {
+        return simd{ _mm_mullo_epi16(this->_d, other._d) };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    /**
+        High half of the 32 bit product.
+    */
+    simd mulhi(const simd& other) const noexcept
+    {
+        return simd{ _mm_mulhi_epi16(this->_d, other._d) };
+    }
+
+    template <int count>
+    simd shift_left() const noexcept
+    {
+        static_assert(count >= 0 && count < 16, "shift count out of range");
+        return simd{ _mm_slli_epi16(this->_d, count) };
+    }
+    /**
+        Arithmetic right shift.
+    */
+    template <int count>
+    simd shift_right() const noexcept
+    {
+        static_assert(count >= 0 && count < 16, "shift count out of range");
+        return simd{ _mm_srai_epi16(this->_d, count) };
+    }
+    /**
+        Shifts each lane left by the corresponding lane of counts, which have to be in [0, 16).
+    */
+    simd shift_left(const simd& counts) const noexcept
+    {
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+        return simd{ _mm_sllv_epi16(this->_d, counts._d) };
+#else
+        const auto values = this->to_array();
+        const auto shifts = counts.to_array();
+        alignas(16) std::array<int16_t, 8> result;
+        for (size_t i = 0; i < 8; ++i)
+            result[i] = static_cast<int16_t>(static_cast<uint16_t>(values[i]) << shifts[i]);
+        return load_aligned(result.data());
+#endif
+    }
+    /**
+        Arithmetic right shift of each lane by the corresponding lane of counts, which have to be in [0, 16).
+    */
+    simd shift_right(const simd& counts) const noexcept
+    {
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+        return simd{ _mm_srav_epi16(this->_d, counts._d) };
+#else
+        const auto values = this->to_array();
+        const auto shifts = counts.to_array();
+        alignas(16) std::array<int16_t, 8> result;
+        for (size_t i = 0; i < 8; ++i)
+            result[i] = static_cast<int16_t>(values[i] >> shifts[i]);
+        return load_aligned(result.data());
+#endif
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ _mm_and_si128(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ _mm_or_si128(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ _mm_xor_si128(this->_d, other._d) };
+    }
+    simd operator~() const noexcept
+    {
+        return simd{ _mm_xor_si128(this->_d, _mm_set1_epi32(-1)) };
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ _mm_min_epi16(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ _mm_max_epi16(this->_d, other._d) };
+    }
+    /**
+        |x|, the lowest value of int16_t stays unchanged.
+    */
+    simd abs() const noexcept
+    {
+#if defined(__SSSE3__) || defined(__AVX__)
+        return simd{ _mm_abs_epi16(this->_d) };
+#else
+        const __m128i sign = _mm_srai_epi16(this->_d, 15);
+        return simd{ _mm_sub_epi16(_mm_xor_si128(this->_d, sign), sign) };
+#endif
+    }
+    /**
+        (a + b + 1) / 2 rounded down, without intermediate overflow.
+    */
+    simd avg(const simd& other) const noexcept
+    {
+        // unsigned average of the values offset by 2^15
+        const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        return simd{ _mm_xor_si128(_mm_avg_epu16(_mm_xor_si128(this->_d, bias), _mm_xor_si128(other._d, bias)), bias) };
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ priv::permute_epi16<idx...>(this->_d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        const __m128i a = this->_d;
+        const __m128i b = other._d;
+        const __m128i ones = _mm_set1_epi32(-1);
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ _mm_cmpeq_epi16(a, b) };
+        case compare_flags::lower:
+            return mask_type{ _mm_cmpgt_epi16(b, a) };
+        case compare_flags::lower_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpgt_epi16(a, b), ones) };
+        case compare_flags::greater:
+            return mask_type{ _mm_cmpgt_epi16(a, b) };
+        case compare_flags::greater_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpgt_epi16(b, a), ones) };
+        case compare_flags::not_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpeq_epi16(a, b), ones) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_blendv_epi8(b._d, a._d, mask.native()) };
+#else
+        return simd{ _mm_or_si128(_mm_and_si128(mask.native(), a._d), _mm_andnot_si128(mask.native(), b._d)) };
+#endif
+    }
+
+    /**
+        Sum of all lanes, widened so that it cannot overflow.
+    */
+    int32_t sum() const noexcept
+    {
+        return priv::sum_epi32(_mm_madd_epi16(this->_d, _mm_set1_epi16(1)));
+    }
+    /**
+        Minimum, maximum, product (wrapping), AND and OR of all lanes.
+    */
+    int16_t reduce_min() const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        // phminposuw on the lanes moved to the unsigned range
+        const __m128i biased = _mm_xor_si128(this->_d, _mm_set1_epi16(-0x8000));
+        return static_cast<int16_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(biased)) - 0x8000);
+#else
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a.min(b); }));
+#endif
+    }
+    int16_t reduce_max() const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return static_cast<int16_t>(-1 - (~*this).reduce_min());
+#else
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a.max(b); }));
+#endif
+    }
+    int16_t reduce_product() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a * b; }));
+    }
+    int16_t reduce_and() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a & b; }));
+    }
+    int16_t reduce_or() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a | b; }));
+    }
+
+private:
+    static int16_t lane0(const simd& value) noexcept
+    {
+        return static_cast<int16_t>(_mm_cvtsi128_si32(value._d));
+    }
+
+    __m128i _d;
+};
+
+using simdi16x8 = simd<int16_t, 8>;
+
+SIMD_NAMESPACE_END
@@ -1,14 +1,113 @@
 #pragma once
 
 #include "../simd_base.hpp"
+#include "permute_sse.hpp"
+#include "reduce_sse.hpp"
 
 #include <immintrin.h>
 #include <smmintrin.h>
 
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdu16x8 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<uint16_t, 8> {
+public:
+    static constexpr size_t value_count = 8;
+
+    simd_mask() noexcept
+        : _m(_mm_setzero_si128())
+    {
+    }
+    simd_mask(bool s0, bool s1, bool s2, bool s3,
+        bool s4, bool s5, bool s6, bool s7) noexcept
+        : _m(_mm_setr_epi16(s0 ? -1 : 0, s1 ? -1 : 0, s2 ? -1 : 0, s3 ? -1 : 0,
+            s4 ? -1 : 0, s5 ? -1 : 0, s6 ? -1 : 0, s7 ? -1 : 0))
+    {
+    }
+    explicit simd_mask(__m128i value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        const __m128i lanes = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+        const __m128i selected = _mm_and_si128(_mm_set1_epi16(static_cast<short>(bits)), lanes);
+        return simd_mask{ _mm_cmpeq_epi16(selected, lanes) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        const __m128i limit = _mm_set1_epi16(static_cast<short>(count < 8 ? count : 8));
+        return simd_mask{ _mm_cmplt_epi16(_mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7), limit) };
+    }
+
+    __m128i native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(this->_m, _mm_setzero_si128())));
+    }
+    bool any() const noexcept
+    {
+        return this->movemask() != 0;
+    }
+    bool all() const noexcept
+    {
+        return this->movemask() == 0xff;
+    }
+    bool none() const noexcept
+    {
+        return this->movemask() == 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_and_si128(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_or_si128(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_xor_si128(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ _mm_xor_si128(this->_m, _mm_set1_epi32(-1)) };
+    }
+
+private:
+    __m128i _m;
+};
+
+/**
+    Lanes of 16 bit unsigned integers. Unlike the other integer types, operator+ and operator-
+    saturate; add_wrap and subtract_wrap wrap around, operator* wraps.
+*/
 template <>
 class simd<uint16_t, 8> : public simd_common<simd<uint16_t, 8>> {
 public:
     using type = uint16_t;
+    using mask_type = simd_mask<uint16_t, 8>;
     static constexpr size_t value_count = 8;
 
     simd() noexcept
@@ -29,9 +128,41 @@ public:
     {
     }
     explicit simd(const uint16_t* input) noexcept
-        : _d(is_aligned(input, 16) ? _mm_load_si128(reinterpret_cast<const __m128i*>(input))
-                                   : _mm_loadu_si128(reinterpret_cast<const __m128i*>(input)))
+        : _d(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input)))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const uint16_t* input, size_t count) noexcept
     {
+        if (count >= 8)
+            return simd{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(input)) };
+        __m128i result = count >= 4 ? _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input)) : _mm_setzero_si128();
+        switch (count) {
+        case 7:
+            result = _mm_insert_epi16(result, input[6], 6);
+            // fall through
+        case 6:
+            result = _mm_insert_epi16(result, input[5], 5);
+            // fall through
+        case 5:
+            result = _mm_insert_epi16(result, input[4], 4);
+            break;
+        case 3:
+            result = _mm_insert_epi16(result, input[2], 2);
+            // fall through
+        case 2:
+            result = _mm_insert_epi16(result, input[1], 1);
+            // fall through
+        case 1:
+            result = _mm_insert_epi16(result, input[0], 0);
+            break;
+        default:
+            break;
+        }
+        return simd{ result };
     }
     explicit simd(const uint16_t* inputLo, const uint16_t* inputHi) noexcept
         : simd(inputLo[0], inputLo[1], inputLo[2], inputLo[3],
@@ -47,15 +178,22 @@ public:
     {
     }
 
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const uint16_t* input) noexcept
+    {
+        return simd{ _mm_load_si128(reinterpret_cast<const __m128i*>(input)) };
+    }
+
+    __m128i native() const noexcept
+    {
+        return this->_d;
+    }
+
     void store(uint16_t* output) const noexcept
     {
-        if (is_aligned(output, 16)) {
-            this->store_aligned(output);
-        } else {
-            alignas(16) uint16_t tmp[8];
-            this->store_aligned(tmp);
-            memcpy(output, tmp, 8 * sizeof(tmp[0]));
-        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), this->_d);
     }
 
     void store_aligned(uint16_t* output) const noexcept
@@ -63,6 +201,41 @@ public:
         _mm_store_si128(reinterpret_cast<__m128i*>(output), this->_d);
     }
 
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(uint16_t* output, size_t count) const noexcept
+    {
+        if (count >= 8) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), this->_d);
+            return;
+        }
+        if (count >= 4)
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(output), this->_d);
+        switch (count) {
+        case 7:
+            output[6] = static_cast<uint16_t>(_mm_extract_epi16(this->_d, 6));
+            // fall through
+        case 6:
+            output[5] = static_cast<uint16_t>(_mm_extract_epi16(this->_d, 5));
+            // fall through
+        case 5:
+            output[4] = static_cast<uint16_t>(_mm_extract_epi16(this->_d, 4));
+            break;
+        case 3:
+            output[2] = static_cast<uint16_t>(_mm_extract_epi16(this->_d, 2));
+            // fall through
+        case 2:
+            output[1] = static_cast<uint16_t>(_mm_extract_epi16(this->_d, 1));
+            // fall through
+        case 1:
+            output[0] = static_cast<uint16_t>(_mm_extract_epi16(this->_d, 0));
+            break;
+        default:
+            break;
+        }
+    }
+
     simd operator+(const simd& other) const noexcept
     {
         return simd(_mm_adds_epu16(this->_d, other._d));
@@ -90,20 +263,234 @@ public:
         this->_d = _mm_mullo_epi16(this->_d, other._d);
         return *this;
     }
-    uint16_t sum() const noexcept
+    /**
+        Wrapping a + b, unlike operator+ which saturates.
+    */
+    simd add_wrap(const simd& other) const noexcept
     {
-        //   0, 1   2,3   4,5,   6,7
-        // + 2, 3   0,1   6,7    4,5
-        __m128i result = _mm_adds_epu16(this->_d, _mm_shuffle_epi32(this->_d, _MM_SHUFFLE(2, 3, 0, 1)));
-        // + 4,5    6,7   0,1,   2,3
-        result = _mm_adds_epu16(result, _mm_shuffle_epi32(this->_d, _MM_SHUFFLE(1, 0, 3, 2)));
-        // + 6,7    4,5  2,3,   0,1
-        result = _mm_adds_epu16(result, _mm_shuffle_epi32(this->_d, _MM_SHUFFLE(0, 1, 2, 3)));
-        return static_cast<uint16_t>(_mm_extract_epi16(result, 0) + _mm_extract_epi16(result, 1));
+        return simd{ _mm_add_epi16(this->_d, other._d) };
+    }
+    /**
+        Wrapping a - b, unlike operator- which saturates.
+    */
+    simd subtract_wrap(const simd& other) const noexcept
+    {
+        return simd{ _mm_sub_epi16(this->_d, other._d) };
+    }
+    /**
+        a + b clamped to the range of uint16_t.
+    */
+    simd add_saturate(const simd& other) const noexcept
+    {
+        return simd{ _mm_adds_epu16(this->_d, other._d) };
+    }
+    /**
+        a - b clamped to the range of uint16_t.
+    */
+    simd subtract_saturate(const simd& other) const noexcept
+    {
+        return simd{ _mm_subs_epu16(this->_d, other._d) };
+    }
+    /**
+        High half of the 32 bit product.
+    */
+    simd mulhi(const simd& other) const noexcept
+    {
+        return simd{ _mm_mulhi_epu16(this->_d, other._d) };
+    }
+
+    template <int count>
+    simd shift_left() const noexcept
+    {
+        static_assert(count >= 0 && count < 16, "shift count out of range");
+        return simd{ _mm_slli_epi16(this->_d, count) };
+    }
+    /**
+        Logical right shift.
+    */
+    template <int count>
+    simd shift_right() const noexcept
+    {
+        static_assert(count >= 0 && count < 16, "shift count out of range");
+        return simd{ _mm_srli_epi16(this->_d, count) };
+    }
+    /**
+        Shifts each lane left by the corresponding lane of counts, which have to be in [0, 16).
+    */
+    simd shift_left(const simd& counts) const noexcept
+    {
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+        return simd{ _mm_sllv_epi16(this->_d, counts._d) };
+#else
+        const auto values = this->to_array();
+        const auto shifts = counts.to_array();
+        alignas(16) std::array<uint16_t, 8> result;
+        for (size_t i = 0; i < 8; ++i)
+            result[i] = static_cast<uint16_t>(static_cast<uint16_t>(values[i]) << shifts[i]);
+        return load_aligned(result.data());
+#endif
+    }
+    /**
+        Logical right shift of each lane by the corresponding lane of counts, which have to be in [0, 16).
+    */
+    simd shift_right(const simd& counts) const noexcept
+    {
+#if defined(__AVX512BW__) && defined(__AVX512VL__)
+        return simd{ _mm_srlv_epi16(this->_d, counts._d) };
+#else
+        const auto values = this->to_array();
+        const auto shifts = counts.to_array();
+        alignas(16) std::array<uint16_t, 8> result;
+        for (size_t i = 0; i < 8; ++i)
+            result[i] = static_cast<uint16_t>(values[i] >> shifts[i]);
+        return load_aligned(result.data());
+#endif
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ _mm_and_si128(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ _mm_or_si128(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ _mm_xor_si128(this->_d, other._d) };
+    }
+    simd operator~() const noexcept
+    {
+        return simd{ _mm_xor_si128(this->_d, _mm_set1_epi32(-1)) };
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_min_epu16(this->_d, other._d) };
+#else
+        return simd{ _mm_sub_epi16(this->_d, _mm_subs_epu16(this->_d, other._d)) };
+#endif
+    }
+    simd max(const simd& other) const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_max_epu16(this->_d, other._d) };
+#else
+        return simd{ _mm_add_epi16(_mm_subs_epu16(this->_d, other._d), other._d) };
+#endif
+    }
+    /**
+        (a + b + 1) / 2 rounded down, without intermediate overflow.
+    */
+    simd avg(const simd& other) const noexcept
+    {
+        return simd{ _mm_avg_epu16(this->_d, other._d) };
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ priv::permute_epi16<idx...>(this->_d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        // unsigned order is the signed order of the values with the sign bit flipped
+        const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        const __m128i a = _mm_xor_si128(this->_d, bias);
+        const __m128i b = _mm_xor_si128(other._d, bias);
+        const __m128i ones = _mm_set1_epi32(-1);
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ _mm_cmpeq_epi16(a, b) };
+        case compare_flags::lower:
+            return mask_type{ _mm_cmpgt_epi16(b, a) };
+        case compare_flags::lower_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpgt_epi16(a, b), ones) };
+        case compare_flags::greater:
+            return mask_type{ _mm_cmpgt_epi16(a, b) };
+        case compare_flags::greater_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpgt_epi16(b, a), ones) };
+        case compare_flags::not_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpeq_epi16(a, b), ones) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_blendv_epi8(b._d, a._d, mask.native()) };
+#else
+        return simd{ _mm_or_si128(_mm_and_si128(mask.native(), a._d), _mm_andnot_si128(mask.native(), b._d)) };
+#endif
+    }
+    /**
+        Sum of all lanes, widened so that it cannot overflow.
+    */
+    uint32_t sum() const noexcept
+    {
+        // pmaddwd multiplies signed values, so move the lanes to the signed range and back
+        const __m128i biased = _mm_xor_si128(this->_d, _mm_set1_epi16(-0x8000));
+        return static_cast<uint32_t>(priv::sum_epi32(_mm_madd_epi16(biased, _mm_set1_epi16(1))) + 8 * 0x8000);
+    }
+    /**
+        Sum of all lanes clamped to 65535.
+    */
+    uint16_t sum_saturate() const noexcept
+    {
+        const uint32_t total = this->sum();
+        return static_cast<uint16_t>(total < 0xffff ? total : 0xffff);
+    }
+    /**
+        Minimum, maximum, product (wrapping), AND and OR of all lanes.
+    */
+    uint16_t reduce_min() const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return static_cast<uint16_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(this->_d)));
+#else
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a.min(b); }));
+#endif
+    }
+    uint16_t reduce_max() const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return static_cast<uint16_t>(0xffff - (~*this).reduce_min());
+#else
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a.max(b); }));
+#endif
+    }
+    uint16_t reduce_product() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a * b; }));
+    }
+    uint16_t reduce_and() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a & b; }));
+    }
+    uint16_t reduce_or() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a | b; }));
     }
 
 private:
+    static uint16_t lane0(const simd& value) noexcept
+    {
+        return static_cast<uint16_t>(_mm_cvtsi128_si32(value._d));
+    }
+
     __m128i _d;
 };
 
 using simdu16x8 = simd<uint16_t, 8>;
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,444 @@
+#pragma once
+
+#include "../simd_base.hpp"
+#include "permute_sse.hpp"
+#include "reduce_sse.hpp"
+
+#include <immintrin.h>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdu32x4 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<uint32_t, 4> {
+public:
+    static constexpr size_t value_count = 4;
+
+    simd_mask() noexcept
+        : _m(_mm_setzero_si128())
+    {
+    }
+    simd_mask(bool s0, bool s1, bool s2, bool s3) noexcept
+        : _m(_mm_setr_epi32(s0 ? -1 : 0, s1 ? -1 : 0, s2 ? -1 : 0, s3 ? -1 : 0))
+    {
+    }
+    explicit simd_mask(__m128i value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+        const __m128i selected = _mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), lanes);
+        return simd_mask{ _mm_cmpeq_epi32(selected, lanes) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        const __m128i limit = _mm_set1_epi32(static_cast<int>(count < 4 ? count : 4));
+        return simd_mask{ _mm_cmplt_epi32(_mm_setr_epi32(0, 1, 2, 3), limit) };
+    }
+
+    __m128i native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(this->_m)));
+    }
+    bool any() const noexcept
+    {
+        return this->movemask() != 0;
+    }
+    bool all() const noexcept
+    {
+        return this->movemask() == 0xf;
+    }
+    bool none() const noexcept
+    {
+        return this->movemask() == 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_and_si128(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_or_si128(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_xor_si128(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ _mm_xor_si128(this->_m, _mm_set1_epi32(-1)) };
+    }
+
+private:
+    __m128i _m;
+};
+
+/**
+    Lanes of 32 bit unsigned integers. operator+, operator- and operator* wrap around, add_saturate and
+    subtract_saturate clamp to the range of the lane type.
+*/
+template <>
+class simd<uint32_t, 4> : public simd_common<simd<uint32_t, 4>> {
+public:
+    using type = uint32_t;
+    using mask_type = simd_mask<uint32_t, 4>;
+    static constexpr size_t value_count = 4;
+
+    simd() noexcept
+        : _d(_mm_setzero_si128())
+    {
+    }
+    explicit simd(uint32_t value) noexcept
+        : _d(_mm_set1_epi32(static_cast<int>(value)))
+    {
+    }
+    simd(uint32_t s0, uint32_t s1, uint32_t s2, uint32_t s3) noexcept
+        : _d(_mm_setr_epi32(static_cast<int>(s0), static_cast<int>(s1), static_cast<int>(s2), static_cast<int>(s3)))
+    {
+    }
+    explicit simd(__m128i value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const uint32_t* input) noexcept
+        : _d(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input)))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const uint32_t* input, size_t count) noexcept
+    {
+        switch (count) {
+        case 0:
+            return simd{};
+        case 1:
+            return simd{ _mm_cvtsi32_si128(static_cast<int>(input[0])) };
+        case 2:
+            return simd{ _mm_loadl_epi64(reinterpret_cast<const __m128i*>(input)) };
+        case 3:
+            return simd{ _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(input)), _mm_cvtsi32_si128(static_cast<int>(input[2]))) };
+        default:
+            return simd{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(input)) };
+        }
+    }
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const uint32_t* input) noexcept
+    {
+        return simd{ _mm_load_si128(reinterpret_cast<const __m128i*>(input)) };
+    }
+
+    __m128i native() const noexcept
+    {
+        return this->_d;
+    }
+
+    void store(uint32_t* output) const noexcept
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), this->_d);
+    }
+
+    void store_aligned(uint32_t* output) const noexcept
+    {
+        _mm_store_si128(reinterpret_cast<__m128i*>(output), this->_d);
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(uint32_t* output, size_t count) const noexcept
+    {
+        switch (count) {
+        case 0:
+            break;
+        case 1:
+            output[0] = static_cast<uint32_t>(_mm_cvtsi128_si32(this->_d));
+            break;
+        case 2:
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(output), this->_d);
+            break;
+        case 3:
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(output), this->_d);
+            output[2] = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_unpackhi_epi64(this->_d, this->_d)));
+            break;
+        default:
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), this->_d);
+            break;
+        }
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ _mm_add_epi32(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        this->_d = _mm_add_epi32(this->_d, other._d);
+        return *this;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ _mm_sub_epi32(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        this->_d = _mm_sub_epi32(this->_d, other._d);
+        return *this;
+    }
+    /**
+        a + b clamped to the range of uint32_t.
+    */
+    simd add_saturate(const simd& other) const noexcept
+    {
+        const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        const __m128i sum = _mm_add_epi32(this->_d, other._d);
+        // the addition wrapped if the sum is below an operand
+        const __m128i carry = _mm_cmpgt_epi32(_mm_xor_si128(this->_d, bias), _mm_xor_si128(sum, bias));
+        return simd{ _mm_or_si128(sum, carry) };
+    }
+    /**
+        a - b clamped to the range of uint32_t.
+    */
+    simd subtract_saturate(const simd& other) const noexcept
+    {
+        const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        const __m128i borrow = _mm_cmpgt_epi32(_mm_xor_si128(other._d, bias), _mm_xor_si128(this->_d, bias));
+        return simd{ _mm_andnot_si128(borrow, _mm_sub_epi32(this->_d, other._d)) };
+    }
+    /**
+        Low half of the product, i.e. the wrapping a * b.
+    */
+    simd operator*(const simd& other) const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_mullo_epi32(this->_d, other._d) };
+#else
+        const __m128i even = _mm_mul_epu32(this->_d, other._d);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(this->_d, 32), _mm_srli_epi64(other._d, 32));
+        return simd{ _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))) };
+#endif
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    /**
+        High half of the 64 bit product.
+    */
+    simd mulhi(const simd& other) const noexcept
+    {
+        const __m128i even = _mm_mul_epu32(this->_d, other._d);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(this->_d, 32), _mm_srli_epi64(other._d, 32));
+        return simd{ _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, _mm_set_epi32(-1, 0, -1, 0))) };
+    }
+
+    template <int count>
+    simd shift_left() const noexcept
+    {
+        static_assert(count >= 0 && count < 32, "shift count out of range");
+        return simd{ _mm_slli_epi32(this->_d, count) };
+    }
+    /**
+        Logical right shift.
+    */
+    template <int count>
+    simd shift_right() const noexcept
+    {
+        static_assert(count >= 0 && count < 32, "shift count out of range");
+        return simd{ _mm_srli_epi32(this->_d, count) };
+    }
+    /**
+        Shifts each lane left by the corresponding lane of counts, which have to be in [0, 32).
+    */
+    simd shift_left(const simd& counts) const noexcept
+    {
+#if defined(__AVX2__)
+        return simd{ _mm_sllv_epi32(this->_d, counts._d) };
+#else
+        const auto values = this->to_array();
+        const auto shifts = counts.to_array();
+        alignas(16) std::array<uint32_t, 4> result;
+        for (size_t i = 0; i < 4; ++i)
+            result[i] = static_cast<uint32_t>(static_cast<uint32_t>(values[i]) << shifts[i]);
+        return load_aligned(result.data());
+#endif
+    }
+    /**
+        Logical right shift of each lane by the corresponding lane of counts, which have to be in [0, 32).
+    */
+    simd shift_right(const simd& counts) const noexcept
+    {
+#if defined(__AVX2__)
+        return simd{ _mm_srlv_epi32(this->_d, counts._d) };
+#else
+        const auto values = this->to_array();
+        const auto shifts = counts.to_array();
+        alignas(16) std::array<uint32_t, 4> result;
+        for (size_t i = 0; i < 4; ++i)
+            result[i] = static_cast<uint32_t>(values[i] >> shifts[i]);
+        return load_aligned(result.data());
+#endif
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ _mm_and_si128(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ _mm_or_si128(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ _mm_xor_si128(this->_d, other._d) };
+    }
+    simd operator~() const noexcept
+    {
+        return simd{ _mm_xor_si128(this->_d, _mm_set1_epi32(-1)) };
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_min_epu32(this->_d, other._d) };
+#else
+        const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        return select(mask_type{ _mm_cmpgt_epi32(_mm_xor_si128(this->_d, bias), _mm_xor_si128(other._d, bias)) }, other, *this);
+#endif
+    }
+    simd max(const simd& other) const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_max_epu32(this->_d, other._d) };
+#else
+        const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        return select(mask_type{ _mm_cmpgt_epi32(_mm_xor_si128(this->_d, bias), _mm_xor_si128(other._d, bias)) }, *this, other);
+#endif
+    }
+    /**
+        (a + b + 1) / 2 rounded down, without intermediate overflow.
+    */
+    simd avg(const simd& other) const noexcept
+    {
+        // (a | b) - ((a ^ b) >> 1)
+        const __m128i half_difference = _mm_srli_epi32(_mm_xor_si128(this->_d, other._d), 1);
+        return simd{ _mm_sub_epi32(_mm_or_si128(this->_d, other._d), half_difference) };
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ priv::permute_epi32<idx...>(this->_d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        // unsigned order is the signed order of the values with the sign bit flipped
+        const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        const __m128i a = _mm_xor_si128(this->_d, bias);
+        const __m128i b = _mm_xor_si128(other._d, bias);
+        const __m128i ones = _mm_set1_epi32(-1);
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ _mm_cmpeq_epi32(a, b) };
+        case compare_flags::lower:
+            return mask_type{ _mm_cmpgt_epi32(b, a) };
+        case compare_flags::lower_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpgt_epi32(a, b), ones) };
+        case compare_flags::greater:
+            return mask_type{ _mm_cmpgt_epi32(a, b) };
+        case compare_flags::greater_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpgt_epi32(b, a), ones) };
+        case compare_flags::not_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpeq_epi32(a, b), ones) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_blendv_epi8(b._d, a._d, mask.native()) };
+#else
+        return simd{ _mm_or_si128(_mm_and_si128(mask.native(), a._d), _mm_andnot_si128(mask.native(), b._d)) };
+#endif
+    }
+
+    /**
+        Sum of all lanes, widened so that it cannot overflow.
+    */
+    uint64_t sum() const noexcept
+    {
+        const __m128i low = _mm_unpacklo_epi32(this->_d, _mm_setzero_si128());
+        const __m128i high = _mm_unpackhi_epi32(this->_d, _mm_setzero_si128());
+        return priv::sum_epi64(_mm_add_epi64(low, high));
+    }
+    /**
+        Minimum, maximum, product (wrapping), AND and OR of all lanes.
+    */
+    uint32_t reduce_min() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a.min(b); }));
+    }
+    uint32_t reduce_max() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a.max(b); }));
+    }
+    uint32_t reduce_product() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a * b; }));
+    }
+    uint32_t reduce_and() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a & b; }));
+    }
+    uint32_t reduce_or() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a | b; }));
+    }
+
+private:
+    static uint32_t lane0(const simd& value) noexcept
+    {
+        return static_cast<uint32_t>(_mm_cvtsi128_si32(value._d));
+    }
+
+    __m128i _d;
+};
+
+using simdu32x4 = simd<uint32_t, 4>;
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,413 @@
+#pragma once
+
+#include "../simd_base.hpp"
+#include "permute_sse.hpp"
+#include "reduce_sse.hpp"
+
+#include <immintrin.h>
+
+SIMD_NAMESPACE_BEGIN
+
+/**
+    Result of a simdu8x16 comparison, each lane is either all ones or all zeros.
+*/
+template <>
+class simd_mask<uint8_t, 16> {
+public:
+    static constexpr size_t value_count = 16;
+
+    simd_mask() noexcept
+        : _m(_mm_setzero_si128())
+    {
+    }
+    explicit simd_mask(__m128i value) noexcept
+        : _m(value)
+    {
+    }
+    /**
+        Mask with the lanes set where the corresponding bit of the argument is set.
+    */
+    static simd_mask from_bits(uint32_t bits) noexcept
+    {
+        const __m128i lanes = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        // the low byte of bits to lanes 0 - 7, the high byte to lanes 8 - 15
+        const __m128i bytes = _mm_unpacklo_epi64(_mm_set1_epi8(static_cast<char>(bits)), _mm_set1_epi8(static_cast<char>(bits >> 8)));
+        return simd_mask{ _mm_cmpeq_epi8(_mm_and_si128(bytes, lanes), lanes) };
+    }
+    /**
+        Mask with the first count lanes set, used to process the remainder of a loop.
+    */
+    static simd_mask first(size_t count) noexcept
+    {
+        const __m128i limit = _mm_set1_epi8(static_cast<char>(count < 16 ? count : 16));
+        return simd_mask{ _mm_cmplt_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), limit) };
+    }
+
+    __m128i native() const noexcept
+    {
+        return this->_m;
+    }
+    uint32_t movemask() const noexcept
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(this->_m));
+    }
+    bool any() const noexcept
+    {
+        return this->movemask() != 0;
+    }
+    bool all() const noexcept
+    {
+        return this->movemask() == 0xffff;
+    }
+    bool none() const noexcept
+    {
+        return this->movemask() == 0;
+    }
+    size_t popcount() const noexcept
+    {
+        return priv::popcount(this->movemask());
+    }
+    bool operator[](size_t index) const noexcept
+    {
+        return (this->movemask() >> index) & 1;
+    }
+
+    simd_mask operator&(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_and_si128(this->_m, other._m) };
+    }
+    simd_mask operator|(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_or_si128(this->_m, other._m) };
+    }
+    simd_mask operator^(const simd_mask& other) const noexcept
+    {
+        return simd_mask{ _mm_xor_si128(this->_m, other._m) };
+    }
+    simd_mask operator~() const noexcept
+    {
+        return simd_mask{ _mm_xor_si128(this->_m, _mm_set1_epi32(-1)) };
+    }
+
+private:
+    __m128i _m;
+};
+
+/**
+    Lanes of 8 bit unsigned integers. operator+, operator- and operator* wrap around, add_saturate and
+    subtract_saturate clamp to the range of the lane type.
+*/
+template <>
+class simd<uint8_t, 16> : public simd_common<simd<uint8_t, 16>> {
+public:
+    using type = uint8_t;
+    using mask_type = simd_mask<uint8_t, 16>;
+    static constexpr size_t value_count = 16;
+
+    simd() noexcept
+        : _d(_mm_setzero_si128())
+    {
+    }
+    explicit simd(uint8_t value) noexcept
+        : _d(_mm_set1_epi8(static_cast<char>(value)))
+    {
+    }
+    simd(uint8_t s0, uint8_t s1, uint8_t s2, uint8_t s3,
+        uint8_t s4, uint8_t s5, uint8_t s6, uint8_t s7,
+        uint8_t s8, uint8_t s9, uint8_t s10, uint8_t s11,
+        uint8_t s12, uint8_t s13, uint8_t s14, uint8_t s15) noexcept
+        : _d(_mm_setr_epi8(static_cast<char>(s0), static_cast<char>(s1), static_cast<char>(s2), static_cast<char>(s3),
+            static_cast<char>(s4), static_cast<char>(s5), static_cast<char>(s6), static_cast<char>(s7),
+            static_cast<char>(s8), static_cast<char>(s9), static_cast<char>(s10), static_cast<char>(s11),
+            static_cast<char>(s12), static_cast<char>(s13), static_cast<char>(s14), static_cast<char>(s15)))
+    {
+    }
+    explicit simd(__m128i value) noexcept
+        : _d(value)
+    {
+    }
+    explicit simd(const uint8_t* input) noexcept
+        : _d(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input)))
+    {
+    }
+    /**
+        Loads the first count values from memory, the remaining lanes are set to zero.
+        Memory past input + count is not accessed.
+    */
+    static simd load_partial(const uint8_t* input, size_t count) noexcept
+    {
+        if (count >= 16)
+            return simd{ input };
+        alignas(16) uint8_t buffer[16] = {};
+        std::memcpy(buffer, input, count * sizeof(uint8_t));
+        return load_aligned(buffer);
+    }
+    /**
+        Loads from memory aligned to 16 bytes, e.g. from an aligned_vector.
+    */
+    static simd load_aligned(const uint8_t* input) noexcept
+    {
+        return simd{ _mm_load_si128(reinterpret_cast<const __m128i*>(input)) };
+    }
+
+    __m128i native() const noexcept
+    {
+        return this->_d;
+    }
+
+    void store(uint8_t* output) const noexcept
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output), this->_d);
+    }
+
+    void store_aligned(uint8_t* output) const noexcept
+    {
+        _mm_store_si128(reinterpret_cast<__m128i*>(output), this->_d);
+    }
+
+    /**
+        Stores the first count values. Memory past output + count is not accessed.
+    */
+    void store_partial(uint8_t* output, size_t count) const noexcept
+    {
+        if (count >= 16) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output), this->_d);
+            return;
+        }
+        alignas(16) uint8_t buffer[16];
+        this->store_aligned(buffer);
+        std::memcpy(output, buffer, count * sizeof(uint8_t));
+    }
+
+    simd operator+(const simd& other) const noexcept
+    {
+        return simd{ _mm_add_epi8(this->_d, other._d) };
+    }
+    simd& operator+=(const simd& other) noexcept
+    {
+        this->_d = _mm_add_epi8(this->_d, other._d);
+        return *this;
+    }
+    simd operator-(const simd& other) const noexcept
+    {
+        return simd{ _mm_sub_epi8(this->_d, other._d) };
+    }
+    simd& operator-=(const simd& other) noexcept
+    {
+        this->_d = _mm_sub_epi8(this->_d, other._d);
+        return *this;
+    }
+    /**
+        a + b clamped to the range of uint8_t.
+    */
+    simd add_saturate(const simd& other) const noexcept
+    {
+        return simd{ _mm_adds_epu8(this->_d, other._d) };
+    }
+    /**
+        a - b clamped to the range of uint8_t.
+    */
+    simd subtract_saturate(const simd& other) const noexcept
+    {
+        return simd{ _mm_subs_epu8(this->_d, other._d) };
+    }
+    /**
+        Low half of the product, i.e. the wrapping a * b.
+    */
+    simd operator*(const simd& other) const noexcept
+    {
+        // there is no 8 bit multiplication, multiply the even and the odd bytes as 16 bit values
+        const __m128i even = _mm_mullo_epi16(this->_d, other._d);
+        const __m128i odd = _mm_mullo_epi16(_mm_srli_epi16(this->_d, 8), _mm_srli_epi16(other._d, 8));
+        return simd{ _mm_or_si128(_mm_slli_epi16(odd, 8), _mm_and_si128(even, _mm_set1_epi16(0xff))) };
+    }
+    simd& operator*=(const simd& other) noexcept
+    {
+        return *this = *this * other;
+    }
+    /**
+        High half of the 16 bit product.
+    */
+    simd mulhi(const simd& other) const noexcept
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i low = _mm_mullo_epi16(_mm_unpacklo_epi8(this->_d, zero), _mm_unpacklo_epi8(other._d, zero));
+        const __m128i high = _mm_mullo_epi16(_mm_unpackhi_epi8(this->_d, zero), _mm_unpackhi_epi8(other._d, zero));
+        return simd{ _mm_packus_epi16(_mm_srli_epi16(low, 8), _mm_srli_epi16(high, 8)) };
+    }
+
+    template <int count>
+    simd shift_left() const noexcept
+    {
+        static_assert(count >= 0 && count < 8, "shift count out of range");
+        // 16 bit shift, then clear the bits shifted in from the neighbouring byte
+        return simd{ _mm_and_si128(_mm_slli_epi16(this->_d, count), _mm_set1_epi8(static_cast<char>((0xff << count) & 0xff))) };
+    }
+    /**
+        Logical right shift.
+    */
+    template <int count>
+    simd shift_right() const noexcept
+    {
+        static_assert(count >= 0 && count < 8, "shift count out of range");
+        return simd{ _mm_and_si128(_mm_srli_epi16(this->_d, count), _mm_set1_epi8(static_cast<char>(0xff >> count))) };
+    }
+    /**
+        Shifts each lane left by the corresponding lane of counts, which have to be in [0, 8).
+    */
+    simd shift_left(const simd& counts) const noexcept
+    {
+        const auto values = this->to_array();
+        const auto shifts = counts.to_array();
+        alignas(16) std::array<uint8_t, 16> result;
+        for (size_t i = 0; i < 16; ++i)
+            result[i] = static_cast<uint8_t>(static_cast<uint8_t>(values[i]) << shifts[i]);
+        return load_aligned(result.data());
+    }
+    /**
+        Logical right shift of each lane by the corresponding lane of counts, which have to be in [0, 8).
+    */
+    simd shift_right(const simd& counts) const noexcept
+    {
+        const auto values = this->to_array();
+        const auto shifts = counts.to_array();
+        alignas(16) std::array<uint8_t, 16> result;
+        for (size_t i = 0; i < 16; ++i)
+            result[i] = static_cast<uint8_t>(values[i] >> shifts[i]);
+        return load_aligned(result.data());
+    }
+
+    simd operator&(const simd& other) const noexcept
+    {
+        return simd{ _mm_and_si128(this->_d, other._d) };
+    }
+    simd operator|(const simd& other) const noexcept
+    {
+        return simd{ _mm_or_si128(this->_d, other._d) };
+    }
+    simd operator^(const simd& other) const noexcept
+    {
+        return simd{ _mm_xor_si128(this->_d, other._d) };
+    }
+    simd operator~() const noexcept
+    {
+        return simd{ _mm_xor_si128(this->_d, _mm_set1_epi32(-1)) };
+    }
+
+    simd min(const simd& other) const noexcept
+    {
+        return simd{ _mm_min_epu8(this->_d, other._d) };
+    }
+    simd max(const simd& other) const noexcept
+    {
+        return simd{ _mm_max_epu8(this->_d, other._d) };
+    }
+    /**
+        (a + b + 1) / 2 rounded down, without intermediate overflow.
+    */
+    simd avg(const simd& other) const noexcept
+    {
+        return simd{ _mm_avg_epu8(this->_d, other._d) };
+    }
+
+    /**
+        { value[idx0], value[idx1], ... }, mapped at compile time to the cheapest instruction
+        sequence for the pattern. The indices are checked with a static_assert.
+    */
+    template <unsigned... idx>
+    simd permute() const noexcept
+    {
+        return simd{ priv::permute_epi8<idx...>(this->_d) };
+    }
+
+    mask_type compare(const simd& other, compare_flags flag) const noexcept
+    {
+        // unsigned order is the signed order of the values with the sign bit flipped
+        const __m128i bias = _mm_set1_epi8(static_cast<char>(0x80));
+        const __m128i a = _mm_xor_si128(this->_d, bias);
+        const __m128i b = _mm_xor_si128(other._d, bias);
+        const __m128i ones = _mm_set1_epi32(-1);
+        switch (flag) {
+        case compare_flags::equal:
+            return mask_type{ _mm_cmpeq_epi8(a, b) };
+        case compare_flags::lower:
+            return mask_type{ _mm_cmpgt_epi8(b, a) };
+        case compare_flags::lower_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpgt_epi8(a, b), ones) };
+        case compare_flags::greater:
+            return mask_type{ _mm_cmpgt_epi8(a, b) };
+        case compare_flags::greater_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpgt_epi8(b, a), ones) };
+        case compare_flags::not_equal:
+            return mask_type{ _mm_xor_si128(_mm_cmpeq_epi8(a, b), ones) };
+        }
+        return mask_type{};
+    }
+
+    /**
+        Lane-wise mask ? a : b.
+    */
+    static simd select(const mask_type& mask, const simd& a, const simd& b) noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return simd{ _mm_blendv_epi8(b._d, a._d, mask.native()) };
+#else
+        return simd{ _mm_or_si128(_mm_and_si128(mask.native(), a._d), _mm_andnot_si128(mask.native(), b._d)) };
+#endif
+    }
+
+    /**
+        Sum of all lanes, widened so that it cannot overflow.
+    */
+    uint32_t sum() const noexcept
+    {
+        // sums of absolute differences to zero add up each group of 8 bytes
+        const __m128i halves = _mm_sad_epu8(this->_d, _mm_setzero_si128());
+        return static_cast<uint32_t>(priv::sum_epi64(halves));
+    }
+    /**
+        Minimum, maximum, product (wrapping), AND and OR of all lanes.
+    */
+    uint8_t reduce_min() const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        // the minimum of each byte pair zero extended to 16 bits, then phminposuw
+        const __m128i pairs = _mm_min_epu8(this->_d, _mm_srli_epi16(this->_d, 8));
+        return static_cast<uint8_t>(_mm_cvtsi128_si32(_mm_minpos_epu16(_mm_and_si128(pairs, _mm_set1_epi16(0xff)))));
+#else
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a.min(b); }));
+#endif
+    }
+    uint8_t reduce_max() const noexcept
+    {
+#if defined(__SSE4_1__) || defined(__AVX__)
+        return static_cast<uint8_t>(0xff - (~*this).reduce_min());
+#else
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a.max(b); }));
+#endif
+    }
+    uint8_t reduce_product() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a * b; }));
+    }
+    uint8_t reduce_and() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a & b; }));
+    }
+    uint8_t reduce_or() const noexcept
+    {
+        return lane0(priv::fold_lanes(*this, [](const simd& a, const simd& b) { return a | b; }));
+    }
+
+private:
+    static uint8_t lane0(const simd& value) noexcept
+    {
+        return static_cast<uint8_t>(_mm_cvtsi128_si32(value._d));
+    }
+
+    __m128i _d;
+};
+
+using simdu8x16 = simd<uint8_t, 16>;
+
+SIMD_NAMESPACE_END
@@ -0,0 +1,60 @@
+#include "catch.hpp"
+
+#include "simd/aligned_allocator.hpp"
+#include "simd/simdf16.hpp"
+#include "simd/simdf4.hpp"
+#include "simd/simdu16x8.hpp"
+
+#include <cstdint>
+
+TEST_CASE("aligned allocator")
+{
+    SECTION("alignment")
+    {
+        for (size_t size = 1; size < 100; size += 7) {
+            aligned_vector<float> floats(size);
+            aligned_vector<uint16_t, 16> shorts(size);
+            REQUIRE(simd_base::is_aligned(floats.data(), 64));
+            REQUIRE(simd_base::is_aligned(shorts.data(), 16));
+        }
+        aligned_vector<float> grown;
+        for (int i = 0; i < 1000; ++i) {
+            grown.push_back(static_cast<float>(i));
+            REQUIRE(simd_base::is_aligned(grown.data(), 64));
+        }
+        REQUIRE(grown[999] == 999);
+    }
+    SECTION("padding")
+    {
+        REQUIRE(aligned_allocator<float>::padded_size(0) == 0);
+        REQUIRE(aligned_allocator<float>::padded_size(1) == 16);
+        REQUIRE(aligned_allocator<float>::padded_size(16) == 16);
+        REQUIRE(aligned_allocator<float>::padded_size(17) == 32);
+        REQUIRE(aligned_allocator<uint16_t, 16>::padded_size(9) == 16);
+        REQUIRE(aligned_allocator<double, 32>::padded_size(5) == 8);
+    }
+    SECTION("rebind and compare")
+    {
+        using rebound = std::allocator_traits<aligned_allocator<float, 32>>::rebind_alloc<uint16_t>;
+        static_assert(std::is_same<rebound, aligned_allocator<uint16_t, 32>>::value, "");
+        REQUIRE(aligned_allocator<float>() == aligned_allocator<uint16_t>());
+        REQUIRE_FALSE(aligned_allocator<float>() != aligned_allocator<float>());
+    }
+    SECTION("whole register access")
+    {
+        // 19 values, the last simdf16 load reads into the padding of the allocation
+        aligned_vector<float> data(19);
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<float>(i);
+        for (size_t i = 0; i < data.size(); i += 16)
+            (simdf16::load_aligned(&data[i]) * simdf16(2.0f)).store_aligned(&data[i]);
+        for (size_t i = 0; i < data.size(); ++i)
+            REQUIRE(data[i] == 2.0f * i);
+
+        aligned_vector<uint16_t> shorts(10, 3);
+        for (size_t i = 0; i < shorts.size(); i += 8)
+            (simdu16x8::load_aligned(&shorts[i]) + simdu16x8(1)).store_aligned(&shorts[i]);
+        REQUIRE(shorts[9] == 4);
+        REQUIRE(simdf4::load_aligned(data.data()).to_array() == std::array<float, 4>{ 0, 2, 4, 6 });
+    }
+}
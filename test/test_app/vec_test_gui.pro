@@ -5,16 +5,43 @@ CONFIG += console
 !android:CONFIG += c++1z
 android:CONFIG += c++14
 
-!android:QMAKE_CXXFLAGS += -msse4.1 -mmmx
+# baseline instruction set of the build, e.g. "qmake SIMD_X86_ARCH=-msse2" for a portable binary;
+# the float kernels of simd_algorithm and simd_blas still run at the widest level of the CPU
+# (simd/dispatch/dispatch.pri)
+isEmpty(SIMD_X86_ARCH):SIMD_X86_ARCH = -msse4.1 -mmmx
+!android:QMAKE_CXXFLAGS += $$SIMD_X86_ARCH
 android:QMAKE_CXXFLAGS += -mfloat-abi=softfp -mfpu=neon
 
+# "qmake CONFIG+=simd_generic" runs the tests against the portable backend (simd/simd_backend.hpp)
+simd_generic:DEFINES += SIMD_BACKEND_GENERIC
+
+include(../../simd/dispatch/dispatch.pri)
+
 DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
         main.cpp \
     ../test_simdf4.cpp \
-    ../test_simdu16x8.cpp
+    ../test_simdu16x8.cpp \
+    ../test_cpu_features.cpp \
+    ../test_simdf8.cpp \
+    ../test_simdf16.cpp \
+    ../test_simd_math.cpp \
+    ../test_aligned_allocator.cpp \
+    ../test_simd_algorithm.cpp \
+    ../test_simd_integer.cpp \
+    ../test_simdd2.cpp \
+    ../test_simdd4.cpp \
+    ../test_float16.cpp \
+    ../test_simd_convert.cpp \
+    ../test_simd_permute.cpp \
+    ../test_mat4f.cpp \
+    ../test_quatf.cpp \
+    ../test_simd_gemm.cpp \
+    ../test_simd_blas.cpp \
+    ../test_simd_parallel.cpp \
+    ../test_simd_dispatch.cpp
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -28,12 +55,65 @@ INCLUDEPATH+=../ \
 
 HEADERS += \
     ../catch.hpp \
+    ../test_values.hpp \
     ../../simd/simd_base.hpp \
+    ../../simd/cpu_features.hpp \
     ../../simd/simdf4.hpp \
-    ../../simd/simdu16x8.hpp
+    ../../simd/simdu16x8.hpp \
+    ../../simd/simdf8.hpp \
+    ../../simd/generic/simdf8_pair.hpp \
+    ../../simd/simdf16.hpp \
+    ../../simd/generic/simdf16_pair.hpp \
+    ../../simd/simd_math.hpp \
+    ../../simd/aligned_allocator.hpp \
+    ../../simd/simd_algorithm.hpp \
+    ../../simd/simdi32x4.hpp \
+    ../../simd/simdu32x4.hpp \
+    ../../simd/simdi16x8.hpp \
+    ../../simd/simdu8x16.hpp \
+    ../../simd/simdd2.hpp \
+    ../../simd/generic/simdd2_scalar.hpp \
+    ../../simd/simdd4.hpp \
+    ../../simd/generic/simdd4_pair.hpp \
+    ../../simd/float16.hpp \
+    ../../simd/simd_convert.hpp \
+    ../../simd/permute_pattern.hpp \
+    ../../simd/simd_backend.hpp \
+    ../../simd/generic/lanes_generic.hpp \
+    ../../simd/generic/simdf4_generic.hpp \
+    ../../simd/generic/simdi32x4_generic.hpp \
+    ../../simd/generic/simdu32x4_generic.hpp \
+    ../../simd/generic/simdi16x8_generic.hpp \
+    ../../simd/generic/simdu16x8_generic.hpp \
+    ../../simd/generic/simdu8x16_generic.hpp \
+    ../../simd/generic/convert_generic.hpp \
+    ../../simd/mat4f.hpp \
+    ../../simd/vec3f.hpp \
+    ../../simd/quatf.hpp \
+    ../../simd/simd_gemm.hpp \
+    ../../simd/simd_blas.hpp \
+    ../../simd/simd_parallel.hpp
 
 
 android:HEADERS += ../../simd/neon/simdf4_neon.hpp \
-    ../../simd/neon/simdu16x8_neon.hpp
+    ../../simd/neon/simdu16x8_neon.hpp \
+    ../../simd/neon/simdi32x4_neon.hpp \
+    ../../simd/neon/simdu32x4_neon.hpp \
+    ../../simd/neon/simdi16x8_neon.hpp \
+    ../../simd/neon/simdu8x16_neon.hpp \
+    ../../simd/neon/simdd2_neon.hpp \
+    ../../simd/neon/convert_neon.hpp \
+    ../../simd/neon/permute_neon.hpp
 !android:HEADERS += ../../simd/x86/simdf4_sse.hpp \
-    ../../simd/x86/simdu16x8_sse.hpp
+    ../../simd/x86/simdu16x8_sse.hpp \
+    ../../simd/x86/simdf8_avx.hpp \
+    ../../simd/x86/simdf16_avx512.hpp \
+    ../../simd/x86/simdi32x4_sse.hpp \
+    ../../simd/x86/simdu32x4_sse.hpp \
+    ../../simd/x86/simdi16x8_sse.hpp \
+    ../../simd/x86/simdu8x16_sse.hpp \
+    ../../simd/x86/simdd2_sse.hpp \
+    ../../simd/x86/simdd4_avx.hpp \
+    ../../simd/x86/convert_sse.hpp \
+    ../../simd/x86/permute_sse.hpp \
+    ../../simd/x86/reduce_sse.hpp
@@ -0,0 +1,82 @@
+#include "catch.hpp"
+
+#include "simd/cpu_features.hpp"
+#include "simd/simdf4.hpp"
+
+namespace {
+int kernel_scalar()
+{
+    return 0;
+}
+int kernel_sse2()
+{
+    return 1;
+}
+int kernel_avx2()
+{
+    return 2;
+}
+} // namespace
+
+TEST_CASE("cpu features")
+{
+    SECTION("detection")
+    {
+        const auto& cpu = simd_base::cpu();
+        REQUIRE(&cpu == &cpu_features::instance());
+        REQUIRE(cpu.supports(simd_isa::scalar));
+        REQUIRE(cpu.supports(cpu.best_isa()));
+        // the running CPU has to support what this test was compiled for
+        REQUIRE(cpu.supports(compiled_isa()));
+        REQUIRE(compiled_isa() <= cpu.best_isa());
+#if defined(SIMD_BACKEND_GENERIC)
+        REQUIRE(compiled_isa() == simd_isa::scalar);
+#endif
+#if defined(__SSE2__)
+        REQUIRE(cpu.has(cpu_features::sse2));
+#endif
+#if defined(__SSE4_1__)
+        REQUIRE(cpu.supports(simd_isa::sse4_1));
+#endif
+#if defined(__AVX2__)
+        REQUIRE(cpu.has(cpu_features::avx2));
+#endif
+        if (cpu.supports(simd_isa::avx2))
+            REQUIRE(cpu.supports(simd_isa::avx));
+        if (cpu.supports(simd_isa::avx512))
+            REQUIRE(cpu.has(cpu_features::avx512f));
+    }
+    SECTION("isa levels")
+    {
+        const cpu_features none(0);
+        REQUIRE(none.best_isa() == simd_isa::scalar);
+
+        const cpu_features sse(cpu_features::sse2 | cpu_features::sse3 | cpu_features::ssse3);
+        REQUIRE(sse.best_isa() == simd_isa::ssse3);
+        REQUIRE_FALSE(sse.supports(simd_isa::sse4_1));
+
+        // AVX2 level requires the lower levels and FMA
+        const cpu_features no_sse41(cpu_features::sse2 | cpu_features::sse3 | cpu_features::ssse3
+            | cpu_features::avx | cpu_features::avx2 | cpu_features::fma);
+        REQUIRE(no_sse41.best_isa() == simd_isa::ssse3);
+    }
+    SECTION("dispatch")
+    {
+        const cpu_features none(0);
+        const cpu_features sse(cpu_features::sse2);
+        const cpu_features avx2(cpu_features::sse2 | cpu_features::sse3 | cpu_features::ssse3 | cpu_features::sse4_1
+            | cpu_features::avx | cpu_features::avx2 | cpu_features::fma);
+
+        auto select = [](const cpu_features& cpu) {
+            return simd_select<int()>({ { simd_isa::sse2, &kernel_sse2 },
+                                          { simd_isa::avx2, &kernel_avx2 },
+                                          { simd_isa::scalar, &kernel_scalar } },
+                cpu);
+        };
+        REQUIRE(select(none)() == 0);
+        REQUIRE(select(sse)() == 1);
+        REQUIRE(select(avx2)() == 2);
+        REQUIRE(simd_select<int()>({ { simd_isa::avx512, &kernel_avx2 } }, none) == nullptr);
+        REQUIRE(simd_select<int()>({ { simd_isa::scalar, &kernel_scalar } })() == 0);
+    }
+}
@@ -0,0 +1,145 @@
+#include "catch.hpp"
+
+#include "simd/simd_algorithm.hpp"
+#include "simd/simdf4.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+bool same_value(float a, float b)
+{
+    return (std::isnan(a) && std::isnan(b)) || priv::float_bits(a) == priv::float_bits(b);
+}
+} // namespace
+
+TEST_CASE("float16")
+{
+    SECTION("scalar")
+    {
+        REQUIRE(float16::from_float(1.0f).bits == 0x3c00);
+        REQUIRE(float16::from_float(-2.0f).bits == 0xc000);
+        REQUIRE(float16::from_float(65504.0f).bits == 0x7bff);
+        REQUIRE(float16::from_float(65519.0f).bits == 0x7bff);
+        REQUIRE(float16::from_float(65520.0f).bits == 0x7c00);
+        REQUIRE(float16::from_float(std::ldexp(1.0f, -24)).bits == 0x0001);
+        REQUIRE(float16::from_float(std::ldexp(1.0f, -25)).bits == 0x0000);
+        REQUIRE(float16::from_float(std::ldexp(3.0f, -26)).bits == 0x0001);
+        REQUIRE(float16::from_float(-0.0f).bits == 0x8000);
+        REQUIRE(float16::from_float(-std::numeric_limits<float>::infinity()).bits == 0xfc00);
+        REQUIRE((float16::from_float(std::numeric_limits<float>::quiet_NaN()).bits & 0x7e00) == 0x7e00);
+
+        // every value converts exactly and back, midpoints round to the even neighbour
+        for (uint32_t bits = 0; bits < 0x10000; ++bits) {
+            const float16 h{ static_cast<uint16_t>(bits) };
+            const float f = h.to_float();
+            const uint32_t em = bits & 0x7fff;
+            if (em > 0x7c00) {
+                REQUIRE(std::isnan(f));
+                continue;
+            }
+            const float expected = em == 0x7c00 ? std::numeric_limits<float>::infinity()
+                : em < 0x400 ? std::ldexp(static_cast<float>(em), -24)
+                             : std::ldexp(static_cast<float>((em & 0x3ff) | 0x400), static_cast<int>(em >> 10) - 25);
+            REQUIRE(f == (bits & 0x8000 ? -expected : expected));
+            REQUIRE(float16::from_float(f).bits == bits);
+            if (em < 0x7bff) {
+                const float next = float16{ static_cast<uint16_t>(bits + 1) }.to_float();
+                const float middle = (f + next) / 2;
+                REQUIRE(float16::from_float(middle).bits == ((bits & 1) ? bits + 1 : bits));
+            }
+        }
+    }
+    SECTION("simdf4")
+    {
+        for (uint32_t bits = 0; bits < 0x10000; bits += 4) {
+            const float16 h[4] = { { static_cast<uint16_t>(bits) }, { static_cast<uint16_t>(bits + 1) },
+                { static_cast<uint16_t>(bits + 2) }, { static_cast<uint16_t>(bits + 3) } };
+            const auto lanes = simdf4(h).to_array();
+            for (size_t i = 0; i < 4; ++i)
+                REQUIRE(same_value(lanes[i], h[i].to_float()));
+        }
+        // a sweep over all float exponents and signs, the stride keeps a mix of mantissas
+        for (uint64_t bits = 0; bits < 0x100000000ull; bits += 4 * 4099) {
+            float values[4];
+            for (uint32_t i = 0; i < 4; ++i)
+                values[i] = priv::bits_to_float(static_cast<uint32_t>(bits + i * 4099));
+            float16 h[4];
+            simdf4(values).store(h);
+            for (size_t i = 0; i < 4; ++i) {
+                const float16 expected = float16::from_float(values[i]);
+                if (std::isnan(values[i]))
+                    REQUIRE((h[i].bits & 0x7e00) == 0x7e00);
+                else
+                    REQUIRE(h[i].bits == expected.bits);
+            }
+        }
+    }
+}
+
+TEST_CASE("bfloat16")
+{
+    SECTION("scalar")
+    {
+        REQUIRE(bfloat16::from_float(1.0f).bits == 0x3f80);
+        REQUIRE(bfloat16::from_float(-3.0f).bits == 0xc040);
+        REQUIRE(bfloat16{ 0x3f80 }.to_float() == 1.0f);
+        // 1 + 2^-8 is halfway between 1 and 1 + 2^-7 and rounds to the even 1
+        REQUIRE(bfloat16::from_float(1.0f + std::ldexp(1.0f, -8)).bits == 0x3f80);
+        REQUIRE(bfloat16::from_float(1.0f + 3 * std::ldexp(1.0f, -8)).bits == 0x3f82);
+        REQUIRE(bfloat16::from_float(std::numeric_limits<float>::max()).bits == 0x7f80);
+        const float signaling = priv::bits_to_float(0x7f800001u);
+        REQUIRE(std::isnan(bfloat16::from_float(signaling).to_float()));
+    }
+    SECTION("simdf4")
+    {
+        for (uint32_t bits = 0; bits < 0x10000; bits += 4) {
+            const bfloat16 h[4] = { { static_cast<uint16_t>(bits) }, { static_cast<uint16_t>(bits + 1) },
+                { static_cast<uint16_t>(bits + 2) }, { static_cast<uint16_t>(bits + 3) } };
+            const auto lanes = simdf4(h).to_array();
+            for (size_t i = 0; i < 4; ++i)
+                REQUIRE(same_value(lanes[i], h[i].to_float()));
+        }
+        for (uint64_t bits = 0; bits < 0x100000000ull; bits += 4 * 4099) {
+            float values[4];
+            for (uint32_t i = 0; i < 4; ++i)
+                values[i] = priv::bits_to_float(static_cast<uint32_t>(bits + i * 4099));
+            bfloat16 h[4];
+            simdf4(values).store(h);
+            for (size_t i = 0; i < 4; ++i)
+                REQUIRE(h[i].bits == bfloat16::from_float(values[i]).bits);
+        }
+    }
+}
+
+TEST_CASE("convert span")
+{
+    const size_t sizes[] = { 0, 1, 3, 4, 5, 15, 16, 17, 63, 100 };
+    std::vector<float> values(110);
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = (static_cast<float>(i) - 40.0f) * 0.37f;
+
+    for (size_t size : sizes) {
+        for (size_t offset = 0; offset < 4; ++offset) {
+            std::vector<float16> halves(size + 1, float16{ 0xffff });
+            std::vector<bfloat16> brains(size + 1, bfloat16{ 0xffff });
+            simd_algorithm::convert_span(values.data() + offset, size, halves.data());
+            simd_algorithm::convert_span(values.data() + offset, size, brains.data());
+            REQUIRE(halves[size].bits == 0xffff);
+            REQUIRE(brains[size].bits == 0xffff);
+
+            std::vector<float> widened(size + 2, -1.0f);
+            std::vector<float> widened_brains(size + 2, -1.0f);
+            simd_algorithm::convert_span(halves.data(), size, widened.data() + offset % 2);
+            simd_algorithm::convert_span(brains.data(), size, widened_brains.data() + offset % 2);
+            for (size_t i = 0; i < size; ++i) {
+                REQUIRE(halves[i].bits == float16::from_float(values[i + offset]).bits);
+                REQUIRE(brains[i].bits == bfloat16::from_float(values[i + offset]).bits);
+                REQUIRE(widened[i + offset % 2] == halves[i].to_float());
+                REQUIRE(widened_brains[i + offset % 2] == brains[i].to_float());
+            }
+            REQUIRE(widened[size + offset % 2] == -1.0f);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#include "catch.hpp"
+#include "test_values.hpp"
+
+#include "simd/mat4f.hpp"
+
+#include <array>
+#include <vector>
+
+namespace {
+using matrix = std::array<std::array<double, 4>, 4>;
+
+matrix reference(const mat4f& m)
+{
+    matrix result;
+    for (size_t r = 0; r < 4; ++r) {
+        for (size_t c = 0; c < 4; ++c)
+            result[r][c] = m(r, c);
+    }
+    return result;
+}
+matrix multiply(const matrix& a, const matrix& b)
+{
+    matrix result{};
+    for (size_t r = 0; r < 4; ++r) {
+        for (size_t c = 0; c < 4; ++c) {
+            for (size_t k = 0; k < 4; ++k)
+                result[r][c] += a[r][k] * b[k][c];
+        }
+    }
+    return result;
+}
+void require_near(const mat4f& m, const matrix& expected, double margin)
+{
+    for (size_t r = 0; r < 4; ++r) {
+        for (size_t c = 0; c < 4; ++c)
+            REQUIRE(m(r, c) == Approx(expected[r][c]).margin(margin));
+    }
+}
+mat4f test_matrix(unsigned seed)
+{
+    // well conditioned: a dominant diagonal plus pseudo-random entries in [-1, 1]
+    float values[16];
+    for (unsigned i = 0; i < 16; ++i)
+        values[i] = next_test_value(seed) + (i % 5 == 0 ? 4.0f : 0.0f);
+    return mat4f(values);
+}
+} // namespace
+
+TEST_CASE("mat4f")
+{
+    const float rows[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    const mat4f m = mat4f::from_rows(rows);
+
+    SECTION("layout")
+    {
+        REQUIRE(m(0, 1) == 2);
+        REQUIRE(m(2, 3) == 12);
+        REQUIRE(m.column(1).to_array() == std::array<float, 4>{ 2, 6, 10, 14 });
+        float stored[16];
+        m.store(stored);
+        REQUIRE(mat4f(stored)(3, 0) == 13);
+        REQUIRE(m.transpose()(0, 1) == 5);
+        REQUIRE(m.transpose().transpose()(1, 0) == 5);
+        REQUIRE(mat4f()(1, 1) == 0);
+        REQUIRE(mat4f::identity()(1, 1) == 1);
+        REQUIRE(mat4f::identity()(1, 2) == 0);
+    }
+    SECTION("multiply")
+    {
+        const mat4f a = test_matrix(1);
+        require_near(a * m, multiply(reference(a), reference(m)), 1e-4);
+        require_near(m * a, multiply(reference(m), reference(a)), 1e-4);
+        require_near(mat4f::identity() * m, reference(m), 0);
+        const simdf4 v = m * simdf4(1, 0, -1, 2);
+        REQUIRE(v.to_array() == std::array<float, 4>{ 6, 14, 22, 30 });
+    }
+    SECTION("inverse")
+    {
+        REQUIRE(mat4f::identity().inverse()(2, 2) == 1);
+        REQUIRE(m.determinant() == 0);
+        for (unsigned seed = 0; seed < 50; ++seed) {
+            const mat4f a = test_matrix(seed);
+            require_near(a * a.inverse(), reference(mat4f::identity()), 1e-5);
+            require_near(a.inverse() * a, reference(mat4f::identity()), 1e-5);
+        }
+        // translation, scale and rotation by 90 degrees around z
+        const float affine[16] = { 0, -2, 0, 5, 2, 0, 0, -3, 0, 0, 4, 1, 0, 0, 0, 1 };
+        const mat4f t = mat4f::from_rows(affine);
+        REQUIRE(t.determinant() == 16);
+        const float expected[16] = { 0, 0.5f, 0, 1.5f, -0.5f, 0, 0, 2.5f, 0, 0, 0.25f, -0.25f, 0, 0, 0, 1 };
+        require_near(t.inverse(), reference(mat4f::from_rows(expected)), 1e-7);
+    }
+    SECTION("transform points")
+    {
+        const float affine[16] = { 0, -2, 0, 5, 2, 0, 0, -3, 0, 0, 4, 1, 0, 0, 0, 1 };
+        const mat4f t = mat4f::from_rows(affine);
+        for (size_t count : { 0, 1, 3, 4, 5, 8, 11, 64 }) {
+            std::vector<vec3f> points(count + 1, vec3f{ -1, -1, -1 });
+            for (size_t i = 0; i < count; ++i)
+                points[i] = vec3f{ float(i), float(i % 3) - 1, 0.5f * float(i) };
+            std::vector<vec3f> output(count + 1, vec3f{ -7, -7, -7 });
+            transform_points(points.data(), count, output.data(), t);
+            for (size_t i = 0; i < count; ++i) {
+                const vec3f p = points[i];
+                REQUIRE(output[i].x == -2 * p.y + 5);
+                REQUIRE(output[i].y == 2 * p.x - 3);
+                REQUIRE(output[i].z == 4 * p.z + 1);
+            }
+            REQUIRE(output[count].x == -7);
+            REQUIRE(output[count].z == -7);
+            // in place
+            transform_points(points.data(), count, points.data(), t);
+            for (size_t i = 0; i < count; ++i)
+                REQUIRE(points[i].y == output[i].y);
+        }
+    }
+}
@@ -0,0 +1,151 @@
+#include "catch.hpp"
+
+#include "simd/quatf.hpp"
+
+#include <array>
+#include <cmath>
+
+namespace {
+const float pi = 3.14159265358979f;
+
+void require_near(const quatf& q, const std::array<float, 4>& expected, double margin = 1e-6)
+{
+    const auto r = q.to_array();
+    for (size_t i = 0; i < 4; ++i)
+        REQUIRE(r[i] == Approx(expected[i]).margin(margin));
+}
+void require_near(const vec3f& v, const vec3f& expected, double margin = 1e-5)
+{
+    REQUIRE(v.x == Approx(expected.x).margin(margin));
+    REQUIRE(v.y == Approx(expected.y).margin(margin));
+    REQUIRE(v.z == Approx(expected.z).margin(margin));
+}
+/**
+    Hamilton product in double precision.
+*/
+std::array<float, 4> multiply(const quatf& qa, const quatf& qb)
+{
+    const auto a = qa.to_array();
+    const auto b = qb.to_array();
+    const double x = double(a[3]) * b[0] + double(a[0]) * b[3] + double(a[1]) * b[2] - double(a[2]) * b[1];
+    const double y = double(a[3]) * b[1] - double(a[0]) * b[2] + double(a[1]) * b[3] + double(a[2]) * b[0];
+    const double z = double(a[3]) * b[2] + double(a[0]) * b[1] - double(a[1]) * b[0] + double(a[2]) * b[3];
+    const double w = double(a[3]) * b[3] - double(a[0]) * b[0] - double(a[1]) * b[1] - double(a[2]) * b[2];
+    return { float(x), float(y), float(z), float(w) };
+}
+quatf test_rotation(int i)
+{
+    const float length = std::sqrt(float(1 + i * i + 4));
+    return quatf::from_axis_angle(vec3f{ 1 / length, float(i) / length, -2 / length }, 0.3f + 0.7f * float(i));
+}
+} // namespace
+
+TEST_CASE("quatf")
+{
+    const quatf z90 = quatf::from_axis_angle(vec3f{ 0, 0, 1 }, pi / 2);
+    const quatf x90 = quatf::from_axis_angle(vec3f{ 1, 0, 0 }, pi / 2);
+
+    SECTION("rotate")
+    {
+        require_near(quatf::identity().rotate(vec3f{ 1, 2, 3 }), vec3f{ 1, 2, 3 });
+        require_near(z90.rotate(vec3f{ 1, 0, 0 }), vec3f{ 0, 1, 0 });
+        require_near(x90.rotate(vec3f{ 0, 1, 0 }), vec3f{ 0, 0, 1 });
+        require_near(z90.transform(vec3f{ 1, 0, 0 }, vec3f{ 10, 20, 30 }), vec3f{ 10, 21, 30 });
+        REQUIRE(z90.rotate(simdf4(1, 0, 0, 7)).to_array()[3] == 7);
+    }
+    SECTION("multiply")
+    {
+        for (int i = 0; i < 8; ++i) {
+            const quatf a = test_rotation(i);
+            const quatf b = test_rotation(i + 3);
+            require_near(a * b, multiply(a, b));
+            const vec3f v{ 0.5f, -1, 2 };
+            require_near((a * b).rotate(v), a.rotate(b.rotate(v)));
+            require_near(a * a.conjugate(), quatf::identity().to_array());
+            require_near(a.conjugate().rotate(a.rotate(v)), v);
+        }
+        // z after x: x maps y to z, z maps z to z
+        require_near((z90 * x90).rotate(vec3f{ 0, 1, 0 }), vec3f{ 0, 0, 1 });
+    }
+    SECTION("normalize")
+    {
+        const quatf q(1, 2, -2, 4);
+        REQUIRE(quatf::dot(q, q) == 25);
+        require_near(q.normalize<simd_base::exact>(), { 0.2f, 0.4f, -0.4f, 0.8f });
+        require_near(q.normalize(), { 0.2f, 0.4f, -0.4f, 0.8f }, 1e-4);
+        require_near(q.normalize<simd_base::newton_2>(), { 0.2f, 0.4f, -0.4f, 0.8f }, 1e-6);
+    }
+    SECTION("interpolation")
+    {
+        const quatf z45 = quatf::from_axis_angle(vec3f{ 0, 0, 1 }, pi / 4);
+        const quatf z22 = quatf::from_axis_angle(vec3f{ 0, 0, 1 }, pi / 8);
+        require_near(quatf::nlerp(quatf::identity(), z90, 0), quatf::identity().to_array(), 1e-4);
+        require_near(quatf::nlerp(quatf::identity(), z90, 1), z90.to_array(), 1e-4);
+        require_near(quatf::nlerp(quatf::identity(), z90, 0.5f), z45.to_array(), 1e-4);
+        require_near(quatf::slerp(quatf::identity(), z90, 0.5f), z45.to_array());
+        // constant angular speed, unlike nlerp
+        require_near(quatf::slerp(quatf::identity(), z90, 0.25f), z22.to_array());
+        // -q is the same rotation, both take the shorter arc
+        const quatf minus_z90(z90.native() ^ simdf4(-0.0f));
+        require_near(quatf::slerp(quatf::identity(), minus_z90, 0.5f), z45.to_array());
+        require_near(quatf::nlerp(quatf::identity(), minus_z90, 0.5f), z45.to_array(), 1e-4);
+        // nearly equal inputs use the linear fallback
+        const quatf tiny = quatf::from_axis_angle(vec3f{ 0, 1, 0 }, 1e-3f);
+        const quatf half = quatf::slerp(quatf::identity(), tiny, 0.5f);
+        require_near(half, quatf::from_axis_angle(vec3f{ 0, 1, 0 }, 5e-4f).to_array());
+    }
+}
+
+TEST_CASE("quatf4")
+{
+    std::array<quatf, 4> a, b;
+    for (int i = 0; i < 4; ++i) {
+        a[i] = test_rotation(i);
+        b[i] = test_rotation(2 * i + 1);
+    }
+    // one pair with a negative dot product and one nearly equal pair
+    b[2] = quatf(a[2].native() ^ simdf4(-0.0f)) * test_rotation(5).normalize<simd_base::exact>();
+    b[3] = quatf::slerp(a[3], b[3], 1e-4f);
+    const quatf4 qa = quatf4::load(a.data());
+    const quatf4 qb = quatf4::load(b.data());
+    const simdf4 t(0.25f, 0.5f, 0.75f, 0.5f);
+    const auto ts = t.to_array();
+
+    SECTION("load / store")
+    {
+        std::array<quatf, 4> stored;
+        qa.store(stored.data());
+        for (size_t i = 0; i < 4; ++i)
+            REQUIRE(stored[i].to_array() == a[i].to_array());
+        REQUIRE(qa.x.to_array()[1] == a[1].to_array()[0]);
+        REQUIRE(qa.w.to_array()[2] == a[2].to_array()[3]);
+    }
+    SECTION("lane-wise like quatf")
+    {
+        std::array<quatf, 4> product, conjugate, normalized, nlerp, slerp;
+        (qa * qb).store(product.data());
+        qa.conjugate().store(conjugate.data());
+        quatf4{ qa.x * simdf4(3.0f), qa.y * simdf4(3.0f), qa.z * simdf4(3.0f), qa.w * simdf4(3.0f) }.normalize().store(normalized.data());
+        quatf4::nlerp(qa, qb, t).store(nlerp.data());
+        quatf4::slerp(qa, qb, t).store(slerp.data());
+        const auto dots = quatf4::dot(qa, qb).to_array();
+
+        vec3f points[4] = { { 1, 0, 0 }, { 0, 2, 0 }, { 0.5f, -1, 3 }, { -4, 0.25f, 1 } };
+        const vec3f translation[4] = { { 1, 2, 3 }, { 0, 0, 0 }, { -1, 0, 1 }, { 10, 20, 30 } };
+        vec3f rotated[4], transformed[4];
+        qa.rotate(vec3f4::load(points)).store(rotated);
+        qa.transform(vec3f4::load(points), vec3f4::load(translation)).store(transformed);
+
+        for (size_t i = 0; i < 4; ++i) {
+            require_near(product[i], (a[i] * b[i]).to_array());
+            require_near(conjugate[i], a[i].conjugate().to_array(), 0);
+            require_near(normalized[i], a[i].to_array(), 1e-4);
+            require_near(nlerp[i], quatf::nlerp(a[i], b[i], ts[i]).to_array(), 1e-4);
+            require_near(slerp[i], quatf::slerp(a[i], b[i], ts[i]).to_array(), 1e-5);
+            REQUIRE(dots[i] == Approx(quatf::dot(a[i], b[i])).margin(1e-6));
+            require_near(rotated[i], a[i].rotate(points[i]));
+            const vec3f r = a[i].transform(points[i], translation[i]);
+            require_near(transformed[i], r);
+        }
+    }
+}
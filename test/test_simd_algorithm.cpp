@@ -0,0 +1,114 @@
+#include "catch.hpp"
+
+#include "simd/aligned_allocator.hpp"
+#include "simd/simd_algorithm.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+TEST_CASE("simd algorithm")
+{
+    // sizes around the unrolled body, at every offset from an aligned address
+    const size_t sizes[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 33, 63, 64, 65, 100, 257 };
+    const size_t max_offset = 16;
+    aligned_vector<float> a(300 + max_offset), b(300 + max_offset);
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = static_cast<float>(i) - 100;
+        b[i] = static_cast<float>(i % 7);
+    }
+
+    SECTION("unary transform")
+    {
+        for (size_t size : sizes) {
+            for (size_t offset = 0; offset < max_offset; offset += 3) {
+                std::vector<float> output(size + 2, -1.0f);
+                simd_algorithm::transform(a.data() + offset, size, output.data() + 1, [](auto v) { return v * v; });
+                REQUIRE(output[0] == -1);
+                REQUIRE(output[size + 1] == -1);
+                for (size_t i = 0; i < size; ++i)
+                    REQUIRE(output[i + 1] == a[i + offset] * a[i + offset]);
+            }
+        }
+    }
+    SECTION("binary transform")
+    {
+        for (size_t size : sizes) {
+            for (size_t offset = 0; offset < max_offset; offset += 5) {
+                aligned_vector<float> output(b.begin(), b.end());
+                simd_algorithm::transform(a.data(), b.data() + offset, size, output.data() + offset,
+                    [](auto x, auto y) { return x.max(y); });
+                for (size_t i = 0; i < output.size(); ++i) {
+                    const bool inside = i >= offset && i < offset + size;
+                    REQUIRE(output[i] == (inside ? std::max(a[i - offset], b[i]) : b[i]));
+                }
+            }
+        }
+    }
+    SECTION("reduce")
+    {
+        for (size_t size : sizes) {
+            for (size_t offset = 0; offset < max_offset; offset += 3) {
+                const float* input = b.data() + offset;
+                const float sum = simd_algorithm::reduce(input, size, 0.0f, [](auto x, auto y) { return x + y; });
+                REQUIRE(sum == std::accumulate(input, input + size, 0.0f));
+                const float max = simd_algorithm::reduce(a.data() + offset, size, -std::numeric_limits<float>::infinity(),
+                    [](auto x, auto y) { return x.max(y); });
+                REQUIRE(max == (size == 0 ? -std::numeric_limits<float>::infinity() : a[offset + size - 1]));
+                // init is not the identity, it has to be applied exactly once
+                const float seeded = simd_algorithm::reduce(input, size, 10.0f, simd_algorithm::plus());
+                REQUIRE(seeded == std::accumulate(input, input + size, 10.0f));
+                const float capped = simd_algorithm::reduce(a.data() + offset, size, -90.0f, [](auto x, auto y) { return x.min(y); });
+                REQUIRE(capped == (size == 0 ? -90.0f : std::min(-90.0f, a[offset])));
+            }
+        }
+    }
+    SECTION("fill / copy")
+    {
+        for (size_t size : sizes) {
+            for (size_t offset = 0; offset < max_offset; offset += 7) {
+                std::vector<float> output(size + max_offset + 1, -1.0f);
+                simd_algorithm::fill(output.data() + offset, size, 2.0f);
+                for (size_t i = 0; i < output.size(); ++i)
+                    REQUIRE(output[i] == (i >= offset && i < offset + size ? 2.0f : -1.0f));
+                simd_algorithm::copy(a.data(), size, output.data() + offset);
+                REQUIRE(std::equal(a.begin(), a.begin() + size, output.begin() + offset));
+                REQUIRE(output[offset + size] == -1);
+            }
+        }
+    }
+    SECTION("uint16_t")
+    {
+        std::vector<uint16_t> values(1000);
+        std::iota(values.begin(), values.end(), uint16_t(0));
+        std::vector<uint16_t> output(values.size());
+        simd_algorithm::transform(values.data() + 1, 998, output.data() + 1, [](auto v) { return v + v; });
+        REQUIRE(output[0] == 0);
+        REQUIRE(output[998] == 1996);
+        REQUIRE(output[999] == 0);
+        const uint16_t sum = simd_algorithm::reduce(values.data() + 3, 100, uint16_t(0), [](auto x, auto y) { return x + y; });
+        REQUIRE(sum == 5250);
+        REQUIRE(simd_algorithm::reduce(values.data() + 3, 100, uint16_t(7), [](auto x, auto y) { return x + y; }) == 5257);
+        simd_algorithm::fill(output.data() + 5, 13, uint16_t(7));
+        REQUIRE(std::count(output.begin(), output.end(), 7) == 13);
+    }
+    SECTION("integer lanes")
+    {
+        std::vector<int32_t> ints(100);
+        std::iota(ints.begin(), ints.end(), -50);
+        simd_algorithm::transform(ints.data(), ints.size(), ints.data(), [](auto v) { return v.abs(); });
+        REQUIRE(simd_algorithm::reduce(ints.data() + 1, ints.size() - 1, 0, [](auto x, auto y) { return x.max(y); }) == 49);
+        REQUIRE(ints[0] == 50);
+
+        std::vector<uint8_t> bytes(77, 200);
+        const uint8_t saturated = simd_algorithm::reduce(bytes.data(), bytes.size(), uint8_t(0), [](auto x, auto y) { return x.add_saturate(y); });
+        REQUIRE(saturated == 255);
+    }
+    SECTION("double lanes")
+    {
+        std::vector<double> values(101);
+        std::iota(values.begin(), values.end(), -50.0);
+        simd_algorithm::transform(values.data(), values.size(), values.data(), [](auto v) { return v * v; });
+        REQUIRE(simd_algorithm::reduce(values.data(), values.size(), 0.0, [](auto x, auto y) { return x + y; }) == 85850);
+    }
+}
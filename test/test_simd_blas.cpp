@@ -0,0 +1,151 @@
+#include "catch.hpp"
+#include "test_values.hpp"
+
+#include "simd/simd_blas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+using simd_blas::column_major;
+using simd_blas::no_transpose;
+using simd_blas::row_major;
+using simd_blas::transpose;
+
+const auto non_temporal = simd_base::cache_coherence::non_temporal;
+
+double reference_dot(size_t n, const float* x, const float* y)
+{
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i)
+        sum += double(x[i]) * y[i];
+    return sum;
+}
+
+/**
+    Runs sgemv on y with one element of padding on each side, which must stay untouched, and
+    compares it with a double precision reference.
+*/
+void check_gemv(simd_blas::layout order, simd_blas::operation op, size_t m, size_t n, float alpha, float beta,
+    simd_base::cache_coherence cache_flags = simd_base::cache_coherence::coherent)
+{
+    // op(A) is m x n, A is stored with 2 elements of padding per row / column
+    const bool by_rows = (order == row_major) != (op == transpose);
+    const size_t lda = (by_rows ? n : m) + 2;
+    const auto a = test_values(lda * (by_rows ? m : n), 1);
+    const auto x = test_values(n, 2);
+    auto y = test_values(m + 2, 3);
+    if (beta == 0.0f)
+        std::fill(y.begin() + 1, y.end() - 1, std::numeric_limits<float>::quiet_NaN());
+    const auto original = y;
+
+    simd_blas::sgemv(order, op, m, n, alpha, a.data(), lda, x.data(), beta, y.data() + 1, cache_flags);
+
+    for (size_t i = 0; i < m; ++i) {
+        double sum = 0;
+        for (size_t j = 0; j < n; ++j)
+            sum += (by_rows ? a[i * lda + j] : a[i + j * lda]) * double(x[j]);
+        const double expected = alpha * sum + (beta == 0.0f ? 0.0 : beta * double(original[i + 1]));
+        REQUIRE(y[i + 1] == Approx(expected).margin(1e-6 * double(n + 1)));
+    }
+    REQUIRE(y.front() == original.front());
+    REQUIRE(y.back() == original.back());
+}
+} // namespace
+
+/**
+    Calls check(n, offset) for every length up to a few registers, at every offset into an
+    aligned array.
+*/
+template <typename Check>
+void for_lengths_and_offsets(Check check)
+{
+    for (size_t offset = 0; offset < 4; ++offset) {
+        for (size_t n = 0; n < 140; n += n < 40 ? 1 : 33)
+            check(n, offset);
+    }
+}
+
+TEST_CASE("simd_blas level 1")
+{
+    const auto x = test_values(200, 1);
+    const auto y = test_values(200, 2);
+
+    SECTION("saxpy and sscal")
+    {
+        for_lengths_and_offsets([&](size_t n, size_t offset) {
+            for (auto cache_flags : { simd_base::cache_coherence::coherent, non_temporal }) {
+                auto result = y;
+                simd_blas::saxpy(n, -1.5f, x.data() + offset, result.data() + offset, cache_flags);
+                for (size_t i = 0; i < result.size(); ++i) {
+                    const bool inside = i >= offset && i < offset + n;
+                    REQUIRE(result[i] == Approx(inside ? -1.5 * double(x[i]) + y[i] : y[i]).margin(1e-6));
+                }
+                result = x;
+                simd_blas::sscal(n, 3.0f, result.data() + offset, cache_flags);
+                for (size_t i = 0; i < result.size(); ++i) {
+                    const bool inside = i >= offset && i < offset + n;
+                    REQUIRE(result[i] == (inside ? 3.0f * x[i] : x[i]));
+                }
+            }
+        });
+    }
+    SECTION("sdot and snrm2")
+    {
+        for_lengths_and_offsets([&](size_t n, size_t offset) {
+            const float* xs = x.data() + offset;
+            const float* ys = y.data() + offset;
+            // sums of n products of magnitude <= 1
+            REQUIRE(simd_blas::sdot(n, xs, ys) == Approx(reference_dot(n, xs, ys)).margin(1e-6 * double(n + 1)));
+            REQUIRE(simd_blas::snrm2(n, xs) == Approx(std::sqrt(reference_dot(n, xs, xs))).epsilon(1e-5).margin(1e-6));
+        });
+    }
+}
+
+TEST_CASE("snrm2 range")
+{
+    const float values[] = { 3, 0, -4, 0, 0 };
+    std::vector<float> x(values, values + 5);
+    REQUIRE(simd_blas::snrm2(5, x.data()) == 5);
+    REQUIRE(simd_blas::snrm2(0, x.data()) == 0);
+
+    // the squares overflow or underflow, the norm does not
+    for (float scale : { 1e30f, 1e-30f, 1e-40f }) {
+        for (size_t i = 0; i < x.size(); ++i)
+            x[i] = values[i] * scale;
+        REQUIRE(simd_blas::snrm2(5, x.data()) == Approx(5.0 * scale).epsilon(1e-5));
+    }
+    // multiples of the smallest denormal need the largest scale
+    for (size_t i = 0; i < x.size(); ++i)
+        x[i] = values[i] * std::numeric_limits<float>::denorm_min();
+    REQUIRE(simd_blas::snrm2(5, x.data()) == 5 * std::numeric_limits<float>::denorm_min());
+    x[1] = std::numeric_limits<float>::infinity();
+    REQUIRE(simd_blas::snrm2(5, x.data()) == std::numeric_limits<float>::infinity());
+    x[1] = std::numeric_limits<float>::quiet_NaN();
+    REQUIRE(std::isnan(simd_blas::snrm2(5, x.data())));
+}
+
+TEST_CASE("sgemv")
+{
+    SECTION("layouts and transposes")
+    {
+        for (auto order : { row_major, column_major }) {
+            for (auto op : { no_transpose, transpose }) {
+                for (size_t m : { 1, 3, 4, 7, 37, 70 }) {
+                    for (size_t n : { 1, 5, 16, 45 }) {
+                        check_gemv(order, op, m, n, 1.0f, 0.0f);
+                        check_gemv(order, op, m, n, -0.5f, 2.0f);
+                    }
+                }
+            }
+        }
+    }
+    SECTION("non-temporal y")
+    {
+        check_gemv(column_major, no_transpose, 301, 17, 1.0f, 0.0f, non_temporal);
+        check_gemv(row_major, transpose, 301, 17, 2.0f, 1.0f, non_temporal);
+        check_gemv(row_major, no_transpose, 33, 17, 2.0f, 1.0f, non_temporal);
+    }
+}
@@ -0,0 +1,105 @@
+#include "catch.hpp"
+
+#include "simd/simd_convert.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace simd_convert;
+
+TEST_CASE("simd convert")
+{
+    SECTION("float / integer")
+    {
+        const simdf4 f{ -2.5f, 1.5f, 2.5f, -7.75f };
+        REQUIRE(convert<simdi32x4>(f).to_array() == std::array<int32_t, 4>{ -2, 1, 2, -7 });
+        REQUIRE(convert_nearest<simdi32x4>(f).to_array() == std::array<int32_t, 4>{ -2, 2, 2, -8 });
+        REQUIRE(convert_nearest<simdi32x4>(simdf4{ 16777216.0f, -1e9f, 0.5f, -0.5f }).to_array() == std::array<int32_t, 4>{ 16777216, -1000000000, 0, 0 });
+
+        const simdf4 u{ 3e9f, 2147483648.0f, 0.75f, -5.0f };
+        REQUIRE(convert<simdu32x4>(u).to_array() == std::array<uint32_t, 4>{ 3000000000u, 2147483648u, 0, 0 });
+        REQUIRE(convert_nearest<simdu32x4>(simdf4{ 4294967040.0f, 2.5f, 3.5f, 0.75f }).to_array() == std::array<uint32_t, 4>{ 4294967040u, 2, 4, 1 });
+
+        REQUIRE(convert<simdf4>(simdi32x4{ -1, 0, 16777217, std::numeric_limits<int32_t>::min() }).to_array() == std::array<float, 4>{ -1, 0, 16777216.0f, -2147483648.0f });
+        REQUIRE(convert<simdf4>(simdu32x4{ 0xffffffffu, 0x80000001u, 16777217u, 65536u }).to_array() == std::array<float, 4>{ 4294967296.0f, 2147483648.0f, 16777216.0f, 65536.0f });
+        // 0x01000003 is between 0x01000002 and 0x01000004 and has to round to even once
+        REQUIRE(convert<simdf4>(simdu32x4{ 0x01000003u, 0x00ffffffu, 0x7fffffc0u, 1u }).to_array()
+            == std::array<float, 4>{ 16777220.0f, 16777215.0f, 2147483648.0f, 1.0f });
+    }
+    SECTION("signedness")
+    {
+        REQUIRE(convert<simdu32x4>(simdi32x4{ -1, 0, 1, std::numeric_limits<int32_t>::min() }).to_array() == std::array<uint32_t, 4>{ 0xffffffffu, 0, 1, 0x80000000u });
+        REQUIRE(convert<simdi32x4>(simdu32x4{ 0xfffffffeu, 7, 0, 0x80000000u }).to_array() == std::array<int32_t, 4>{ -2, 7, 0, std::numeric_limits<int32_t>::min() });
+        REQUIRE(convert<simdu16x8>(simdi16x8{ -1, 0, 1, -32768, 32767, 2, 3, 4 }).to_array() == std::array<uint16_t, 8>{ 0xffff, 0, 1, 0x8000, 0x7fff, 2, 3, 4 });
+        REQUIRE(convert<simdi16x8>(simdu16x8{ 0xffff, 0, 1, 0x8000, 0x7fff, 2, 3, 4 }).to_array() == std::array<int16_t, 8>{ -1, 0, 1, -32768, 32767, 2, 3, 4 });
+    }
+    SECTION("widen")
+    {
+        std::array<uint8_t, 16> bytes;
+        for (size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = static_cast<uint8_t>(250 + i);
+        const simdu8x16 b(bytes.data());
+        const auto low = widen_low(b).to_array();
+        const auto high = widen_high(b).to_array();
+        for (size_t i = 0; i < 8; ++i) {
+            REQUIRE(low[i] == bytes[i]);
+            REQUIRE(high[i] == bytes[i + 8]);
+        }
+
+        const simdu16x8 words{ 0, 1, 0x7fff, 0x8000, 0xffff, 2, 3, 65000 };
+        REQUIRE(widen_low(words).to_array() == std::array<uint32_t, 4>{ 0, 1, 0x7fff, 0x8000 });
+        REQUIRE(widen_high(words).to_array() == std::array<uint32_t, 4>{ 0xffff, 2, 3, 65000 });
+
+        const simdi16x8 shorts{ 0, -1, 32767, -32768, 5, -6, 7, -8 };
+        REQUIRE(widen_low(shorts).to_array() == std::array<int32_t, 4>{ 0, -1, 32767, -32768 });
+        REQUIRE(widen_high(shorts).to_array() == std::array<int32_t, 4>{ 5, -6, 7, -8 });
+
+        const simdf4 f{ 0.1f, -2, 3e38f, 4 };
+        REQUIRE(widen_low(f).to_array() == std::array<double, 2>{ double(0.1f), -2 });
+        REQUIRE(widen_high(f).to_array() == std::array<double, 2>{ double(3e38f), 4 });
+
+        // u8 to float through u16 and u32
+        REQUIRE(convert<simdf4>(widen_low(widen_high(b))).to_array() == std::array<float, 4>{ 2, 3, 4, 5 });
+    }
+    SECTION("narrow")
+    {
+        const simdi32x4 a{ -70000, -32769, -32768, 0 };
+        const simdi32x4 b{ 1, 32767, 32768, 70000 };
+        REQUIRE(narrow_saturate<simdi16x8>(a, b).to_array() == std::array<int16_t, 8>{ -32768, -32768, -32768, 0, 1, 32767, 32767, 32767 });
+        REQUIRE(narrow_saturate<simdu16x8>(a, b).to_array() == std::array<uint16_t, 8>{ 0, 0, 0, 0, 1, 32767, 32768, 65535 });
+        REQUIRE(narrow_saturate<simdu16x8>(simdi32x4{ 65535, 65536, std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::min() }, b).to_array()
+            == std::array<uint16_t, 8>{ 65535, 65535, 65535, 0, 1, 32767, 32768, 65535 });
+
+        const simdu32x4 ua{ 0, 65535, 65536, 0xffffffffu };
+        const simdu32x4 ub{ 0x80000000u, 40000, 1, 0x8000u };
+        REQUIRE(narrow_saturate<simdu16x8>(ua, ub).to_array() == std::array<uint16_t, 8>{ 0, 65535, 65535, 65535, 65535, 40000, 1, 0x8000 });
+
+        const simdi16x8 s{ -32768, -1, 0, 1, 127, 128, 255, 256 };
+        REQUIRE(narrow_saturate<simdu8x16>(s, simdi16x8{ 32767 }).to_array()
+            == std::array<uint8_t, 16>{ 0, 0, 0, 1, 127, 128, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255 });
+
+        const simdu16x8 w{ 0, 1, 254, 255, 256, 0x7fff, 0x8000, 0xffff };
+        REQUIRE(narrow_saturate<simdu8x16>(w, simdu16x8{ 3 }).to_array()
+            == std::array<uint8_t, 16>{ 0, 1, 254, 255, 255, 255, 255, 255, 3, 3, 3, 3, 3, 3, 3, 3 });
+    }
+    SECTION("round trip")
+    {
+        std::array<uint8_t, 16> bytes;
+        for (size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = static_cast<uint8_t>(i * 17);
+        const simdu8x16 b(bytes.data());
+        const simdu16x8 lo = widen_low(b);
+        const simdu16x8 hi = widen_high(b);
+        const simdf4 f0 = convert<simdf4>(widen_low(lo)) * simdf4(1.5f);
+        const simdf4 f1 = convert<simdf4>(widen_high(lo)) * simdf4(1.5f);
+        const simdf4 f2 = convert<simdf4>(widen_low(hi)) * simdf4(1.5f);
+        const simdf4 f3 = convert<simdf4>(widen_high(hi)) * simdf4(1.5f);
+        const simdi16x8 s0 = narrow_saturate<simdi16x8>(convert_nearest<simdi32x4>(f0), convert_nearest<simdi32x4>(f1));
+        const simdi16x8 s1 = narrow_saturate<simdi16x8>(convert_nearest<simdi32x4>(f2), convert_nearest<simdi32x4>(f3));
+        const auto result = narrow_saturate<simdu8x16>(s0, s1).to_array();
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            const float scaled = std::nearbyint(bytes[i] * 1.5f);
+            REQUIRE(result[i] == (scaled > 255 ? 255 : static_cast<uint8_t>(scaled)));
+        }
+    }
+}
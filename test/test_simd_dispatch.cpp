@@ -0,0 +1,167 @@
+#include "catch.hpp"
+#include "test_values.hpp"
+
+#include "simd/dispatch/native_kernels.hpp"
+#include "simd/simd_blas.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+const cpu_features sse_cpu(cpu_features::sse2);
+const cpu_features avx2_cpu(cpu_features::sse2 | cpu_features::sse3 | cpu_features::ssse3 | cpu_features::sse4_1
+    | cpu_features::avx | cpu_features::avx2 | cpu_features::fma);
+const cpu_features avx512_cpu(avx2_cpu.flags() | cpu_features::avx512f | cpu_features::avx512dq | cpu_features::avx512bw
+    | cpu_features::avx512vl);
+
+/**
+    The kernel tables the running CPU can execute, with their level.
+*/
+std::vector<std::pair<simd_isa, simd_dispatch::float_kernels>> supported_tables()
+{
+    std::vector<std::pair<simd_isa, simd_dispatch::float_kernels>> tables{ { compiled_isa(), native_float_kernels() } };
+#if defined(SIMD_DISPATCH) && defined(SIMD_BACKEND_X86)
+    const auto& cpu = cpu_features::instance();
+    if (cpu.supports(simd_isa::avx2))
+        tables.push_back({ simd_isa::avx2, simd_dispatch::avx2_kernels() });
+    if (cpu.supports(simd_isa::avx512))
+        tables.push_back({ simd_isa::avx512, simd_dispatch::avx512_kernels() });
+#endif
+    return tables;
+}
+
+double reference_dot(size_t n, const float* x, const float* y)
+{
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i)
+        sum += double(x[i]) * y[i];
+    return sum;
+}
+} // namespace
+
+TEST_CASE("simd dispatch")
+{
+    const auto native_sdot = &simd_blas::priv::sdot_kernel;
+
+    SECTION("fallback")
+    {
+        // a CPU without the wider levels gets the kernels of the calling translation unit
+        REQUIRE(simd_dispatch::kernel_isa(compiled_isa(), cpu_features(0)) == compiled_isa());
+        REQUIRE(simd_dispatch::kernel_isa(compiled_isa(), sse_cpu) == compiled_isa());
+        REQUIRE(simd_dispatch::select(compiled_isa(), native_sdot, &simd_dispatch::float_kernels::sdot, cpu_features(0)) == native_sdot);
+        REQUIRE(simd_dispatch::select(compiled_isa(), native_sdot, &simd_dispatch::float_kernels::sdot, sse_cpu) == native_sdot);
+        REQUIRE(simd_dispatch::select(compiled_isa(), &simd_algorithm::priv::reduce_entry<simd_algorithm::plus>,
+                    &simd_dispatch::float_kernels::reduce, simd_dispatch::plus_op, sse_cpu)
+            == &simd_algorithm::priv::reduce_entry<simd_algorithm::plus>);
+
+        // the tables are only touched when the running CPU can execute them
+        const auto& cpu = cpu_features::instance();
+        if (cpu.supports(simd_isa::avx2)) {
+            const simd_isa expected = simd_dispatch::enabled && compiled_isa() < simd_isa::avx2 ? simd_isa::avx2 : compiled_isa();
+            REQUIRE(simd_dispatch::kernel_isa(compiled_isa(), avx2_cpu) == expected);
+#if defined(SIMD_DISPATCH) && defined(SIMD_BACKEND_X86)
+            // forced down from AVX-512 on a machine that has it
+            const auto avx2_sdot = simd_dispatch::select(compiled_isa(), native_sdot, &simd_dispatch::float_kernels::sdot, avx2_cpu);
+            REQUIRE(avx2_sdot == (compiled_isa() < simd_isa::avx2 ? simd_dispatch::avx2_kernels().sdot : native_sdot));
+            if (compiled_isa() < simd_isa::avx512 && cpu.supports(simd_isa::avx512))
+                REQUIRE(avx2_sdot != simd_dispatch::avx512_kernels().sdot);
+#endif
+        }
+        if (cpu.supports(simd_isa::avx512)) {
+            const simd_isa expected = simd_dispatch::enabled && compiled_isa() < simd_isa::avx512 ? simd_isa::avx512 : compiled_isa();
+            REQUIRE(simd_dispatch::kernel_isa(compiled_isa(), avx512_cpu) == expected);
+#if defined(SIMD_DISPATCH) && defined(SIMD_BACKEND_X86)
+            REQUIRE(simd_dispatch::select(compiled_isa(), native_sdot, &simd_dispatch::float_kernels::sdot, avx512_cpu)
+                == (compiled_isa() < simd_isa::avx512 ? simd_dispatch::avx512_kernels().sdot : native_sdot));
+#endif
+        }
+        // a level at or above the variants keeps its own kernels
+        REQUIRE(simd_dispatch::kernel_isa(simd_isa::avx512, cpu) == simd_isa::avx512);
+        REQUIRE(simd_dispatch::kernel_isa(compiled_isa(), cpu) >= compiled_isa());
+    }
+    SECTION("kernels agree")
+    {
+        const size_t n = 1000;
+        const auto x = test_values(n + 1, 1);
+        const auto y = test_values(n + 1, 2);
+        for (const auto& table : supported_tables()) {
+            INFO("level " << int(table.first));
+            const auto& k = table.second;
+            // offset by one to start off the register alignment
+            const float* xs = x.data() + 1;
+            const float* ys = y.data() + 1;
+
+            REQUIRE(k.sdot(n, xs, ys) == Approx(reference_dot(n, xs, ys)).margin(1e-4));
+            REQUIRE(k.snrm2(n, xs) == Approx(std::sqrt(reference_dot(n, xs, xs))));
+
+            double sum = 0;
+            float largest = xs[0];
+            for (size_t i = 0; i < n; ++i) {
+                sum += xs[i];
+                largest = std::max(largest, xs[i]);
+            }
+            REQUIRE(k.reduce[simd_dispatch::plus_op](xs, n, 0.0f) == Approx(sum).margin(1e-4));
+            REQUIRE(k.reduce[simd_dispatch::maximum_op](xs, n, -1.0f) == largest);
+
+            std::vector<float> out(n);
+            k.transform[simd_dispatch::absolute_op](xs, n, out.data());
+            for (size_t i = 0; i < n; ++i)
+                REQUIRE(out[i] == std::abs(xs[i]));
+            k.transform_binary[simd_dispatch::multiplies_op](xs, ys, n, out.data());
+            for (size_t i = 0; i < n; ++i)
+                REQUIRE(out[i] == xs[i] * ys[i]);
+
+            out.assign(ys, ys + n);
+            k.saxpy(n, 2.0f, xs, out.data(), false);
+            for (size_t i = 0; i < n; ++i)
+                REQUIRE(out[i] == Approx(2.0f * xs[i] + ys[i]).margin(1e-6));
+
+            // column-major 7 x 5 = (9 x 7)^T * 9 x 5
+            const size_t rows = 7, columns = 5, depth = 9;
+            std::vector<float> c(rows * columns);
+            k.sgemm(rows, columns, depth, 1.0f, xs, depth, true, ys, depth, false, 0.0f, c.data(), rows);
+            for (size_t i = 0; i < rows; ++i) {
+                for (size_t j = 0; j < columns; ++j)
+                    REQUIRE(c[i + j * rows] == Approx(reference_dot(depth, xs + i * depth, ys + j * depth)).margin(1e-5));
+            }
+            k.sgemv(true, rows, depth, 1.0f, xs, depth, ys, 0.0f, c.data(), false);
+            for (size_t i = 0; i < rows; ++i)
+                REQUIRE(c[i] == Approx(reference_dot(depth, xs + i * depth, ys)).margin(1e-5));
+        }
+    }
+    SECTION("entry points")
+    {
+        const size_t n = 333;
+        const auto x = test_values(n, 3);
+        const auto y = test_values(n, 4);
+
+        // the public functions run the kernel selected for this machine
+        const auto sdot = simd_dispatch::select(compiled_isa(), native_sdot, &simd_dispatch::float_kernels::sdot);
+        REQUIRE(simd_blas::sdot(n, x.data(), y.data()) == sdot(n, x.data(), y.data()));
+        const auto sum = simd_dispatch::select(compiled_isa(), &simd_algorithm::priv::reduce_entry<simd_algorithm::plus>,
+            &simd_dispatch::float_kernels::reduce, simd_dispatch::plus_op);
+        REQUIRE(simd_algorithm::reduce(x.data(), n, 0.0f, simd_algorithm::plus()) == sum(x.data(), n, 0.0f));
+
+        std::vector<float> out(n);
+        simd_algorithm::transform(x.data(), n, out.data(), simd_algorithm::absolute());
+        simd_algorithm::transform(out.data(), n, out.data(), simd_algorithm::square_root());
+        for (size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == std::sqrt(std::abs(x[i])));
+        simd_algorithm::transform(x.data(), y.data(), n, out.data(), simd_algorithm::minimum());
+        for (size_t i = 0; i < n; ++i)
+            REQUIRE(out[i] == std::min(x[i], y[i]));
+
+        // other element types take the kernels of the compile flags
+        std::vector<int32_t> values(n);
+        int32_t expected = 0;
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = int32_t(i % 17) - 8;
+            expected += values[i];
+        }
+        REQUIRE(simd_algorithm::reduce(values.data(), n, 0, simd_algorithm::plus()) == expected);
+        REQUIRE(simd_algorithm::reduce(values.data(), n, -100, simd_algorithm::maximum()) == 8);
+    }
+}
@@ -0,0 +1,105 @@
+#include "catch.hpp"
+#include "test_values.hpp"
+
+#include "simd/simd_gemm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace {
+using simd_blas::column_major;
+using simd_blas::no_transpose;
+using simd_blas::row_major;
+using simd_blas::transpose;
+
+/**
+    Element (row, column) of op(X), with X stored in the given layout and leading dimension.
+*/
+double element(const std::vector<float>& x, simd_blas::layout order, simd_blas::operation op, size_t ld, size_t row, size_t column)
+{
+    if (op == transpose)
+        std::swap(row, column);
+    return order == row_major ? x[row * ld + column] : x[row + column * ld];
+}
+size_t index(simd_blas::layout order, size_t ld, size_t row, size_t column)
+{
+    return order == row_major ? row * ld + column : row + column * ld;
+}
+
+/**
+    Runs sgemm and compares C with a double precision reference, including the padding between
+    the rows / columns of C, which must stay untouched.
+*/
+void check_gemm(simd_blas::layout order, simd_blas::operation op_a, simd_blas::operation op_b,
+    size_t m, size_t n, size_t k, float alpha, float beta, size_t padding = 0)
+{
+    // op(A) is m x k, op(B) k x n, stored with `padding` extra elements per row / column
+    const bool a_rows = (order == row_major) != (op_a == transpose);
+    const bool b_rows = (order == row_major) != (op_b == transpose);
+    const size_t lda = (a_rows ? k : m) + padding;
+    const size_t ldb = (b_rows ? n : k) + padding;
+    const size_t ldc = (order == row_major ? n : m) + padding;
+    const auto a = test_values(lda * (a_rows ? m : k), 1);
+    const auto b = test_values(ldb * (b_rows ? k : n), 2);
+    auto c = test_values(ldc * (order == row_major ? m : n), 3);
+    if (beta == 0.0f)
+        std::fill(c.begin(), c.end(), std::numeric_limits<float>::quiet_NaN());
+    const auto original = c;
+
+    simd_blas::sgemm(order, op_a, op_b, m, n, k, alpha, a.data(), lda, b.data(), ldb, beta, c.data(), ldc);
+
+    std::vector<bool> in_matrix(c.size(), false);
+    for (size_t i = 0; i < m; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            double sum = 0;
+            for (size_t p = 0; p < k; ++p)
+                sum += element(a, order, op_a, lda, i, p) * element(b, order, op_b, ldb, p, j);
+            const size_t at = index(order, ldc, i, j);
+            const double expected = alpha * sum + (beta == 0.0f ? 0.0 : beta * double(original[at]));
+            // float accumulation of k products of magnitude <= 1
+            REQUIRE(c[at] == Approx(expected).margin(1e-6 * double(k + 1)));
+            in_matrix[at] = true;
+        }
+    }
+    for (size_t i = 0; i < c.size(); ++i) {
+        if (!in_matrix[i])
+            REQUIRE((c[i] == original[i] || (std::isnan(c[i]) && std::isnan(original[i]))));
+    }
+}
+} // namespace
+
+TEST_CASE("sgemm")
+{
+    SECTION("layouts and transposes")
+    {
+        for (auto order : { row_major, column_major }) {
+            for (auto op_a : { no_transpose, transpose }) {
+                for (auto op_b : { no_transpose, transpose })
+                    check_gemm(order, op_a, op_b, 37, 29, 23, 1.0f, 0.0f, 3);
+            }
+        }
+    }
+    SECTION("sizes around the tiles and blocks")
+    {
+        // 1, the register tile edges, and k across two depth blocks
+        check_gemm(column_major, no_transpose, no_transpose, 1, 1, 1, 1.0f, 0.0f);
+        check_gemm(column_major, no_transpose, no_transpose, 8, 6, 5, 1.0f, 0.0f);
+        check_gemm(column_major, no_transpose, no_transpose, 32, 12, 7, 1.0f, 0.0f);
+        check_gemm(column_major, no_transpose, no_transpose, 33, 13, 300, 1.0f, 0.5f);
+        check_gemm(row_major, transpose, no_transpose, 150, 400, 9, 1.0f, 0.0f);
+        check_gemm(row_major, no_transpose, transpose, 70, 70, 513, -1.0f, 1.0f, 1);
+    }
+    SECTION("alpha and beta")
+    {
+        check_gemm(row_major, no_transpose, no_transpose, 17, 19, 21, 2.5f, 0.0f);
+        check_gemm(row_major, no_transpose, no_transpose, 17, 19, 21, -0.5f, 2.0f);
+        check_gemm(column_major, transpose, transpose, 17, 19, 21, 1.0f, -1.0f);
+        // alpha = 0 or k = 0 only scale C, beta = 0 overwrites NaN
+        check_gemm(row_major, no_transpose, no_transpose, 9, 10, 11, 0.0f, 3.0f);
+        check_gemm(row_major, no_transpose, no_transpose, 9, 10, 0, 1.0f, 0.5f);
+        check_gemm(column_major, no_transpose, no_transpose, 9, 10, 0, 1.0f, 0.0f);
+    }
+}
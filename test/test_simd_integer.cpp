@@ -0,0 +1,250 @@
+#include "catch.hpp"
+
+#include "simd/simdi16x8.hpp"
+#include "simd/simdi32x4.hpp"
+#include "simd/simdu16x8.hpp"
+#include "simd/simdu32x4.hpp"
+#include "simd/simdu8x16.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace {
+/**
+    Edge values of T followed by pseudo random ones.
+*/
+template <typename T>
+std::vector<T> test_values()
+{
+    using limits = std::numeric_limits<T>;
+    std::vector<T> result = { 0, 1, 2, 3, 7, limits::max(), static_cast<T>(limits::max() - 1), limits::min(),
+        static_cast<T>(limits::min() + 1), static_cast<T>(limits::max() / 2), static_cast<T>(limits::max() / 2 + 1),
+        static_cast<T>(-1), static_cast<T>(-2), static_cast<T>(-100) };
+    uint32_t state = 12345;
+    while (result.size() < 256) {
+        state = state * 1664525u + 1013904223u;
+        result.push_back(static_cast<T>(state >> 7));
+    }
+    return result;
+}
+
+template <typename T>
+T clamp_to(int64_t value)
+{
+    return static_cast<T>(std::min<int64_t>(std::max<int64_t>(value, std::numeric_limits<T>::min()), std::numeric_limits<T>::max()));
+}
+
+template <typename T>
+T mulhi_reference(T a, T b)
+{
+    constexpr int bits = sizeof(T) * 8;
+    if (std::is_signed<T>::value)
+        return static_cast<T>((static_cast<int64_t>(a) * static_cast<int64_t>(b)) >> bits);
+    return static_cast<T>((static_cast<uint64_t>(a) * static_cast<uint64_t>(b)) >> bits);
+}
+
+// operator+ and operator- of simdu16x8 saturate, the other integer types wrap
+template <typename V>
+V add_wrap(const V& a, const V& b)
+{
+    return a + b;
+}
+template <typename V>
+V subtract_wrap(const V& a, const V& b)
+{
+    return a - b;
+}
+template <>
+simdu16x8 add_wrap(const simdu16x8& a, const simdu16x8& b)
+{
+    return a.add_wrap(b);
+}
+template <>
+simdu16x8 subtract_wrap(const simdu16x8& a, const simdu16x8& b)
+{
+    return a.subtract_wrap(b);
+}
+} // namespace
+
+TEMPLATE_TEST_CASE("simd integer", "", simdi32x4, simdu32x4, simdi16x8, simdu16x8, simdu8x16)
+{
+    using V = TestType;
+    using T = typename V::type;
+    using U = typename std::make_unsigned<T>::type;
+    constexpr size_t N = V::value_count;
+    constexpr int bits = sizeof(T) * 8;
+    const auto values = test_values<T>();
+
+    // every lane of every operation is compared against the scalar result
+    auto check = [&](auto simd_op, auto scalar_op) {
+        for (size_t offset = 0; offset + 2 * N <= values.size(); offset += 3) {
+            const V a(&values[offset]);
+            const V b(&values[values.size() - offset - N]);
+            const auto lanes_a = a.to_array();
+            const auto lanes_b = b.to_array();
+            const auto result = V(simd_op(a, b)).to_array();
+            for (size_t i = 0; i < N; ++i) {
+                INFO("a = " << +lanes_a[i] << ", b = " << +lanes_b[i]);
+                REQUIRE(+result[i] == +static_cast<T>(scalar_op(lanes_a[i], lanes_b[i])));
+            }
+        }
+    };
+
+    SECTION("load and store")
+    {
+        alignas(16) std::array<T, N> lanes;
+        V(&values[1]).store_aligned(lanes.data());
+        REQUIRE(std::equal(lanes.begin(), lanes.end(), &values[1]));
+        REQUIRE(V::load_aligned(lanes.data()).to_array() == lanes);
+        REQUIRE(V(values[5]).to_array()[N - 1] == values[5]);
+        for (size_t count = 0; count <= N; ++count) {
+            std::array<T, N + 1> output;
+            output.fill(T(42));
+            V::load_partial(&values[3], count).store_partial(output.data(), count);
+            for (size_t i = 0; i < N; ++i)
+                REQUIRE(+output[i] == +(i < count ? values[3 + i] : T(42)));
+            REQUIRE(output[N] == T(42));
+            const auto loaded = V::load_partial(&values[3], count).to_array();
+            for (size_t i = count; i < N; ++i)
+                REQUIRE(loaded[i] == T(0));
+        }
+    }
+    SECTION("arithmetic")
+    {
+        check([](V a, V b) { return add_wrap(a, b); }, [](T a, T b) { return static_cast<U>(static_cast<U>(a) + static_cast<U>(b)); });
+        check([](V a, V b) { return subtract_wrap(a, b); }, [](T a, T b) { return static_cast<U>(static_cast<U>(a) - static_cast<U>(b)); });
+        check([](V a, V b) { return a.add_saturate(b); }, [](T a, T b) { return clamp_to<T>(int64_t(a) + int64_t(b)); });
+        check([](V a, V b) { return a.subtract_saturate(b); }, [](T a, T b) { return clamp_to<T>(int64_t(a) - int64_t(b)); });
+        check([](V a, V b) { return a * b; }, [](T a, T b) { return static_cast<U>(uint64_t(a) * uint64_t(b)); });
+        check([](V a, V b) { return a.mulhi(b); }, [](T a, T b) { return mulhi_reference(a, b); });
+        check([](V a, V b) { return a.avg(b); }, [](T a, T b) { return (int64_t(a) + int64_t(b) + 1) >> 1; });
+        check([](V a, V b) { return a.min(b); }, [](T a, T b) { return std::min(a, b); });
+        check([](V a, V b) { return a.max(b); }, [](T a, T b) { return std::max(a, b); });
+
+        V sum(T(1));
+        sum += V(T(2));
+        sum -= V(T(1));
+        sum *= V(T(3));
+        REQUIRE(sum.to_array()[0] == T(6));
+    }
+    SECTION("reductions")
+    {
+        using S = decltype(V().sum());
+        for (size_t offset = 0; offset + N <= values.size(); offset += 5) {
+            const V a(&values[offset]);
+            S sum = 0;
+            T low = values[offset], high = values[offset];
+            U product = 1, all = static_cast<U>(~U(0)), any = 0;
+            for (size_t i = 0; i < N; ++i) {
+                const T value = values[offset + i];
+                sum = static_cast<S>(sum + value);
+                low = std::min(low, value);
+                high = std::max(high, value);
+                product = static_cast<U>(uint64_t(product) * uint64_t(static_cast<U>(value)));
+                all = static_cast<U>(all & static_cast<U>(value));
+                any = static_cast<U>(any | static_cast<U>(value));
+            }
+            INFO("offset = " << offset);
+            REQUIRE(a.sum() == sum);
+            REQUIRE(+a.reduce_min() == +low);
+            REQUIRE(+a.reduce_max() == +high);
+            REQUIRE(+a.reduce_product() == +static_cast<T>(product));
+            REQUIRE(+a.reduce_and() == +static_cast<T>(all));
+            REQUIRE(+a.reduce_or() == +static_cast<T>(any));
+        }
+        REQUIRE(sizeof(S) > sizeof(T));
+        REQUIRE(V(std::numeric_limits<T>::max()).sum() == S(N) * std::numeric_limits<T>::max());
+        REQUIRE(V(std::numeric_limits<T>::min()).sum() == S(N) * std::numeric_limits<T>::min());
+    }
+    SECTION("bitwise and shifts")
+    {
+        check([](V a, V b) { return a & b; }, [](T a, T b) { return a & b; });
+        check([](V a, V b) { return a | b; }, [](T a, T b) { return a | b; });
+        check([](V a, V b) { return a ^ b; }, [](T a, T b) { return a ^ b; });
+        check([](V a, V) { return ~a; }, [](T a, T) { return ~a; });
+        check([](V a, V) { return a.template shift_left<0>(); }, [](T a, T) { return a; });
+        check([](V a, V) { return a.template shift_left<3>(); }, [](T a, T) { return static_cast<U>(static_cast<U>(a) << 3); });
+        check([](V a, V) { return a.template shift_left<bits - 1>(); }, [](T a, T) { return static_cast<U>(static_cast<U>(a) << (bits - 1)); });
+        check([](V a, V) { return a.template shift_right<0>(); }, [](T a, T) { return a; });
+        check([](V a, V) { return a.template shift_right<3>(); }, [](T a, T) { return a >> 3; });
+        check([](V a, V) { return a.template shift_right<bits - 1>(); }, [](T a, T) { return a >> (bits - 1); });
+
+        const V count_mask(static_cast<T>(bits - 1));
+        check([&](V a, V b) { return a.shift_left(b & count_mask); }, [](T a, T b) { return static_cast<U>(static_cast<U>(a) << (b & (bits - 1))); });
+        check([&](V a, V b) { return a.shift_right(b & count_mask); }, [](T a, T b) { return a >> (b & (bits - 1)); });
+    }
+    SECTION("compare and select")
+    {
+        using flags = simd_base::compare_flags;
+        for (size_t offset = 0; offset + 2 * N <= values.size(); offset += 5) {
+            const V a(&values[offset]);
+            const V b(&values[offset + N / 2]);
+            const auto lanes_a = a.to_array();
+            const auto lanes_b = b.to_array();
+            uint32_t equal = 0, lower = 0, lower_equal = 0;
+            for (size_t i = 0; i < N; ++i) {
+                equal |= uint32_t(lanes_a[i] == lanes_b[i]) << i;
+                lower |= uint32_t(lanes_a[i] < lanes_b[i]) << i;
+                lower_equal |= uint32_t(lanes_a[i] <= lanes_b[i]) << i;
+            }
+            const uint32_t all = (1u << N) - 1;
+            REQUIRE(a.compare(b, flags::equal).movemask() == equal);
+            REQUIRE(a.compare(b, flags::lower).movemask() == lower);
+            REQUIRE(a.compare(b, flags::lower_equal).movemask() == lower_equal);
+            REQUIRE(a.compare(b, flags::greater).movemask() == (~lower_equal & all));
+            REQUIRE(a.compare(b, flags::greater_equal).movemask() == (~lower & all));
+            REQUIRE(a.compare(b, flags::not_equal).movemask() == (~equal & all));
+            REQUIRE(V::select(a.compare(b, flags::lower), a, b).to_array() == a.min(b).to_array());
+        }
+    }
+    SECTION("mask")
+    {
+        using mask = typename V::mask_type;
+        const uint32_t all = (1u << N) - 1;
+        for (uint32_t bits_set : { 0u, 1u, 5u, 0x80u & all, all, all - 1, 0x5555u & all }) {
+            const mask m = mask::from_bits(bits_set);
+            REQUIRE(m.movemask() == bits_set);
+            REQUIRE(m.any() == (bits_set != 0));
+            REQUIRE(m.all() == (bits_set == all));
+            REQUIRE(m.none() == (bits_set == 0));
+            REQUIRE(m.popcount() == priv::popcount(bits_set));
+            REQUIRE((~m).movemask() == (~bits_set & all));
+            REQUIRE((m & mask::from_bits(3)).movemask() == (bits_set & 3));
+            REQUIRE((m | mask::from_bits(3)).movemask() == (bits_set | 3));
+            REQUIRE((m ^ mask::from_bits(3)).movemask() == (bits_set ^ 3));
+            for (size_t i = 0; i < N; ++i)
+                REQUIRE(m[i] == (((bits_set >> i) & 1) != 0));
+            const auto selected = V::select(m, V(T(1)), V(T(2))).to_array();
+            for (size_t i = 0; i < N; ++i)
+                REQUIRE(selected[i] == T(((bits_set >> i) & 1) ? 1 : 2));
+        }
+        for (size_t count = 0; count <= N + 1; ++count)
+            REQUIRE(mask::first(count).movemask() == (count >= N ? all : (1u << count) - 1));
+        REQUIRE(mask().none());
+    }
+}
+
+TEMPLATE_TEST_CASE("simd integer abs", "", simdi32x4, simdi16x8)
+{
+    using V = TestType;
+    using T = typename V::type;
+    for (T value : test_values<T>()) {
+        const T expected = value == std::numeric_limits<T>::min() ? value : static_cast<T>(value < 0 ? -value : value);
+        REQUIRE(V(value).abs().to_array()[0] == expected);
+    }
+    REQUIRE(simdi32x4(1, -2, 3, -4).abs().to_array() == (std::array<int32_t, 4>{ 1, 2, 3, 4 }));
+    REQUIRE(simd_mask<int32_t, 4>(true, false, true, false).movemask() == 5u);
+    REQUIRE(simd_mask<int16_t, 8>(true, false, true, false, false, false, false, true).movemask() == 0x85u);
+}
+
+TEST_CASE("simd u16 x 8 sum")
+{
+    REQUIRE(simdu16x8(0xffff).sum() == 8u * 0xffff);
+    REQUIRE(simdu16x8(0xffff).sum_saturate() == 0xffff);
+    REQUIRE(simdu16x8(40000, 30000, 0, 0, 0, 0, 0, 0).sum_saturate() == 0xffff);
+    REQUIRE(simdu16x8(1, 2, 3, 4, 5, 6, 7, 8).sum_saturate() == 36);
+}
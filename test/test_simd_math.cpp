@@ -0,0 +1,116 @@
+#include "catch.hpp"
+
+#include "simd/simd_math.hpp"
+#include "simd/simdf16.hpp"
+#include "simd/simdf4.hpp"
+#include "simd/simdf8.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace {
+/**
+    Distance between result and exact in units in the last place of float at exact, the ulp of
+    the smallest denormal for results in the denormal range.
+*/
+double ulp_error(float result, double exact)
+{
+    int exponent;
+    std::frexp(exact, &exponent);
+    const double ulp = std::ldexp(1.0, std::max(exponent - 24, -149));
+    return std::fabs(static_cast<double>(result) - exact) / ulp;
+}
+
+/**
+    Checks f against the double precision reference at 1000 points of [lo, hi], within the
+    error bound documented in simd_math.hpp.
+*/
+template <typename V, typename F, typename R>
+void check_range(F f, R reference, float lo, float hi, double max_ulp)
+{
+    const size_t steps = 1000;
+    for (size_t i = 0; i < steps; i += V::value_count) {
+        alignas(64) std::array<float, V::value_count> input;
+        for (size_t j = 0; j < V::value_count; ++j)
+            input[j] = lo + (hi - lo) * static_cast<float>(std::min(i + j, steps)) / steps;
+        const auto result = f(V(input.data())).to_array();
+        for (size_t j = 0; j < V::value_count; ++j) {
+            INFO("x = " << input[j] << ", result = " << result[j]);
+            REQUIRE(ulp_error(result[j], reference(static_cast<double>(input[j]))) <= max_ulp);
+        }
+    }
+}
+} // namespace
+
+TEMPLATE_TEST_CASE("simd math", "", simdf4, simdf8, simdf16)
+{
+    using V = TestType;
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    SECTION("exp / log")
+    {
+        check_range<V>([](V x) { return simd_math::exp(x); }, [](double x) { return std::exp(x); }, -87, 88, 1);
+        check_range<V>([](V x) { return simd_math::exp2(x); }, [](double x) { return std::exp2(x); }, -126, 127, 2);
+        check_range<V>([](V x) { return simd_math::log(x); }, [](double x) { return std::log(x); }, 1e-3f, 1e4f, 1);
+        check_range<V>([](V x) { return simd_math::log2(x); }, [](double x) { return std::log2(x); }, 1e-30f, 1e30f, 2);
+
+        REQUIRE(simd_math::exp(V(-inf)).to_array()[0] == 0);
+        REQUIRE(simd_math::exp(V(inf)).to_array()[0] == inf);
+        REQUIRE(simd_math::exp(V(100)).to_array()[0] == inf);
+        REQUIRE(simd_math::exp(V()).to_array()[0] == 1);
+        REQUIRE(std::isnan(simd_math::exp(V(nan)).to_array()[0]));
+        REQUIRE(simd_math::exp2(V(10)).to_array()[0] == 1024);
+        REQUIRE(simd_math::exp2(V(-140)).to_array()[0] == Approx(std::exp2(-140.0)).margin(0));
+
+        REQUIRE(simd_math::log(V()).to_array()[0] == -inf);
+        REQUIRE(simd_math::log(V(inf)).to_array()[0] == inf);
+        REQUIRE(simd_math::log(V(1)).to_array()[0] == 0);
+        REQUIRE(std::isnan(simd_math::log(V(-1)).to_array()[0]));
+        REQUIRE(simd_math::log2(V(1024)).to_array()[0] == 10);
+        REQUIRE(simd_math::log2(V(std::numeric_limits<float>::denorm_min())).to_array()[0] == -149);
+    }
+    SECTION("trigonometric")
+    {
+        check_range<V>([](V x) { return simd_math::sin(x); }, [](double x) { return std::sin(x); }, -100, 100, 3);
+        check_range<V>([](V x) { return simd_math::cos(x); }, [](double x) { return std::cos(x); }, -100, 100, 3);
+        check_range<V>([](V x) { return simd_math::tan(x); }, [](double x) { return std::tan(x); }, -1.5f, 1.5f, 4);
+        check_range<V>([](V x) { return simd_math::atan2(x, V(0.5f)); },
+            [](double x) { return std::atan2(x, static_cast<double>(0.5f)); }, -10, 10, 4);
+        check_range<V>([](V x) { return simd_math::atan2(V(-2.0f), x); },
+            [](double x) { return std::atan2(-2.0, x); }, -10, 10, 4);
+
+        V s, c;
+        simd_math::sincos(V(0.5f), s, c);
+        REQUIRE(s.to_array()[0] == Approx(std::sin(0.5)));
+        REQUIRE(c.to_array()[0] == Approx(std::cos(0.5)));
+        REQUIRE(std::signbit(simd_math::sin(V(-0.0f)).to_array()[0]));
+        REQUIRE(std::isnan(simd_math::sin(V(inf)).to_array()[0]));
+        REQUIRE(simd_math::atan2(V(0.0f), V(-0.0f)).to_array()[0] == Approx(3.14159265358979));
+        REQUIRE(simd_math::atan2(V(inf), V(inf)).to_array()[0] == Approx(0.785398163397448));
+        REQUIRE(simd_math::atan2(V(1), V(0.0f)).to_array()[0] == Approx(1.5707963267949));
+    }
+    SECTION("pow")
+    {
+        check_range<V>([](V x) { return simd_math::pow(x, V(2.5f)); }, [](double x) { return std::pow(x, 2.5); }, 0, 1e6f, 3 + 2.5 * std::log2(1e6));
+        check_range<V>([](V y) { return simd_math::pow(V(3.0f), y); }, [](double y) { return std::pow(3.0, y); }, -20, 20, 3 + 20 * std::log2(3.0));
+
+        REQUIRE(simd_math::pow(V(-2), V(3)).to_array()[0] == -8);
+        REQUIRE(simd_math::pow(V(-2), V(-2)).to_array()[0] == 0.25f);
+        REQUIRE(std::isnan(simd_math::pow(V(-2), V(0.5f)).to_array()[0]));
+        REQUIRE(simd_math::pow(V(nan), V()).to_array()[0] == 1);
+        REQUIRE(simd_math::pow(V(0.0f), V(-1)).to_array()[0] == inf);
+        REQUIRE(simd_math::pow(V(2), V(1e10f)).to_array()[0] == inf);
+        REQUIRE(simd_math::pow(V(0.5f), V(inf)).to_array()[0] == 0);
+    }
+    SECTION("tanh / erf")
+    {
+        check_range<V>([](V x) { return simd_math::tanh(x); }, [](double x) { return std::tanh(x); }, -10, 10, 2);
+        check_range<V>([](V x) { return simd_math::erf(x); }, [](double x) { return std::erf(x); }, -5, 5, 3);
+        REQUIRE(simd_math::tanh(V(inf)).to_array()[0] == 1);
+        REQUIRE(simd_math::erf(V(-inf)).to_array()[0] == -1);
+        REQUIRE(std::isnan(simd_math::erf(V(nan)).to_array()[0]));
+    }
+}
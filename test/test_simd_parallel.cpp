@@ -0,0 +1,146 @@
+#include "catch.hpp"
+
+#include "simd/simd_parallel.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace {
+using simd_parallel::range;
+using simd_parallel::thread_pool;
+
+/**
+    The chunks parallel_for passes to its kernel, sorted by begin.
+*/
+template <typename T>
+std::vector<range> chunks_of(range r, size_t grain, thread_pool& pool)
+{
+    std::mutex mutex;
+    std::vector<range> chunks;
+    simd_parallel::parallel_for<T>(r, grain, [&](range chunk) {
+        std::lock_guard<std::mutex> lock(mutex);
+        chunks.push_back(chunk);
+    }, pool);
+    std::sort(chunks.begin(), chunks.end(), [](const range& a, const range& b) { return a.begin < b.begin; });
+    return chunks;
+}
+} // namespace
+
+TEST_CASE("thread_pool")
+{
+    for (size_t threads : { 1, 2, 5 }) {
+        thread_pool pool(threads);
+        REQUIRE(pool.thread_count() == threads);
+        // repeated runs reuse the workers, every task runs exactly once
+        for (size_t task_count : { 0, 1, 3, 100, 1000 }) {
+            std::vector<std::atomic<int>> calls(task_count);
+            for (auto& c : calls)
+                c = 0;
+            pool.run(task_count, [&](size_t i) { ++calls[i]; });
+            for (const auto& c : calls)
+                REQUIRE(c == 1);
+        }
+    }
+    SECTION("nested runs")
+    {
+        thread_pool pool(4);
+        std::atomic<int> calls{ 0 };
+        pool.run(8, [&](size_t) { pool.run(8, [&](size_t) { ++calls; }); });
+        REQUIRE(calls == 64);
+    }
+}
+
+TEST_CASE("parallel_for chunks")
+{
+    thread_pool pool(3);
+    SECTION("cache line boundaries")
+    {
+        // 16 floats or 32 uint16_t per cache line
+        const auto floats = chunks_of<float>({ 5, 1000 }, 40, pool);
+        REQUIRE(floats.size() == 21);
+        REQUIRE(floats.front().begin == 5);
+        REQUIRE(floats.front().end == 48);
+        REQUIRE(floats.back().end == 1000);
+        for (size_t i = 1; i < floats.size(); ++i) {
+            REQUIRE(floats[i].begin == floats[i - 1].end);
+            REQUIRE(floats[i].begin % 16 == 0);
+        }
+        const auto shorts = chunks_of<uint16_t>({ 0, 100 }, 1, pool);
+        REQUIRE(shorts.size() == 4);
+        REQUIRE(shorts[1].begin == 32);
+        REQUIRE(shorts[3].end == 100);
+    }
+    SECTION("empty and single chunk ranges")
+    {
+        REQUIRE(chunks_of<float>({ 7, 7 }, 16, pool).empty());
+        const auto single = chunks_of<float>({ 3, 10 }, 1 << 14, pool);
+        REQUIRE(single.size() == 1);
+        REQUIRE((single[0].begin == 3 && single[0].end == 10));
+    }
+    SECTION("huge grains")
+    {
+        for (size_t grain : { SIZE_MAX, SIZE_MAX - 3, SIZE_MAX / 2 + 1 }) {
+            const auto single = chunks_of<float>({ 100, 5000 }, grain, pool);
+            REQUIRE(single.size() == 1);
+            REQUIRE((single[0].begin == 100 && single[0].end == 5000));
+        }
+        const auto top = chunks_of<uint8_t>({ SIZE_MAX - 10, SIZE_MAX }, SIZE_MAX, pool);
+        REQUIRE(top.size() == 1);
+        REQUIRE((top[0].begin == SIZE_MAX - 10 && top[0].end == SIZE_MAX));
+    }
+}
+
+TEST_CASE("parallel transform and reduce")
+{
+    const size_t count = 100003;
+    aligned_vector<float> input(count);
+    aligned_vector<uint16_t> shorts(count);
+    for (size_t i = 0; i < count; ++i) {
+        input[i] = 0.001f * static_cast<float>(i % 1013) - 0.5f;
+        shorts[i] = static_cast<uint16_t>(i * 7);
+    }
+    thread_pool pool(4);
+
+    SECTION("transform")
+    {
+        aligned_vector<float> expected(count), output(count);
+        const auto op = [](const simd<float, simd_algorithm::native_width<float>::value>& v) { return v * v + v; };
+        simd_algorithm::transform(input.data(), count, expected.data(), op);
+        simd_parallel::transform(input.data(), count, output.data(), op, 1000, pool);
+        REQUIRE(output == expected);
+
+        aligned_vector<uint16_t> short_output(count);
+        simd_parallel::transform(shorts.data(), shorts.data(), count, short_output.data(),
+            [](const simdu16x8& a, const simdu16x8& b) { return a.add_wrap(b); }, 1000, pool);
+        for (size_t i = 0; i < count; ++i)
+            REQUIRE(short_output[i] == static_cast<uint16_t>(2 * shorts[i]));
+    }
+    SECTION("reduce is independent of the thread count")
+    {
+        const auto add = [](const simd<float, simd_algorithm::native_width<float>::value>& a,
+                             const simd<float, simd_algorithm::native_width<float>::value>& b) { return a + b; };
+        const float sum = simd_parallel::reduce(input.data(), count, 0.0f, add, 1000, pool);
+        double expected = 0;
+        for (float v : input)
+            expected += v;
+        REQUIRE(sum == Approx(expected).margin(1e-2));
+        for (size_t threads : { 1, 2, 7 }) {
+            thread_pool other(threads);
+            REQUIRE(simd_parallel::reduce(input.data(), count, 0.0f, add, 1000, other) == sum);
+        }
+        const auto max = [](const simdu16x8& a, const simdu16x8& b) { return a.max(b); };
+        REQUIRE(simd_parallel::reduce(shorts.data(), count, uint16_t(0), max, 1000, pool) == *std::max_element(shorts.begin(), shorts.end()));
+    }
+    SECTION("reduce applies init once")
+    {
+        uint16_t expected = 5;
+        for (uint16_t v : shorts)
+            expected = static_cast<uint16_t>(expected + v);
+        const auto add = [](const simdu16x8& a, const simdu16x8& b) { return a.add_wrap(b); };
+        for (size_t grain : { size_t(1000), size_t(4096), count })
+            REQUIRE(simd_parallel::reduce(shorts.data(), count, uint16_t(5), add, grain, pool) == expected);
+    }
+}
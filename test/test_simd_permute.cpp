@@ -0,0 +1,112 @@
+#include "catch.hpp"
+
+#include "simd/simdd2.hpp"
+#include "simd/simdf4.hpp"
+#include "simd/simdi16x8.hpp"
+#include "simd/simdi32x4.hpp"
+#include "simd/simdu16x8.hpp"
+#include "simd/simdu32x4.hpp"
+#include "simd/simdu8x16.hpp"
+
+#include <utility>
+
+namespace {
+template <unsigned... idx, typename V>
+void check_permute(const V& value)
+{
+    const auto input = value.to_array();
+    const auto output = value.template permute<idx...>().to_array();
+    const unsigned indices[] = { idx... };
+    for (size_t i = 0; i < output.size(); ++i)
+        REQUIRE(output[i] == input[indices[i]]);
+}
+
+template <typename V, size_t... pattern>
+void check_all_permutes(const V& value, std::index_sequence<pattern...>)
+{
+    // every combination of 4 lane indices
+    int expand[] = { (check_permute<pattern & 3, (pattern >> 2) & 3, (pattern >> 4) & 3, (pattern >> 6) & 3>(value), 0)... };
+    (void)expand;
+}
+
+template <size_t... pattern>
+void check_all_shuffles(const simdf4& a, const simdf4& b, std::index_sequence<pattern...>)
+{
+    const auto x = a.to_array();
+    const auto y = b.to_array();
+    int expand[] = { ([&] {
+        const auto r = simdf4::shuffle<pattern & 3, (pattern >> 2) & 3, (pattern >> 4) & 3, (pattern >> 6) & 3>(a, b).to_array();
+        REQUIRE(r == std::array<float, 4>{ x[pattern & 3], x[(pattern >> 2) & 3], y[(pattern >> 4) & 3], y[(pattern >> 6) & 3] });
+    }(),
+        0)... };
+    (void)expand;
+}
+
+template <typename V>
+void check_8_lanes(const V& v)
+{
+    check_permute<0, 1, 2, 3, 4, 5, 6, 7>(v);
+    check_permute<5, 5, 5, 5, 5, 5, 5, 5>(v);
+    check_permute<3, 4, 5, 6, 7, 0, 1, 2>(v);
+    check_permute<1, 0, 3, 2, 5, 4, 7, 6>(v);
+    check_permute<3, 2, 1, 0, 7, 6, 5, 4>(v);
+    check_permute<7, 6, 5, 4, 3, 2, 1, 0>(v);
+    check_permute<0, 0, 1, 1, 2, 2, 3, 3>(v);
+    check_permute<4, 4, 5, 5, 6, 6, 7, 7>(v);
+    check_permute<0, 2, 4, 6, 0, 2, 4, 6>(v);
+    check_permute<1, 3, 5, 7, 1, 3, 5, 7>(v);
+    check_permute<0, 0, 2, 2, 4, 4, 6, 6>(v);
+    check_permute<1, 1, 3, 3, 5, 5, 7, 7>(v);
+    check_permute<6, 7, 0, 1, 2, 3, 2, 3>(v);
+    check_permute<3, 1, 2, 0, 5, 7, 4, 6>(v);
+    check_permute<7, 0, 6, 1, 5, 2, 4, 3>(v);
+}
+} // namespace
+
+TEST_CASE("simd permute")
+{
+    SECTION("4 lanes")
+    {
+        check_all_permutes(simdf4{ 1.5f, -2, 3, 4 }, std::make_index_sequence<256>{});
+        check_all_permutes(simdi32x4{ -1, 2, -3, 4 }, std::make_index_sequence<256>{});
+        check_all_permutes(simdu32x4{ 10, 20, 0xffffffffu, 40 }, std::make_index_sequence<256>{});
+        check_all_shuffles(simdf4{ 1, 2, 3, 4 }, simdf4{ 5, 6, 7, 8 }, std::make_index_sequence<256>{});
+    }
+    SECTION("2 lanes")
+    {
+        const simdd2 d{ 1.5, -2.5 };
+        check_permute<0, 1>(d);
+        check_permute<1, 0>(d);
+        check_permute<0, 0>(d);
+        check_permute<1, 1>(d);
+    }
+    SECTION("8 lanes")
+    {
+        check_8_lanes(simdu16x8{ 10, 11, 12, 13, 14, 15, 0xfffe, 0xffff });
+        check_8_lanes(simdi16x8{ -10, 11, -12, 13, -14, 15, -16, 17 });
+    }
+    SECTION("16 lanes")
+    {
+        std::array<uint8_t, 16> data;
+        for (size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<uint8_t>(100 + i * 9);
+        const simdu8x16 v(data.data());
+        check_permute<0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15>(v);
+        check_permute<9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9>(v);
+        check_permute<5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4>(v);
+        check_permute<1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14>(v);
+        check_permute<3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12>(v);
+        check_permute<7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8>(v);
+        check_permute<15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0>(v);
+        check_permute<0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7>(v);
+        check_permute<8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13, 14, 14, 15, 15>(v);
+        check_permute<0, 2, 4, 6, 8, 10, 12, 14, 0, 2, 4, 6, 8, 10, 12, 14>(v);
+        check_permute<1, 3, 5, 7, 9, 11, 13, 15, 1, 3, 5, 7, 9, 11, 13, 15>(v);
+        check_permute<0, 0, 2, 2, 4, 4, 6, 6, 8, 8, 10, 10, 12, 12, 14, 14>(v);
+        check_permute<1, 1, 3, 3, 5, 5, 7, 7, 9, 9, 11, 11, 13, 13, 15, 15>(v);
+        // moves 16 bit and 32 bit groups
+        check_permute<2, 3, 0, 1, 6, 7, 4, 5, 14, 15, 12, 13, 8, 9, 10, 11>(v);
+        check_permute<12, 13, 14, 15, 0, 1, 2, 3, 8, 9, 10, 11, 4, 5, 6, 7>(v);
+        check_permute<3, 0, 15, 4, 4, 9, 1, 12, 7, 7, 2, 10, 11, 5, 13, 8>(v);
+    }
+}
@@ -0,0 +1,130 @@
+#include "catch.hpp"
+
+#include "simd/simdd2.hpp"
+
+#include <cmath>
+
+TEST_CASE("simd double x2")
+{
+    SECTION("basics")
+    {
+        static_assert(simdd2::bit_count() == 128, "");
+        simdd2 a(5.0);
+        simdd2 b{ 4, 7 };
+        auto c = a + b;
+        REQUIRE(c.to_array() == std::array<double, 2>{ 9, 12 });
+
+        c /= simdd2(2.0);
+        c = c * simdd2(4.0);
+        c = c - a;
+        REQUIRE(c.to_array() == std::array<double, 2>{ 13, 19 });
+
+        c = simdd2{ -1, 2 };
+        b = simdd2{ -2, 3 };
+        REQUIRE(c.min(b).to_array() == std::array<double, 2>{ -2, 2 });
+        REQUIRE(c.max(b).to_array() == std::array<double, 2>{ -1, 3 });
+        REQUIRE(c.abs().to_array() == std::array<double, 2>{ 1, 2 });
+        REQUIRE(simdd2{ 2, 16 }.sqrt().to_array() == std::array<double, 2>{ std::sqrt(2.0), 4 });
+        REQUIRE((simdd2{ 1, -2 } & simdd2(-0.0)).to_array() == std::array<double, 2>{ 0, -0.0 });
+        REQUIRE(std::signbit((simdd2(1.0) | simdd2(-0.0)).to_array()[1]));
+        REQUIRE((simdd2(-3.0) ^ simdd2(-0.0)).to_array()[0] == 3);
+    }
+    SECTION("load / store")
+    {
+        alignas(16) std::array<double, 3> data{ 0, 1, 2 };
+        alignas(16) std::array<double, 3> output{};
+        simdd2(data.data() + 1).store(output.data() + 1);
+        simdd2::load_aligned(data.data()).store_aligned(output.data());
+        REQUIRE(output == std::array<double, 3>{ 0, 1, 2 });
+        simdd2(7.0).store_aligned(output.data(), simd_base::cache_coherence::non_temporal);
+        simd_base::store_fence();
+        REQUIRE(output[1] == 7);
+        for (size_t count = 0; count <= 2; ++count) {
+            const auto loaded = simdd2::load_partial(data.data() + 1, count).to_array();
+            std::array<double, 3> partial{ -1, -1, -1 };
+            simdd2(data.data() + 1).store_partial(partial.data(), count);
+            for (size_t i = 0; i < 2; ++i) {
+                REQUIRE(loaded[i] == (i < count ? data[i + 1] : 0.0));
+                REQUIRE(partial[i] == (i < count ? data[i + 1] : -1.0));
+            }
+            REQUIRE(partial[2] == -1);
+        }
+    }
+    SECTION("float conversion")
+    {
+        const simdf4 f{ 1.5f, -2.25f, 3e30f, 0.1f };
+        REQUIRE(simdd2::from_float_low(f).to_array() == std::array<double, 2>{ 1.5, -2.25 });
+        REQUIRE(simdd2::from_float_high(f).to_array() == std::array<double, 2>{ double(3e30f), double(0.1f) });
+        REQUIRE(simdd2::to_float(simdd2{ 1.5, -2.25 }, simdd2{ 0.1, 1e300 }).to_array() == std::array<float, 4>{ 1.5f, -2.25f, 0.1f, INFINITY });
+    }
+    SECTION("reciprocal")
+    {
+        const simdd2 val{ 0.001, 12345.678 };
+        for (size_t i = 0; i < 2; ++i) {
+            const double x = val.to_array()[i];
+            REQUIRE(val.rcp<simd_base::estimate>().to_array()[i] == Approx(1.0 / x).epsilon(4e-3));
+            REQUIRE(val.rsqrt<simd_base::newton_1>().to_array()[i] == Approx(1.0 / std::sqrt(x)).epsilon(3e-5));
+            REQUIRE(val.rcp<simd_base::newton_2>().to_array()[i] == Approx(1.0 / x).epsilon(1e-9));
+            REQUIRE(val.rsqrt().to_array()[i] == 1.0 / std::sqrt(x));
+            REQUIRE(val.rcp().to_array()[i] == 1.0 / x);
+        }
+    }
+    SECTION("rounding and exponents")
+    {
+        REQUIRE(simdd2{ 2.5, -1.5 }.round().to_array() == std::array<double, 2>{ 2, -2 });
+        REQUIRE(simdd2{ 1e17 + 2, -0.4 }.round().to_array() == std::array<double, 2>{ 1e17 + 2, -0.0 });
+        REQUIRE(simdd2{ 2.5, -1.5 }.floor().to_array() == std::array<double, 2>{ 2, -2 });
+        REQUIRE(simdd2{ 3, 0.75 }.ldexp(simdd2{ 4, -1000 }).to_array() == std::array<double, 2>{ 48, std::ldexp(0.75, -1000) });
+        simdd2 exponent;
+        const auto mantissa = simdd2{ 48, 1e-300 }.frexp(exponent).to_array();
+        int e;
+        REQUIRE(mantissa[0] == 0.75);
+        REQUIRE(mantissa[1] == std::frexp(1e-300, &e));
+        REQUIRE(exponent.to_array() == std::array<double, 2>{ 6, double(e) });
+    }
+    SECTION("fma")
+    {
+        const simdd2 a{ 1, -3 };
+        const simdd2 b{ 4, 6 };
+        const simdd2 c(2.0);
+        REQUIRE(simdd2::fma(a, b, c).to_array() == std::array<double, 2>{ 6, -16 });
+        REQUIRE(simdd2::fms(a, b, c).to_array() == std::array<double, 2>{ 2, -20 });
+        REQUIRE(simdd2::fnma(a, b, c).to_array() == std::array<double, 2>{ -2, 20 });
+    }
+    SECTION("compare and mask")
+    {
+        const simdd2 a{ -2, 1 };
+        const simdd2 b{ -1, 1 };
+        REQUIRE(a.compare(b, simd_base::compare_flags::equal).movemask() == 0x2);
+        REQUIRE(a.compare(b, simd_base::compare_flags::lower).movemask() == 0x1);
+        REQUIRE(a.compare(b, simd_base::compare_flags::lower_equal).movemask() == 0x3);
+        REQUIRE(a.compare(b, simd_base::compare_flags::greater).movemask() == 0x0);
+        REQUIRE(a.compare(b, simd_base::compare_flags::greater_equal).movemask() == 0x2);
+        REQUIRE(a.compare(b, simd_base::compare_flags::not_equal).movemask() == 0x1);
+
+        const auto mask = a.compare(b, simd_base::compare_flags::lower);
+        REQUIRE(mask[0]);
+        REQUIRE_FALSE(mask[1]);
+        REQUIRE(mask.popcount() == 1);
+        REQUIRE((mask | ~mask).all());
+        REQUIRE((mask & ~mask).none());
+        REQUIRE((mask ^ simdd2::mask_type::from_bits(0x3)).movemask() == 0x2);
+        REQUIRE(simdd2::mask_type(false, true).movemask() == 0x2);
+        REQUIRE(simdd2::mask_type::first(1).movemask() == 0x1);
+        REQUIRE(simdd2::mask_type::first(5).all());
+        REQUIRE(simdd2::select(mask, simdd2(9.0), a).to_array() == std::array<double, 2>{ 9, 1 });
+    }
+    SECTION("horizontal add, shuffle, transpose")
+    {
+        const simdd2 a{ 1, 2 };
+        const simdd2 b{ 10, 20 };
+        REQUIRE(simdd2::horizontal_add(a, b).to_array() == std::array<double, 2>{ 3, 30 });
+        REQUIRE((simdd2::shuffle<1, 0>(a, b).to_array()) == std::array<double, 2>{ 2, 10 });
+        REQUIRE(simdd2::unpack_low(a, b).to_array() == std::array<double, 2>{ 1, 10 });
+        REQUIRE(simdd2::unpack_high(a, b).to_array() == std::array<double, 2>{ 2, 20 });
+        simdd2 r0 = a, r1 = b;
+        simdd2::transpose(r0, r1);
+        REQUIRE(r0.to_array() == std::array<double, 2>{ 1, 10 });
+        REQUIRE(r1.to_array() == std::array<double, 2>{ 2, 20 });
+    }
+}
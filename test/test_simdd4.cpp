@@ -0,0 +1,144 @@
+#include "catch.hpp"
+
+#include "simd/simdd4.hpp"
+
+#include <cmath>
+
+TEST_CASE("simd double x4")
+{
+    SECTION("basics")
+    {
+        static_assert(simdd4::bit_count() == 256, "");
+        simdd4 a(5.0);
+        simdd4 b{ 4, 5, 6, 7 };
+        auto c = a + b;
+        REQUIRE(c.to_array() == std::array<double, 4>{ 9, 10, 11, 12 });
+
+        c /= simdd4(2.0);
+        c = c * simdd4(4.0);
+        c = c - a;
+        REQUIRE(c.to_array() == std::array<double, 4>{ 13, 15, 17, 19 });
+
+        c = simdd4{ -1, 2, 0, 4 };
+        b = simdd4{ -2, 0, 1, 3 };
+        REQUIRE(c.min(b).to_array() == std::array<double, 4>{ -2, 0, 0, 3 });
+        REQUIRE(c.max(b).to_array() == std::array<double, 4>{ -1, 2, 1, 4 });
+        REQUIRE(c.abs().to_array() == std::array<double, 4>{ 1, 2, 0, 4 });
+        REQUIRE(simdd4{ 4, 9, 16, 25 }.sqrt().to_array() == std::array<double, 4>{ 2, 3, 4, 5 });
+    }
+    SECTION("halves")
+    {
+        simdd4 a(simdd2(1, 2), simdd2(3, 4));
+        REQUIRE(a.to_array() == std::array<double, 4>{ 1, 2, 3, 4 });
+        REQUIRE(a.low().to_array() == std::array<double, 2>{ 1, 2 });
+        REQUIRE(a.high().to_array() == std::array<double, 2>{ 3, 4 });
+    }
+    SECTION("load / store")
+    {
+        alignas(32) std::array<double, 5> data{ 0, 1, 2, 3, 4 };
+        alignas(32) std::array<double, 5> output{};
+        simdd4(data.data() + 1).store(output.data() + 1);
+        simdd4::load_aligned(data.data()).store_aligned(output.data());
+        REQUIRE(output == data);
+        simdd4(7.0).store_aligned(output.data(), simd_base::cache_coherence::non_temporal);
+        simd_base::store_fence();
+        REQUIRE(output[3] == 7);
+        for (size_t count = 0; count <= 4; ++count) {
+            const auto loaded = simdd4::load_partial(data.data() + 1, count).to_array();
+            std::array<double, 5> partial;
+            partial.fill(-1);
+            simdd4(data.data() + 1).store_partial(partial.data(), count);
+            for (size_t i = 0; i < 4; ++i) {
+                REQUIRE(loaded[i] == (i < count ? data[i + 1] : 0.0));
+                REQUIRE(partial[i] == (i < count ? data[i + 1] : -1.0));
+            }
+            REQUIRE(partial[4] == -1);
+        }
+    }
+    SECTION("float conversion")
+    {
+        const simdf4 f{ 1.5f, -2.25f, 3e30f, 0.1f };
+        const simdd4 d(f);
+        REQUIRE(d.to_array() == std::array<double, 4>{ 1.5, -2.25, double(3e30f), double(0.1f) });
+        REQUIRE(d.to_float().to_array() == f.to_array());
+        REQUIRE(simdd4{ 0.1, 1e300, -1e-300, 2 }.to_float().to_array() == std::array<float, 4>{ 0.1f, INFINITY, -0.0f, 2 });
+    }
+    SECTION("reciprocal")
+    {
+        const simdd4 val{ 0.001, 0.75, 3, 12345.678 };
+        for (size_t i = 0; i < 4; ++i) {
+            const double x = val.to_array()[i];
+            REQUIRE(val.rcp<simd_base::estimate>().to_array()[i] == Approx(1.0 / x).epsilon(4e-3));
+            REQUIRE(val.rsqrt<simd_base::newton_1>().to_array()[i] == Approx(1.0 / std::sqrt(x)).epsilon(3e-5));
+            REQUIRE(val.rcp<simd_base::newton_2>().to_array()[i] == Approx(1.0 / x).epsilon(1e-9));
+            REQUIRE(val.rsqrt().to_array()[i] == 1.0 / std::sqrt(x));
+        }
+    }
+    SECTION("rounding and exponents")
+    {
+        REQUIRE(simdd4{ 2.5, -1.5, 0.5, 1e17 + 2 }.round().to_array() == std::array<double, 4>{ 2, -2, 0, 1e17 + 2 });
+        REQUIRE(simdd4{ 2.5, -1.5, -0.5, 3 }.floor().to_array() == std::array<double, 4>{ 2, -2, -1, 3 });
+        REQUIRE(simdd4{ 3, 0.75, 1, 1 }.ldexp(simdd4{ 4, -1000, 1023, 0 }).to_array() == std::array<double, 4>{ 48, std::ldexp(0.75, -1000), std::ldexp(1.0, 1023), 1 });
+        simdd4 exponent;
+        const auto mantissa = simdd4{ 48, 1, 0.3, 1e300 }.frexp(exponent).to_array();
+        for (size_t i = 0; i < 4; ++i) {
+            int e;
+            const double x = simdd4{ 48, 1, 0.3, 1e300 }.to_array()[i];
+            REQUIRE(mantissa[i] == std::frexp(x, &e));
+            REQUIRE(exponent.to_array()[i] == e);
+        }
+    }
+    SECTION("fma")
+    {
+        const simdd4 a{ 1, 2, -3, 0.5 };
+        const simdd4 b{ 4, -5, 6, 8 };
+        const simdd4 c(2.0);
+        REQUIRE(simdd4::fma(a, b, c).to_array() == std::array<double, 4>{ 6, -8, -16, 6 });
+        REQUIRE(simdd4::fms(a, b, c).to_array() == std::array<double, 4>{ 2, -12, -20, 2 });
+        REQUIRE(simdd4::fnma(a, b, c).to_array() == std::array<double, 4>{ -2, 12, 20, -2 });
+    }
+    SECTION("compare and mask")
+    {
+        const simdd4 a{ -2, 0, 1, 4 };
+        const simdd4 b{ -1, 9, 1, 3 };
+        REQUIRE(a.compare(b, simd_base::compare_flags::equal).movemask() == 0x4);
+        REQUIRE(a.compare(b, simd_base::compare_flags::lower).movemask() == 0x3);
+        REQUIRE(a.compare(b, simd_base::compare_flags::lower_equal).movemask() == 0x7);
+        REQUIRE(a.compare(b, simd_base::compare_flags::greater).movemask() == 0x8);
+        REQUIRE(a.compare(b, simd_base::compare_flags::greater_equal).movemask() == 0xc);
+        REQUIRE(a.compare(b, simd_base::compare_flags::not_equal).movemask() == 0xb);
+
+        const auto mask = a.compare(b, simd_base::compare_flags::greater_equal);
+        REQUIRE(mask.popcount() == 2);
+        REQUIRE(mask.any());
+        REQUIRE_FALSE(mask.all());
+        REQUIRE(mask.low().none());
+        REQUIRE(mask.high().all());
+        REQUIRE((~mask).movemask() == 0x3);
+        REQUIRE((mask ^ simdd4::mask_type::from_bits(0x5)).movemask() == 0x9);
+        REQUIRE(simdd4::mask_type::first(3).movemask() == 0x7);
+        REQUIRE(simdd4::mask_type::first(4).all());
+        REQUIRE(simdd4::select(mask, simdd4(-1.0), a).to_array() == std::array<double, 4>{ -2, 0, -1, -1 });
+    }
+    SECTION("horizontal add, shuffle, transpose")
+    {
+        const simdd4 a{ 1, 2, 3, 4 };
+        const simdd4 b{ 10, 20, 30, 40 };
+        REQUIRE(simdd4::horizontal_add(a, b).to_array() == std::array<double, 4>{ 3, 30, 7, 70 });
+        REQUIRE((simdd4::shuffle<1, 0>(a, b).to_array()) == std::array<double, 4>{ 2, 10, 4, 30 });
+        REQUIRE(simdd4::unpack_low(a, b).to_array() == std::array<double, 4>{ 1, 10, 3, 30 });
+        REQUIRE(simdd4::unpack_high(a, b).to_array() == std::array<double, 4>{ 2, 20, 4, 40 });
+
+        std::array<simdd4, 4> rows;
+        for (size_t i = 0; i < 4; ++i) {
+            const double r = static_cast<double>(i * 4);
+            rows[i] = simdd4(r, r + 1, r + 2, r + 3);
+        }
+        simdd4::transpose(rows[0], rows[1], rows[2], rows[3]);
+        for (size_t i = 0; i < 4; ++i) {
+            const auto row = rows[i].to_array();
+            for (size_t j = 0; j < 4; ++j)
+                REQUIRE(row[j] == static_cast<double>(j * 4 + i));
+        }
+    }
+}
@@ -0,0 +1,116 @@
+#include "catch.hpp"
+
+#include "simd/simdf16.hpp"
+
+#include <cmath>
+
+TEST_CASE("simd float x16")
+{
+    const simdf16 a{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+    SECTION("basics")
+    {
+        static_assert(simdf16::bit_count() == 512, "");
+        auto res = ((a + simdf16(1)) * simdf16(2) - simdf16(2)) / simdf16(2);
+        REQUIRE(res.to_array() == a.to_array());
+        REQUIRE(simdf16(simdf8(1), simdf8(2)).high().to_array() == simdf8(2).to_array());
+        REQUIRE(a.low().to_array() == std::array<float, 8>{ 0, 1, 2, 3, 4, 5, 6, 7 });
+        REQUIRE((simdf16() - a).abs().to_array() == a.to_array());
+        REQUIRE((a * a).sqrt().to_array() == a.to_array());
+        REQUIRE(a.min(simdf16(3)).to_array()[15] == 3);
+        REQUIRE(a.max(simdf16(3)).to_array()[0] == 3);
+    }
+    SECTION("reciprocal")
+    {
+        const simdf16 val = a + simdf16(0.5f);
+        for (size_t i = 0; i < 16; ++i) {
+            const double x = val.to_array()[i];
+            REQUIRE(val.rcp<simd_base::estimate>().to_array()[i] == Approx(1.0 / x).epsilon(4e-3));
+            REQUIRE(val.rsqrt<simd_base::newton_1>().to_array()[i] == Approx(1.0 / std::sqrt(x)).epsilon(3e-5));
+            REQUIRE(val.rcp<simd_base::newton_2>().to_array()[i] == Approx(1.0 / x).epsilon(3e-7));
+            REQUIRE(val.rsqrt().to_array()[i] == Approx(1.0 / std::sqrt(x)).epsilon(3e-7));
+        }
+    }
+    SECTION("fma")
+    {
+        REQUIRE(simdf16::fma(a, a, simdf16(1)).to_array()[15] == 226);
+        REQUIRE(simdf16::fms(a, simdf16(2), simdf16(1)).to_array()[15] == 29);
+        REQUIRE(simdf16::fnma(a, simdf16(2), simdf16(1)).to_array()[15] == -29);
+    }
+    SECTION("compare to mask")
+    {
+        auto mask = a.compare(simdf16(4), simd_base::compare_flags::lower);
+        REQUIRE(mask.movemask() == 0x000f);
+        REQUIRE(mask.popcount() == 4);
+        REQUIRE(mask.any());
+        REQUIRE_FALSE(mask.all());
+        REQUIRE(mask[3]);
+        REQUIRE_FALSE(mask[4]);
+
+        REQUIRE(a.compare(a, simd_base::compare_flags::equal).all());
+        REQUIRE(a.compare(a, simd_base::compare_flags::not_equal).none());
+        REQUIRE(a.compare(simdf16(8), simd_base::compare_flags::greater_equal).movemask() == 0xff00);
+        REQUIRE((~mask).movemask() == 0xfff0);
+        REQUIRE((mask | ~mask).all());
+        REQUIRE((mask & ~mask).none());
+        REQUIRE((mask ^ simdf16::mask_type::first(8)).movemask() == 0x00f0);
+
+        auto res = simdf16::select(mask, a, simdf16(-1)).to_array();
+        REQUIRE(res[0] == 0);
+        REQUIRE(res[3] == 3);
+        REQUIRE(res[4] == -1);
+        REQUIRE(res[15] == -1);
+    }
+    SECTION("masked load / store")
+    {
+        std::array<float, 5> data{ 1, 2, 3, 4, 5 };
+        simdf16 tail(data.data(), simdf16::mask_type::first(data.size()));
+        auto res = tail.to_array();
+        REQUIRE(res[0] == 1);
+        REQUIRE(res[4] == 5);
+        REQUIRE(res[5] == 0);
+        REQUIRE(res[15] == 0);
+
+        std::array<float, 7> output{};
+        output[6] = -1;
+        (tail * simdf16(2)).store(output.data(), simdf16::mask_type::first(6));
+        REQUIRE(output == std::array<float, 7>{ 2, 4, 6, 8, 10, 0, -1 });
+        REQUIRE(simdf16::mask_type::first(0).none());
+        REQUIRE(simdf16::mask_type::first(16).all());
+        REQUIRE(simdf16::mask_type::first(20).all());
+    }
+    SECTION("partial load / store")
+    {
+        for (size_t count = 0; count <= 16; ++count) {
+            std::array<float, 17> output;
+            output.fill(-1);
+            simdf16::load_partial(a.to_array().data(), count).store_partial(output.data(), count);
+            for (size_t i = 0; i < 16; ++i)
+                REQUIRE(output[i] == (i < count ? static_cast<float>(i) : -1.0f));
+            REQUIRE(output[16] == -1);
+            REQUIRE(simdf16::load_partial(output.data(), count).compare(simdf16(-1), simd_base::compare_flags::equal).none());
+        }
+    }
+    SECTION("horizontal add / shuffle")
+    {
+        auto res = simdf16::horizontal_add(a, simdf16(1)).to_array();
+        REQUIRE(res[0] == 1);
+        REQUIRE(res[1] == 5);
+        REQUIRE(res[2] == 2);
+        REQUIRE(res[4] == 9);
+        REQUIRE(res[12] == 25);
+        REQUIRE(res[14] == 2);
+
+        res = simdf16::shuffle<3, 2, 1, 0>(a, a).to_array();
+        REQUIRE(res[0] == 3);
+        REQUIRE(res[3] == 0);
+        REQUIRE(res[4] == 7);
+        res = simdf16::unpack_low(a, simdf16() - a).to_array();
+        REQUIRE(res[0] == 0);
+        REQUIRE(res[2] == 1);
+        REQUIRE(res[3] == -1);
+        REQUIRE(res[12] == 12);
+        res = simdf16::unpack_high(a, a).to_array();
+        REQUIRE(res[0] == 2);
+        REQUIRE(res[15] == 15);
+    }
+}
@@ -2,6 +2,7 @@
 
 #include "simd/simd_base.hpp"
 #include "simd/simdf4.hpp"
+#include <cmath>
 #include <iostream>
 
 TEST_CASE("simd float x4")
@@ -49,52 +50,95 @@ TEST_CASE("simd float x4")
         REQUIRE(output[3] == Approx(3));
         REQUIRE(output[4] == Approx(4));
     }
+    SECTION("partial load / store")
+    {
+        const std::array<float, 4> data{ 1, 2, 3, 4 };
+        for (size_t count = 0; count <= 4; ++count) {
+            const auto loaded = simdf4::load_partial(data.data(), count).to_array();
+            std::array<float, 5> output{ -1, -1, -1, -1, -1 };
+            simdf4(1, 2, 3, 4).store_partial(output.data(), count);
+            for (size_t i = 0; i < 4; ++i) {
+                REQUIRE(loaded[i] == (i < count ? data[i] : 0.0f));
+                REQUIRE(output[i] == (i < count ? data[i] : -1.0f));
+            }
+            REQUIRE(output[4] == -1);
+        }
+        REQUIRE(simdf4::load_partial(data.data(), 10).to_array() == data);
+    }
     SECTION("abs")
     {
         simdf4 val{ 0, -1, 2, -5 };
         auto abs = val.abs();
         REQUIRE(abs.to_array() == std::array<float, 4>{ 0, 1, 2, 5 });
     }
+    SECTION("reciprocal")
+    {
+        const simdf4 val{ 0.001f, 0.75f, 3, 12345.678f };
+        const auto x = val.to_array();
+        const auto check = [&](const simdf4& rcp, const simdf4& rsqrt, double epsilon) {
+            for (size_t i = 0; i < 4; ++i) {
+                REQUIRE(rcp.to_array()[i] == Approx(1.0 / x[i]).epsilon(epsilon));
+                REQUIRE(rsqrt.to_array()[i] == Approx(1.0 / std::sqrt(x[i])).epsilon(epsilon));
+            }
+        };
+        check(val.rcp<simd_base::estimate>(), val.rsqrt<simd_base::estimate>(), 4e-3);
+        check(val.rcp<simd_base::newton_1>(), val.rsqrt<simd_base::newton_1>(), 3e-5);
+        check(val.rcp<simd_base::newton_2>(), val.rsqrt<simd_base::newton_2>(), 3e-7);
+        check(val.rcp(), val.rsqrt(), 3e-7);
+        REQUIRE(simdf4(0.0f).sqrt().to_array()[0] == 0);
+    }
+    SECTION("fma")
+    {
+        const simdf4 a{ 1, 2, -3, 0.5f };
+        const simdf4 b{ 4, -5, 6, 8 };
+        const simdf4 c{ 1, 1, 2, -4 };
+        REQUIRE(simdf4::fma(a, b, c).to_array() == std::array<float, 4>{ 5, -9, -16, 0 });
+        REQUIRE(simdf4::fms(a, b, c).to_array() == std::array<float, 4>{ 3, -11, -20, 8 });
+        REQUIRE(simdf4::fnma(a, b, c).to_array() == std::array<float, 4>{ -3, 11, 20, -8 });
+#if defined(__FMA__) || defined(__aarch64__)
+        // (1 + 2^-12)^2 = 1 + 2^-11 + 2^-24, the last term is lost when the product is rounded
+        const simdf4 x(1.0f + 1.0f / 4096);
+        REQUIRE(simdf4::fms(x, x, simdf4(1.0f + 1.0f / 2048)).to_array()[0] == 1.0f / 16777216);
+#endif
+    }
     SECTION("compare")
     {
         simdf4 a{ -2, 0, 1, 4 };
         simdf4 b{ -1, 9, 1, 78 };
 
-        auto res = a.compare(b, simd_base::compare_flags::equal).to_array();
-        REQUIRE(res[0] == 0);
-        REQUIRE(res[1] == 0);
-        REQUIRE(res[2] != 0);
-        REQUIRE(res[3] == 0);
-
-        res = a.compare(b, simd_base::compare_flags::lower).to_array();
-        REQUIRE(res[0] != 0);
-        REQUIRE(res[1] != 0);
-        REQUIRE(res[2] == 0);
-        REQUIRE(res[3] != 0);
-
-        res = a.compare(b, simd_base::compare_flags::greater).to_array();
-        REQUIRE(res[0] == 0);
-        REQUIRE(res[1] == 0);
-        REQUIRE(res[2] == 0);
-        REQUIRE(res[3] == 0);
-
-        res = a.compare(b, simd_base::compare_flags::not_equal).to_array();
-        REQUIRE(res[0] != 0);
-        REQUIRE(res[1] != 0);
-        REQUIRE(res[2] == 0);
-        REQUIRE(res[3] != 0);
-
-        res = a.compare(b, simd_base::compare_flags::lower_equal).to_array();
-        REQUIRE(res[0] != 0);
-        REQUIRE(res[1] != 0);
-        REQUIRE(res[2] != 0);
-        REQUIRE(res[3] != 0);
+        REQUIRE(a.compare(b, simd_base::compare_flags::equal).movemask() == 0x4);
+        REQUIRE(a.compare(b, simd_base::compare_flags::lower).movemask() == 0xb);
+        REQUIRE(a.compare(b, simd_base::compare_flags::greater).movemask() == 0x0);
+        REQUIRE(a.compare(b, simd_base::compare_flags::not_equal).movemask() == 0xb);
+        REQUIRE(a.compare(b, simd_base::compare_flags::lower_equal).movemask() == 0xf);
+        REQUIRE(a.compare(b, simd_base::compare_flags::greater_equal).movemask() == 0x4);
+    }
+    SECTION("mask")
+    {
+        simdf4 a{ -2, 0, 1, 4 };
+        auto mask = a.compare(simdf4(0.5f), simd_base::compare_flags::lower);
+        REQUIRE(mask[0]);
+        REQUIRE(mask[1]);
+        REQUIRE_FALSE(mask[2]);
+        REQUIRE(mask.any());
+        REQUIRE_FALSE(mask.all());
+        REQUIRE_FALSE(mask.none());
+        REQUIRE(mask.popcount() == 2);
+        REQUIRE((~mask).movemask() == 0xc);
+        REQUIRE((mask & simdf4::mask_type(true, false, true, true)).movemask() == 0x1);
+        REQUIRE((mask | simdf4::mask_type(false, false, false, true)).movemask() == 0xb);
+        REQUIRE((mask ^ simdf4::mask_type::from_bits(0xf)).movemask() == 0xc);
+        REQUIRE(simdf4::mask_type().none());
+        REQUIRE(simdf4::mask_type::from_bits(0xf).all());
+        REQUIRE(simdf4::mask_type::first(3).movemask() == 0x7);
+        REQUIRE(simdf4::mask_type::first(0).none());
+        REQUIRE(simdf4::mask_type::first(9).all());
 
-        res = a.compare(b, simd_base::compare_flags::greater_equal).to_array();
-        REQUIRE(res[0] == 0);
-        REQUIRE(res[1] == 0);
-        REQUIRE(res[2] != 0);
-        REQUIRE(res[3] == 0);
+        auto res = simdf4::select(mask, simdf4(), a);
+        REQUIRE(res.to_array() == std::array<float, 4>{ 0, 0, 1, 4 });
+        // branchless clamp to zero
+        res = simdf4::select(a.compare(simdf4(), simd_base::compare_flags::greater), a, simdf4());
+        REQUIRE(res.to_array() == std::array<float, 4>{ 0, 0, 1, 4 });
     }
     SECTION("horizontal add")
     {
@@ -103,6 +147,26 @@ TEST_CASE("simd float x4")
         auto res = simdf4::horizontal_add(a, b);
         REQUIRE(res.to_array() == std::array<float, 4>{ 3, 7, 11, 15 });
     }
+    SECTION("reductions")
+    {
+        simdf4 a{ 1, -2, 8, 4 };
+        REQUIRE(a.reduce_add() == 11);
+        REQUIRE(a.reduce_min() == -2);
+        REQUIRE(a.reduce_max() == 8);
+        REQUIRE(simdf4(-3, -1, -7, -5).reduce_max() == -1);
+        REQUIRE(simdf4::dot(a, simdf4{ 2, 3, 1, -1 }) == 0);
+        REQUIRE(simdf4::dot(a, a) == 85);
+        // every lane takes part wherever it is
+        for (int lane = 0; lane < 4; ++lane) {
+            std::array<float, 4> values = { 1, 1, 1, 1 };
+            values[lane] = 10;
+            const simdf4 v(values.data());
+            REQUIRE(v.reduce_add() == 13);
+            REQUIRE(v.reduce_max() == 10);
+            values[lane] = -10;
+            REQUIRE(simdf4(values.data()).reduce_min() == -10);
+        }
+    }
     SECTION("unpack")
     {
         simdf4 a{ 1, 2, 3, 4 };
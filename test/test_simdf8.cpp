@@ -0,0 +1,155 @@
+#include "catch.hpp"
+
+#include "simd/simdf8.hpp"
+
+#include <cmath>
+
+TEST_CASE("simd float x8")
+{
+    SECTION("basics")
+    {
+        static_assert(simdf8::bit_count() == 256, "");
+        simdf8 a(5);
+        simdf8 b{ 4, 5, 6, 7, 8, 9, 10, 11 };
+        auto c = a + b;
+        REQUIRE(c.to_array() == std::array<float, 8>{ 9, 10, 11, 12, 13, 14, 15, 16 });
+
+        c /= simdf8(2.0f);
+        c = c * simdf8(4.0f);
+        c = c - a;
+        REQUIRE(c.to_array() == std::array<float, 8>{ 13, 15, 17, 19, 21, 23, 25, 27 });
+
+        c = simdf8{ -1, 2, 0, 4, 5, -6, 7, 8 };
+        b = simdf8{ -2, 0, 1, 3, 6, -7, 7, 0 };
+        REQUIRE(c.min(b).to_array() == std::array<float, 8>{ -2, 0, 0, 3, 5, -7, 7, 0 });
+        REQUIRE(c.max(b).to_array() == std::array<float, 8>{ -1, 2, 1, 4, 6, -6, 7, 8 });
+        REQUIRE(c.abs().to_array() == std::array<float, 8>{ 1, 2, 0, 4, 5, 6, 7, 8 });
+
+        const auto res = simdf8{ 2, 3, 4, 9, 16, 25, 1, 0 }.sqrt().to_array();
+        REQUIRE(res[0] == Approx(sqrt(2)));
+        REQUIRE(res[1] == Approx(sqrt(3)));
+        REQUIRE(res[2] == Approx(2));
+        REQUIRE(res[3] == Approx(3));
+        REQUIRE(res[4] == Approx(4));
+        REQUIRE(res[5] == Approx(5));
+        REQUIRE(res[6] == Approx(1));
+    }
+    SECTION("halves")
+    {
+        simdf8 a(simdf4(1, 2, 3, 4), simdf4(5, 6, 7, 8));
+        REQUIRE(a.to_array() == std::array<float, 8>{ 1, 2, 3, 4, 5, 6, 7, 8 });
+        REQUIRE(a.low().to_array() == std::array<float, 4>{ 1, 2, 3, 4 });
+        REQUIRE(a.high().to_array() == std::array<float, 4>{ 5, 6, 7, 8 });
+    }
+    SECTION("load / store")
+    {
+        alignas(32) std::array<float, 9> data{ 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+        simdf8 aligned(data.data());
+        simdf8 unaligned(data.data() + 1);
+        alignas(32) std::array<float, 9> output{};
+        unaligned.store(output.data() + 1);
+        REQUIRE(output == data);
+        aligned.store_aligned(output.data());
+        REQUIRE(output[7] == 7);
+        aligned.store(output.data(), simd_base::cache_coherence::non_temporal);
+        simd_base::store_fence();
+        REQUIRE(output[7] == 7);
+    }
+    SECTION("partial load / store")
+    {
+        const std::array<float, 8> data{ 1, 2, 3, 4, 5, 6, 7, 8 };
+        for (size_t count = 0; count <= 8; ++count) {
+            const auto loaded = simdf8::load_partial(data.data(), count).to_array();
+            std::array<float, 9> output;
+            output.fill(-1);
+            simdf8(data.data()).store_partial(output.data(), count);
+            for (size_t i = 0; i < 8; ++i) {
+                REQUIRE(loaded[i] == (i < count ? data[i] : 0.0f));
+                REQUIRE(output[i] == (i < count ? data[i] : -1.0f));
+            }
+            REQUIRE(output[8] == -1);
+        }
+    }
+    SECTION("reciprocal")
+    {
+        const simdf8 val{ 0.001f, 0.75f, 3, 12345.678f, 1, 2, 4, 1e10f };
+        for (size_t i = 0; i < 8; ++i) {
+            const double x = val.to_array()[i];
+            REQUIRE(val.rcp<simd_base::estimate>().to_array()[i] == Approx(1.0 / x).epsilon(4e-3));
+            REQUIRE(val.rsqrt<simd_base::newton_1>().to_array()[i] == Approx(1.0 / std::sqrt(x)).epsilon(3e-5));
+            REQUIRE(val.rcp<simd_base::newton_2>().to_array()[i] == Approx(1.0 / x).epsilon(3e-7));
+            REQUIRE(val.rsqrt().to_array()[i] == Approx(1.0 / std::sqrt(x)).epsilon(3e-7));
+        }
+    }
+    SECTION("fma")
+    {
+        const simdf8 a{ 1, 2, -3, 0.5f, 0, 1, 2, 3 };
+        const simdf8 b{ 4, -5, 6, 8, 1, 1, 1, 1 };
+        const simdf8 c(2);
+        REQUIRE(simdf8::fma(a, b, c).to_array() == std::array<float, 8>{ 6, -8, -16, 6, 2, 3, 4, 5 });
+        REQUIRE(simdf8::fms(a, b, c).to_array() == std::array<float, 8>{ 2, -12, -20, 2, -2, -1, 0, 1 });
+        REQUIRE(simdf8::fnma(a, b, c).to_array() == std::array<float, 8>{ -2, 12, 20, -2, 2, 1, 0, -1 });
+    }
+    SECTION("compare")
+    {
+        simdf8 a{ -2, 0, 1, 4, 1, 1, 1, 1 };
+        simdf8 b{ -1, 9, 1, 78, 0, 1, 2, 1 };
+
+        REQUIRE(a.compare(b, simd_base::compare_flags::equal).movemask() == 0xa4);
+        REQUIRE(a.compare(b, simd_base::compare_flags::lower).movemask() == 0x4b);
+        REQUIRE(a.compare(b, simd_base::compare_flags::lower_equal).movemask() == 0xef);
+        REQUIRE(a.compare(b, simd_base::compare_flags::greater).movemask() == 0x10);
+        REQUIRE(a.compare(b, simd_base::compare_flags::greater_equal).movemask() == 0xb4);
+        REQUIRE(a.compare(b, simd_base::compare_flags::not_equal).movemask() == 0x5b);
+    }
+    SECTION("mask")
+    {
+        simdf8 a{ 0, 1, 2, 3, 4, 5, 6, 7 };
+        auto mask = a.compare(simdf8(5), simd_base::compare_flags::greater_equal);
+        REQUIRE(mask.movemask() == 0xe0);
+        REQUIRE(mask.popcount() == 3);
+        REQUIRE(mask.any());
+        REQUIRE_FALSE(mask.all());
+        REQUIRE(mask.low().none());
+        REQUIRE(mask.high().movemask() == 0xe);
+        REQUIRE((~mask).movemask() == 0x1f);
+        REQUIRE((mask | ~mask).all());
+        REQUIRE((mask & ~mask).none());
+        REQUIRE((mask ^ simdf8::mask_type::from_bits(0xff)).movemask() == 0x1f);
+        REQUIRE(simdf8::mask_type::first(6).movemask() == 0x3f);
+        REQUIRE(simdf8::mask_type::first(2).movemask() == 0x03);
+        REQUIRE(simdf8::mask_type::first(8).all());
+
+        auto res = simdf8::select(mask, simdf8(-1), a);
+        REQUIRE(res.to_array() == std::array<float, 8>{ 0, 1, 2, 3, 4, -1, -1, -1 });
+    }
+    SECTION("horizontal add")
+    {
+        simdf8 a{ 1, 2, 3, 4, 5, 6, 7, 8 };
+        simdf8 b{ 10, 20, 30, 40, 50, 60, 70, 80 };
+        auto res = simdf8::horizontal_add(a, b);
+        REQUIRE(res.to_array() == std::array<float, 8>{ 3, 7, 30, 70, 11, 15, 110, 150 });
+    }
+    SECTION("shuffle / unpack")
+    {
+        simdf8 a{ 1, 2, 3, 4, 5, 6, 7, 8 };
+        simdf8 b{ 10, 20, 30, 40, 50, 60, 70, 80 };
+        REQUIRE(simdf8::shuffle<2, 1, 0, 3>(a, b).to_array() == std::array<float, 8>{ 3, 2, 10, 40, 7, 6, 50, 80 });
+        REQUIRE(simdf8::unpack_low(a, b).to_array() == std::array<float, 8>{ 1, 10, 2, 20, 5, 50, 6, 60 });
+        REQUIRE(simdf8::unpack_high(a, b).to_array() == std::array<float, 8>{ 3, 30, 4, 40, 7, 70, 8, 80 });
+    }
+    SECTION("transposition")
+    {
+        std::array<simdf8, 8> rows;
+        for (size_t i = 0; i < 8; ++i) {
+            const float r = static_cast<float>(i * 8);
+            rows[i] = simdf8(r, r + 1, r + 2, r + 3, r + 4, r + 5, r + 6, r + 7);
+        }
+        simdf8::transpose(rows[0], rows[1], rows[2], rows[3], rows[4], rows[5], rows[6], rows[7]);
+        for (size_t i = 0; i < 8; ++i) {
+            const auto row = rows[i].to_array();
+            for (size_t j = 0; j < 8; ++j)
+                REQUIRE(row[j] == static_cast<float>(j * 8 + i));
+        }
+    }
+}
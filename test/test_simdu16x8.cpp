@@ -20,6 +20,21 @@ TEST_CASE("simd u16 x 8")
         s = simdu16x8(data8x8.data());
         REQUIRE(s.to_array() == data);
     }
+    SECTION("partial load / store")
+    {
+        const std::array<uint16_t, 8> data = { 1, 2, 3, 4, 5, 6, 7, 8 };
+        for (size_t count = 0; count <= 8; ++count) {
+            const auto loaded = simdu16x8::load_partial(data.data(), count).to_array();
+            std::array<uint16_t, 9> output;
+            output.fill(0xffff);
+            simdu16x8(data.data()).store_partial(output.data(), count);
+            for (size_t i = 0; i < 8; ++i) {
+                REQUIRE(loaded[i] == (i < count ? data[i] : 0));
+                REQUIRE(output[i] == (i < count ? data[i] : 0xffff));
+            }
+            REQUIRE(output[8] == 0xffff);
+        }
+    }
     SECTION("arthmetic")
     {
         simdu16x8 result = simdu16x8(5) + simdu16x8(1, 2, 3, 4, 5, 6, 7, 8);
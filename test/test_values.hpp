@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+    Deterministic pseudo-random value in [-1, 1] in steps of 0.001, advancing seed (a linear
+    congruential generator, the same sequence on every platform).
+*/
+inline float next_test_value(unsigned& seed)
+{
+    seed = seed * 1103515245u + 12345u;
+    return static_cast<float>((seed >> 16) % 2001) / 1000.0f - 1.0f;
+}
+
+/**
+    count values of next_test_value starting from seed.
+*/
+inline std::vector<float> test_values(size_t count, unsigned seed)
+{
+    std::vector<float> values(count);
+    for (auto& v : values)
+        v = next_test_value(seed);
+    return values;
+}